@@ -116,6 +116,23 @@ typedef struct cl_mem_ext_ptr_t {
 /* Additional cl_device_partition_property */
 #define CL_DEVICE_PARTITION_BY_CONNECTIVITY         (1 << 31)
 
+/*
+ * Additional cl_command_queue_properties.  Hints for scheduling the
+ * DMA operations (buffer read, write, map, unmap, migrate) of the
+ * command queue relative to those of other command queues on the same
+ * device.  Default is normal priority.
+ */
+#define XCL_QUEUE_PRIORITY_HIGH                     (1 << 30)
+#define XCL_QUEUE_PRIORITY_LOW                      (1 << 29)
+
+/*
+ * Additional cl_context_properties.  Value is a cl_bool, when CL_TRUE
+ * the devices of the context are ordered such that devices attached
+ * to the NUMA node of the thread creating the context come first, and
+ * host memory of buffers is placed on the NUMA node of the devices.
+ */
+#define XCL_CONTEXT_PREFER_LOCAL_DEVICES            0x1200
+
 #ifdef CL_VERSION_1_0
 extern cl_int
 clSetCommandQueueProperty(cl_command_queue command_queue,
@@ -355,6 +372,31 @@ clPollStream(cl_stream             /* stream*/,
 	cl_int /*timeout in ms*/,
 	cl_int * /*errcode_ret*/) CL_API_SUFFIX__VERSION_1_0;
 
+/* clPollStreamSet - Poll a set of streams on a device for completion.
+ * Each stream must have its own completion queue, enabled with
+ * clSetStreamOpt(STREAM_OPT_AIO_MAX_EVENT).  Only the completions
+ * of the specified streams are returned, other streams on the device
+ * are not serviced.
+ * @streams               : The streams, all on the same device
+ * @num_streams           : Number of streams
+ * @completions           : Completions array
+ * @min_num_completions   : Minimum number of completions requested
+ * @max_num_completions   : Maximum number of completions requested
+ * @actual_num_completions: Actual number of completions returned.
+ * @timeout               : Timeout in milliseconds (ms)
+ * @errcode_ret :         : The return value eg CL_SUCCESS
+ * Return a cl_int.
+ */
+extern CL_API_ENTRY cl_int CL_API_CALL
+clPollStreamSet(const cl_stream*      /* streams*/,
+	cl_uint /*num_streams*/,
+       	cl_streams_poll_req_completions* /*completions*/,
+	cl_int  /*min_num_completion*/,
+	cl_int  /*max_num_completion*/,
+	cl_int* /*actual num_completion*/,
+	cl_int /*timeout in ms*/,
+	cl_int * /*errcode_ret*/) CL_API_SUFFIX__VERSION_1_0;
+
 /* clSetStreamOpt -Set stream options.
  * @stream                : The stream
  * @option                : the option type
@@ -23,7 +23,11 @@
 #include "core/common/config.h"
 #include "core/include/ert.h"
 
-namespace xrt_core { namespace bo {
+namespace xrt_core {
+
+class device;
+
+namespace bo {
 
 /**
  * address() - Get physical device address of BO
@@ -64,6 +68,13 @@ XRT_CORE_COMMON_EXPORT
 size_t
 alignment();
 
+// Release cached user memory registrations of a device, see
+// Runtime.ubuf_cache_mb.  Called before an xclbin is loaded and when
+// the device is closed, since registrations hold device memory.
+XRT_CORE_COMMON_EXPORT
+void
+release_userptr_cache(const xrt_core::device* device);
+
 }} // namespace bo, xrt_core
 
 #endif
@@ -20,6 +20,7 @@
 #include "core/common/device.h"
 #include "xrt.h"
 #include "ert.h"
+#include <bitset>
 
 /**
  * class command - Command API expected by sws and kds command monitor
@@ -77,8 +78,59 @@ public:
   virtual void
   notify(ert_cmd_state) = 0;
 
+  /**
+   * struct exec_cache - Scheduler data derived from a frozen command
+   *
+   * @exec: scheduler object for the command's device
+   * @cus:  compute units decoded from the command packet cu masks
+   *
+   * The cache is populated by the scheduler the first time a frozen
+   * command is started, and is cleared when the command is frozen
+   * or thawed.
+   */
+  struct exec_cache
+  {
+    void* exec = nullptr;
+    std::bitset<128> cus;
+  };
+
+  /**
+   * is_frozen() - check if command packet layout is frozen
+   *
+   * The packet header and cu masks of a frozen command do not change
+   * between executions, only the argument payload changes.
+   */
+  bool
+  is_frozen() const
+  {
+    return m_frozen;
+  }
+
+  /**
+   * set_frozen() - freeze or thaw the command packet layout
+   *
+   * Must not be called while the command is running.
+   */
+  void
+  set_frozen(bool frozen)
+  {
+    m_frozen = frozen;
+    m_exec_cache = exec_cache{};
+  }
+
+  /**
+   * get_exec_cache() - scheduler data for frozen command
+   */
+  exec_cache&
+  get_exec_cache() const
+  {
+    return m_exec_cache;
+  }
+
 private:
   unsigned long m_uid;
+  bool m_frozen = false;
+  mutable exec_cache m_exec_cache;
 };
 
 
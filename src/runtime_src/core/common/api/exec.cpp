@@ -116,6 +116,16 @@ unmanaged_wait(const command* cmd)
     sws::unmanaged_wait(cmd);
 }
 
+// Wait for a command to complete execution or timeout
+std::cv_status
+unmanaged_wait(const command* cmd, const std::chrono::milliseconds& timeout)
+{
+  if (kds_enabled())
+    return kds::unmanaged_wait(cmd, timeout);
+  else
+    return sws::unmanaged_wait(cmd, timeout);
+}
+
 void
 init(xrt_core::device* device)
 {
@@ -18,6 +18,8 @@
 #define xrt_core_exec_h_
 
 #include "core/common/config.h"
+#include <chrono>
+#include <condition_variable>
 #include <vector>
 #include <memory>
 
@@ -43,6 +45,9 @@ unmanaged_start(command* cmd)
 void
 unmanaged_wait(const command* cmd);
 
+std::cv_status
+unmanaged_wait(const command* cmd, const std::chrono::milliseconds& timeout);
+
 void
 start();
 
@@ -68,6 +73,9 @@ unmanaged_start(command* cmd);
 void
 unmanaged_wait(const command* cmd);
 
+std::cv_status
+unmanaged_wait(const command* cmd, const std::chrono::milliseconds& timeout);
+
 void
 start();
 
@@ -105,6 +113,13 @@ XRT_CORE_COMMON_EXPORT
 void
 unmanaged_wait(const command* cmd);
 
+// Wait for a command to complete execution or for timeout to expire.
+// Same as above, but returns std::cv_status::timeout if the command
+// did not complete before the timeout.
+XRT_CORE_COMMON_EXPORT
+std::cv_status
+unmanaged_wait(const command* cmd, const std::chrono::milliseconds& timeout);
+
 void
 start();
 
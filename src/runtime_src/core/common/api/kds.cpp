@@ -18,6 +18,8 @@
 #include "exec.h"
 #include "ert.h"
 #include "command.h"
+#include "core/common/completion_reactor.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
 #include "core/common/thread.h"
 #include "core/common/debug.h"
@@ -28,6 +30,7 @@
 #include <algorithm>
 #include <thread>
 #include <mutex>
+#include <chrono>
 #include <condition_variable>
 #include <list>
 #include <map>
@@ -78,24 +81,82 @@ notify_host(xrt_core::command* cmd)
 // @monitor_thread: Thread for asynchronous monitoring of command execution
 // @exec_wait_call_count:  Count of number of calls to exec wait
 // @stop: Stop the monitor thread
+// @reactor: Completion reactor monitoring this device if any
+// @reactor_handle: Handle of this device in the completion reactor
+// @exec_wait_cond: Signalled by the reactor on device interrupt
 //
 // This class is per xrt_core::device. The class constructor starts a
 // command monitor thread that manages command execution.  It also
 // provides a thread safe interface to shim level exec_wait which can
 // be called explicitly to wait for command completion.
+//
+// If the completion reactor is enabled and the device has a file
+// descriptor to wait on, then the reactor monitors command execution
+// in place of the monitor thread.  The reactor is the only caller of
+// shim level exec_wait, which is then replaced with waiting for the
+// reactor to observe an interrupt.
 class kds_device
 {
   xrt_core::device* device;
-  std::mutex exec_wait_mutex;
+  std::timed_mutex exec_wait_mutex;
   std::mutex work_mutex;
   std::condition_variable work_cond;
   command_queue_type submitted_cmds;
+  command_queue_type running_cmds;
+  command_queue_type busy_cmds;
   uint64_t exec_wait_call_count = 0;
   bool stop = false;
 
+  std::shared_ptr<xrt_core::completion_reactor> reactor;
+  xrt_core::completion_reactor::handle_type reactor_handle = 0;
+  std::condition_variable_any exec_wait_cond;
+
   // thread can be constructed only after data members are initialized
   std::thread monitor_thread;  
 
+  // notify_completed() - Notify managed commands that have completed
+  //
+  // Must be called after exec_wait, see monitor_loop().  Called by
+  // the monitor thread or by the completion reactor, never both.
+  void
+  notify_completed()
+  {
+    // Drain submitted commands.
+    {
+      std::lock_guard<std::mutex> lk(work_mutex);
+      std::copy(submitted_cmds.begin(), submitted_cmds.end(), std::back_inserter(running_cmds));
+      submitted_cmds.clear();
+    }
+    // At this point running_cmds is guaranteed to contain the
+    // command(s) for which exec_wait returned.
+
+    // Preserve order of processing
+    for (auto cmd : running_cmds) {
+      if (completed(cmd))
+        notify_host(cmd);
+      else
+        busy_cmds.push_back(cmd);
+    }
+
+    running_cmds.swap(busy_cmds);
+    busy_cmds.clear();
+  }
+
+  // on_interrupt() - Completion reactor observed a device interrupt
+  //
+  // Counts as a call to shim level exec_wait.  Threads waiting in
+  // exec_wait() are released and managed commands are notified.
+  void
+  on_interrupt()
+  {
+    {
+      std::lock_guard<std::timed_mutex> lk(exec_wait_mutex);
+      ++exec_wait_call_count;
+    }
+    exec_wait_cond.notify_all();
+    notify_completed();
+  }
+
   // monitor_loop() - Manage running commands and notify on completion
   //
   // The monitor thread services managed command and asynchronously
@@ -106,9 +167,6 @@ class kds_device
   void
   monitor_loop()
   {
-    std::vector<xrt_core::command*> busy_cmds;
-    std::vector<xrt_core::command*> running_cmds;
-
     while (1) {
 
       // Larger wait synchronized with launch()
@@ -124,9 +182,9 @@ class kds_device
       // Finer wait
       exec_wait();
 
-      // Drain submitted commands.  It is important that this comes
-      // after exec_wait and is synchronized with launch() that added
-      // to submitted_cmds.
+      // Drain submitted commands and notify completed commands.  It
+      // is important that draining comes after exec_wait and is
+      // synchronized with launch() that added to submitted_cmds.
       //
       // Scenario if before exec_wait is that a new command was added
       // to submitted_cmds and exec_buf immediately after the critical
@@ -139,24 +197,7 @@ class kds_device
       // The sequence is very important.  It must be guaranteed that
       // exec_wait will never return for a command that is not yet
       // in either running_cmds or submitted_cmds.
-      {
-        std::lock_guard<std::mutex> lk(work_mutex);
-        std::copy(submitted_cmds.begin(), submitted_cmds.end(), std::back_inserter(running_cmds));
-        submitted_cmds.clear();
-      }
-      // At this point running_cmds is guaranteed to contain the
-      // command(s) for which exec_wait returned.
-
-      // Preserve order of processing
-      for (auto cmd : running_cmds) {
-        if (completed(cmd))
-          notify_host(cmd);
-        else
-          busy_cmds.push_back(cmd);
-      }
-
-      running_cmds.swap(busy_cmds);
-      busy_cmds.clear();
+      notify_completed();
     } // while (1)
   }
 
@@ -180,14 +221,27 @@ class kds_device
   
 
 public:
-  // Constructor starts monitor thread
+  // Constructor adds device to completion reactor or starts monitor thread
   kds_device(xrt_core::device* dev)
-      : device(dev), monitor_thread(xrt_core::thread(&kds_device::monitor, this))
-  {}
+      : device(dev)
+  {
+    auto fd = xrt_core::config::get_kds_reactor() ? device->get_exec_wait_fd() : -1;
+    if (fd >= 0 && (reactor = xrt_core::completion_reactor::instance())) {
+      reactor_handle = reactor->add(fd, [this] { on_interrupt(); });
+      return;
+    }
 
-  // Destructor stops and joins monitor thread
+    monitor_thread = xrt_core::role_thread(xrt_core::thread_role::completion, dev, &kds_device::monitor, this);
+  }
+
+  // Destructor removes device from reactor or stops and joins monitor thread
   ~kds_device()
   {
+    if (reactor) {
+      reactor->remove(reactor_handle);
+      return;
+    }
+
     stop = true;
     work_cond.notify_one();
     monitor_thread.join();
@@ -211,21 +265,82 @@ public:
   void
   exec_wait()
   {
-    static thread_local uint64_t thread_exec_wait_call_count = 0;
-    std::lock_guard<std::mutex> lk(exec_wait_mutex);
+    std::unique_lock<std::timed_mutex> lk(exec_wait_mutex);
 
-    if (thread_exec_wait_call_count != exec_wait_call_count) {
-      // some other thread has called exec_wait and may have
-      // covered this thread's commands, synchronize thread
-      // local call count and return to caller.
-      thread_exec_wait_call_count = exec_wait_call_count;
+    if (sync_exec_wait_call_count(false))
+      return;
+
+    // The wait is bounded like shim level exec_wait below, callers
+    // check command state after return so a missed interrupt only
+    // delays them
+    if (reactor) {
+      auto count = exec_wait_call_count;
+      if (exec_wait_cond.wait_for(lk, std::chrono::milliseconds(1000), [this, count] { return exec_wait_call_count != count; }))
+        sync_exec_wait_call_count(false);
       return;
     }
 
     while (device->exec_wait(1000)==0) {}
 
-    // synchronize this thread with total call count
-    thread_exec_wait_call_count = ++exec_wait_call_count;
+    sync_exec_wait_call_count(true);
+  }
+
+  // Timed version of exec_wait()
+  //
+  // Return: false if deadline expired without shim exec_wait
+  // returning, true otherwise.
+  //
+  // Another thread may be blocked in shim exec_wait while holding the
+  // lock, so the lock itself is acquired with the deadline.
+  bool
+  exec_wait(const std::chrono::steady_clock::time_point& deadline)
+  {
+    std::unique_lock<std::timed_mutex> lk(exec_wait_mutex, deadline);
+    if (!lk.owns_lock())
+      return false;
+
+    if (sync_exec_wait_call_count(false))
+      return true;
+
+    if (reactor) {
+      auto count = exec_wait_call_count;
+      if (!exec_wait_cond.wait_until(lk, deadline, [this, count] { return exec_wait_call_count != count; }))
+        return false;
+      sync_exec_wait_call_count(false);
+      return true;
+    }
+
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>
+      (deadline - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0 || device->exec_wait(static_cast<int>(remaining))==0)
+      return false;
+
+    sync_exec_wait_call_count(true);
+    return true;
+  }
+
+  // Synchronize this thread with the total exec_wait call count,
+  // optionally after incrementing total count.  Must be called with
+  // exec_wait_mutex locked.
+  //
+  // Return: true if the thread local count was behind, meaning some
+  // other thread has called exec_wait and may have covered this
+  // thread's commands.
+  bool
+  sync_exec_wait_call_count(bool called)
+  {
+    static thread_local uint64_t thread_exec_wait_call_count = 0;
+    if (called) {
+      thread_exec_wait_call_count = ++exec_wait_call_count;
+      return false;
+    }
+
+    if (thread_exec_wait_call_count != exec_wait_call_count) {
+      thread_exec_wait_call_count = exec_wait_call_count;
+      return true;
+    }
+
+    return false;
   }
 
   // exec_wait() - Wait for specific command completion
@@ -244,6 +359,26 @@ public:
     notify_host(const_cast<xrt_core::command*>(cmd), static_cast<ert_cmd_state>(pkt->state));
   }
 
+  // exec_wait() - Wait for specific command completion or timeout
+  //
+  // The command is notified only if it completed.
+  std::cv_status
+  exec_wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout)
+  {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto pkt = cmd->get_ert_packet();
+    while (pkt->state < ERT_CMD_STATE_COMPLETED) {
+      if (!exec_wait(deadline) && std::chrono::steady_clock::now() >= deadline)
+        break;
+    }
+
+    if (pkt->state < ERT_CMD_STATE_COMPLETED)
+      return std::cv_status::timeout;
+
+    notify_host(const_cast<xrt_core::command*>(cmd), static_cast<ert_cmd_state>(pkt->state));
+    return std::cv_status::no_timeout;
+  }
+
   // exec_buf() - Submit a command for execution
   //
   // This function is used to schedule unmanaged commands for
@@ -320,11 +455,19 @@ get_kds_device_or_error(const xrt_core::device* device)
 }
 
 // Get kds_device from command object.  Throws if kds_device
-// doesn't exist
+// doesn't exist.  The kds_device of a frozen command is looked
+// up once and cached in the command.
 kds_device*
 get_kds_device(const xrt_core::command* cmd)
 {
-  return get_kds_device_or_error(cmd->get_device());
+  auto& cache = cmd->get_exec_cache();
+  if (cache.exec)
+    return static_cast<kds_device*>(cache.exec);
+
+  auto kdev = get_kds_device_or_error(cmd->get_device());
+  if (cmd->is_frozen())
+    cache.exec = kdev;
+  return kdev;
 }
 
 } // namespace
@@ -340,6 +483,15 @@ unmanaged_wait(const xrt_core::command* cmd)
   kdev->exec_wait(cmd);
 }
 
+// Wait for command completion for unmanaged command execution
+// with timeout
+std::cv_status
+unmanaged_wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout)
+{
+  auto kdev = get_kds_device(cmd);
+  return kdev->exec_wait(cmd, timeout);
+}
+
 // Start unmanaged command execution.  The command must be explicitly
 // tested for completion, either by actively polling command state or
 // calling unmanaged wait
@@ -37,6 +37,7 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 
@@ -144,13 +145,28 @@ public:
   {
     static size_type count = 0;
     m_uid = count++;
-    if (m_ecmd->type==ERT_CU) {
-      m_cus |= m_kcmd->cu_mask;
-      for (size_type i=0; i<m_kcmd->extra_cu_masks; ++i) {
-        cu_bitset_type mask(m_kcmd->data[i]);
-        m_cus |= (mask<<sizeof(value_type)*8*i);
-      }
+    if (m_ecmd->type==ERT_CU)
+      m_cus = decode_cus(m_kcmd);
+  }
+
+  // Construct with CUs already decoded, used for frozen commands
+  xocl_cmd(exec_core* ec, cmd_ptr cmd, const cu_bitset_type& cus)
+    : m_cmd(cmd), m_ecmd(m_cmd->get_ert_packet()), m_exec(ec), m_cus(cus), m_state(ERT_CMD_STATE_NEW)
+  {
+    static size_type count = 0;
+    m_uid = count++;
+  }
+
+  // Decode the CUs a start kernel command can execute on
+  static cu_bitset_type
+  decode_cus(const ert_start_kernel_cmd* kcmd)
+  {
+    cu_bitset_type cus(kcmd->cu_mask);
+    for (size_type i=0; i<kcmd->extra_cu_masks; ++i) {
+      cu_bitset_type mask(kcmd->data[i]);
+      cus |= (mask<<sizeof(value_type)*8*i);
     }
+    return cus;
   }
 
   value_type
@@ -291,6 +307,13 @@ public:
   {
     return std::make_shared<xocl_cmd>(ec,cmd);
   }
+
+  // Create a command object for a frozen command
+  static std::shared_ptr<xocl_cmd>
+  create(exec_core* ec, cmd_ptr cmd, const cu_bitset_type& cus)
+  {
+    return std::make_shared<xocl_cmd>(ec,cmd,cus);
+  }
 };
 
 using xcmd_ptr = std::shared_ptr<xocl_cmd>;
@@ -836,10 +859,24 @@ namespace xrt_core { namespace sws {
 void
 managed_start(xrt_core::command* cmd)
 {
-  auto device = cmd->get_device();
-
-  auto& exec = s_device_exec_core[device];
-  auto xcmd = xocl_cmd::create(exec.get(),cmd);
+  xcmd_ptr xcmd;
+  exec_core* exec = nullptr;
+  if (cmd->is_frozen()) {
+    // Device lookup and cu decoding done once for frozen command
+    auto& cache = cmd->get_exec_cache();
+    if (!cache.exec) {
+      auto pkt = cmd->get_ert_packet();
+      cache.exec = s_device_exec_core[cmd->get_device()].get();
+      if (pkt->type == ERT_CU)
+        cache.cus = xocl_cmd::decode_cus(reinterpret_cast<ert_start_kernel_cmd*>(pkt));
+    }
+    exec = static_cast<exec_core*>(cache.exec);
+    xcmd = xocl_cmd::create(exec,cmd,cache.cus);
+  }
+  else {
+    exec = s_device_exec_core[cmd->get_device()].get();
+    xcmd = xocl_cmd::create(exec,cmd);
+  }
   auto scheduler = exec->get_scheduler();
 
   std::lock_guard<std::mutex> lk(s_pending_mutex);
@@ -861,13 +898,26 @@ unmanaged_wait(const xrt_core::command* cmd)
     s_cmd_complete_cond.wait(lk);
 }
 
+std::cv_status
+unmanaged_wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout)
+{
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  auto ert_pkt = cmd->get_ert_packet();
+  std::unique_lock<std::mutex> lk(s_cmd_complete_mutex);
+  while (ert_pkt->state < ERT_CMD_STATE_COMPLETED)
+    if (s_cmd_complete_cond.wait_until(lk, deadline) == std::cv_status::timeout)
+      return (ert_pkt->state < ERT_CMD_STATE_COMPLETED)
+        ? std::cv_status::timeout : std::cv_status::no_timeout;
+  return std::cv_status::no_timeout;
+}
+
 void
 start()
 {
   if (s_running)
     throw std::runtime_error("software command scheduler is already started");
 
-  s_scheduler_thread = xrt_core::thread(scheduler_loop);
+  s_scheduler_thread = xrt_core::role_thread(xrt_core::thread_role::completion, nullptr, scheduler_loop);
   s_running = true;
 }
 
@@ -0,0 +1,382 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XRT_CORE_COMMON_SOURCE
+#include "timeout.h"
+#include "core/common/debug.h"
+#include "core/common/error.h"
+#include "core/common/thread.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace xrt_core { namespace timeout {
+
+// class wheel - hierarchical timer wheel
+//
+// Four levels of 64 slots with a tick of 1ms, covering 2^24 ticks
+// (about 4.6 hours).  Level 0 holds timers expiring within the next
+// 64 ticks, one slot per tick.  Higher level slots cover 64 times
+// the range of a slot in the level below, and are cascaded down when
+// the lower level wraps.  Timers beyond the range are parked in the
+// last level and re-inserted on cascade.
+//
+// The wheel is not thread safe, it is protected by the service mutex.
+class wheel
+{
+public:
+  // Circular list with sentinel per slot
+  struct slot_list
+  {
+    timer head;
+    slot_list() { head.m_prev = head.m_next = &head; }
+    bool empty() const { return head.m_next == &head; }
+  };
+
+  static void
+  link(slot_list& list, timer* t)
+  {
+    t->m_next = &list.head;
+    t->m_prev = list.head.m_prev;
+    list.head.m_prev->m_next = t;
+    list.head.m_prev = t;
+  }
+
+  static void
+  unlink(timer* t)
+  {
+    t->m_prev->m_next = t->m_next;
+    t->m_next->m_prev = t->m_prev;
+    t->m_prev = t->m_next = nullptr;
+  }
+
+private:
+  static constexpr unsigned int bits = 6;
+  static constexpr unsigned int slots = 1 << bits;
+  static constexpr uint64_t mask = slots - 1;
+  static constexpr unsigned int levels = 4;
+  static constexpr uint64_t max_delta = (1ULL << (bits * levels)) - 1;
+
+  slot_list m_slots[levels][slots];
+  uint64_t m_occupied[levels] = {0};  // bit per non empty slot
+  uint64_t m_next = 0;                // next tick to process
+  size_t m_armed = 0;
+
+  void
+  place(timer* t)
+  {
+    auto expires = t->m_expires;
+    unsigned int level = 0;
+    if (expires < m_next)
+      expires = m_next;
+    else {
+      auto delta = expires - m_next;
+      if (delta > max_delta)
+        expires = m_next + max_delta;
+      while (level < levels - 1 && (expires - m_next) >= (1ULL << (bits * (level + 1))))
+        ++level;
+    }
+
+    auto idx = (expires >> (bits * level)) & mask;
+    link(m_slots[level][idx], t);
+    m_occupied[level] |= (1ULL << idx);
+    t->m_state = timer::state::armed;
+  }
+
+  // Move timers of a slot in level down to lower levels.
+  // Return the slot index, zero means next level must cascade too.
+  uint64_t
+  cascade(unsigned int level)
+  {
+    auto idx = (m_next >> (bits * level)) & mask;
+    auto& list = m_slots[level][idx];
+    m_occupied[level] &= ~(1ULL << idx);
+    while (!list.empty()) {
+      auto t = list.head.m_next;
+      unlink(t);
+      place(t);
+    }
+    return idx;
+  }
+
+public:
+  wheel() = default;
+  wheel(const wheel&) = delete;
+  wheel& operator=(const wheel&) = delete;
+
+  size_t
+  size() const
+  {
+    return m_armed;
+  }
+
+  // Add timer, now is the current tick.  An empty wheel is moved
+  // forward to now so advance() need not walk idle ticks.
+  void
+  add(timer* t, uint64_t expires, uint64_t now)
+  {
+    if (!m_armed && m_next < now)
+      m_next = now;
+    t->m_expires = expires;
+    place(t);
+    ++m_armed;
+  }
+
+  void
+  remove(timer* t)
+  {
+    // slot bit is cleared lazily when the slot is processed
+    unlink(t);
+    t->m_state = timer::state::idle;
+    --m_armed;
+  }
+
+  // Process ticks up to and including now, move expired timers to
+  // the expired list
+  void
+  advance(uint64_t now, slot_list& expired)
+  {
+    while (m_next <= now) {
+      auto idx = m_next & mask;
+      if (!idx) {
+        for (unsigned int level = 1; level < levels; ++level)
+          if (cascade(level))
+            break;
+      }
+
+      auto& list = m_slots[0][idx];
+      m_occupied[0] &= ~(1ULL << idx);
+      while (!list.empty()) {
+        auto t = list.head.m_next;
+        unlink(t);
+        link(expired, t);
+        t->m_state = timer::state::expired;
+        --m_armed;
+      }
+
+      ++m_next;
+    }
+  }
+
+  // Next tick at which advance() may have work
+  uint64_t
+  next_event() const
+  {
+    // Cascade is due, or search level 0 from m_next up to the next cascade
+    auto idx = m_next & mask;
+    if (!idx)
+      return m_next;
+    auto pending = m_occupied[0] >> idx;
+    if (pending) {
+      unsigned int skip = 0;
+      while (!(pending & 1)) {
+        pending >>= 1;
+        ++skip;
+      }
+      return m_next + skip;
+    }
+    return (m_next | mask) + 1;
+  }
+};
+
+// class service - timer thread servicing the wheel
+class service
+{
+  std::mutex m_mutex;
+  std::condition_variable m_work;    // wheel changed
+  std::condition_variable m_fired;   // callback completed
+  wheel m_wheel;
+  wheel::slot_list m_expired;        // callbacks not yet called
+  timer* m_running = nullptr;        // callback being called
+  const clock::time_point m_epoch;
+  std::thread::id m_thread_id;
+  uint64_t m_wakeup = UINT64_MAX;    // tick the thread sleeps until
+  bool m_stop = false;
+  std::thread m_thread;
+
+  uint64_t
+  to_tick(const clock::time_point& tp) const
+  {
+    if (tp <= m_epoch)
+      return 0;
+    // round up so a timer never fires before its deadline
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(tp - m_epoch).count();
+    return (us + 999) / 1000;
+  }
+
+  uint64_t
+  now_tick() const
+  {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - m_epoch).count();
+    return ms;
+  }
+
+  void
+  run()
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    while (!m_stop) {
+      if (!m_wheel.size()) {
+        m_wakeup = UINT64_MAX;
+        m_work.wait(lk);
+        continue;
+      }
+
+      auto now = now_tick();
+      m_wheel.advance(now, m_expired);
+
+      if (m_expired.empty()) {
+        m_wakeup = m_wheel.size() ? m_wheel.next_event() : UINT64_MAX;
+        if (m_wakeup == UINT64_MAX)
+          m_work.wait(lk);
+        else
+          m_work.wait_until(lk, m_epoch + std::chrono::milliseconds(m_wakeup));
+        continue;
+      }
+
+      // Call the callbacks without holding the lock.  A timer is idle
+      // before its callback is called, and is not touched after the
+      // callback returns, since the callback may re-arm or destruct
+      // its timer, or cancel other expired timers.
+      int fired = 0;
+      while (!m_expired.empty()) {
+        auto t = m_expired.head.m_next;
+        wheel::unlink(t);
+        t->m_state = timer::state::idle;
+        m_running = t;
+        lk.unlock();
+        try {
+          t->m_callback();
+        }
+        catch (const std::exception& ex) {
+          xrt_core::send_exception_message(ex.what());
+        }
+        lk.lock();
+        m_running = nullptr;
+        m_fired.notify_all();
+        ++fired;
+      }
+      XRT_DEBUGF("xrt_core::timeout fired %d timers\n", fired);
+    }
+  }
+
+public:
+  service()
+    : m_epoch(clock::now())
+    , m_thread(xrt_core::role_thread(xrt_core::thread_role::completion, nullptr, &service::run, this))
+  {
+    m_thread_id = m_thread.get_id();
+  }
+
+  ~service()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+    }
+    m_work.notify_one();
+    m_thread.join();
+  }
+
+  void
+  arm(timer* t, const clock::time_point& deadline)
+  {
+    auto tick = to_tick(deadline);
+    bool wake = false;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      if (t->m_state == timer::state::armed)
+        m_wheel.remove(t);
+      else if (t->m_state == timer::state::expired)
+        wheel::unlink(t);
+      m_wheel.add(t, tick, now_tick());
+      wake = tick < m_wakeup;
+      if (wake)
+        m_wakeup = tick;
+    }
+    if (wake)
+      m_work.notify_one();
+  }
+
+  bool
+  cancel(timer* t)
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    // Wait for a running callback unless called from the callback
+    while (m_running == t && std::this_thread::get_id() != m_thread_id)
+      m_fired.wait(lk);
+    if (t->m_state == timer::state::expired) {
+      // callback has not been called
+      wheel::unlink(t);
+      t->m_state = timer::state::idle;
+      return true;
+    }
+    if (t->m_state != timer::state::armed)
+      return false;
+    m_wheel.remove(t);
+    return true;
+  }
+};
+
+namespace {
+
+// The service is started by first arm().  Timers that were never
+// armed, or that are destructed after the service at exit, do not
+// touch the service.
+static std::atomic<bool> s_started {false};
+static std::atomic<bool> s_stopped {false};
+
+struct service_holder
+{
+  service svc;
+  service_holder() { s_started = true; }
+  ~service_holder() { s_stopped = true; }
+};
+
+static service*
+get_service()
+{
+  static service_holder holder;
+  return &holder.svc;
+}
+
+} // namespace
+
+timer::
+~timer()
+{
+  cancel(this);
+}
+
+void
+arm(timer* t, const clock::time_point& deadline)
+{
+  if (s_stopped)
+    return;
+  get_service()->arm(t, deadline);
+}
+
+bool
+cancel(timer* t)
+{
+  if (!s_started || s_stopped)
+    return false;
+  return get_service()->cancel(t);
+}
+
+}} // timeout, xrt_core
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xrt_core_timeout_h_
+#define xrt_core_timeout_h_
+
+#include "core/common/config.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+////////////////////////////////////////////////////////////////
+// Central deadline tracking for command execution.
+//
+// Deadlines are kept in a hierarchical timer wheel serviced by one
+// thread per process.  A timer is armed with a deadline and a
+// callback.  The callback is called from the timer thread if the
+// timer is not canceled before the deadline.  All timers that
+// expire in the same tick are fired in one pass, so any number of
+// waiters with deadlines costs one timer thread wake up per tick
+// instead of one timed wait per waiter.
+//
+// Resolution is one millisecond, callbacks fire at or shortly after
+// the deadline.  Callbacks must not block, they typically set a flag
+// and notify a condition variable.
+////////////////////////////////////////////////////////////////
+namespace xrt_core { namespace timeout {
+
+using clock = std::chrono::steady_clock;
+
+// class timer - intrusive timer wheel entry
+//
+// The timer is owned by the caller, it is not copyable or movable
+// because the wheel links to it while armed.  The destructor cancels
+// the timer.  A callback may destruct its own timer, and other timers.
+class timer
+{
+public:
+  using callback_type = std::function<void()>;
+
+  explicit
+  timer(callback_type&& fcn)
+    : m_callback(std::move(fcn))
+  {}
+
+  timer() = default;
+  timer(const timer&) = delete;
+  timer& operator=(const timer&) = delete;
+
+  XRT_CORE_COMMON_EXPORT
+  ~timer();
+
+  void
+  set_callback(callback_type&& fcn)
+  {
+    m_callback = std::move(fcn);
+  }
+
+private:
+  friend class wheel;
+  friend class service;
+
+  enum class state { idle, armed, expired };
+
+  timer* m_prev = nullptr;
+  timer* m_next = nullptr;
+  uint64_t m_expires = 0;     // tick
+  state m_state = state::idle;
+  callback_type m_callback;
+};
+
+// arm() - Arm timer to fire at deadline
+//
+// An armed timer is re-armed with the new deadline.  May be called
+// from within the timer's own callback.
+XRT_CORE_COMMON_EXPORT
+void
+arm(timer* t, const clock::time_point& deadline);
+
+inline void
+arm(timer* t, const std::chrono::milliseconds& timeout)
+{
+  arm(t, clock::now() + timeout);
+}
+
+// cancel() - Disarm timer
+//
+// Return: true if the timer was disarmed before firing
+//
+// If the timer callback is running, then cancel waits for the
+// callback to return, so the timer can be destructed after cancel.
+XRT_CORE_COMMON_EXPORT
+bool
+cancel(timer* t);
+
+}} // timeout, xrt_core
+
+#endif
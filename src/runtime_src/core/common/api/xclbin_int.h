@@ -20,6 +20,7 @@
 
 // This file defines implementation extensions to the XRT XCLBIN APIs.
 #include "core/include/experimental/xrt_xclbin.h"
+#include "core/common/config.h"
 
 namespace xrt_core {
 namespace xclbin_int {
@@ -37,6 +38,7 @@ xrt::xclbin
 get_xclbin(xrtXclbinHandle);
 
 // get_axlf_section() - Retrieve specified section
+XRT_CORE_COMMON_EXPORT
 std::pair<const char*, size_t>
 get_axlf_section(const xrt::xclbin& xclbin, axlf_section_kind kind);
 
@@ -26,20 +26,28 @@
 
 #include "device_int.h"
 #include "kernel_int.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
 #include "core/common/memalign.h"
 #include "core/common/message.h"
+#include "core/common/numa.h"
 #include "core/common/query_requests.h"
 #include "core/common/system.h"
 #include "core/common/unistd.h"
 #include "core/common/xclbin_parser.h"
 
+#include <cerrno>
 #include <cstdlib>
+#include <list>
 #include <map>
+#include <mutex>
 #include <set>
+#include <tuple>
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 4100 4996 4505 )
+#else
+# include <sys/mman.h>
 #endif
 
 namespace {
@@ -355,6 +363,51 @@ public:
 };
 
 
+// class ubuf_registration - User provided host side buffer registered with driver
+//
+// The driver buffer object created from user memory, shared by
+// buffer_ubuf objects created from the same user memory when the
+// registration cache is enabled.  The driver buffer object is freed
+// when the last reference is released.  A cached registration does
+// not keep the device open, the driver frees the buffer object when
+// the device is closed.
+struct ubuf_registration
+{
+  std::weak_ptr<xrt_core::device> device;
+  xclBufferHandle handle;
+
+  ubuf_registration(const std::shared_ptr<xrt_core::device>& dev, xclBufferHandle bhdl)
+    : device(dev), handle(bhdl)
+  {}
+
+  ~ubuf_registration()
+  {
+    try {
+      if (auto dev = device.lock())
+        dev->free_bo(handle);
+    }
+    catch (...) {
+    }
+  }
+};
+
+// class buffer_ubuf_cached - User provided host side buffer from cache
+//
+// The driver buffer object is owned by the registration
+class buffer_ubuf_cached : public buffer_ubuf
+{
+  std::shared_ptr<ubuf_registration> registration;
+
+public:
+  buffer_ubuf_cached(xclDeviceHandle dhdl, std::shared_ptr<ubuf_registration> reg, size_t sz, void* buf)
+    : buffer_ubuf(dhdl, reg->handle, sz, buf)
+    , registration(std::move(reg))
+  {
+    free_bo = false;
+  }
+};
+
+
 // class buffer_hbuf - XRT allocated host side buffer
 //
 // XRT allocated host side buffer.  The host side buffer
@@ -570,6 +623,143 @@ alloc_bo(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags flags, xrtMemoryGroup g
   return device->alloc_bo(sz, flags);
 }
 
+// class ubuf_cache - Registration cache of user provided host buffers
+//
+// Opt-in with Runtime.ubuf_cache_mb.  Registrations are keyed by
+// device, user address range, and flags, and are shared by all
+// buffer objects created with the same key.  The cache references
+// the most recently used registrations up to the budget in bytes, a
+// registration is freed when evicted or released and no longer used
+// by any buffer object.
+//
+// A cached registration is dropped if its user memory is no longer
+// mapped when looked up.  Memory that is freed and mapped again at
+// the same address cannot be detected, it must be released explicitly
+// with xrt::release_userptr() before it is freed.
+//
+// Registrations are driver buffer objects that count as device memory
+// use, so the registrations of a device are dropped before an xclbin
+// is loaded and when the device is closed.
+class ubuf_cache
+{
+  using key_type = std::tuple<const xrt_core::device*, uintptr_t, size_t, xrtBufferFlags>;
+  using lru_type = std::list<key_type>;
+
+  struct entry
+  {
+    std::shared_ptr<xrt::ubuf_registration> registration;
+    lru_type::iterator lru_itr;
+  };
+
+  std::mutex mutex;
+  std::map<key_type, entry> entries;
+  lru_type lru;    // most recently used first
+  size_t bytes = 0;
+  size_t budget;
+
+  static bool
+  is_mapped(void* userptr, size_t sz)
+  {
+#ifndef _WIN32
+    return msync(userptr, sz, MS_ASYNC) == 0 || errno != ENOMEM;
+#else
+    return true;
+#endif
+  }
+
+  void
+  erase(std::map<key_type, entry>::iterator itr)
+  {
+    bytes -= std::get<2>(itr->first);
+    lru.erase(itr->second.lru_itr);
+    entries.erase(itr);
+  }
+
+public:
+  explicit ubuf_cache(size_t bgt)
+    : budget(bgt)
+  {}
+
+  // Cache if enabled, nullptr otherwise.  The cache is never
+  // destroyed since devices closed at exit release from it.
+  static ubuf_cache*
+  instance()
+  {
+    static size_t mb = xrt_core::config::get_ubuf_cache_mb();
+    if (!mb)
+      return nullptr;
+    static auto cache = new ubuf_cache(mb * 1024 * 1024);
+    return cache;
+  }
+
+  std::shared_ptr<xrt::ubuf_registration>
+  acquire(xclDeviceHandle dhdl, void* userptr, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
+  {
+    auto device = xrt_core::get_userpf_device(dhdl);
+    key_type key {device.get(), reinterpret_cast<uintptr_t>(userptr), sz, (flags & ~XRT_BO_FLAGS_MEMIDX_MASK) | grp};
+
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      auto itr = entries.find(key);
+      if (itr != entries.end()) {
+        if (is_mapped(userptr, sz)) {
+          lru.splice(lru.begin(), lru, itr->second.lru_itr);
+          return itr->second.registration;
+        }
+        erase(itr);
+      }
+    }
+
+    // Pin outside the lock, another thread may have registered the
+    // same memory meanwhile in which case that registration is used
+    auto registration = std::make_shared<xrt::ubuf_registration>(device, alloc_bo(dhdl, userptr, sz, flags, grp));
+    if (sz > budget)
+      return registration;
+
+    std::lock_guard<std::mutex> lk(mutex);
+    auto itr = entries.find(key);
+    if (itr != entries.end())
+      return itr->second.registration;
+
+    lru.push_front(key);
+    entries.emplace(key, entry{registration, lru.begin()});
+    bytes += sz;
+    while (bytes > budget)
+      erase(entries.find(lru.back()));
+
+    return registration;
+  }
+
+  // Drop registrations overlapping the address range
+  void
+  release(void* userptr, size_t sz)
+  {
+    auto begin = reinterpret_cast<uintptr_t>(userptr);
+    auto end = begin + sz;
+    std::lock_guard<std::mutex> lk(mutex);
+    for (auto itr = entries.begin(); itr != entries.end(); ) {
+      auto addr = std::get<1>(itr->first);
+      auto next = std::next(itr);
+      if (addr < end && begin < addr + std::get<2>(itr->first))
+        erase(itr);
+      itr = next;
+    }
+  }
+
+  // Drop registrations of device
+  void
+  release(const xrt_core::device* device)
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    for (auto itr = entries.begin(); itr != entries.end(); ) {
+      auto next = std::next(itr);
+      if (std::get<0>(itr->first) == device)
+        erase(itr);
+      itr = next;
+    }
+  }
+};
+
 static void
 free_bo(xrtBufferHandle bhdl)
 {
@@ -593,14 +783,42 @@ alloc_ubuf(xclDeviceHandle dhdl, void* userptr, size_t sz, xrtBufferFlags flags,
   if (!is_aligned_ptr(userptr))
     throw xrt_core::error(-EINVAL, "userptr is not aligned");
 
+  if (auto cache = ubuf_cache::instance())
+    return std::make_shared<xrt::buffer_ubuf_cached>(dhdl, cache->acquire(dhdl, userptr, sz, flags, grp), sz, userptr);
+
   auto handle = alloc_bo(dhdl, userptr, sz, flags, grp);
   auto boh = std::make_shared<xrt::buffer_ubuf>(dhdl, handle, sz, userptr);
   return boh;
 }
 
+// NUMA node of a device, -1 on single node hosts.  The lookup
+// queries sysfs so it is done once per device.
+static int
+get_device_node(xclDeviceHandle dhdl)
+{
+  if (xrt_core::numa::topology::instance().num_nodes() < 2)
+    return -1;
+
+  static std::mutex mutex;
+  static std::map<xrt_core::device::id_type, int> nodes;
+  auto device = xrt_core::get_userpf_device(dhdl);
+  std::lock_guard<std::mutex> lk(mutex);
+  auto itr = nodes.find(device->get_device_id());
+  if (itr != nodes.end())
+    return (*itr).second;
+  return nodes[device->get_device_id()] = xrt_core::numa::get_device_node(device.get());
+}
+
 static std::shared_ptr<xrt::bo_impl>
-alloc_hbuf(xclDeviceHandle dhdl, xrt_core::aligned_ptr_type&& hbuf, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
+alloc_hbuf(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
 {
+  // Place the host backing on the node of the device before the
+  // pages are touched, only whole pages can be placed
+  auto node = get_device_node(dhdl);
+  auto hbuf = xrt_core::aligned_alloc(get_alignment(), node < 0 ? sz : xrt_core::numa::page_roundup(sz));
+  if (node >= 0)
+    xrt_core::numa::bind(hbuf.get(), xrt_core::numa::page_roundup(sz), node);
+
   auto handle =  alloc_bo(dhdl, hbuf.get(), sz, flags, grp);
   auto boh = std::make_shared<xrt::buffer_hbuf>(dhdl, handle, sz, std::move(hbuf));
   return boh;
@@ -641,7 +859,7 @@ alloc(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
     if (is_nodma(dhdl))
       return alloc_nodma(dhdl, sz, flags, grp);
     else
-      return alloc_hbuf(dhdl, xrt_core::aligned_alloc(get_alignment(), sz), sz, flags, grp);
+      return alloc_hbuf(dhdl, sz, flags, grp);
 #endif
   case XCL_BO_FLAGS_CACHEABLE:
   case XCL_BO_FLAGS_SVM:
@@ -731,6 +949,13 @@ is_aligned_ptr(const void* ptr)
   return ::is_aligned_ptr(ptr);
 }
 
+void
+release_userptr_cache(const xrt_core::device* device)
+{
+  if (auto cache = ubuf_cache::instance())
+    cache->release(device);
+}
+
 size_t
 alignment()
 {
@@ -849,6 +1074,13 @@ copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
     });
 }
 
+void
+release_userptr(void* userptr, size_t size)
+{
+  if (auto cache = ubuf_cache::instance())
+    cache->release(userptr, size);
+}
+
 } // xrt
 
 #ifdef XRT_ENABLE_AIE
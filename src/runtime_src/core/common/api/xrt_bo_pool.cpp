@@ -0,0 +1,626 @@
+/*
+ * Copyright (C) 2021, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// This file implements XRT buffer pool APIs as declared in
+// core/include/experimental/xrt_bo_pool.h
+#define XCL_DRIVER_DLL_EXPORT  // exporting xrt_bo_pool.h
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+#include "core/include/experimental/xrt_bo_pool.h"
+
+#include "native_profile.h"
+#include "core/common/error.h"
+#include "core/common/message.h"
+#include "core/common/thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+# include <linux/futex.h>
+# include <sys/mman.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/syscall.h>
+# include <sys/un.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+// Shared memory layout, followed by
+//   uint32_t ring[count]
+//   std::atomic<uint32_t> refs[count]
+//
+// The std::atomic members are lock free and address free so they
+// work across processes.  sent and freed are futex words that are
+// bumped when a buffer is sent and when a buffer is returned to the
+// pool respectively.
+struct pool_header
+{
+  static constexpr uint32_t pool_magic = 0x58424f50; // XBOP
+  static constexpr uint32_t pool_version = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t count;
+  uint64_t size;
+
+  alignas(64) std::atomic<uint64_t> head;   // written by sender
+  std::atomic<uint32_t> sent;
+  std::atomic<uint32_t> send_waiters;
+
+  alignas(64) std::atomic<uint64_t> tail;   // written by receiver
+  std::atomic<uint32_t> freed;
+  std::atomic<uint32_t> free_waiters;
+};
+
+static size_t
+shm_size(size_t count)
+{
+  return sizeof(pool_header) + count * (sizeof(uint32_t) + sizeof(std::atomic<uint32_t>));
+}
+
+static std::string
+shm_name(const std::string& name)
+{
+  if (name.empty() || name.find('/') != std::string::npos)
+    throw xrt_core::system_error(EINVAL, "invalid bo pool name '" + name + "'");
+  return "/xrt_bo_pool." + name;
+}
+
+// Abstract unix socket used to pass the exported buffer handles
+static sockaddr_un
+socket_address(const std::string& name, socklen_t& len)
+{
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  auto path = "xrt_bo_pool." + name;
+  if (path.size() + 1 > sizeof(addr.sun_path))
+    throw xrt_core::system_error(ENAMETOOLONG, "bo pool name too long '" + name + "'");
+  std::memcpy(addr.sun_path + 1, path.data(), path.size());
+  len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + path.size());
+  return addr;
+}
+
+static void
+futex_wake(std::atomic<uint32_t>* word)
+{
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Wait while word is val or until deadline, return false on timeout
+static bool
+futex_wait(std::atomic<uint32_t>* word, uint32_t val, std::atomic<uint32_t>* waiters,
+           bool forever, const std::chrono::steady_clock::time_point& deadline)
+{
+  timespec ts {0, 0};
+  if (!forever) {
+    auto left = deadline - std::chrono::steady_clock::now();
+    if (left <= std::chrono::steady_clock::duration::zero())
+      return false;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+    ts.tv_sec = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+  }
+
+  ++(*waiters);
+  auto ret = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, val,
+                     forever ? nullptr : &ts, nullptr, 0);
+  auto err = errno;
+  --(*waiters);
+  return !(ret && err == ETIMEDOUT);
+}
+
+// Number of handles passed per message
+constexpr size_t fds_per_msg = 64;
+
+static void
+send_fds(int sock, const std::vector<int>& fds)
+{
+  for (size_t offset = 0; offset < fds.size(); offset += fds_per_msg) {
+    uint32_t num = static_cast<uint32_t>(std::min(fds_per_msg, fds.size() - offset));
+    char cbuf[CMSG_SPACE(fds_per_msg * sizeof(int))];
+    std::memset(cbuf, 0, sizeof(cbuf));
+    iovec iov = {&num, sizeof(num)};
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = CMSG_SPACE(num * sizeof(int));
+    auto cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(num * sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), fds.data() + offset, num * sizeof(int));
+    if (sendmsg(sock, &msg, MSG_NOSIGNAL) < 0)
+      throw xrt_core::system_error(errno, "failed to send bo pool handles");
+  }
+}
+
+static std::vector<int>
+receive_fds(int sock, size_t count)
+{
+  std::vector<int> fds;
+  while (fds.size() < count) {
+    uint32_t num = 0;
+    char cbuf[CMSG_SPACE(fds_per_msg * sizeof(int))];
+    iovec iov = {&num, sizeof(num)};
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) <= 0)
+      break;
+    auto cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS || num > fds_per_msg)
+      break;
+    auto at = fds.size();
+    fds.resize(at + num);
+    std::memcpy(fds.data() + at, CMSG_DATA(cmsg), num * sizeof(int));
+  }
+
+  if (fds.size() != count) {
+    for (auto fd : fds)
+      close(fd);
+    throw xrt_core::system_error(EPROTO, "failed to receive bo pool handles");
+  }
+  return fds;
+}
+
+} // namespace
+#endif
+
+namespace xrt {
+
+#ifndef _WIN32
+// class bo_pool_impl - shared memory ring and imported buffers
+//
+// The creator owns the shared memory object and the socket through
+// which attaching processes receive the exported buffer handles.
+// Every process holds an xrt::bo per buffer for the life time of
+// the pool object, so buffers are mapped once per process.
+class bo_pool_impl
+{
+  std::string m_shm_name;
+  bool m_creator = false;
+  pool_header* m_hdr = nullptr;
+  size_t m_shm_size = 0;
+  uint32_t* m_ring = nullptr;
+  std::atomic<uint32_t>* m_refs = nullptr;
+  std::vector<xrt::bo> m_bos;
+  std::vector<int> m_exported;   // creator only
+  int m_sock = -1;               // creator only
+  std::thread m_acceptor;        // creator only
+  size_t m_next_free = 0;
+
+  void
+  map_shm(int fd, size_t sz)
+  {
+    auto addr = mmap(nullptr, sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+      throw xrt_core::system_error(errno, "failed to map bo pool '" + m_shm_name + "'");
+    m_shm_size = sz;
+    m_hdr = static_cast<pool_header*>(addr);
+    m_ring = reinterpret_cast<uint32_t*>(m_hdr + 1);
+  }
+
+  void
+  set_refs()
+  {
+    m_refs = reinterpret_cast<std::atomic<uint32_t>*>(m_ring + m_hdr->count);
+  }
+
+  // Send exported handles to each process that attaches
+  void
+  accept_loop()
+  {
+    while (true) {
+      int conn = accept4(m_sock, nullptr, nullptr, SOCK_CLOEXEC);
+      if (conn < 0) {
+        if (errno == EINTR || errno == ECONNABORTED)
+          continue;
+        return;  // socket shut down
+      }
+      try {
+        send_fds(conn, m_exported);
+      }
+      catch (const std::exception& ex) {
+        xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", ex.what());
+      }
+      close(conn);
+    }
+  }
+
+  void
+  check_index(size_t idx) const
+  {
+    if (idx >= m_bos.size())
+      throw xrt_core::system_error(EINVAL, "bo pool index out of range: " + std::to_string(idx));
+  }
+
+public:
+  bo_pool_impl(const xrt::device& device, const std::string& name, size_t count,
+               size_t size, xrt::bo::flags flags, xrt::memory_group grp)
+    : m_shm_name(shm_name(name)), m_creator(true)
+  {
+    if (!count || count > UINT32_MAX)
+      throw xrt_core::system_error(EINVAL, "invalid bo pool count");
+
+    // Remove stale object left by a process that did not exit cleanly
+    shm_unlink(m_shm_name.c_str());
+    int fd = shm_open(m_shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0)
+      throw xrt_core::system_error(errno, "failed to create bo pool '" + m_shm_name + "'");
+    if (ftruncate(fd, shm_size(count))) {
+      auto err = errno;
+      close(fd);
+      shm_unlink(m_shm_name.c_str());
+      throw xrt_core::system_error(err, "failed to size bo pool '" + m_shm_name + "'");
+    }
+
+    try {
+      map_shm(fd, shm_size(count));
+      new (m_hdr) pool_header();
+      m_hdr->count = count;
+      m_hdr->size = size;
+      set_refs();
+      for (size_t idx = 0; idx < count; ++idx)
+        new (m_refs + idx) std::atomic<uint32_t>(0);
+
+      m_bos.reserve(count);
+      m_exported.reserve(count);
+      for (size_t idx = 0; idx < count; ++idx) {
+        m_bos.emplace_back(device, size, flags, grp);
+        m_exported.push_back(m_bos.back().export_buffer());
+      }
+
+      m_sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      if (m_sock < 0)
+        throw xrt_core::system_error(errno, "failed to create bo pool socket");
+      socklen_t len = 0;
+      auto addr = socket_address(name, len);
+      if (bind(m_sock, reinterpret_cast<sockaddr*>(&addr), len) || listen(m_sock, 16))
+        throw xrt_core::system_error(errno, "failed to bind bo pool socket for '" + name + "'");
+
+      // Publish only when fully initialized
+      m_hdr->version = pool_header::pool_version;
+      std::atomic_thread_fence(std::memory_order_release);
+      m_hdr->magic = pool_header::pool_magic;
+
+      m_acceptor = xrt_core::thread(&bo_pool_impl::accept_loop, this);
+    }
+    catch (...) {
+      cleanup();
+      throw;
+    }
+  }
+
+  bo_pool_impl(const xrt::device& device, const std::string& name)
+    : m_shm_name(shm_name(name))
+  {
+    int fd = shm_open(m_shm_name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+      throw xrt_core::system_error(errno, "failed to open bo pool '" + m_shm_name + "'");
+    struct stat st;
+    if (fstat(fd, &st) || static_cast<size_t>(st.st_size) < sizeof(pool_header)) {
+      close(fd);
+      throw xrt_core::system_error(EINVAL, "invalid bo pool '" + m_shm_name + "'");
+    }
+
+    try {
+      map_shm(fd, st.st_size);
+      if (m_hdr->magic != pool_header::pool_magic
+          || m_hdr->version != pool_header::pool_version
+          || m_shm_size < shm_size(m_hdr->count))
+        throw xrt_core::system_error(EINVAL, "bo pool '" + m_shm_name + "' is not ready");
+      std::atomic_thread_fence(std::memory_order_acquire);
+      set_refs();
+
+      int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      if (sock < 0)
+        throw xrt_core::system_error(errno, "failed to create bo pool socket");
+      socklen_t len = 0;
+      auto addr = socket_address(name, len);
+      if (connect(sock, reinterpret_cast<sockaddr*>(&addr), len)) {
+        auto err = errno;
+        close(sock);
+        throw xrt_core::system_error(err, "failed to connect to bo pool '" + name + "'");
+      }
+      std::vector<int> fds;
+      try {
+        fds = receive_fds(sock, m_hdr->count);
+      }
+      catch (...) {
+        close(sock);
+        throw;
+      }
+      close(sock);
+
+      // Import and map each buffer once, the imported buffer holds
+      // its own reference so the handle can be closed right away
+      m_bos.reserve(fds.size());
+      try {
+        for (auto ehdl : fds)
+          m_bos.emplace_back(device, ehdl);
+      }
+      catch (...) {
+        for (auto ehdl : fds)
+          close(ehdl);
+        throw;
+      }
+      for (auto ehdl : fds)
+        close(ehdl);
+    }
+    catch (...) {
+      cleanup();
+      throw;
+    }
+  }
+
+  ~bo_pool_impl()
+  {
+    cleanup();
+  }
+
+  void
+  cleanup()
+  {
+    if (m_sock >= 0) {
+      shutdown(m_sock, SHUT_RDWR);
+      if (m_acceptor.joinable())
+        m_acceptor.join();
+      close(m_sock);
+      m_sock = -1;
+    }
+    for (auto ehdl : m_exported)
+      close(ehdl);
+    m_exported.clear();
+    if (m_hdr) {
+      munmap(m_hdr, m_shm_size);
+      m_hdr = nullptr;
+    }
+    if (m_creator)
+      shm_unlink(m_shm_name.c_str());
+  }
+
+  size_t
+  size() const
+  {
+    return m_bos.size();
+  }
+
+  xrt::bo&
+  buffer(size_t idx)
+  {
+    check_index(idx);
+    return m_bos[idx];
+  }
+
+  size_t
+  acquire(const bo_pool::timeout_type& timeout)
+  {
+    auto count = m_bos.size();
+    auto forever = timeout.count() == 0;
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+      auto seq = m_hdr->freed.load();
+      for (size_t n = 0; n < count; ++n) {
+        auto idx = (m_next_free + n) % count;
+        uint32_t expected = 0;
+        if (m_refs[idx].compare_exchange_strong(expected, 1)) {
+          m_next_free = idx + 1;
+          return idx;
+        }
+      }
+      if (!futex_wait(&m_hdr->freed, seq, &m_hdr->free_waiters, forever, deadline))
+        throw xrt_core::system_error(ETIMEDOUT, "timeout waiting for free buffer in bo pool");
+    }
+  }
+
+  void
+  send(size_t idx)
+  {
+    check_index(idx);
+    if (!m_refs[idx].load())
+      throw xrt_core::system_error(EINVAL, "sending buffer not acquired from bo pool");
+    auto head = m_hdr->head.load(std::memory_order_relaxed);
+    if (head - m_hdr->tail.load(std::memory_order_acquire) >= m_hdr->count)
+      throw xrt_core::system_error(EOVERFLOW, "bo pool ring is full");
+    m_ring[head % m_hdr->count] = static_cast<uint32_t>(idx);
+    m_hdr->head.store(head + 1, std::memory_order_release);
+    ++m_hdr->sent;
+    if (m_hdr->send_waiters.load())
+      futex_wake(&m_hdr->sent);
+  }
+
+  size_t
+  receive(const bo_pool::timeout_type& timeout)
+  {
+    auto forever = timeout.count() == 0;
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+      auto seq = m_hdr->sent.load();
+      auto tail = m_hdr->tail.load(std::memory_order_relaxed);
+      if (m_hdr->head.load(std::memory_order_acquire) != tail) {
+        size_t idx = m_ring[tail % m_hdr->count];
+        m_hdr->tail.store(tail + 1, std::memory_order_release);
+        return idx;
+      }
+      if (!futex_wait(&m_hdr->sent, seq, &m_hdr->send_waiters, forever, deadline))
+        throw xrt_core::system_error(ETIMEDOUT, "timeout waiting for buffer from bo pool");
+    }
+  }
+
+  void
+  retain(size_t idx)
+  {
+    check_index(idx);
+    auto refs = m_refs[idx].load();
+    do {
+      if (!refs)
+        throw xrt_core::system_error(EINVAL, "retaining free buffer in bo pool");
+    } while (!m_refs[idx].compare_exchange_weak(refs, refs + 1));
+  }
+
+  void
+  release(size_t idx)
+  {
+    check_index(idx);
+    auto refs = m_refs[idx].load();
+    do {
+      if (!refs)
+        throw xrt_core::system_error(EINVAL, "releasing free buffer in bo pool");
+    } while (!m_refs[idx].compare_exchange_weak(refs, refs - 1));
+
+    if (refs > 1)
+      return;
+    ++m_hdr->freed;
+    if (m_hdr->free_waiters.load())
+      futex_wake(&m_hdr->freed);
+  }
+};
+#else
+class bo_pool_impl
+{
+  [[noreturn]] static void
+  not_supported()
+  {
+    throw xrt_core::system_error(ENOSYS, "bo pool is not supported on this platform");
+  }
+
+public:
+  template <typename ...Args>
+  bo_pool_impl(Args&&...)             { not_supported(); }
+  size_t size() const                 { not_supported(); }
+  xrt::bo& buffer(size_t)             { not_supported(); }
+  size_t acquire(const bo_pool::timeout_type&) { not_supported(); }
+  void send(size_t)                   { not_supported(); }
+  size_t receive(const bo_pool::timeout_type&) { not_supported(); }
+  void retain(size_t)                 { not_supported(); }
+  void release(size_t)                { not_supported(); }
+};
+#endif
+
+} // namespace xrt
+
+namespace {
+
+static std::shared_ptr<xrt::bo_pool_impl>
+alloc_pool(const xrt::device& device, const std::string& name, size_t count,
+           size_t size, xrt::bo::flags flags, xrt::memory_group grp)
+{
+  return std::make_shared<xrt::bo_pool_impl>(device, name, count, size, flags, grp);
+}
+
+static std::shared_ptr<xrt::bo_pool_impl>
+attach_pool(const xrt::device& device, const std::string& name)
+{
+  return std::make_shared<xrt::bo_pool_impl>(device, name);
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_pool C++ API implementations (xrt_bo_pool.h)
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+bo_pool::
+bo_pool(const xrt::device& device, const std::string& name, size_t count,
+        size_t size, xrt::bo::flags flags, xrt::memory_group grp)
+  : handle(xdp::native::profiling_wrapper("xrt::bo_pool::bo_pool",
+           alloc_pool, device, name, count, size, flags, grp))
+{}
+
+bo_pool::
+bo_pool(const xrt::device& device, const std::string& name)
+  : handle(xdp::native::profiling_wrapper("xrt::bo_pool::bo_pool",
+           attach_pool, device, name))
+{}
+
+size_t
+bo_pool::
+size() const
+{
+  return handle->size();
+}
+
+xrt::bo&
+bo_pool::
+buffer(size_t idx) const
+{
+  return handle->buffer(idx);
+}
+
+size_t
+bo_pool::
+acquire(const timeout_type& timeout)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_pool::acquire", [this, &timeout]{
+    return handle->acquire(timeout);
+  });
+}
+
+void
+bo_pool::
+send(size_t idx)
+{
+  xdp::native::profiling_wrapper("xrt::bo_pool::send", [this, idx]{
+    handle->send(idx);
+  });
+}
+
+size_t
+bo_pool::
+receive(const timeout_type& timeout)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_pool::receive", [this, &timeout]{
+    return handle->receive(timeout);
+  });
+}
+
+void
+bo_pool::
+retain(size_t idx)
+{
+  handle->retain(idx);
+}
+
+void
+bo_pool::
+release(size_t idx)
+{
+  xdp::native::profiling_wrapper("xrt::bo_pool::release", [this, idx]{
+    handle->release(idx);
+  });
+}
+
+} // namespace xrt
@@ -31,6 +31,7 @@
 #include "xclbin_int.h" // Non public xclbin APIs
 #include "native_profile.h"
 
+#include <future>
 #include <map>
 #include <vector>
 #include <fstream>
@@ -203,6 +204,34 @@ load_xclbin(const xclbin& xclbin)
   });
 }
 
+std::future<uuid>
+device::
+load_xclbin_async(const xclbin& xclbin)
+{
+  return xdp::native::profiling_wrapper("xrt::device::load_xclbin_async",
+  [this, &xclbin]{
+    // The thread owns a reference to the device
+    return std::async(std::launch::async, [dhdl = handle, xclbin] {
+      dhdl->load_xclbin(xclbin);
+      return xclbin.get_uuid();
+    });
+  });
+}
+
+std::future<uuid>
+device::
+load_xclbin_async(const std::string& fnm)
+{
+  return xdp::native::profiling_wrapper("xrt::device::load_xclbin_async",
+  [this, &fnm]{
+    return std::async(std::launch::async, [dhdl = handle, fnm] {
+      xrt::xclbin xclbin{fnm};
+      dhdl->load_xclbin(xclbin);
+      return xclbin.get_uuid();
+    });
+  });
+}
+
 uuid
 device::
 get_xclbin_uuid() const
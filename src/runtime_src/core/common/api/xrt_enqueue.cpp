@@ -21,6 +21,7 @@
 #include "core/include/experimental/xrt_enqueue.h"
 
 #include "core/common/debug.h"
+#include "core/common/thread.h"
 
 #include <memory>
 #include <vector>
@@ -343,7 +344,7 @@ public:
     : m_retain(q)
     , m_event_queue(q.get_impl())
   {
-    m_handler = std::thread(&event_handler_impl::run, this);
+    m_handler = xrt_core::role_thread(xrt_core::thread_role::completion, nullptr, &event_handler_impl::run, this);
   }
 
   // Destruct event handler requesting event queue to notify waiting
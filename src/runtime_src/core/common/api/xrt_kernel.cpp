@@ -28,6 +28,7 @@
 #include "bo.h"
 #include "device_int.h"
 #include "enqueue.h"
+#include "timeout.h"
 #include "core/common/bo_cache.h"
 #include "core/common/config_reader.h"
 #include "core/common/device.h"
@@ -46,6 +47,7 @@
 #include <chrono>
 #include <cstdarg>
 #include <cstdlib>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -589,6 +591,7 @@ public:
     : m_device(dev)
     , m_execbuf(m_device->create_exec_buf<ert_start_kernel_cmd>())
     , m_done(true)
+    , m_deadline([this] { timeout_expired(); })
   {
     static unsigned int count = 0;
     m_uid = count++;
@@ -665,6 +668,38 @@ public:
       m_callbacks->pop_back();
   }
 
+  // set_timeout() - Deadline for each execution of this command
+  //
+  // @timeout:  Timeout relative to start of command, 0 disables
+  // @fcn:      Function to call if command is not complete at deadline
+  //
+  // The deadline is tracked by the timeout service, the function is
+  // called from the timeout service thread with ERT_CMD_STATE_TIMEOUT.
+  // The command itself is not affected.
+  void
+  set_timeout(const std::chrono::milliseconds& timeout, callback_function_type&& fcn)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_done)
+      throw xrt_core::error(EBUSY, "Cannot set timeout on running command");
+    m_timeout = timeout;
+    m_timeout_callback = std::move(fcn);
+  }
+
+  // freeze() - Freeze or thaw the command packet layout
+  //
+  // A command can be frozen only when it is not running.  Thawing
+  // is allowed any time, schedulers use their cached data only when
+  // a command is started.
+  void
+  freeze(bool frozen)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (frozen && !m_done)
+      throw xrt_core::error(EBUSY, "Cannot freeze running command");
+    set_frozen(frozen);
+  }
+
   // set_event() - enqueued notifcation of event
   //
   // @event:  Event to notify upon completion of cmd
@@ -724,6 +759,8 @@ public:
       m_managed = (m_callbacks && !m_callbacks->empty());
       m_done = false;
     }
+    if (m_timeout.count())
+      xrt_core::timeout::arm(&m_deadline, m_timeout);
     if (m_managed)
       xrt_core::exec::managed_start(this);
     else
@@ -747,16 +784,31 @@ public:
     return static_cast<ert_cmd_state>(pkt->state);
   }
 
+  // Wait for command completion or timeout.  Return current
+  // command state if timeout expires.
+  //
+  // The deadline of a managed wait is tracked by the timeout service,
+  // which wakes all waiters that expire in the same tick together.
   ert_cmd_state
   wait(const std::chrono::milliseconds& timeout_ms) const
   {
     if (m_managed) {
-      std::unique_lock<std::mutex> lk(m_mutex);
-      while (!m_done)
-        m_exec_done.wait_for(lk, timeout_ms);
+      bool expired = false;
+      xrt_core::timeout::timer deadline([this, &expired] {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        expired = true;
+        m_exec_done.notify_all();
+      });
+      xrt_core::timeout::arm(&deadline, timeout_ms);
+      {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        while (!m_done && !expired)
+          m_exec_done.wait(lk);
+      }
+      xrt_core::timeout::cancel(&deadline);
     }
     else {
-      xrt_core::exec::unmanaged_wait(this);
+      xrt_core::exec::unmanaged_wait(this, timeout_ms);
     }
 
     auto pkt = get_ert_packet();
@@ -789,17 +841,21 @@ public:
   {
     bool complete = false;
     bool callbacks = false;
+    bool deadline = false;
     if (s>=ERT_CMD_STATE_COMPLETED) {
       std::lock_guard<std::mutex> lk(m_mutex);
       XRT_DEBUGF("kernel_command::notify() m_uid(%d) m_state(%d)\n", m_uid, s);
       complete = m_done = true;
       callbacks = (m_callbacks && !m_callbacks->empty());
+      deadline = (m_timeout.count() != 0);
       if (m_event)
         xrt_core::enqueue::done(m_event.get());
     }
 
     if (complete) {
       m_exec_done.notify_all();
+      if (deadline)
+        xrt_core::timeout::cancel(&m_deadline);
       if (callbacks)
         run_callbacks(s);
 
@@ -811,6 +867,20 @@ public:
   }
 
 private:
+  // Called by timeout service when deadline of running command expires
+  void
+  timeout_expired()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      if (m_done || !m_timeout_callback)
+        return;
+    }
+
+    // callback is not changed while command is running
+    m_timeout_callback(ERT_CMD_STATE_TIMEOUT);
+  }
+
   std::shared_ptr<device_type> m_device;
   mutable std::shared_ptr<xrt::event_impl> m_event;
   execbuf_type m_execbuf; // underlying execution buffer
@@ -822,6 +892,13 @@ private:
   mutable std::condition_variable m_exec_done;
 
   std::unique_ptr<callback_list> m_callbacks;
+
+  std::chrono::milliseconds m_timeout {0};
+  callback_function_type m_timeout_callback;
+
+  // deadline timer must be destructed first, it cancels a pending
+  // call to timeout_expired()
+  xrt_core::timeout::timer m_deadline;
 };
 
 // class argument - get argument value from va_arg
@@ -1536,6 +1613,10 @@ class run_impl
   void
   validate_ip_arg_connectivity(size_t argidx, int32_t grpidx)
   {
+    // a frozen run has validated this connection already
+    if (frozen && frozen_grpidx[argidx] == grpidx)
+      return;
+
     // remove ips that don't meet requested connectivity
     auto itr = std::remove_if(ips.begin(), ips.end(),
                    [argidx, grpidx] (const auto& ip) {
@@ -1559,6 +1640,28 @@ class run_impl
     // encoded in command packet.
     ips.erase(itr,ips.end());
     encode_cumasks = true;
+
+    // the command layout changed, so a frozen run is thawed
+    thaw();
+  }
+
+  // Record validated connection of a frozen run
+  void
+  freeze_arg_connectivity(size_t argidx, int32_t grpidx)
+  {
+    if (frozen)
+      frozen_grpidx[argidx] = grpidx;
+  }
+
+  // Thaw a frozen run, the layout will be validated on next freeze()
+  void
+  thaw()
+  {
+    if (!frozen)
+      return;
+    frozen = false;
+    frozen_grpidx.clear();
+    cmd->freeze(false);
   }
 
   // Clone the commmand packet of another run_impl
@@ -1585,6 +1688,10 @@ class run_impl
   uint32_t uid;                           // internal unique id for debug
   std::unique_ptr<arg_setter> arg_setter; // helper to populate payload data
   bool encode_cumasks = false;            // indicate if cmd cumasks must be re-encoded
+  bool frozen = false;                    // command layout validated, see freeze()
+  std::vector<int32_t> frozen_grpidx;     // validated memory group per argument
+
+  static constexpr int32_t no_grpidx = std::numeric_limits<int32_t>::min();
 
 public:
   uint32_t
@@ -1605,6 +1712,12 @@ public:
     cmd->pop_callback();
   }
 
+  void
+  set_timeout(const std::chrono::milliseconds& timeout, callback_function_type&& fcn)
+  {
+    cmd->set_timeout(timeout, std::move(fcn));
+  }
+
   // set_event() - enqueued notifcation of event
   //
   // @event:  Event to notify upon completion of run
@@ -1711,7 +1824,9 @@ public:
   void
   set_arg_at_index(size_t index, const xrt::bo& bo)
   {
-    validate_ip_arg_connectivity(index, xrt_core::bo::group_id(bo));
+    auto grpidx = xrt_core::bo::group_id(bo);
+    validate_ip_arg_connectivity(index, grpidx);
+    freeze_arg_connectivity(index, grpidx);
     auto value = xrt_core::bo::address(bo);
     set_arg_at_index(index, &value, sizeof(value));
   }
@@ -1749,10 +1864,59 @@ public:
     }
   }
 
+  // freeze() - validate command layout once for repeated starts
+  //
+  // The command packet header, compute unit masks, and argument
+  // offsets are validated and the packet layout is frozen.  Starting
+  // a frozen run only updates the command state and submits the
+  // packet, and the schedulers cache what they derive from the
+  // packet header.  Global arguments that are set to buffers in a
+  // previously validated memory group skip connectivity checks.
+  //
+  // A change of argument connectivity that filters compute units
+  // changes the layout and thaws the run.
+  void
+  freeze()
+  {
+    if (encode_cumasks) {
+      cmd->encode_compute_units(cumask, kernel->get_num_cumasks());
+      encode_cumasks = false;
+    }
+
+    auto kcmd = cmd->get_ert_cmd<ert_start_kernel_cmd*>();
+    if (kcmd->opcode != ERT_START_CU && kcmd->opcode != ERT_START_FA)
+      throw xrt_core::error(EINVAL, "Cannot freeze command with opcode " + std::to_string(kcmd->opcode));
+    if (static_cast<size_t>(kcmd->extra_cu_masks) + 1 != kernel->get_num_cumasks())
+      throw xrt_core::error(EINVAL, "Command cu masks do not match kernel");
+
+    auto& args = kernel->get_args();
+    if (kcmd->opcode == ERT_START_CU) {
+      // argument payload must fit in command register map
+      size_t regmap_bytes = (kcmd->count - kcmd->extra_cu_masks - 1) * sizeof(uint32_t);
+      for (auto& arg : args) {
+        if (arg.index() == argument::no_index)
+          break;
+        if (arg.offset() + arg.size() > regmap_bytes)
+          throw xrt_core::error(EINVAL, "Argument '" + arg.name() + "' is outside command register map");
+      }
+    }
+
+    cmd->freeze(true);
+    frozen_grpidx.assign(args.size(), no_grpidx);
+    frozen = true;
+  }
+
   // start() - start the run object (execbuf)
   void
   start()
   {
+    // A frozen run has a valid packet layout
+    if (frozen) {
+      cmd->get_ert_packet()->state = ERT_CMD_STATE_NEW;
+      cmd->run();
+      return;
+    }
+
     // If this run object's cus were filtered compared to kernel cus
     // then update the command packet encoded cus.
     // To avoid comparison consider bool flag set when filtering
@@ -1791,6 +1955,9 @@ public:
   }
 };
 
+// Remove when c++17
+constexpr int32_t run_impl::no_grpidx;
+
 // struct run_update_type - RTP update
 //
 // Asynchronous runtime update of kernel arguments.  Each argument is
@@ -2248,6 +2415,15 @@ start()
   });
 }
 
+void
+run::
+freeze()
+{
+  xdp::native::profiling_wrapper("xrt::run::freeze", [this]{
+    handle->freeze();
+  });
+}
+
 ert_cmd_state
 run::
 wait(const std::chrono::milliseconds& timeout_ms) const
@@ -2315,6 +2491,20 @@ add_callback(ert_cmd_state state,
   handle->add_callback([=](ert_cmd_state state) { fcn(key, state, data); });
 }
 
+void
+run::
+set_timeout(const std::chrono::milliseconds& timeout,
+            std::function<void(const void*, ert_cmd_state, void*)> fcn,
+            void* data)
+{
+  XRT_DEBUGF("run::set_timeout run(%d)\n", handle->get_uid());
+  auto key = handle.get();
+  if (!fcn)
+    handle->set_timeout(timeout, nullptr);
+  else
+    handle->set_timeout(timeout, [=](ert_cmd_state state) { fcn(key, state, data); });
+}
+
 void
 run::
 set_event(const std::shared_ptr<event_impl>& event) const
@@ -0,0 +1,391 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#define XRT_CORE_COMMON_SOURCE
+#include "completion_reactor.h"
+#include "config_reader.h"
+#include "error.h"
+#include "thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+# include <sys/epoll.h>
+# include <sys/eventfd.h>
+# include <sys/timerfd.h>
+# include <unistd.h>
+#endif
+
+namespace xrt_core {
+
+#ifdef __linux__
+
+struct completion_reactor::impl
+{
+  // epoll data of the reactor's own descriptors, descriptors added
+  // by users have handles starting at first_handle
+  static constexpr handle_type stop_id = 0;
+  static constexpr handle_type timer_id = 1;
+  static constexpr handle_type first_handle = 2;
+
+  struct entry
+  {
+    int fd;
+    handler_type handler;
+    bool removed = false;
+
+    entry(int f, handler_type&& h)
+      : fd(f), handler(std::move(h))
+    {}
+  };
+
+  options m_options;
+  int m_epfd = -1;
+  int m_stopfd = -1;
+  int m_timerfd = -1;
+
+  // Synchronize add() and remove() with calling handlers.  Handlers
+  // are called without the lock, m_running is the entry whose handler
+  // is running and remove() waits for it.
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<handle_type, std::shared_ptr<entry>> m_entries;
+  handle_type m_next = first_handle;
+  const entry* m_running = nullptr;
+
+  std::atomic<uint64_t> m_wakeups {0};
+  std::thread m_thread;
+
+  static void
+  throw_if_error(int ret, const char* msg)
+  {
+    if (ret < 0)
+      throw std::system_error(errno, std::system_category(), msg);
+  }
+
+  void
+  ctl(int op, int fd, handle_type id)
+  {
+    epoll_event ev = {};
+    ev.events = (id < first_handle) ? EPOLLIN : (EPOLLIN | EPOLLONESHOT);
+    ev.data.u64 = id;
+    throw_if_error(epoll_ctl(m_epfd, op, fd, &ev), "epoll_ctl");
+  }
+
+  void
+  arm_timer(unsigned int usec)
+  {
+    itimerspec its = {};
+    its.it_value.tv_sec = usec / 1000000;
+    its.it_value.tv_nsec = (usec % 1000000) * 1000;
+    timerfd_settime(m_timerfd, 0, &its, nullptr);
+  }
+
+  void
+  disarm_timer()
+  {
+    itimerspec its = {};
+    timerfd_settime(m_timerfd, 0, &its, nullptr);
+    uint64_t expirations = 0;
+    while (::read(m_timerfd, &expirations, sizeof(expirations)) > 0) {}
+  }
+
+  // Number of descriptors ready to coalesce before calling handlers.
+  // A descriptor is reported once until re-armed, so more ready
+  // descriptors than are registered is never reached.
+  size_t
+  coalesce_target()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return std::min<size_t>(m_options.coalesce_count, m_entries.size());
+  }
+
+  // Wait for ready descriptors and collect them in ready, returns
+  // false if the reactor is stopping
+  bool
+  collect(std::vector<epoll_event>& events, std::vector<handle_type>& ready, bool& expired)
+  {
+    auto n = epoll_wait(m_epfd, events.data(), static_cast<int>(events.size()), -1);
+    if (n < 0 && errno != EINTR)
+      throw_if_error(n, "epoll_wait");
+
+    for (int i = 0; i < n; ++i) {
+      auto id = events[i].data.u64;
+      if (id == stop_id)
+        return false;
+      if (id == timer_id)
+        expired = true;
+      else
+        ready.push_back(id);
+    }
+    return true;
+  }
+
+  // Re-arm the ready descriptors and collect their entries in
+  // handlers.  A descriptor that was closed without being removed is
+  // dropped.
+  void
+  rearm(const std::vector<handle_type>& ready, std::vector<std::shared_ptr<entry>>& handlers)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (auto id : ready) {
+      auto itr = m_entries.find(id);
+      if (itr == m_entries.end())
+        continue;  // removed while collecting
+
+      // Wait for the descriptor again before calling the handler.
+      // Re-arming polls the descriptor, and some drivers (xocl)
+      // consume one completion per poll, so the handler must run
+      // after the last poll or that completion is lost.
+      try {
+        ctl(EPOLL_CTL_MOD, (*itr).second->fd, id);
+      }
+      catch (const std::system_error& ex) {
+        if (ex.code().value() != EBADF && ex.code().value() != ENOENT)
+          throw;
+        send_exception_message(std::string("completion reactor dropped descriptor: ") + ex.what());
+        (*itr).second->removed = true;
+        m_entries.erase(itr);
+        continue;
+      }
+
+      handlers.push_back((*itr).second);
+    }
+  }
+
+  void
+  dispatch(const std::vector<handle_type>& ready, std::vector<std::shared_ptr<entry>>& handlers)
+  {
+    handlers.clear();
+    rearm(ready, handlers);
+
+    for (auto& e : handlers) {
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (e->removed)
+          continue;
+        m_running = e.get();
+      }
+
+      try {
+        e->handler();
+      }
+      catch (const std::exception& ex) {
+        send_exception_message(std::string("completion handler failed: ") + ex.what());
+      }
+
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_running = nullptr;
+      }
+      m_cv.notify_all();
+    }
+    handlers.clear();
+    ++m_wakeups;
+  }
+
+  void
+  loop()
+  {
+    std::vector<epoll_event> events(64);
+    std::vector<handle_type> ready;
+    std::vector<std::shared_ptr<entry>> handlers;
+    auto coalesce = m_options.coalesce_us && m_options.coalesce_count > 1;
+
+    while (1) {
+      ready.clear();
+      bool expired = false;
+      if (!collect(events, ready, expired))
+        return;
+      if (ready.empty())
+        continue;
+
+      auto target = coalesce ? coalesce_target() : 0;
+      if (ready.size() < target) {
+        arm_timer(m_options.coalesce_us);
+        while (!expired && ready.size() < target)
+          if (!collect(events, ready, expired))
+            return;
+        disarm_timer();
+      }
+
+      dispatch(ready, handlers);
+    }
+  }
+
+  void
+  run()
+  {
+    try {
+      loop();
+    }
+    catch (const std::exception& ex) {
+      send_exception_message(std::string("completion reactor died unexpectedly: ") + ex.what());
+    }
+  }
+
+  explicit
+  impl(const options& opt)
+    : m_options(opt)
+  {
+    try {
+      throw_if_error(m_epfd = epoll_create1(EPOLL_CLOEXEC), "epoll_create1");
+      throw_if_error(m_stopfd = eventfd(0, EFD_CLOEXEC), "eventfd");
+      throw_if_error(m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK), "timerfd_create");
+      ctl(EPOLL_CTL_ADD, m_stopfd, stop_id);
+      ctl(EPOLL_CTL_ADD, m_timerfd, timer_id);
+    }
+    catch (...) {
+      close();
+      throw;
+    }
+    m_thread = role_thread(thread_role::completion, nullptr, &impl::run, this);
+  }
+
+  ~impl()
+  {
+    uint64_t one = 1;
+    if (::write(m_stopfd, &one, sizeof(one)) != sizeof(one))
+      send_exception_message("failed to stop completion reactor");
+    m_thread.join();
+    close();
+  }
+
+  void
+  close()
+  {
+    for (auto fd : {m_timerfd, m_stopfd, m_epfd})
+      if (fd >= 0)
+        ::close(fd);
+  }
+
+  handle_type
+  add(int fd, handler_type&& handler)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto id = m_next++;
+    m_entries.emplace(id, std::make_shared<entry>(fd, std::move(handler)));
+    try {
+      ctl(EPOLL_CTL_ADD, fd, id);
+    }
+    catch (...) {
+      m_entries.erase(id);
+      throw;
+    }
+    return id;
+  }
+
+  void
+  remove(handle_type id)
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    auto itr = m_entries.find(id);
+    if (itr == m_entries.end())
+      return;
+    auto e = (*itr).second;
+    epoll_ctl(m_epfd, EPOLL_CTL_DEL, e->fd, nullptr);
+    e->removed = true;
+    m_entries.erase(itr);
+
+    // Wait for the handler to return unless removed by the handler
+    if (std::this_thread::get_id() != m_thread.get_id())
+      m_cv.wait(lk, [this, &e] { return m_running != e.get(); });
+  }
+};
+
+#else
+
+struct completion_reactor::impl
+{
+  explicit
+  impl(const options&)
+  {
+    throw std::runtime_error("completion reactor is not supported");
+  }
+
+  handle_type
+  add(int, handler_type&&)
+  {
+    return 0;
+  }
+
+  void
+  remove(handle_type)
+  {}
+
+  std::atomic<uint64_t> m_wakeups {0};
+};
+
+#endif
+
+completion_reactor::
+completion_reactor(const options& opt)
+  : m_impl(std::make_unique<impl>(opt))
+{}
+
+completion_reactor::
+~completion_reactor()
+{}
+
+std::shared_ptr<completion_reactor>
+completion_reactor::
+instance()
+{
+  static auto reactor = []() -> std::shared_ptr<completion_reactor> {
+    try {
+      options opt;
+      opt.coalesce_count = config::get_kds_coalesce_count();
+      opt.coalesce_us = config::get_kds_coalesce_us();
+      return std::make_shared<completion_reactor>(opt);
+    }
+    catch (const std::exception& ex) {
+      send_exception_message(std::string("completion reactor not available: ") + ex.what());
+      return nullptr;
+    }
+  }();
+  return reactor;
+}
+
+completion_reactor::handle_type
+completion_reactor::
+add(int fd, handler_type handler)
+{
+  return m_impl->add(fd, std::move(handler));
+}
+
+void
+completion_reactor::
+remove(handle_type handle)
+{
+  m_impl->remove(handle);
+}
+
+uint64_t
+completion_reactor::
+get_wakeup_count() const
+{
+  return m_impl->m_wakeups;
+}
+
+} // xrt_core
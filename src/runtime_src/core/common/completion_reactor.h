@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xrt_core_common_completion_reactor_h_
+#define xrt_core_common_completion_reactor_h_
+
+#include "config.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace xrt_core {
+
+/**
+ * class completion_reactor - wait for completion on many file descriptors
+ *
+ * The reactor waits for any number of file descriptors to become
+ * readable from one thread and calls the handler of each descriptor
+ * that is ready.  This replaces a thread per device blocked in poll
+ * on a single device descriptor.
+ *
+ * A descriptor that became ready is not waited on again until its
+ * handler is called, and is waited on again before the handler runs
+ * so readiness that arrives during the handler is not lost.  A
+ * handler may therefore be called with nothing left to do.  Handlers
+ * that must consume the readiness of their descriptor, e.g. read an
+ * eventfd, must do so.
+ *
+ * Interrupts can be coalesced.  Once woken, the reactor keeps
+ * collecting ready descriptors until the coalesce count is reached
+ * or the coalesce time has expired, and then calls the handlers of
+ * all collected descriptors.  The count is of descriptors, not of
+ * completions, and is capped by the number of added descriptors, so
+ * a single descriptor is never coalesced.  The count has no effect
+ * when the time is zero.
+ *
+ * Handlers are called from the reactor thread without any reactor
+ * lock held and may call add() and remove().  A descriptor that is
+ * closed without being removed is dropped when it is re-armed.
+ */
+class completion_reactor
+{
+public:
+  using handler_type = std::function<void()>;
+  using handle_type = uint64_t;
+
+  struct options
+  {
+    unsigned int coalesce_count = 1;   // ready descriptors
+    unsigned int coalesce_us = 0;      // microseconds
+  };
+
+  /**
+   * Create a reactor and start its thread
+   *
+   * Throws if the host does not support the reactor.
+   */
+  XRT_CORE_COMMON_EXPORT
+  explicit
+  completion_reactor(const options& opt);
+
+  XRT_CORE_COMMON_EXPORT
+  ~completion_reactor();
+
+  /**
+   * Process wide reactor configured per ini file
+   *
+   * @return
+   *   The reactor, or nullptr if the host does not support it
+   */
+  XRT_CORE_COMMON_EXPORT
+  static std::shared_ptr<completion_reactor>
+  instance();
+
+  /**
+   * Wait on fd and call handler when it is readable
+   *
+   * @return
+   *   Handle to remove the descriptor
+   */
+  XRT_CORE_COMMON_EXPORT
+  handle_type
+  add(int fd, handler_type handler);
+
+  /**
+   * Stop waiting on a descriptor
+   *
+   * The handler is not running and will not be called once this
+   * function returns, unless called from the handler itself.  The
+   * descriptor must be removed before it is closed.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  remove(handle_type handle);
+
+  /**
+   * @return
+   *   Number of times the reactor has woken and called handlers
+   */
+  XRT_CORE_COMMON_EXPORT
+  uint64_t
+  get_wakeup_count() const;
+
+private:
+  struct impl;
+  std::unique_ptr<impl> m_impl;
+};
+
+} // xrt_core
+
+#endif
@@ -248,6 +248,20 @@ get_aie_trace_buffer_size()
   return value;
 }
 
+inline bool
+get_aie_trace_periodic_offload()
+{
+  static bool value = detail::get_bool_value("Debug.aie_trace_periodic_offload", false);
+  return value;
+}
+
+inline unsigned int
+get_aie_trace_buffer_offload_interval_ms()
+{
+  static unsigned int value = detail::get_uint_value("Debug.aie_trace_buffer_offload_interval_ms", 10);
+  return value;
+}
+
 inline bool
 get_profile_api()
 {
@@ -262,6 +276,25 @@ get_xrt_trace()
   return value;
 }
 
+// Comma separated sampling rates for HAL API trace, a default rate
+// optionally followed by per API rates, e.g. "0.01,ExecBuf:0.001".
+// Empty means every call is traced.
+inline std::string
+get_xrt_trace_sampling()
+{
+  static std::string value = detail::get_string_value("Debug.xrt_trace_sampling", "");
+  return value;
+}
+
+// Comma separated thresholds in us above which a HAL API call is
+// always traced in sampling mode, e.g. "1000,ExecWait:10000".
+inline std::string
+get_xrt_trace_slow_call_us()
+{
+  static std::string value = detail::get_string_value("Debug.xrt_trace_slow_call_us", "");
+  return value;
+}
+
 inline bool
 get_native_xrt_trace()
 {
@@ -346,6 +379,62 @@ get_dma_threads()
   return value;
 }
 
+/**
+ * Place DMA and completion threads of a device on the cpus local to
+ * the device's NUMA node unless their cpu affinity is configured
+ */
+inline bool
+get_numa_affinity()
+{
+  static bool value = detail::get_bool_value("Runtime.numa_affinity",true);
+  return value;
+}
+
+/**
+ * Schedule DMA operations by priority and size, and split large
+ * transfers into chunks spread over the DMA workers.  When false DMA
+ * operations are served in FIFO order.
+ */
+inline bool
+get_dma_scheduler()
+{
+  static bool value = detail::get_bool_value("Runtime.dma_scheduler",true);
+  return value;
+}
+
+/**
+ * DMA operations up to this size (bytes) are served before larger
+ * operations of the same priority
+ */
+inline unsigned int
+get_dma_small_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.dma_small_size",64*1024);
+  return value;
+}
+
+/**
+ * Chunk size (bytes) for splitting large DMA transfers, 0 disables
+ * splitting
+ */
+inline unsigned int
+get_dma_chunk_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.dma_chunk_size",4*1024*1024);
+  return value;
+}
+
+/**
+ * Max number of deleted OpenCL events whose memory is cached per
+ * context for reuse, 0 disables caching
+ */
+inline unsigned int
+get_event_pool_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.event_pool_size",1024);
+  return value;
+}
+
 inline unsigned int
 get_polling_throttle()
 {
@@ -413,6 +502,39 @@ get_kds()
   return value;
 }
 
+/**
+ * Monitor command completion of all devices from one thread that
+ * waits on the completion file descriptors of the devices.  When
+ * disabled each device has its own completion thread.
+ */
+inline bool
+get_kds_reactor()
+{
+  static bool value = detail::get_bool_value("Runtime.kds_reactor",false);
+  return value;
+}
+
+/**
+ * Completion reactor coalescing.  Once woken, the reactor keeps
+ * collecting completion interrupts until the count is reached or
+ * the time in microseconds has expired, whichever comes first, and
+ * then services all the devices that were interrupted.  Default is
+ * to service each interrupt as it arrives.
+ */
+inline unsigned int
+get_kds_coalesce_count()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.kds_coalesce_count",1);
+  return value;
+}
+
+inline unsigned int
+get_kds_coalesce_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.kds_coalesce_us",0);
+  return value;
+}
+
 /**
  * Enable / disable embedded runtime scheduler
  */
@@ -525,6 +647,93 @@ get_noop_completion_delay_us()
   return delay;
 }
 
+/**
+ * Number of devices presented by the noop shim
+ */
+inline unsigned int
+get_noop_devices()
+{
+  static unsigned int devices = detail::get_uint_value("Runtime.noop_devices", 1);
+  return devices;
+}
+
+/**
+ * Time the noop shim spends in xclLoadXclBin, emulates the download
+ * and clock setup of a real device
+ */
+inline unsigned int
+get_noop_load_xclbin_delay_ms()
+{
+  static unsigned int delay = detail::get_uint_value("Runtime.noop_load_xclbin_delay_ms", 0);
+  return delay;
+}
+
+/**
+ * Time in nanoseconds per page the noop shim spends in creating a
+ * buffer object from user memory, which emulates the driver pinning
+ * and mapping the user pages
+ */
+inline unsigned int
+get_noop_userptr_pin_ns_per_page()
+{
+  static unsigned int delay = detail::get_uint_value("Runtime.noop_userptr_pin_ns_per_page", 0);
+  return delay;
+}
+
+/**
+ * Load an xclbin onto the devices of an OpenCL context concurrently
+ * rather than one device after the other.  Off by default.
+ */
+inline bool
+get_parallel_xclbin_load()
+{
+  static bool value = detail::get_bool_value("Runtime.parallel_xclbin_load", false);
+  return value;
+}
+
+/**
+ * Budget in MB of user memory that stays registered with the driver
+ * after the buffer objects created from it are destroyed.  A buffer
+ * object created from the same user memory, size, and flags reuses
+ * the registration rather than pinning the pages again.  The least
+ * recently used registrations are released when over budget.  User
+ * memory must be released with xrt::release_userptr() before it is
+ * freed or unmapped.  Default 0 disables the cache.
+ *
+ * Each cached registration is a driver buffer object that reserves
+ * device memory until released, in addition to pinning host pages.
+ * Registrations of a device are released before an xclbin is loaded
+ * on it and when it is closed.
+ */
+inline unsigned int
+get_ubuf_cache_mb()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.ubuf_cache_mb", 0);
+  return value;
+}
+
+/**
+ * Enable OpenCL buffer read and write directly between page aligned
+ * user memory and device memory, bypassing the host side buffer of
+ * the buffer object, for transfers of at least direct_dma_min_size
+ * bytes.  Smaller transfers are staged since pinning user pages
+ * costs more than copying them.  Buffers in host memory banks are
+ * always staged.  Off by default.
+ */
+inline bool
+get_direct_dma()
+{
+  static bool value = detail::get_bool_value("Runtime.direct_dma", false);
+  return value;
+}
+
+inline unsigned int
+get_direct_dma_min_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.direct_dma_min_size", 256 * 1024);
+  return value;
+}
+
 /**
  * Set CMD BO cache size. CUrrently it is only used in xclCopyBO()
  */
@@ -23,6 +23,7 @@
 #include "config_reader.h"
 #include "xclbin_parser.h"
 #include "xclbin_swemu.h"
+#include "core/common/api/bo.h"
 #include "core/common/api/xclbin_int.h"
 #include "core/include/xrt.h"
 #include "core/include/xclbin.h"
@@ -62,6 +63,11 @@ device::
 {
   // virtual must be declared and defined
   XRT_DEBUGF("xrt_core::device::~device(0x%x) idx(%d)\n", this, m_device_id);
+  try {
+    xrt_core::bo::release_userptr_cache(this);
+  }
+  catch (...) {
+  }
 }
 
 bool
@@ -95,7 +101,16 @@ get_xclbin_uuid() const
 
   // Emulation mode likely, just return m_xclbin_uuid which reflects
   // the uuid of the xclbin loaded by this process.
-  return m_xclbin ? m_xclbin.get_uuid() : uuid{};
+  auto xclbin = get_xclbin();
+  return xclbin ? xclbin.get_uuid() : uuid{};
+}
+
+xrt::xclbin
+device::
+get_xclbin() const
+{
+  std::lock_guard<std::mutex> lk(m_xclbin_mutex);
+  return m_xclbin;
 }
 
 // Unforunately there are two independent entry points into loading an
@@ -109,10 +124,16 @@ device::
 load_xclbin(const xrt::xclbin& xclbin)
 {
   try {
-    m_xclbin = xclbin;
+    // cached user memory registrations hold device memory
+    xrt_core::bo::release_userptr_cache(this);
+    {
+      std::lock_guard<std::mutex> lk(m_xclbin_mutex);
+      m_xclbin = xclbin;
+    }
     load_axlf(xclbin.get_axlf());
   }
   catch (const std::exception&) {
+    std::lock_guard<std::mutex> lk(m_xclbin_mutex);
     m_xclbin = {};
     throw;
   }
@@ -132,7 +153,8 @@ load_xclbin(const uuid& xclbin_id)
     throw error(ENODEV, "no cached xclbin data");
 
   const axlf* top = reinterpret_cast<axlf *>(xclbin_full.data());
-  load_axlf_meta(m_xclbin.get_axlf());
+  load_axlf_meta(get_xclbin().get_axlf());
+  std::lock_guard<std::mutex> lk(m_xclbin_mutex);
   m_xclbin = xrt::xclbin{top};
 #else
   throw error(ENOTSUP, "load xclbin by uuid is not supported");
@@ -147,8 +169,11 @@ void
 device::
 register_axlf(const axlf* top)
 {
-  if (!m_xclbin || m_xclbin.get_uuid() != uuid(top->m_header.uuid))
+  {
+    std::lock_guard<std::mutex> lk(m_xclbin_mutex);
+    if (!m_xclbin || m_xclbin.get_uuid() != uuid(top->m_header.uuid))
       m_xclbin = xrt::xclbin{top};
+  }
 
   // encode / compress memory connections, a mapping from mem_topology
   // memory index to encoded index.  The compressed indices facilitate
@@ -174,13 +199,14 @@ std::pair<const char*, size_t>
 device::
 get_axlf_section(axlf_section_kind section, const uuid& xclbin_id) const
 {
-  if (xclbin_id && xclbin_id != m_xclbin.get_uuid())
+  auto xclbin = get_xclbin();
+  if (xclbin_id && xclbin_id != xclbin.get_uuid())
     throw error(EINVAL, "xclbin id mismatch");
 
-  if (!m_xclbin)
+  if (!xclbin)
     return {nullptr, 0};
 
-  return xrt_core::xclbin_int::get_axlf_section(m_xclbin, section);
+  return xrt_core::xclbin_int::get_axlf_section(xclbin, section);
 }
 
 std::pair<const char*, size_t>
@@ -197,7 +223,7 @@ const std::vector<size_t>&
 device::
 get_memidx_encoding(const uuid& xclbin_id) const
 {
-  if (xclbin_id && xclbin_id != m_xclbin.get_uuid())
+  if (xclbin_id && xclbin_id != get_xclbin().get_uuid())
     throw error(EINVAL, "xclbin id mismatch");
   return m_memidx_encoding;
 }
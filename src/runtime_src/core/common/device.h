@@ -33,6 +33,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <mutex>
 #include <boost/any.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/optional/optional.hpp>
@@ -223,6 +224,18 @@ public:
   uuid
   get_xclbin_uuid() const;
 
+  /**
+   * get_xclbin() - Get xclbin loaded by this process
+   *
+   * Return: The xclbin, empty if none is loaded
+   *
+   * The uuid and the sections of the returned xclbin are consistent
+   * even if another xclbin is loaded concurrently.
+   */
+  XRT_CORE_COMMON_EXPORT
+  xrt::xclbin
+  get_xclbin() const;
+
   /**
    * get_axlf_section() - Get section from currently loaded axlf
    *
@@ -316,6 +329,19 @@ public:
   close(int) const
   { throw std::runtime_error("Not implemented"); }
 
+  /**
+   * get_exec_wait_fd() - File descriptor that is readable when exec_wait()
+   * would return
+   *
+   * Return: fd, or -1 if the device does not support waiting for
+   * command completion on a file descriptor
+   *
+   * The fd is owned by the device.
+   */
+  virtual int
+  get_exec_wait_fd() const
+  { return -1; }
+
   /**
    * file_open() - Opens a scoped fd
    * THIS FUNCTION DOES NOT BELONG HERE
@@ -333,6 +359,7 @@ public:
 
   std::vector<size_t> m_memidx_encoding; // compressed mem_toplogy indices
   xrt::xclbin m_xclbin;                  // currently loaded xclbin
+  mutable std::mutex m_xclbin_mutex;     // synchronize load with m_xclbin readers
 };
 
 /**
@@ -858,6 +858,47 @@ u32 kds_get_cu_proto(struct kds_sched *kds, int idx)
 	return cu_mgmt->xcus[idx]->info.protocol;
 }
 
+/*
+ * Mask of the first 32 argument words (offset 0x10 and up) that only
+ * host writes.  ERT may skip writing these words when unchanged.
+ * Words of output arguments are written by the CU itself and words
+ * not covered by any argument are unknown, neither is in the mask.
+ *
+ * Do not use this function when xclbin can be changed
+ */
+u32 kds_get_cu_shadow_mask(struct kds_sched *kds, int idx)
+{
+	struct xrt_cu_info *info = &kds->cu_mgmt.xcus[idx]->info;
+	u32 mask = 0;
+	u32 word;
+	int i;
+
+	for (i = 0; i < info->num_args; i++) {
+		struct xrt_cu_arg *arg = &info->args[i];
+
+		if (arg->dir != DIR_INPUT || arg->offset < 0x10)
+			continue;
+		for (word = (arg->offset - 0x10) / 4;
+		     word < 32 && word * 4 + 0x10 < arg->offset + arg->size;
+		     word++)
+			mask |= 1U << word;
+	}
+
+	/* An output argument sharing a word makes the word unsafe */
+	for (i = 0; i < info->num_args; i++) {
+		struct xrt_cu_arg *arg = &info->args[i];
+
+		if (arg->dir == DIR_INPUT || arg->offset < 0x10)
+			continue;
+		for (word = (arg->offset - 0x10) / 4;
+		     word < 32 && word * 4 + 0x10 < arg->offset + arg->size;
+		     word++)
+			mask &= ~(1U << word);
+	}
+
+	return mask;
+}
+
 static void ert_dummy_submit(struct kds_ert *ert, struct kds_command *xcmd)
 {
 	kds_err(xcmd->client, "ert submit op not implemented\n");
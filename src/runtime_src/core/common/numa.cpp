@@ -0,0 +1,250 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#define XRT_CORE_COMMON_SOURCE
+#include "numa.h"
+#include "device.h"
+#include "query_requests.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/tokenizer.hpp>
+
+#ifdef __linux__
+# include <sched.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+namespace {
+
+// Content of a sysfs file, empty if the file cannot be read
+static std::string
+read_sysfs(const std::string& path)
+{
+  std::ifstream ifs(path);
+  std::string value;
+  std::getline(ifs, value);
+  boost::trim(value);
+  return value;
+}
+
+} // namespace
+
+namespace xrt_core { namespace numa {
+
+std::vector<unsigned int>
+parse_cpulist(const std::string& cpus)
+{
+  auto str = boost::trim_copy_if(cpus, boost::is_any_of("{} \n"));
+  using tokenizer = boost::tokenizer<boost::char_separator<char>>;
+  boost::char_separator<char> sep(", ");
+  std::vector<unsigned int> result;
+  for (auto& tok : tokenizer(str, sep)) {
+    auto dash = tok.find('-');
+    auto first = std::stoul(tok.substr(0, dash));
+    auto last = (dash == std::string::npos) ? first : std::stoul(tok.substr(dash + 1));
+    if (last < first)
+      throw std::runtime_error("bad cpu range '" + tok + "'");
+    for (auto cpu = first; cpu <= last; ++cpu)
+      result.push_back(static_cast<unsigned int>(cpu));
+  }
+  return result;
+}
+
+topology::
+topology(const std::string& sysfs_root)
+  : m_root(sysfs_root)
+{
+  namespace bfs = boost::filesystem;
+  bfs::path dir(m_root + "/devices/system/node");
+  boost::system::error_code ec;
+  if (!bfs::is_directory(dir, ec))
+    return;
+
+  for (bfs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+    auto name = it->path().filename().string();
+    if (name.compare(0, 4, "node") || name.size() == 4
+        || !std::all_of(name.begin() + 4, name.end(), ::isdigit))
+      continue;
+
+    auto node = std::stoi(name.substr(4));
+    try {
+      auto cpus = parse_cpulist(read_sysfs((it->path() / "cpulist").string()));
+      for (auto cpu : cpus) {
+        if (cpu >= m_cpu_node.size())
+          m_cpu_node.resize(cpu + 1, -1);
+        m_cpu_node[cpu] = node;
+      }
+      m_nodes.emplace(node, std::move(cpus));
+    }
+    catch (const std::exception&) {
+      // Malformed cpulist, node is not known
+    }
+  }
+}
+
+const topology&
+topology::
+instance()
+{
+  static topology topo("/sys");
+  return topo;
+}
+
+int
+topology::
+get_cpu_node(unsigned int cpu) const
+{
+  return cpu < m_cpu_node.size() ? m_cpu_node[cpu] : -1;
+}
+
+const std::vector<unsigned int>&
+topology::
+get_node_cpus(int node) const
+{
+  static const std::vector<unsigned int> none;
+  auto itr = m_nodes.find(node);
+  return itr != m_nodes.end() ? (*itr).second : none;
+}
+
+int
+topology::
+get_cpulist_node(const std::string& cpus) const
+{
+  try {
+    int node = -1;
+    for (auto cpu : parse_cpulist(cpus)) {
+      auto cpu_node = get_cpu_node(cpu);
+      if (cpu_node < 0 || (node >= 0 && cpu_node != node))
+        return -1;
+      node = cpu_node;
+    }
+    return node;
+  }
+  catch (const std::exception&) {
+    return -1;
+  }
+}
+
+int
+topology::
+get_pci_node(const std::string& bdf) const
+{
+  auto dev = m_root + "/bus/pci/devices/" + bdf;
+  auto value = read_sysfs(dev + "/numa_node");
+  try {
+    if (!value.empty() && std::stoi(value) >= 0)
+      return std::stoi(value);
+  }
+  catch (const std::exception&) {
+  }
+
+  // Firmware did not report the node, use the cpus local to the device
+  return get_cpulist_node(read_sysfs(dev + "/local_cpulist"));
+}
+
+int
+get_device_node(const device* device)
+{
+  if (!device)
+    return -1;
+
+  try {
+    auto node = device_query<query::numa_node>(device);
+    if (node >= 0)
+      return node;
+  }
+  catch (const std::exception&) {
+  }
+
+  try {
+    return topology::instance().get_cpulist_node(device_query<query::cpu_affinity>(device));
+  }
+  catch (const std::exception&) {
+  }
+
+  return -1;
+}
+
+#ifdef __linux__
+
+size_t
+page_roundup(size_t size)
+{
+  auto page = static_cast<size_t>(getpagesize());
+  return (size + page - 1) & ~(page - 1);
+}
+
+int
+get_current_node()
+{
+  auto cpu = sched_getcpu();
+  return cpu < 0 ? -1 : topology::instance().get_cpu_node(cpu);
+}
+
+bool
+bind(void* addr, size_t size, int node)
+{
+  constexpr unsigned long mpol_preferred = 1;     // MPOL_PREFERRED
+  constexpr unsigned long mpol_mf_move = 1 << 1;  // MPOL_MF_MOVE
+  constexpr size_t max_nodes = 1024;
+  constexpr size_t bits = sizeof(unsigned long) * 8;
+
+  if (node < 0 || static_cast<size_t>(node) >= max_nodes || !addr || !size)
+    return false;
+
+  // Single node system, nothing to do
+  if (topology::instance().num_nodes() < 2)
+    return false;
+
+  // Never round the range, neighbouring allocations in a partial
+  // page would be moved with it
+  auto page = static_cast<uintptr_t>(getpagesize());
+  if ((reinterpret_cast<uintptr_t>(addr) % page) || (size % page))
+    return false;
+
+  unsigned long mask[max_nodes / bits] = {0};
+  mask[node / bits] = 1UL << (node % bits);
+  return syscall(SYS_mbind, addr, size, mpol_preferred, mask, max_nodes + 1, mpol_mf_move) == 0;
+}
+
+#else
+
+size_t
+page_roundup(size_t size)
+{
+  return size;
+}
+
+int
+get_current_node()
+{
+  return -1;
+}
+
+bool
+bind(void*, size_t, int)
+{
+  return false;
+}
+
+#endif
+
+}} // numa, xrt_core
@@ -0,0 +1,156 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xrt_core_common_numa_h_
+#define xrt_core_common_numa_h_
+
+#include "config.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xrt_core {
+
+class device;
+
+namespace numa {
+
+/**
+ * Parse a cpu list such as "0-3,8,10-11" or "{4,5,2}"
+ *
+ * @return
+ *   The listed cpus in order of the list
+ *
+ * Throws on malformed list.
+ */
+XRT_CORE_COMMON_EXPORT
+std::vector<unsigned int>
+parse_cpulist(const std::string& cpus);
+
+/**
+ * NUMA topology of the host as described by a sysfs tree
+ *
+ * Nodes are read from <root>/devices/system/node/node<N>/cpulist and
+ * the node of a PCI device from <root>/bus/pci/devices/<bdf>/numa_node,
+ * or from the device's local_cpulist if numa_node is not known.
+ */
+class topology
+{
+public:
+  XRT_CORE_COMMON_EXPORT
+  explicit
+  topology(const std::string& sysfs_root);
+
+  /**
+   * Topology of this host per /sys
+   */
+  XRT_CORE_COMMON_EXPORT
+  static const topology&
+  instance();
+
+  size_t
+  num_nodes() const
+  {
+    return m_nodes.size();
+  }
+
+  /**
+   * @return
+   *   Node of cpu, or -1 if not known
+   */
+  XRT_CORE_COMMON_EXPORT
+  int
+  get_cpu_node(unsigned int cpu) const;
+
+  /**
+   * @return
+   *   Cpus of node, empty if node is not known
+   */
+  XRT_CORE_COMMON_EXPORT
+  const std::vector<unsigned int>&
+  get_node_cpus(int node) const;
+
+  /**
+   * @return
+   *   Node that holds all cpus in the argument cpu list, or -1 if
+   *   the cpus are on different nodes or not known
+   */
+  XRT_CORE_COMMON_EXPORT
+  int
+  get_cpulist_node(const std::string& cpus) const;
+
+  /**
+   * @param bdf
+   *   PCI device name in sysfs, e.g. 0000:65:00.1
+   * @return
+   *   Node the PCI device is attached to, or -1 if not known
+   */
+  XRT_CORE_COMMON_EXPORT
+  int
+  get_pci_node(const std::string& bdf) const;
+
+private:
+  std::string m_root;
+  std::map<int, std::vector<unsigned int>> m_nodes;
+  std::vector<int> m_cpu_node;
+};
+
+/**
+ * @return
+ *   Node the device is attached to, or -1 if not known
+ */
+XRT_CORE_COMMON_EXPORT
+int
+get_device_node(const device* device);
+
+/**
+ * @return
+ *   Node of the cpu the calling thread is running on, or -1 if not known
+ */
+XRT_CORE_COMMON_EXPORT
+int
+get_current_node();
+
+/**
+ * @return
+ *   Size rounded up to whole pages, the size to allocate for memory
+ *   that is passed to bind()
+ */
+XRT_CORE_COMMON_EXPORT
+size_t
+page_roundup(size_t size);
+
+/**
+ * Prefer node for the physical pages of an address range
+ *
+ * Pages already in use are migrated when possible, pages not yet
+ * touched are allocated on node when first used.  The range must be
+ * a page aligned allocation of whole pages (see page_roundup), a
+ * partial page would move other allocations sharing the page.
+ *
+ * @return
+ *   true if the policy was applied, false if node is -1, the range
+ *   is not whole pages, or the host does not support NUMA memory
+ *   policies
+ */
+XRT_CORE_COMMON_EXPORT
+bool
+bind(void* addr, size_t size, int node);
+
+}} // numa, xrt_core
+
+#endif
@@ -200,6 +200,7 @@ enum class key_type
   logic_uuids,
   rp_program_status,
   cpu_affinity,
+  numa_node,
   shared_host_mem,
 
   aie_metadata,
@@ -2129,6 +2130,16 @@ struct cpu_affinity : request
   get(const device*) const = 0;
 };
 
+// NUMA node the device is attached to, -1 if not known
+struct numa_node : request
+{
+  using result_type = int;
+  static const key_type key = key_type::numa_node;
+
+  virtual boost::any
+  get(const device*) const = 0;
+};
+
 struct shared_host_mem : request
 {
   using result_type = uint64_t;
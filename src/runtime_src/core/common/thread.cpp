@@ -1,5 +1,5 @@
 /**
- * Copyright (C) 2016-2017 Xilinx, Inc
+ * Copyright (C) 2016-2021 Xilinx, Inc
  *
  * Licensed under the Apache License, Version 2.0 (the "License"). You may
  * not use this file except in compliance with the License. A copy of the
@@ -16,9 +16,14 @@
 #define XRT_CORE_COMMON_SOURCE
 #include "thread.h"
 #include "debug.h"
+#include "device.h"
 #include "message.h"
 #include "config_reader.h"
+#include "query_requests.h"
 
+#include <array>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <iostream>
 
@@ -32,6 +37,49 @@
 
 namespace {
 
+using thread_role = xrt_core::thread_role;
+
+constexpr size_t num_roles = static_cast<size_t>(thread_role::xma) + 1;
+
+static const char*
+role_name(thread_role role)
+{
+  static const char* names[num_roles] = { "generic", "dma", "completion", "profile", "xma" };
+  return names[static_cast<size_t>(role)];
+}
+
+// Roles that are placed on the device's NUMA node by default
+static bool
+is_numa_role(thread_role role)
+{
+  return role == thread_role::dma || role == thread_role::completion;
+}
+
+// Value of Runtime.<key>_<role>, defaulting to Runtime.<key>
+static std::string
+get_role_value(const std::string& key, thread_role role)
+{
+  auto value = xrt_core::config::detail::get_string_value(("Runtime." + key).c_str(), "default");
+  if (role == thread_role::generic)
+    return value;
+  auto role_key = "Runtime." + key + "_" + role_name(role);
+  return xrt_core::config::detail::get_string_value(role_key.c_str(), value);
+}
+
+// Per role value computed once on first use
+template <typename Value, typename Make>
+static const Value&
+get_role_cached(thread_role role, Make make)
+{
+  static std::mutex mutex;
+  static std::array<std::unique_ptr<Value>, num_roles> values;
+  std::lock_guard<std::mutex> lk(mutex);
+  auto& value = values[static_cast<size_t>(role)];
+  if (!value)
+    value = std::make_unique<Value>(make(role));
+  return *value;
+}
+
 namespace platform_specific {
 
 #ifdef __GNUC__
@@ -55,92 +103,147 @@ debug_thread_policy(const std::string& str, int policy, int priority)
   }
 }
 
-static void
-set_thread_policy(std::thread& thread)
+struct policy_type
 {
-  static int policy = 0;
-  static int priority = 0;
-  static bool initialized = false;
-  if (!initialized) {
-    initialized=true;
+  int policy = 0;
+  int priority = 0;
+};
 
+static policy_type
+make_policy(thread_role role)
+{
+  // Default is the policy of the thread that first creates a thread
+  static policy_type dflt = [] {
+    policy_type p;
     sched_param sch;
-    pthread_getschedparam(pthread_self(),&policy,&sch);
-    priority = sch.sched_priority;
+    pthread_getschedparam(pthread_self(),&p.policy,&sch);
+    p.priority = sch.sched_priority;
+    debug_thread_policy("default",p.policy,p.priority);
+    return p;
+  }();
 
-    debug_thread_policy("default",policy,priority);
+  auto p = dflt;
+  auto config_policy = get_role_value("thread_policy",role);
+  if (config_policy=="rr") {
+    p.policy = SCHED_RR;
+    p.priority = 1;
+  }
+  else if (config_policy=="fifo") {
+    p.policy = SCHED_FIFO;
+    p.priority = 1;
+  }
+  else if (config_policy=="other") {
+    p.policy = SCHED_OTHER;
+    p.priority = 0;
+  }
 
-    static std::string config_policy = xrt_core::config::detail::get_string_value("Runtime.thread_policy","default");
-    if (config_policy=="rr") {
-      policy = SCHED_RR;
-      priority = 1;
-    }
-    else if (config_policy=="fifo") {
-      policy = SCHED_FIFO;
-      priority = 1;
-    }
-    else if (config_policy=="other") {
-      policy = SCHED_OTHER;
-      priority = 0;
-    }
+  debug_thread_policy(std::string("config ") + role_name(role),p.policy,p.priority);
+  return p;
+}
+
+static void
+set_thread_policy(std::thread& thread, thread_role role)
+{
+  auto& p = get_role_cached<policy_type>(role, make_policy);
+  struct sched_param sch;
+  sch.sched_priority = p.priority;
+  pthread_setschedparam(thread.native_handle(), p.policy, &sch);
+}
 
-    debug_thread_policy("config",policy,priority);
+// Parse a cpu list such as "{4,5,2}" or "0-7,16-23".  Returns false
+// if the list names a cpu that is out of range.
+static bool
+parse_cpus(std::string cpus, cpu_set_t& cpuset, bool warn)
+{
+  boost::trim_if(cpus,boost::is_any_of("{} \n"));
+  using tokenizer=boost::tokenizer<boost::char_separator<char> >;
+  boost::char_separator<char> sep(", ");
+  auto max_cpus = std::thread::hardware_concurrency();
+  CPU_ZERO(&cpuset);
+  for (auto& tok : tokenizer(cpus,sep)) {
+    auto dash = tok.find('-');
+    auto first = std::stoul(tok.substr(0,dash));
+    auto last = (dash == std::string::npos) ? first : std::stoul(tok.substr(dash+1));
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      if (cpu >= max_cpus || cpu >= CPU_SETSIZE) {
+        if (warn)
+          xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring cpu affinity since cpu #" + std::to_string(cpu) + " is out of range\n");
+        return false;
+      }
+      XRT_DEBUG(std::cout,"adding cpu #",cpu," to affinity mask\n");
+      CPU_SET(cpu,&cpuset);
+    }
   }
+  return CPU_COUNT(&cpuset) > 0;
+}
 
-  struct sched_param sch;
-  sch.sched_priority = priority;
-  pthread_setschedparam(thread.native_handle(), policy, &sch);
+struct affinity_type
+{
+  bool configured = false;  // affinity is specified in ini file
+  bool all = true;          // no affinity
+  cpu_set_t cpuset;
+};
+
+static affinity_type
+make_affinity(thread_role role)
+{
+  affinity_type a;
+  auto cpus = get_role_value("cpu_affinity",role);
+  if (cpus=="default")
+    return a;
+
+  a.configured = true;
+  try {
+    a.all = !parse_cpus(cpus,a.cpuset,true);
+  }
+  catch (const std::exception&) {
+    xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring bad cpu affinity '" + cpus + "'\n");
+  }
+  return a;
 }
 
 static void
-set_cpu_affinity(std::thread& thread)
-{
-  static bool initialized = false;
-  static cpu_set_t cpuset;
-  static bool all=false;
-  if (!initialized) {
-    initialized = true;
-
-    std::string cpus = xrt_core::config::detail::get_string_value("Runtime.cpu_affinity","default");
-    if (cpus=="default")
-      all=true;
-    else {
-      boost::trim_if(cpus,boost::is_any_of("{}"));
-      using tokenizer=boost::tokenizer<boost::char_separator<char> >;
-      boost::char_separator<char> sep(", ");
-      auto max_cpus = std::thread::hardware_concurrency();
-      CPU_ZERO(&cpuset);
-      for (auto& tok : tokenizer(cpus,sep)) {
-        auto cpu = std::stoul(tok);
-        if (cpu < max_cpus) {
-          XRT_DEBUG(std::cout,"adding cpu #",cpu," to affinity mask\n");
-          CPU_SET(cpu,&cpuset);
-        }
-        else {
-          xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring cpu affinity since cpu #" + tok + " is out of range\n");
-          all=true;
-        }
-      }
+set_cpu_affinity(std::thread& thread, thread_role role, const std::string& local_cpus)
+{
+  auto& a = get_role_cached<affinity_type>(role, make_affinity);
+  if (a.configured) {
+    if (a.all)
+      return;
+
+    if (pthread_setaffinity_np(thread.native_handle(),sizeof(cpu_set_t),&a.cpuset)) {
+      throw std::runtime_error("error calling pthread_setaffinity_np");
     }
+    return;
   }
 
-  if (all)
+  // Not configured, place on local NUMA node if known
+  if (local_cpus.empty() || !is_numa_role(role) || !xrt_core::config::get_numa_affinity())
     return;
 
+  cpu_set_t cpuset;
+  try {
+    if (!parse_cpus(local_cpus,cpuset,false))
+      return;
+  }
+  catch (const std::exception&) {
+    return;
+  }
+
+  // Best effort, the process may be restricted to other cpus
   if (pthread_setaffinity_np(thread.native_handle(),sizeof(cpu_set_t),&cpuset)) {
-    throw std::runtime_error("error calling pthread_setaffinity_np");
+    XRT_DEBUG(std::cout,"failed to place ",role_name(role)," thread on cpus ",local_cpus,"\n");
   }
 }
 
 #else
 
 static void
-set_thread_policy(std::thread&)
+set_thread_policy(std::thread&, thread_role)
 {
 }
 
 static void
-set_cpu_affinity(std::thread&)
+set_cpu_affinity(std::thread&, thread_role, const std::string&)
 {
 }
 
@@ -156,12 +259,34 @@ namespace detail {
 
 void set_thread_policy(std::thread& thread)
 {
-  ::platform_specific::set_thread_policy(thread);
+  ::platform_specific::set_thread_policy(thread, thread_role::generic);
 }
 
 void set_cpu_affinity(std::thread& thread)
 {
-  ::platform_specific::set_cpu_affinity(thread);
+  ::platform_specific::set_cpu_affinity(thread, thread_role::generic, "");
+}
+
+void
+set_thread_role(std::thread& thread, thread_role role, const std::string& local_cpus)
+{
+  ::platform_specific::set_thread_policy(thread, role);
+  ::platform_specific::set_cpu_affinity(thread, role, local_cpus);
+}
+
+void
+set_thread_role(std::thread& thread, thread_role role, const device* device)
+{
+  std::string local_cpus;
+  if (device && is_numa_role(role) && config::get_numa_affinity()) {
+    try {
+      local_cpus = device_query<query::cpu_affinity>(device);
+    }
+    catch (const std::exception&) {
+      // Not supported by device, no default placement
+    }
+  }
+  set_thread_role(thread, role, local_cpus);
 }
 
 } // detail
@@ -18,9 +18,36 @@
 #define xrt_core_common_thread_h_
 
 #include "config.h"
+#include <string>
 #include <thread>
 
-namespace xrt_core { 
+namespace xrt_core {
+
+class device;
+
+/**
+ * Roles of runtime threads
+ *
+ * Each role has its own cpu affinity and scheduling policy in
+ * sdaccel.ini, which default to the global values:
+ *  [Runtime]
+ *   cpu_affinity = {4,5,6,7}
+ *   thread_policy = other
+ *   cpu_affinity_profile = {0,1}
+ *   thread_policy_completion = rr
+ *
+ * Threads of the dma and completion roles that serve a device and
+ * have no cpu affinity configured are placed on the cpus local to the
+ * device's NUMA node, unless Runtime.numa_affinity=false.
+ */
+enum class thread_role
+{
+  generic,     // threads not covered by a specific role
+  dma,         // DMA workers
+  completion,  // command completion and event handling
+  profile,     // profiling, trace offload and counter polling
+  xma,         // XMA session polling
+};
 
 namespace detail {
 
@@ -41,6 +68,27 @@ XRT_CORE_COMMON_EXPORT
 void
 set_cpu_affinity(std::thread& thread);
 
+/**
+ * Set policy and cpu affinity of a thread per its role.  If no
+ * affinity is configured for the role, then local_cpus, a cpu list
+ * such as "0-7,16-23", is used for the roles that are placed on the
+ * local NUMA node.
+ *
+ * This function is not for public use
+ */
+XRT_CORE_COMMON_EXPORT
+void
+set_thread_role(std::thread& thread, thread_role role, const std::string& local_cpus);
+
+/**
+ * Set policy and cpu affinity of a thread per its role, using the
+ * cpus local to device, if any, as default for the roles that are
+ * placed on the local NUMA node.
+ */
+XRT_CORE_COMMON_EXPORT
+void
+set_thread_role(std::thread& thread, thread_role role, const device* device);
+
 }
 
 /**
@@ -65,10 +113,26 @@ thread(Args&&... args)
   return t;
 }
 
-  
+/**
+ * Construct a thread with the policy and cpu affinity of a role
+ *
+ * @param role
+ *  Role of the thread
+ * @param device
+ *  Device served by the thread or nullptr
+ *
+ * Remaining arguments are forwarded to std::thread ctor.
+ */
+template <typename ...Args>
+std::thread
+role_thread(thread_role role, const device* device, Args&&... args)
+{
+  auto t = std::thread(std::forward<Args>(args)...);
+  detail::set_thread_role(t, role, device);
+  return t;
+}
+
 } // xrt_core
 
 
 #endif
-
-
@@ -16,8 +16,12 @@
 
 #include "aie_parser.h"
 #include "core/common/device.h"
+#include "core/common/api/xclbin_int.h"
 #include "core/include/xclbin.h"
 
+#include <algorithm>
+#include <list>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -66,88 +70,66 @@ get_driver_config(const pt::ptree& aie_meta)
 }
 
 adf::graph_config
-get_graph(const pt::ptree& aie_meta, const std::string& graph_name)
+get_graph(const pt::ptree& graph)
 {
   adf::graph_config graph_config;
 
-  for (auto& graph : aie_meta.get_child("aie_metadata.graphs")) {
-    if (graph.second.get<std::string>("name") != graph_name)
-      continue;
+  graph_config.id = graph.get<int>("id");
+  graph_config.name = graph.get<std::string>("name");
+
+  int count = 0;
+  for (auto& node : graph.get_child("core_columns")) {
+    graph_config.coreColumns.push_back(std::stoul(node.second.data()));
+    count++;
+  }
 
-    graph_config.id = graph.second.get<int>("id");
-    graph_config.name = graph.second.get<std::string>("name");
-
-    int count = 0;
-    for (auto& node : graph.second.get_child("core_columns")) {
-      graph_config.coreColumns.push_back(std::stoul(node.second.data()));
-      count++;
-    }
-
-    int num_tiles = count;
-
-    count = 0;
-    for (auto& node : graph.second.get_child("core_rows")) {
-      graph_config.coreRows.push_back(std::stoul(node.second.data()));
-      count++;
-    }
-    throw_if_error(count < num_tiles,"core_rows < num_tiles");
-
-    count = 0;
-    for (auto& node : graph.second.get_child("iteration_memory_columns")) {
-      graph_config.iterMemColumns.push_back(std::stoul(node.second.data()));
-      count++;
-    }
-    throw_if_error(count < num_tiles,"iteration_memory_columns < num_tiles");
-
-    count = 0;
-    for (auto& node : graph.second.get_child("iteration_memory_rows")) {
-      graph_config.iterMemRows.push_back(std::stoul(node.second.data()));
-      count++;
-    }
-    throw_if_error(count < num_tiles,"iteration_memory_rows < num_tiles");
-
-    count = 0;
-    for (auto& node : graph.second.get_child("iteration_memory_addresses")) {
-      graph_config.iterMemAddrs.push_back(std::stoul(node.second.data()));
-      count++;
-    }
-    throw_if_error(count < num_tiles,"iteration_memory_addresses < num_tiles");
-
-    count = 0;
-    for (auto& node : graph.second.get_child("multirate_triggers")) {
-      graph_config.triggered.push_back(node.second.data() == "true");
-      count++;
-    }
-    throw_if_error(count < num_tiles,"multirate_triggers < num_tiles");
+  int num_tiles = count;
 
+  count = 0;
+  for (auto& node : graph.get_child("core_rows")) {
+    graph_config.coreRows.push_back(std::stoul(node.second.data()));
+    count++;
   }
+  throw_if_error(count < num_tiles,"core_rows < num_tiles");
 
-  return graph_config;
-}
+  count = 0;
+  for (auto& node : graph.get_child("iteration_memory_columns")) {
+    graph_config.iterMemColumns.push_back(std::stoul(node.second.data()));
+    count++;
+  }
+  throw_if_error(count < num_tiles,"iteration_memory_columns < num_tiles");
 
-int
-get_graph_id(const pt::ptree& aie_meta, const std::string& graph_name)
-{
-  for (auto& graph : aie_meta.get_child("aie_metadata.graphs")) {
-    if (graph.second.get<std::string>("name") != graph_name)
-      continue;
+  count = 0;
+  for (auto& node : graph.get_child("iteration_memory_rows")) {
+    graph_config.iterMemRows.push_back(std::stoul(node.second.data()));
+    count++;
+  }
+  throw_if_error(count < num_tiles,"iteration_memory_rows < num_tiles");
+
+  count = 0;
+  for (auto& node : graph.get_child("iteration_memory_addresses")) {
+    graph_config.iterMemAddrs.push_back(std::stoul(node.second.data()));
+    count++;
+  }
+  throw_if_error(count < num_tiles,"iteration_memory_addresses < num_tiles");
 
-    int id = graph.second.get<int>("id");
-    return id;
+  count = 0;
+  for (auto& node : graph.get_child("multirate_triggers")) {
+    graph_config.triggered.push_back(node.second.data() == "true");
+    count++;
   }
+  throw_if_error(count < num_tiles,"multirate_triggers < num_tiles");
 
-  return -1;
+  return graph_config;
 }
 
-std::unordered_map<std::string, adf::rtp_config>
-get_rtp(const pt::ptree& aie_meta, int graph_id)
+// RTPs indexed by graph id and port name
+std::unordered_map<int, std::unordered_map<std::string, adf::rtp_config>>
+get_rtps(const pt::ptree& aie_meta)
 {
-  std::unordered_map<std::string, adf::rtp_config> rtps;
+  std::unordered_map<int, std::unordered_map<std::string, adf::rtp_config>> rtps;
 
   for (auto& rtp_node : aie_meta.get_child("aie_metadata.RTPs")) {
-    if (rtp_node.second.get<int>("graph_id") != graph_id)
-      continue;
-
     adf::rtp_config rtp;
     rtp.portId = rtp_node.second.get<int>("port_id");
     rtp.aliasId = rtp_node.second.get<int>("alias_id");
@@ -176,7 +158,7 @@ get_rtp(const pt::ptree& aie_meta, int graph_id)
     rtp.isConnect = rtp_node.second.get<bool>("is_connected");
     rtp.hasLock = rtp_node.second.get<bool>("requires_lock");
 
-    rtps[rtp.portName] = rtp;
+    rtps[rtp.graphId][rtp.portName] = rtp;
   }
 
   return rtps;
@@ -325,117 +307,170 @@ get_trace_gmio(const pt::ptree& aie_meta)
   return gmios;
 }
 
+// Fill table with value of parser, or the error if the parser throws
+template <typename TableType, typename Parser>
+static void
+fill(TableType& table, Parser&& parser)
+{
+  try {
+    table.value = parser();
+  }
+  catch (...) {
+    table.error = std::current_exception();
+  }
+}
+
 } // namespace
 
 namespace xrt_core { namespace edge { namespace aie {
 
-adf::driver_config
-get_driver_config(const xrt_core::device* device)
+// Graph nodes indexed by name, the first graph of a name is used
+struct metadata::graph_nodes
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return adf::driver_config();
+  std::unordered_map<std::string, pt::ptree> nodes;
+
+  explicit
+  graph_nodes(const pt::ptree& aie_meta)
+  {
+    for (auto& graph : aie_meta.get_child("aie_metadata.graphs"))
+      nodes.emplace(graph.second.get<std::string>("name"), graph.second);
+  }
+};
 
+metadata::
+metadata(const char* data, size_t size)
+{
   pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_driver_config(aie_meta);
+  read_aie_metadata(data, size, aie_meta);
+
+  fill(m_driver_config, [&] { return ::get_driver_config(aie_meta); });
+  fill(m_graph_nodes, [&] { return std::make_shared<const graph_nodes>(aie_meta); });
+  fill(m_rtps, [&] { return ::get_rtps(aie_meta); });
+  fill(m_old_gmios, [&] { return ::get_old_gmio(aie_meta); });
+  fill(m_gmios, [&] { return ::get_gmios(aie_meta); });
+  fill(m_plios, [&] { return ::get_plio(aie_meta); });
+  fill(m_counters, [&] { return ::get_profile_counter(aie_meta); });
+  fill(m_trace_gmios, [&] { return ::get_trace_gmio(aie_meta); });
 }
 
-adf::graph_config
-get_graph(const xrt_core::device* device, const std::string& graph_name)
+const adf::graph_config*
+metadata::
+get_graph(const std::string& graph_name) const
+{
+  auto& graph_nodes = m_graph_nodes.get()->nodes;
+
+  std::lock_guard<std::mutex> lk(m_graph_mutex);
+  auto itr = m_graphs.find(graph_name);
+  if (itr != m_graphs.end())
+    return &(*itr).second;
+
+  auto node = graph_nodes.find(graph_name);
+  if (node == graph_nodes.end())
+    return nullptr;
+
+  // Elements of an unordered_map are not moved by insertion
+  return &(*m_graphs.emplace(graph_name, ::get_graph((*node).second)).first).second;
+}
+
+std::shared_ptr<const metadata>
+get_metadata(const xrt_core::device* device)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
+  // The uuid and the section of one xclbin, not affected by a
+  // concurrent load of another xclbin
+  auto xclbin = device->get_xclbin();
+  if (!xclbin)
+    return nullptr;
+
+  auto data = xrt_core::xclbin_int::get_axlf_section(xclbin, AIE_METADATA);
   if (!data.first || !data.second)
-    return adf::graph_config();
+    return nullptr;
+
+  // Metadata of an xclbin without uuid cannot be cached
+  auto uuid = xclbin.get_uuid();
+  if (!uuid)
+    return std::make_shared<const metadata>(data.first, data.second);
+
+  // Most recently used first, evicted metadata is released when its
+  // last user is done with it
+  constexpr size_t max_cached = 4;
+  static std::mutex mutex;
+  static std::list<std::pair<xrt_core::uuid, std::shared_ptr<const metadata>>> cache;
+  std::lock_guard<std::mutex> lk(mutex);
+  auto itr = std::find_if(cache.begin(), cache.end(), [&uuid](const auto& entry) { return entry.first == uuid; });
+  if (itr != cache.end()) {
+    cache.splice(cache.begin(), cache, itr);
+    return cache.front().second;
+  }
 
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_graph(aie_meta, graph_name);
+  cache.emplace_front(uuid, std::make_shared<const metadata>(data.first, data.second));
+  if (cache.size() > max_cached)
+    cache.pop_back();
+  return cache.front().second;
+}
+
+adf::driver_config
+get_driver_config(const xrt_core::device* device)
+{
+  auto meta = get_metadata(device);
+  return meta ? meta->get_driver_config() : adf::driver_config();
+}
+
+adf::graph_config
+get_graph(const xrt_core::device* device, const std::string& graph_name)
+{
+  auto meta = get_metadata(device);
+  auto graph = meta ? meta->get_graph(graph_name) : nullptr;
+  return graph ? *graph : adf::graph_config();
 }
 
 int
 get_graph_id(const xrt_core::device* device, const std::string& graph_name)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return -1;
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_graph_id(aie_meta, graph_name);
+  auto meta = get_metadata(device);
+  auto graph = meta ? meta->get_graph(graph_name) : nullptr;
+  return graph ? graph->id : NON_EXIST_ID;
 }
 
 std::unordered_map<std::string, adf::rtp_config>
 get_rtp(const xrt_core::device* device, int graph_id)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return std::unordered_map<std::string, adf::rtp_config>();
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_rtp(aie_meta, graph_id);
+  auto meta = get_metadata(device);
+  return meta ? meta->get_rtps(graph_id) : std::unordered_map<std::string, adf::rtp_config>();
 }
 
 std::vector<gmio_type>
 get_old_gmios(const xrt_core::device* device)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return std::vector<gmio_type>();
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_old_gmio(aie_meta);
+  auto meta = get_metadata(device);
+  return meta ? meta->get_old_gmios() : std::vector<gmio_type>();
 }
 
 std::unordered_map<std::string, adf::gmio_config>
 get_gmios(const xrt_core::device* device)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return std::unordered_map<std::string, adf::gmio_config>();
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_gmios(aie_meta);
+  auto meta = get_metadata(device);
+  return meta ? meta->get_gmios() : std::unordered_map<std::string, adf::gmio_config>();
 }
 
 std::vector<plio_type>
 get_plios(const xrt_core::device* device)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return std::vector<plio_type>();
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_plio(aie_meta);
+  auto meta = get_metadata(device);
+  return meta ? meta->get_plios() : std::vector<plio_type>();
 }
 
 std::vector<counter_type>
 get_profile_counters(const xrt_core::device* device)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return std::vector<counter_type>();
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_profile_counter(aie_meta);
+  auto meta = get_metadata(device);
+  return meta ? meta->get_profile_counters() : std::vector<counter_type>();
 }
 
 std::vector<gmio_type>
 get_trace_gmios(const xrt_core::device* device)
 {
-  auto data = device->get_axlf_section(AIE_METADATA);
-  if (!data.first || !data.second)
-    return std::vector<gmio_type>();
-
-  pt::ptree aie_meta;
-  read_aie_metadata(data.first, data.second, aie_meta);
-  return ::get_trace_gmio(aie_meta);
+  auto meta = get_metadata(device);
+  return meta ? meta->get_trace_gmios() : std::vector<gmio_type>();
 }
 
 }}} // aie, edge, xrt_core
-
@@ -17,6 +17,9 @@
 #ifndef edge_common_ai_parser_h_
 #define edge_common_ai_parser_h_
 
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -136,6 +139,130 @@ get_profile_counters(const xrt_core::device* device);
 std::vector<gmio_type>
 get_trace_gmios(const xrt_core::device* device);
 
+/**
+ * class metadata - AIE metadata of an xclbin parsed into lookup tables
+ *
+ * The JSON of the AIE_METADATA section is parsed once when the object
+ * is constructed.  RTPs are indexed by graph id and port name.  Graphs
+ * are indexed by name and a graph is converted on its first lookup, a
+ * design has many graphs and a process opens few of them.  A table or
+ * graph that fails to parse throws its error when accessed, others
+ * remain usable.
+ */
+class metadata
+{
+  template <typename ValueType>
+  struct table
+  {
+    ValueType value;
+    std::exception_ptr error;
+
+    const ValueType&
+    get() const
+    {
+      if (error)
+        std::rethrow_exception(error);
+      return value;
+    }
+  };
+
+  using rtp_map = std::unordered_map<std::string, adf::rtp_config>;
+  using gmio_map = std::unordered_map<std::string, adf::gmio_config>;
+
+  // JSON nodes of graphs by name, defined in aie_parser.cpp
+  struct graph_nodes;
+
+  table<adf::driver_config> m_driver_config;
+  table<std::shared_ptr<const graph_nodes>> m_graph_nodes;
+  mutable std::mutex m_graph_mutex;
+  mutable std::unordered_map<std::string, adf::graph_config> m_graphs;
+  table<std::unordered_map<int, rtp_map>> m_rtps;
+  table<std::vector<gmio_type>> m_old_gmios;
+  table<gmio_map> m_gmios;
+  table<std::vector<plio_type>> m_plios;
+  table<std::vector<counter_type>> m_counters;
+  table<std::vector<gmio_type>> m_trace_gmios;
+
+public:
+  /**
+   * metadata() - Parse AIE metadata
+   *
+   * @data: AIE_METADATA section data
+   * @size: size of section data
+   *
+   * Throws if the data is not valid JSON.
+   */
+  metadata(const char* data, size_t size);
+
+  const adf::driver_config&
+  get_driver_config() const
+  {
+    return m_driver_config.get();
+  }
+
+  /**
+   * get_graph() - Return graph with name or nullptr if not found
+   */
+  const adf::graph_config*
+  get_graph(const std::string& graph_name) const;
+
+  /**
+   * get_rtps() - Return RTP ports of graph indexed by port name
+   */
+  const rtp_map&
+  get_rtps(int graph_id) const
+  {
+    static const rtp_map none;
+    auto& rtps = m_rtps.get();
+    auto itr = rtps.find(graph_id);
+    return itr != rtps.end() ? (*itr).second : none;
+  }
+
+  const std::vector<gmio_type>&
+  get_old_gmios() const
+  {
+    return m_old_gmios.get();
+  }
+
+  const gmio_map&
+  get_gmios() const
+  {
+    return m_gmios.get();
+  }
+
+  const std::vector<plio_type>&
+  get_plios() const
+  {
+    return m_plios.get();
+  }
+
+  const std::vector<counter_type>&
+  get_profile_counters() const
+  {
+    return m_counters.get();
+  }
+
+  const std::vector<gmio_type>&
+  get_trace_gmios() const
+  {
+    return m_trace_gmios.get();
+  }
+};
+
+/**
+ * get_metadata() - get parsed AIE metadata of xclbin loaded on device
+ *
+ * @device: device with loaded meta data
+ * Return: Parsed metadata or nullptr if the xclbin has no AIE metadata
+ *
+ * The metadata is parsed on first use and cached by xclbin uuid, so
+ * all devices and all users of the same xclbin share the parsed
+ * metadata.  Only the metadata of the most recently used xclbins is
+ * cached.
+ */
+std::shared_ptr<const metadata>
+get_metadata(const xrt_core::device* device);
+
 }}} // aie, edge, xrt_core
 
 #endif
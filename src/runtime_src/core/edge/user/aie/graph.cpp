@@ -62,8 +62,12 @@ graph_type(std::shared_ptr<xrt_core::device> dev, const uuid_t uuid, const std::
     aieArray = getAieArray();
 #endif
 
+    /* Graph metadata is parsed once per xclbin */
+    auto meta = xrt_core::edge::aie::get_metadata(device.get());
+    auto graph = meta ? meta->get_graph(name) : nullptr;
+
 #ifndef __AIESIM__
-    id = xrt_core::edge::aie::get_graph_id(device.get(), name);
+    id = graph ? graph->id : xrt_core::edge::aie::NON_EXIST_ID;
     if (id == xrt_core::edge::aie::NON_EXIST_ID)
         throw xrt_core::error(-EINVAL, "Can not get id for Graph '" + name + "'");
 
@@ -74,10 +78,12 @@ graph_type(std::shared_ptr<xrt_core::device> dev, const uuid_t uuid, const std::
     access_mode = am;
 
     /* Initialize graph tile metadata */
-    graph_config = xrt_core::edge::aie::get_graph(device.get(), name);
+    if (graph)
+        graph_config = *graph;
 
     /* Initialize graph rtp metadata */
-    rtps = xrt_core::edge::aie::get_rtp(device.get(), graph_config.id);
+    if (meta)
+        rtps = meta->get_rtps(graph_config.id);
 
     pAIEConfigAPI = std::make_shared<adf::graph_api>(&graph_config);
     pAIEConfigAPI->configure();
@@ -100,6 +100,10 @@ struct ert_packet {
  * @stat_enabled:    [4]     enabled driver to record timestamp for various
  *                           states cmd has gone through. The stat data
  *                           is appended after cmd data.
+ * @shadow_invalidate: [5]   CU registers were written outside of ERT, e.g.
+ *                           with xclRegWrite, since the CU was last started.
+ *                           ERT discards its register shadow of the CU.
+ *                           Set by driver.
  * @extra_cu_masks:  [11-10] extra CU masks in addition to mandatory mask
  * @count:           [22-12] number of words following header for cmd data. Not
  *                           include stat data.
@@ -118,7 +122,8 @@ struct ert_start_kernel_cmd {
     struct {
       uint32_t state:4;          /* [3-0]   */
       uint32_t stat_enabled:1;   /* [4]     */
-      uint32_t unused:5;         /* [9-5]   */
+      uint32_t shadow_invalidate:1; /* [5]  */
+      uint32_t unused:4;         /* [9-6]   */
       uint32_t extra_cu_masks:2; /* [11-10] */
       uint32_t count:11;         /* [22-12] */
       uint32_t opcode:5;         /* [27-23] */
@@ -224,7 +229,12 @@ struct ert_start_copybo_cmd {
  * @cu_isr:1         enable CUISR custom module for HW scheduler
  * @cq_int:1         enable interrupt from host to HW scheduler
  * @cdma:1           enable CDMA kernel
- * @unused:25
+ * @cu_shadow:1      only write CU argument registers that changed since
+ *                   the previous start of the CU.  @data is followed by
+ *                   @num_cus masks of the argument words that may be
+ *                   shadowed, bit i is the word at offset 0x10 + 4*i.
+ *                   Words written by the CU itself must not be set.
+ * @unused:24
  * @dsa52:1          reserved for internal use
  *
  * @data:            addresses of @num_cus CUs
@@ -261,7 +271,8 @@ struct ert_configure_cmd {
   uint32_t dmsg:1;
   uint32_t echo:1;
   uint32_t intr:1;
-  uint32_t unusedf:19;
+  uint32_t cu_shadow:1;
+  uint32_t unusedf:18;
   uint32_t dsa52:1;
 
   /* cu address map size is num_cus */
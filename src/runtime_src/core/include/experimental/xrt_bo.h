@@ -14,4 +14,32 @@
  * License for the specific language governing permissions and limitations
  * under the License.
  */
+#ifndef _XRT_EXPERIMENTAL_BO_H_
+#define _XRT_EXPERIMENTAL_BO_H_
+
 #include "xrt/xrt_bo.h"
+
+#ifdef __cplusplus
+namespace xrt {
+
+/**
+ * release_userptr() - Release cached registrations of user memory
+ *
+ * @userptr:  Start of user memory range
+ * @size:     Size of user memory range
+ *
+ * With Runtime.ubuf_cache_mb set, user memory of buffer objects
+ * created from a user pointer stays registered with the driver
+ * after the buffer objects are destroyed.  Cached registrations
+ * overlapping the range must be released before the memory is freed
+ * or unmapped.  A registration still used by a buffer object is
+ * freed when that buffer object is destroyed.
+ */
+XCL_DRIVER_DLLESPEC
+void
+release_userptr(void* userptr, size_t size);
+
+} // xrt
+#endif
+
+#endif
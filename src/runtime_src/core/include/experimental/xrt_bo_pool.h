@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2021, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_POOL_H_
+#define _XRT_BO_POOL_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+
+#ifdef __cplusplus
+# include <chrono>
+# include <memory>
+# include <string>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/**
+ * class bo_pool - Pool of buffers shared between processes
+ *
+ * The process that creates a pool allocates the buffers and exports
+ * each buffer once.  Other processes attach to the pool by name,
+ * which imports and maps each buffer once.  After that buffers are
+ * handed off between processes by index through a ring in shared
+ * memory.  No buffer is exported, imported, or mapped per handoff.
+ *
+ * Each buffer has a reference count in shared memory.  A buffer is
+ * free when its count is zero, acquire() takes a free buffer with a
+ * count of one.  The reference is transferred with send() and
+ * receive(), and the buffer is returned to the pool when the last
+ * reference is released.
+ *
+ * The ring supports one sending and one receiving thread at a time,
+ * which may be in the same or in different processes.
+ *
+ * Supported on Linux only.
+ */
+class bo_pool_impl;
+class bo_pool
+{
+public:
+  using timeout_type = std::chrono::milliseconds;
+
+  /**
+   * bo_pool() - Constructor for empty pool
+   */
+  bo_pool()
+  {}
+
+  /**
+   * bo_pool() - Create a pool of buffers
+   *
+   * @device:  Device on which to allocate the buffers
+   * @name:    Name of the pool, used by other processes to attach
+   * @count:   Number of buffers in the pool
+   * @size:    Size of each buffer
+   * @flags:   Buffer flags
+   * @grp:     Memory group of the buffers
+   *
+   * The pool is removed from the system when the creating object
+   * is destructed, already attached processes keep their buffers.
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_pool(const xrt::device& device, const std::string& name, size_t count,
+          size_t size, xrt::bo::flags flags, xrt::memory_group grp);
+
+  /**
+   * bo_pool() - Attach to a pool created by another process
+   *
+   * @device:  Device to import the buffers into
+   * @name:    Name of the pool
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_pool(const xrt::device& device, const std::string& name);
+
+  /**
+   * size() - Number of buffers in the pool
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  size() const;
+
+  /**
+   * buffer() - Buffer object at index
+   *
+   * The buffer is imported and mapped once per process.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo&
+  buffer(size_t idx) const;
+
+  /**
+   * acquire() - Take a free buffer from the pool
+   *
+   * @timeout:  Max time to wait for a free buffer, 0 waits forever
+   * Return:    Index of buffer with reference count of one
+   *
+   * Throws std::system_error with ETIMEDOUT on timeout.
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  acquire(const timeout_type& timeout = timeout_type{0});
+
+  /**
+   * send() - Hand off buffer to the receiving side
+   *
+   * @idx:  Index of buffer, caller's reference is transferred
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  send(size_t idx);
+
+  /**
+   * receive() - Get next buffer handed off by the sending side
+   *
+   * @timeout:  Max time to wait for a buffer, 0 waits forever
+   * Return:    Index of buffer, caller owns the reference
+   *
+   * Throws std::system_error with ETIMEDOUT on timeout.
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  receive(const timeout_type& timeout = timeout_type{0});
+
+  /**
+   * retain() - Add a reference to a buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  retain(size_t idx);
+
+  /**
+   * release() - Release a reference to a buffer
+   *
+   * The buffer returns to the pool when the last reference is
+   * released.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  release(size_t idx);
+
+private:
+  std::shared_ptr<bo_pool_impl> handle;
+};
+
+} // namespace xrt
+
+#endif // __cplusplus
+
+#endif
@@ -1043,6 +1043,30 @@ xclPollQueue(xclDeviceHandle handle, uint64_t q_hdl, int min_compl,
 		   int max_compl, struct xclReqCompletion *comps,
 		   int* actual_compl, int timeout);
 
+/**
+ * xclPollQueueSet - poll a set of read/write queues for completion
+ * @handle:        Device handle
+ * @num_queues:    Number of queues in q_hdls
+ * @q_hdls:        Queue handles, each with a per-queue aio context
+ * @min_compl:     Unblock only when receiving min_compl completions
+ * @max_compl:     Max number of completion with one poll
+ * @comps:         Completed request array
+ * @actual_compl:  Number of requests been completed
+ * @timeout:       Timeout in ms, wait forever if <= 0
+ * Return:         0 on success or appropriate error number
+ *
+ * Wait for completions of non-blocking read/write requests on any of
+ * the specified queues.  Completions are reaped from the per-queue
+ * aio contexts directly into the comps array, so completions of
+ * queues not in the set are left for their owners.  Per-queue aio
+ * is enabled with xclSetQueueOpt(STREAM_OPT_AIO_MAX_EVENT).
+ */
+XCL_DRIVER_DLLESPEC
+int
+xclPollQueueSet(xclDeviceHandle handle, int num_queues, const uint64_t *q_hdls,
+		int min_compl, int max_compl, struct xclReqCompletion *comps,
+		int* actual_compl, int timeout);
+
 /**
  * xclSetQueueOpt - Set a single read/write queue's option
  * @handle:        Device handle
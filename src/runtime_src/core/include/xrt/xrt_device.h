@@ -24,6 +24,7 @@
 
 #ifdef __cplusplus
 # include "xrt/detail/param_traits.h"
+# include <future>
 # include <memory>
 # include <boost/any.hpp> // std::any c++17
 #endif
@@ -229,6 +230,41 @@ public:
   uuid
   load_xclbin(const xrt::xclbin& xclbin);
 
+  /**
+   * load_xclbin_async() - Start loading an xclbin object
+   *
+   * @param xclbin
+   *  xrt::xclbin object
+   * @return
+   *  Future with UUID of argument xclbin, ready when the xclbin
+   *  is loaded
+   *
+   * The xclbin is loaded on a separate thread and this function
+   * returns immediately.  Use this function to load multiple devices
+   * concurrently.  An error in loading the xclbin is thrown by get()
+   * of the returned future.  The device must not be used otherwise
+   * until the load has completed.
+   */
+  XCL_DRIVER_DLLESPEC
+  std::future<uuid>
+  load_xclbin_async(const xrt::xclbin& xclbin);
+
+  /**
+   * load_xclbin_async() - Start reading and loading an xclbin file
+   *
+   * @param xclbin_fnm
+   *  Full path to xclbin file
+   * @return
+   *  Future with UUID of argument xclbin, ready when the xclbin
+   *  is loaded
+   *
+   * Same as load_xclbin_async() of an xrt::xclbin object, except
+   * that the file is also read on the separate thread.
+   */
+  XCL_DRIVER_DLLESPEC
+  std::future<uuid>
+  load_xclbin_async(const std::string& xclbin_fnm);
+
   /**
    * get_xclbin_uuid() - Get UUID of xclbin image loaded on device
    *
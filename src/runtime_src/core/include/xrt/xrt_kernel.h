@@ -99,6 +99,25 @@ class run
   void
   start();
 
+  /**
+   * freeze() - Freeze the command layout of a run for repeated starts
+   *
+   * The command packet header, compute units, and argument offsets
+   * of this run are validated once.  Subsequent calls to ``start()``
+   * only submit the command, and the runtime caches scheduling data
+   * derived from the command.  Use for launch loops where only
+   * argument values change between starts.
+   *
+   * Setting a global argument to a buffer in a memory bank that
+   * changes the compute units this run can execute on unfreezes the
+   * run.  Call ``freeze()`` again after such a change.
+   *
+   * The run must not be running when it is frozen.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  freeze();
+
   /**
    * wait() - Wait for a run to complete execution
    *
@@ -174,6 +193,30 @@ class run
                std::function<void(const void*, ert_cmd_state, void*)> callback,
                void* data);
 
+  /**
+   * set_timeout() - Set a deadline for each execution of this run
+   *
+   * @param timeout     Timeout relative to start of run, 0 disables
+   * @param callback    Callback function called when deadline expires
+   * @param data        User data to pass to callback function
+   *
+   * The callback function is called with ``ERT_CMD_STATE_TIMEOUT``
+   * if the run has not completed when the timeout expires.  The
+   * function is called from a runtime thread that tracks deadlines
+   * for all runs, it must not block.  The run itself is not
+   * affected and continues execution.
+   *
+   * The function object's first parameter is the same 'key' as
+   * for ``add_callback``.
+   *
+   * The timeout cannot be changed while the run is executing.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  set_timeout(const std::chrono::milliseconds& timeout,
+              std::function<void(const void*, ert_cmd_state, void*)> callback,
+              void* data);
+
   /**
    * set_event() - Add event for enqueued operations
    *
@@ -161,6 +161,9 @@ struct xocl_ert_user {
 	uint32_t 		ert_dmsg;
 	uint32_t		echo;
 	uint32_t		intr;
+	uint32_t		cu_shadow;
+	/* CUs written by host outside of ERT since last start */
+	DECLARE_BITMAP(cu_shadow_stale, MAX_CUS);
 
 	/* ert validate result cache*/
 	struct ert_validate_cmd ert_valid;
@@ -253,6 +256,55 @@ static ssize_t ert_intr_store(struct device *dev,
 }
 static DEVICE_ATTR_WO(ert_intr);
 
+static ssize_t ert_cu_shadow_store(struct device *dev,
+	struct device_attribute *da, const char *buf, size_t count)
+{
+	struct xocl_ert_user *ert_user = platform_get_drvdata(to_platform_device(dev));
+	u32 val;
+
+	mutex_lock(&ert_user->lock);
+	if (kstrtou32(buf, 10, &val) == -EINVAL || val > 1) {
+		xocl_err(&to_platform_device(dev)->dev,
+			"usage: echo 0 or 1 > ert_cu_shadow");
+		mutex_unlock(&ert_user->lock);
+		return -EINVAL;
+	}
+
+	ert_user->cu_shadow = val;
+
+	mutex_unlock(&ert_user->lock);
+	return count;
+}
+static ssize_t ert_cu_shadow_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	struct xocl_ert_user *ert_user = platform_get_drvdata(to_platform_device(dev));
+
+	return sprintf(buf, "%u\n", ert_user->cu_shadow);
+}
+static DEVICE_ATTR_RW(ert_cu_shadow);
+
+/*
+ * Host wrote CU registers directly (xclRegWrite), the next start
+ * command of the CU tells ERT to discard its register shadow
+ */
+static ssize_t ert_cu_shadow_invalidate_store(struct device *dev,
+	struct device_attribute *da, const char *buf, size_t count)
+{
+	struct xocl_ert_user *ert_user = platform_get_drvdata(to_platform_device(dev));
+	u32 val;
+
+	if (kstrtou32(buf, 10, &val) || val >= MAX_CUS) {
+		xocl_err(&to_platform_device(dev)->dev,
+			"usage: echo <cu index> > ert_cu_shadow_invalidate");
+		return -EINVAL;
+	}
+
+	set_bit(val, ert_user->cu_shadow_stale);
+	return count;
+}
+static DEVICE_ATTR_WO(ert_cu_shadow_invalidate);
+
 static ssize_t mb_sleep_store(struct device *dev,
 	struct device_attribute *da, const char *buf, size_t count)
 {
@@ -329,6 +381,8 @@ static struct attribute *ert_user_attrs[] = {
 	&dev_attr_snap_shot.attr,
 	&dev_attr_ert_echo.attr,
 	&dev_attr_ert_intr.attr,
+	&dev_attr_ert_cu_shadow.attr,
+	&dev_attr_ert_cu_shadow_invalidate.attr,
 	&dev_attr_mb_sleep.attr,
 	&dev_attr_cq_read_cnt.attr,
 	&dev_attr_cq_write_cnt.attr,
@@ -1104,6 +1158,23 @@ static int ert_cfg_cmd(struct xocl_ert_user *ert_user, struct ert_user_command *
 	cfg->dmsg = ert_user->ert_dmsg;
 	cfg->echo = ert_user->echo;
 	cfg->intr = ert_user->intr;
+	cfg->cu_shadow = ert_user->cu_shadow;
+	if (cfg->cu_shadow) {
+		struct kds_sched *kds = &XDEV(xdev)->kds;
+		int i;
+
+		/* CU shadow masks follow the CU addresses */
+		if ((6 + 2 * cfg->num_cus) * sizeof(u32) > cfg->slot_size) {
+			ERTUSER_INFO(ert_user, "CU shadow disabled, %d CUs exceed slot size %d\n",
+				     cfg->num_cus, cfg->slot_size);
+			cfg->cu_shadow = 0;
+		} else {
+			for (i = 0; i < cfg->num_cus; i++)
+				cfg->data[cfg->num_cus + i] = kds_get_cu_shadow_mask(kds, i);
+			cfg->count = 5 + 2 * cfg->num_cus;
+		}
+	}
+	bitmap_zero(ert_user->cu_shadow_stale, MAX_CUS);
 
 	// The KDS side of of the scheduler is now configured.  If ERT is
 	// enabled, then the configure command will be started asynchronously
@@ -1207,6 +1278,8 @@ static inline int process_ert_rq(struct xocl_ert_user *ert_user)
 		if (kds_echo) {
 			ecmd->completed = true;
 		} else {
+			u32 header = epkt->header;
+
 			if (cmd_opcode(ecmd) == OP_START) {
 				// write kds selected cu_idx in first cumask (first word after header)
 				iowrite32(ecmd->xcmd->cu_idx, ert_user->cq_base + slot_addr + 4);
@@ -1214,12 +1287,16 @@ static inline int process_ert_rq(struct xocl_ert_user *ert_user)
 				// write remaining packet (past header and cuidx)
 				xocl_memcpy_toio(ert_user->cq_base + slot_addr + 8,
 						 ecmd->xcmd->execbuf+2, (epkt->count-1)*sizeof(u32));
+
+				if (ert_user->cu_shadow &&
+				    test_and_clear_bit(ecmd->xcmd->cu_idx, ert_user->cu_shadow_stale))
+					header |= 1 << 5; /* shadow_invalidate */
 			} else {
 				xocl_memcpy_toio(ert_user->cq_base + slot_addr + 4,
 					  ecmd->xcmd->execbuf+1, epkt->count*sizeof(u32));
 			}
 
-			iowrite32(epkt->header, ert_user->cq_base + slot_addr);
+			iowrite32(header, ert_user->cq_base + slot_addr);
 		}
 
 		/*
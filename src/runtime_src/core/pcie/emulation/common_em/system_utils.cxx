@@ -1,19 +1,225 @@
 #include "system_utils.h"
 
-namespace systemUtil {
-  
-  inline void printErrorMessage(const std::string &command, int status, const std::string& LineNo )
-  {
-    if (!status)
-      return;      
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <zlib.h>
+
+namespace {
+
+// Minimal zip archive extractor, replaces running unzip in a shell.
+// Supports stored and deflated entries of archives without zip64
+// extensions, which is what the emulation data archives use.
+namespace zip {
+
+const uint32_t local_header_signature = 0x04034b50;
+const uint32_t central_header_signature = 0x02014b50;
+const uint32_t end_of_central_dir_signature = 0x06054b50;
+const size_t local_header_size = 30;
+const size_t central_header_size = 46;
+const size_t end_of_central_dir_size = 22;
+const uint16_t method_stored = 0;
+const uint16_t method_deflated = 8;
+const uint8_t host_unix = 3;
+
+inline uint16_t
+get16(const std::vector<char>& buf, size_t offset)
+{
+  if (offset + 2 > buf.size())
+    throw std::runtime_error("truncated zip archive");
+  auto p = reinterpret_cast<const unsigned char*>(buf.data() + offset);
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t
+get32(const std::vector<char>& buf, size_t offset)
+{
+  return get16(buf, offset) | (static_cast<uint32_t>(get16(buf, offset + 2)) << 16);
+}
+
+static size_t
+find_end_of_central_dir(const std::vector<char>& buf)
+{
+  if (buf.size() < end_of_central_dir_size)
+    throw std::runtime_error("not a zip archive");
+
+  // The record is followed by a comment of at most 64K
+  size_t last = buf.size() - end_of_central_dir_size;
+  size_t first = last > 0xffff ? last - 0xffff : 0;
+  for (size_t offset = last + 1; offset-- > first; )
+    if (get32(buf, offset) == end_of_central_dir_signature)
+      return offset;
+
+  throw std::runtime_error("not a zip archive");
+}
+
+// Entries must extract below the destination directory
+static boost::filesystem::path
+entry_path(const boost::filesystem::path& dest, const std::string& name)
+{
+  boost::filesystem::path rel(name);
+  if (name.empty() || rel.has_root_path())
+    throw std::runtime_error("invalid zip entry name '" + name + "'");
+  for (auto& element : rel)
+    if (element == "..")
+      throw std::runtime_error("invalid zip entry name '" + name + "'");
+  return dest / rel;
+}
+
+static void
+inflate_to(const char* data, size_t csize, size_t usize, uint32_t crc, std::ostream& os, const std::string& name)
+{
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+    throw std::runtime_error("zlib initialization failed");
+
+  std::vector<char> out(256 * 1024);
+  uLong ocrc = crc32(0L, Z_NULL, 0);
+  size_t total = 0;
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  zs.avail_in = static_cast<uInt>(csize);
+  int ret = Z_OK;
+  while (ret != Z_STREAM_END) {
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    ret = inflate(&zs, Z_NO_FLUSH);
+    if (ret != Z_OK && ret != Z_STREAM_END) {
+      inflateEnd(&zs);
+      throw std::runtime_error("corrupt zip entry '" + name + "'");
+    }
+    auto produced = out.size() - zs.avail_out;
+    if (!produced && ret != Z_STREAM_END) {
+      inflateEnd(&zs);
+      throw std::runtime_error("truncated zip entry '" + name + "'");
+    }
+    ocrc = crc32(ocrc, reinterpret_cast<const Bytef*>(out.data()), static_cast<uInt>(produced));
+    os.write(out.data(), produced);
+    total += produced;
+  }
+  inflateEnd(&zs);
+
+  if (total != usize || ocrc != crc)
+    throw std::runtime_error("corrupt zip entry '" + name + "'");
+}
+
+static void
+extract(const std::string& archive, const std::string& destination)
+{
+  std::ifstream is(archive, std::ios::binary);
+  if (!is)
+    throw std::runtime_error("failed to open '" + archive + "'");
+  std::vector<char> buf((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+  auto eocd = find_end_of_central_dir(buf);
+  size_t entries = get16(buf, eocd + 10);
+  size_t offset = get32(buf, eocd + 16);
+  if (entries == 0xffff || offset == 0xffffffff)
+    throw std::runtime_error("zip64 archives are not supported");
 
-    if (!LineNo.empty()) {  
-      std::cerr << "ERROR: [EMU 60-600] " << command.c_str() << " Exception Caught - Failed with the error code " << status << " at the Line Number " << LineNo << ". PLEASE CHECK YOUR PERMISSIONS " << std::endl;
-    } else {
-      std::cerr << "ERROR: [EMU 60-600] " << command.c_str() << " Exception Caught - Failed with the error code " << status << ". PLEASE CHECK YOUR PERMISSIONS " << std::endl;
+  boost::filesystem::path dest(destination);
+  boost::filesystem::create_directories(dest);
+
+  for (size_t entry = 0; entry < entries; ++entry) {
+    if (get32(buf, offset) != central_header_signature)
+      throw std::runtime_error("corrupt zip central directory");
+
+    uint8_t host = static_cast<uint8_t>(get16(buf, offset + 4) >> 8);
+    uint16_t flags = get16(buf, offset + 8);
+    uint16_t method = get16(buf, offset + 10);
+    uint32_t crc = get32(buf, offset + 16);
+    size_t csize = get32(buf, offset + 20);
+    size_t usize = get32(buf, offset + 24);
+    size_t name_len = get16(buf, offset + 28);
+    size_t extra_len = get16(buf, offset + 30);
+    size_t comment_len = get16(buf, offset + 32);
+    uint32_t attributes = get32(buf, offset + 38);
+    size_t local = get32(buf, offset + 42);
+    if (offset + central_header_size + name_len > buf.size())
+      throw std::runtime_error("corrupt zip central directory");
+    std::string name(buf.data() + offset + central_header_size, name_len);
+    offset += central_header_size + name_len + extra_len + comment_len;
+
+    if (flags & 0x1)
+      throw std::runtime_error("encrypted zip entry '" + name + "' is not supported");
+    if (csize == 0xffffffff || usize == 0xffffffff || local == 0xffffffff)
+      throw std::runtime_error("zip64 archives are not supported");
+
+    auto path = entry_path(dest, name);
+    if (name.back() == '/') {
+      boost::filesystem::create_directories(path);
+      continue;
+    }
+    boost::filesystem::create_directories(path.parent_path());
+
+    if (get32(buf, local) != local_header_signature)
+      throw std::runtime_error("corrupt zip entry '" + name + "'");
+    size_t data = local + local_header_size + get16(buf, local + 26) + get16(buf, local + 28);
+    if (data + csize > buf.size())
+      throw std::runtime_error("truncated zip entry '" + name + "'");
+
+    mode_t mode = (host == host_unix) ? static_cast<mode_t>(attributes >> 16) : 0;
+    if (S_ISLNK(mode) && method == method_stored) {
+      boost::filesystem::remove(path);
+      boost::filesystem::create_symlink(std::string(buf.data() + data, csize), path);
+      continue;
     }
-    exit(1);
+
+    std::ofstream os(path.string(), std::ios::binary | std::ios::trunc);
+    if (!os)
+      throw std::runtime_error("failed to create '" + path.string() + "'");
+    if (method == method_stored) {
+      if (csize != usize || crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(buf.data() + data), static_cast<uInt>(csize)) != crc)
+        throw std::runtime_error("corrupt zip entry '" + name + "'");
+      os.write(buf.data() + data, csize);
+    }
+    else if (method == method_deflated)
+      inflate_to(buf.data() + data, csize, usize, crc, os, name);
+    else
+      throw std::runtime_error("unsupported compression method in zip entry '" + name + "'");
+    os.close();
+    if (!os)
+      throw std::runtime_error("failed to write '" + path.string() + "'");
+
+    if (mode & 07777)
+      boost::filesystem::permissions(path, static_cast<boost::filesystem::perms>(mode & 07777));
   }
+}
+
+} // zip
+
+// cp or cat >>, depending on mode
+static void
+copy_file(const std::string& src, const std::string& dest, std::ios::openmode mode)
+{
+  std::ifstream is(src, std::ios::binary);
+  std::ofstream os(dest, std::ios::binary | mode);
+  if (!is || !os)
+    throw std::runtime_error("failed to copy " + src + " to " + dest);
+  if (is.peek() != std::ifstream::traits_type::eof())
+    os << is.rdbuf();
+  os.close();
+  if (!os)
+    throw std::runtime_error("failed to copy " + src + " to " + dest);
+}
+
+// chmod -R, symbolic links are not followed
+static void
+set_permissions(const boost::filesystem::path& root, boost::filesystem::perms perms)
+{
+  boost::filesystem::permissions(root, perms);
+  if (!boost::filesystem::is_directory(root))
+    return;
+  for (boost::filesystem::recursive_directory_iterator itr(root), end; itr != end; ++itr)
+    if (!boost::filesystem::is_symlink(itr->symlink_status()))
+      boost::filesystem::permissions(itr->path(), perms);
+}
+
+} // namespace
+
+namespace systemUtil {
   
   void makeSystemCall (std::string &operand1, systemOperation operation, std::string operand2, std::string LineNo)
   {
@@ -42,52 +248,49 @@ namespace systemUtil {
         case COPY   :
           {
             operationStr = "COPY";
-            std::stringstream copyCommand;
-            copyCommand <<"cp "<<operand1<<" "<<operand2;
             if (boost::filesystem::exists(operand1) )
             {
-              int status = system(copyCommand.str().c_str());
-              printErrorMessage(copyCommand.str(),status, LineNo);
+              boost::filesystem::path dest(operand2);
+              if (boost::filesystem::is_directory(dest))
+                dest /= boost::filesystem::path(operand1).filename();
+              copy_file(operand1, dest.string(), std::ios::trunc);
             }
             break;
           }
         case APPEND   :
           {
             operationStr = "APPEND";
-            std::stringstream appendCommand;
-            appendCommand <<"cat "<<operand1<<">> "<<operand2;
             if (boost::filesystem::exists(operand1) )
             {
-              int status = system(appendCommand.str().c_str());
-              printErrorMessage(appendCommand.str(),status, LineNo);
+              copy_file(operand1, operand2, std::ios::app);
             }
             break;
           }
         case UNZIP  :
           {
             operationStr = "UNZIP";
-            std::stringstream unzipCommand;
-            unzipCommand <<"unzip -q " << operand1 << " -d " << operand2;
             if (getenv("ENABLE_HAL_HW_EMU_DEBUG")) {
-              std::cout << __func__ << " DEBUG_MSGS unzipCommand: " << unzipCommand.str().c_str() << std::endl;
+              std::cout << __func__ << " DEBUG_MSGS unzip: " << operand1 << " to " << operand2 << std::endl;
             }
-            int status = system(unzipCommand.str().c_str());
-            if (getenv("ENABLE_HAL_HW_EMU_DEBUG")) {
-              std::cout << __func__ << " DEBUG_MSGS unzip status: " << status << std::endl;
-            }
-            printErrorMessage(unzipCommand.str(),status, LineNo);
+            zip::extract(operand1, operand2);
             break;
           }
         case PERMISSIONS : 
           {
             operationStr = "PERMISSIONS";
-            std::stringstream permissionsCommand ;
-            permissionsCommand << "chmod -R " << operand2 << " " << operand1;
-            int status = system(permissionsCommand.str().c_str());
-            printErrorMessage(permissionsCommand.str(),status, LineNo);
+            auto perms = static_cast<boost::filesystem::perms>(std::stoul(operand2, nullptr, 8) & 07777);
+            set_permissions(operand1, perms);
             break;
           }
       }
+    } catch (const std::exception& ex) {
+      if (!LineNo.empty()) {
+        std::cerr << "ERROR: [EMU 60-601] " << " Exception Caught - Failed with the command " << operationStr.c_str() << " operation at the Line Number: " << LineNo.c_str() << ": " << ex.what() << std::endl;
+      }
+      else {
+        std::cerr << "ERROR: [EMU 60-601] " << " Exception Caught - Failed with the command " << operationStr.c_str() << ": " << ex.what() << std::endl;
+      }
+      exit(1);
     } catch (...) {
       if (!LineNo.empty()) {
         std::cerr << "ERROR: [EMU 60-601] " << " Exception Caught - Failed with the command " << operationStr.c_str() << " operation at the Line Number: " << LineNo.c_str() << std::endl;
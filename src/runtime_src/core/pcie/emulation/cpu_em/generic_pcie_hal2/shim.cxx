@@ -53,6 +53,7 @@ namespace xclcpuemhal2 {
     ,mDeviceIndex(deviceIndex)
   {
     binaryCounter = 0;
+    mDeviceProcessPid = 0;
     mReqCounter = 0;
     sock = nullptr;
     ci_msg.set_size(0);
@@ -165,6 +166,22 @@ namespace xclcpuemhal2 {
 
   }
 
+  // The device process has exited when the run directory is removed,
+  // but a debugger attached to it may still be releasing files in the
+  // directory.  Retry for a bounded time rather than sleeping up front.
+  static void removeRunDirectory(std::string& directory)
+  {
+    for (int retry = 0; retry < 50; ++retry)
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(directory, ec);
+      if (!ec)
+        return;
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    systemUtil::makeSystemCall(directory, systemUtil::systemOperation::REMOVE);
+  }
+
   static void sigHandler(int sn, siginfo_t *si, void *sc)
   {
     switch (sn) {
@@ -469,6 +486,7 @@ namespace xclcpuemhal2 {
         if(r == -1){std::cerr << "FATAL ERROR : child process did not launch" << std::endl; exit(1);}
         exit(0);
       }
+      mDeviceProcessPid = pid;
     }
     sock = new unix_socket;
   }
@@ -1104,10 +1122,13 @@ namespace xclcpuemhal2 {
     }
     mCloseAll = false;
 
+    // Wait for the device process to exit
     int status = 0;
-    bool simDontRun = xclemulation::config::getInstance()->isDontRun();
-    if(!simDontRun)
-      while (-1 == waitpid(0, &status, 0));
+    if (mDeviceProcessPid > 0)
+    {
+      while (-1 == waitpid(mDeviceProcessPid, &status, 0) && errno == EINTR);
+      mDeviceProcessPid = 0;
+    }
 
     systemUtil::makeSystemCall(socketName, systemUtil::systemOperation::REMOVE);
     delete sock;
@@ -1124,9 +1145,7 @@ namespace xclcpuemhal2 {
     //clean up directories which are created inside the driver
     if( xclemulation::config::getInstance()->isKeepRunDirEnabled() == false)
     {
-      //TODO sleeping for some time sothat gdb releases the process and its contents
-      sleep(5);
-      systemUtil::makeSystemCall(deviceDirectory, systemUtil::systemOperation::REMOVE);
+      removeRunDirectory(deviceDirectory);
     }
     google::protobuf::ShutdownProtobufLibrary();
   }
@@ -311,6 +311,7 @@ namespace xclcpuemhal2 {
       size_t buf_size;
       unsigned int binaryCounter;
       unix_socket* sock;
+      pid_t mDeviceProcessPid;
 
 
       uint64_t mRAMSize;
@@ -1633,28 +1633,28 @@ uint32_t HwEmShim::getAddressSpace (uint32_t topology)
             extension = "wlf";
           }
           std::string wdbFileName = binaryDirectory + "/" + fileName + "."+extension;
-          std::string destPath = "'" + std::string(path) + "/" + fileName +"." + extension + "'";
+          std::string destPath = std::string(path) + "/" + fileName +"." + extension;
           systemUtil::makeSystemCall(wdbFileName, systemUtil::systemOperation::COPY,destPath, boost::lexical_cast<std::string>(__LINE__));
 
           // Copy waveform config
           std::string wcfgFilePath= binaryDirectory + "/" + bdName + "_behav.wcfg";
-          std::string destPath2 = "'" + std::string(path) + "/" + fileName + ".wcfg'";
+          std::string destPath2 = std::string(path) + "/" + fileName + ".wcfg";
           systemUtil::makeSystemCall(wcfgFilePath, systemUtil::systemOperation::COPY, destPath2, boost::lexical_cast<std::string>(__LINE__));
 
           // Append to detailed kernel trace data mining results file
           std::string logFilePath= binaryDirectory + "/profile_kernels.csv";
-          std::string destPath3 = "'" + std::string(path) + "/profile_kernels.csv'";
+          std::string destPath3 = std::string(path) + "/profile_kernels.csv";
           systemUtil::makeSystemCall(logFilePath, systemUtil::systemOperation::APPEND, destPath3, boost::lexical_cast<std::string>(__LINE__));
           xclemulation::copyLogsFromOneFileToAnother(logFilePath, mDebugLogStream);
 
           // Append to detailed kernel trace "timeline" file
           std::string traceFilePath = binaryDirectory + "/timeline_kernels.csv";
-          std::string destPath4 = "'" + std::string(path) + "/timeline_kernels.csv'";
+          std::string destPath4 = std::string(path) + "/timeline_kernels.csv";
           systemUtil::makeSystemCall(traceFilePath, systemUtil::systemOperation::APPEND, destPath4, boost::lexical_cast<std::string>(__LINE__));
 
           // Copy proto inst file
           std::string protoFilePath= binaryDirectory + "/" + bdName + "_behav.protoinst";
-          std::string destPath6 = "'" + std::string(path) + "/" + fileName + ".protoinst'";
+          std::string destPath6 = std::string(path) + "/" + fileName + ".protoinst";
           systemUtil::makeSystemCall(protoFilePath, systemUtil::systemOperation::COPY, destPath6, boost::lexical_cast<std::string>(__LINE__));
 
 
@@ -1664,13 +1664,13 @@ uint32_t HwEmShim::getAddressSpace (uint32_t topology)
 
         // Copy Simulation Log file
         std::string simulationLogFilePath= binaryDirectory + "/" + "simulate.log";
-        std::string destPath5 = "'" + std::string(path) + "/" + fileName + "_simulate.log'";
+        std::string destPath5 = std::string(path) + "/" + fileName + "_simulate.log";
         systemUtil::makeSystemCall(simulationLogFilePath, systemUtil::systemOperation::COPY, destPath5, boost::lexical_cast<std::string>(__LINE__));
 
 
         // Copy xsc_report Log file
         std::string xscReportLogFilePath= binaryDirectory + "/" + "xsc_report.log";
-        std::string destPath8 = "'" + std::string(path) + "/" + fileName + "_xsc_report.log'";
+        std::string destPath8 = std::string(path) + "/" + fileName + "_xsc_report.log";
         systemUtil::makeSystemCall(xscReportLogFilePath, systemUtil::systemOperation::COPY, destPath8, boost::lexical_cast<std::string>(__LINE__));
 
       }
@@ -0,0 +1,304 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Stream completion polling benchmark.
+//
+// Models the shim's queue_cb AIO paths with temporary files standing
+// in for the QDMA queues.  Each round every queue submits a number of
+// requests, the busy queues more than the watched queue.  The
+// application waits for the completions of the watched queue only.
+//
+//  shared:    all queues submit to one aio context (xclPollCompletion),
+//             completions of other queues are stashed until their
+//             owner polls for them
+//  per-queue: every queue has its own aio context and eventfd
+//             (xclPollQueueSet), only the watched queue is reaped
+//
+// % aio_poll_bench [-q <queues>] [-r <rounds>] [-b <requests per busy queue per round>]
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/aio_abi.h>
+
+namespace {
+
+constexpr size_t xfer_size = 4096;
+
+inline int io_setup(unsigned nr, aio_context_t *ctxp)
+{
+  return syscall(__NR_io_setup, nr, ctxp);
+}
+
+inline int io_destroy(aio_context_t ctx)
+{
+  return syscall(__NR_io_destroy, ctx);
+}
+
+inline int io_submit(aio_context_t ctx, long nr, struct iocb **iocbpp)
+{
+  return syscall(__NR_io_submit, ctx, nr, iocbpp);
+}
+
+inline int io_getevents(aio_context_t ctx, long min_nr, long max_nr,
+                        struct io_event *events, struct timespec *timeout)
+{
+  return syscall(__NR_io_getevents, ctx, min_nr, max_nr, events, timeout);
+}
+
+struct queue
+{
+  int fd = -1;
+  int efd = -1;
+  aio_context_t ctx = 0;
+  std::vector<char> buf = std::vector<char>(xfer_size);
+  std::deque<io_event> stash;   // completions reaped by someone else
+
+  queue(const std::string& dir, unsigned max_evts, bool own_ctx)
+  {
+    std::string path = dir + "/aio_poll_bench_XXXXXX";
+    fd = mkstemp(&path[0]);
+    if (fd < 0)
+      throw std::runtime_error("mkstemp failed: " + std::string(strerror(errno)));
+    unlink(path.c_str());
+    if (!own_ctx)
+      return;
+    if (io_setup(max_evts, &ctx))
+      throw std::runtime_error("io_setup failed: " + std::string(strerror(errno)));
+    efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  }
+
+  ~queue()
+  {
+    if (ctx)
+      io_destroy(ctx);
+    if (efd >= 0)
+      close(efd);
+    close(fd);
+  }
+
+  void
+  submit(aio_context_t to, int n)
+  {
+    std::vector<iovec> iov(n, iovec{buf.data(), xfer_size});
+    std::vector<iocb> cbs(n);
+    std::vector<iocb*> cbp(n);
+    for (int i = 0; i < n; ++i) {
+      memset(&cbs[i], 0, sizeof(iocb));
+      cbs[i].aio_fildes = fd;
+      cbs[i].aio_lio_opcode = IOCB_CMD_PWRITEV;
+      cbs[i].aio_buf = reinterpret_cast<uint64_t>(&iov[i]);
+      cbs[i].aio_nbytes = 1;
+      cbs[i].aio_data = reinterpret_cast<uint64_t>(this);
+      if (efd >= 0) {
+        cbs[i].aio_flags = IOCB_FLAG_RESFD;
+        cbs[i].aio_resfd = efd;
+      }
+      cbp[i] = &cbs[i];
+    }
+    if (io_submit(to, n, cbp.data()) != n)
+      throw std::runtime_error("io_submit failed: " + std::string(strerror(errno)));
+  }
+};
+
+using clock_type = std::chrono::steady_clock;
+
+struct result
+{
+  double ns_per_compl = 0;   // time to get the watched completion
+  std::chrono::nanoseconds wait {0};
+  uint64_t syscalls = 0;
+  uint64_t stashed = 0;
+};
+
+// Wait for one completion of the watched queue on the shared context
+static result
+run_shared(std::vector<queue*>& queues, aio_context_t shared, int rounds, int busy)
+{
+  result r;
+  std::vector<io_event> evts(queues.size() * busy + 1);
+  auto watched = queues[0];
+  for (int round = 0; round < rounds; ++round) {
+    for (size_t q = 0; q < queues.size(); ++q)
+      queues[q]->submit(shared, q ? busy : 1);
+
+    auto start = clock_type::now();
+    while (watched->stash.empty()) {
+      int rc = io_getevents(shared, 1, evts.size(), evts.data(), nullptr);
+      ++r.syscalls;
+      if (rc < 0)
+        throw std::runtime_error("io_getevents failed: " + std::string(strerror(errno)));
+      for (int i = 0; i < rc; ++i) {
+        auto owner = reinterpret_cast<queue*>(evts[i].data);
+        owner->stash.push_back(evts[i]);
+        if (owner != watched)
+          ++r.stashed;
+      }
+    }
+    watched->stash.pop_front();
+    r.wait += clock_type::now() - start;
+
+    // Owners of the other queues drain their stash eventually
+    for (size_t q = 1; q < queues.size(); ++q)
+      queues[q]->stash.clear();
+  }
+  r.ns_per_compl = r.wait.count() / double(rounds);
+  return r;
+}
+
+// Wait for one completion of the watched queue on its own context
+static result
+run_per_queue(std::vector<queue*>& queues, int rounds, int busy)
+{
+  result r;
+  io_event evt;
+  auto watched = queues[0];
+  pollfd pfd = {watched->efd, POLLIN, 0};
+  timespec zero = {0, 0};
+  for (int round = 0; round < rounds; ++round) {
+    for (size_t q = 0; q < queues.size(); ++q)
+      queues[q]->submit(queues[q]->ctx, q ? busy : 1);
+
+    auto start = clock_type::now();
+    while (true) {
+      uint64_t cnt;
+      (void) read(watched->efd, &cnt, sizeof(cnt));
+      int rc = io_getevents(watched->ctx, 0, 1, &evt, &zero);
+      r.syscalls += 2;
+      if (rc < 0)
+        throw std::runtime_error("io_getevents failed: " + std::string(strerror(errno)));
+      if (rc)
+        break;
+      poll(&pfd, 1, -1);
+      ++r.syscalls;
+    }
+    r.wait += clock_type::now() - start;
+
+    // Owners of the other queues reap their own completions
+    for (size_t q = 1; q < queues.size(); ++q) {
+      std::vector<io_event> evts(busy);
+      int got = 0;
+      while (got < busy)
+        got += io_getevents(queues[q]->ctx, 1, busy - got, evts.data(), nullptr);
+    }
+  }
+  r.ns_per_compl = r.wait.count() / double(rounds);
+  return r;
+}
+
+static void
+usage()
+{
+  std::cout << "usage: aio_poll_bench [options]\n\n";
+  std::cout << "  -q <queues>, default 16\n";
+  std::cout << "  -r <rounds>, default 10000\n";
+  std::cout << "  -b <requests per busy queue per round>, default 8\n";
+  std::cout << "  -d <directory for queue files>, default /tmp\n";
+  std::cout << "  -h\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  int nqueues = 16;
+  int rounds = 10000;
+  int busy = 8;
+  std::string dir = "/tmp";
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-q")
+      nqueues = std::stoi(arg);
+    else if (cur == "-r")
+      rounds = std::stoi(arg);
+    else if (cur == "-b")
+      busy = std::stoi(arg);
+    else if (cur == "-d")
+      dir = arg;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (nqueues < 2 || rounds <= 0 || busy <= 0)
+    throw std::runtime_error("need at least 2 queues, 1 round, and 1 request");
+
+  unsigned max_evts = nqueues * busy * 2;
+  result shared_r, per_queue_r;
+  {
+    aio_context_t shared = 0;
+    if (io_setup(max_evts, &shared))
+      throw std::runtime_error("io_setup failed: " + std::string(strerror(errno)));
+    std::vector<queue*> queues;
+    for (int q = 0; q < nqueues; ++q)
+      queues.push_back(new queue(dir, 0, false));
+    shared_r = run_shared(queues, shared, rounds, busy);
+    for (auto q : queues)
+      delete q;
+    io_destroy(shared);
+  }
+  {
+    std::vector<queue*> queues;
+    for (int q = 0; q < nqueues; ++q)
+      queues.push_back(new queue(dir, busy * 2, true));
+    per_queue_r = run_per_queue(queues, rounds, busy);
+    for (auto q : queues)
+      delete q;
+  }
+
+  std::cout << "queues: " << nqueues << ", rounds: " << rounds
+            << ", busy queue requests per round: " << busy << "\n";
+  std::cout << "shared:    " << shared_r.ns_per_compl << " ns per watched completion, "
+            << shared_r.syscalls << " reap syscalls, "
+            << shared_r.stashed << " foreign completions stashed\n";
+  std::cout << "per-queue: " << per_queue_r.ns_per_compl << " ns per watched completion, "
+            << per_queue_r.syscalls << " reap syscalls, "
+            << per_queue_r.stashed << " foreign completions stashed\n";
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "Error: " << ex.what() << "\n";
+  }
+  return 1;
+}
@@ -16,6 +16,7 @@
 
 
 #include "device_linux.h"
+#include "shim.h"
 #include "core/common/query_requests.h"
 #include "core/pcie/driver/linux/include/mgmt-ioctl.h"
 
@@ -547,6 +548,7 @@ initialize_query_table()
   emplace_sysfs_getput<query::rp_program_status>             ("", "rp_program");
   emplace_sysfs_get<query::shared_host_mem>                  ("address_translator", "host_mem_size");
   emplace_sysfs_get<query::cpu_affinity>                     ("", "local_cpulist");
+  emplace_sysfs_get<query::numa_node>                        ("", "numa_node");
   emplace_sysfs_get<query::mailbox_metrics>                  ("mailbox", "recv_metrics");
   emplace_sysfs_get<query::clock_timestamp>                  ("ert_user", "clock_timestamp");
   emplace_sysfs_getput<query::ert_sleep>                     ("ert_user", "mb_sleep");
@@ -651,6 +653,14 @@ close(int dev_handle) const
   pcidev::get_dev(get_device_id(), false)->close(dev_handle);
 }
 
+int
+device_linux::
+get_exec_wait_fd() const
+{
+  auto drv = xocl::shim::handleCheck(get_device_handle());
+  return drv ? drv->getExecWaitFd() : -1;
+}
+
 void
 device_linux::
 xclmgmt_load_xclbin(const char* buffer) const {
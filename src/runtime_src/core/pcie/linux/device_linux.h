@@ -38,6 +38,7 @@ public:
   virtual void close(int dev_handle) const;
   virtual void reset(query::reset_type&) const;
   virtual void xclmgmt_load_xclbin(const char* buffer) const;
+  virtual int  get_exec_wait_fd() const;
 
 private:
   // Private look up function for concrete query::request
@@ -29,6 +29,8 @@
 #include "core/common/config_reader.h"
 #include "core/common/query_requests.h"
 #include "core/common/AlignedAllocator.h"
+#include "core/common/thread.h"
+#include "core/common/api/bo.h"
 
 #include "plugin/xdp/hal_profile.h"
 #include "plugin/xdp/hal_api_interface.h"
@@ -54,6 +56,7 @@
 #include <cstdarg>
 #include <cerrno>
 #include <condition_variable>
+#include <mutex>
 
 #include <unistd.h>
 #include <poll.h>
@@ -63,6 +66,7 @@
 #include <sys/uio.h>
 #include <sys/syscall.h>
 #include <sys/file.h>
+#include <sys/eventfd.h>
 #include <linux/aio_abi.h>
 #include <asm/mman.h>
 
@@ -136,12 +140,15 @@ namespace xocl {
  * Configuration:
  * - qAioEn:		per queue aio context enabled or not
  * - qAioCtx:		per queue aio context, valid only if qAioEn = true
+ * - qEventFd:		eventfd signaled on completion in qAioCtx, used to
+ * 			wait for completions on a set of queues
  * - set_option():	optional configurations for aio context and batching
  *
  * i/o data path:
  * - queue_submit_io(): format & submit i/o to the kernel driver
  * - queue_poll_completion(): polliing for completion event for asynchronously
  * 			submitted i/o requests, valid only if qAioEn = true
+ * - queue_reap_completion(): non-blocking version of queue_poll_completion()
  */
 
 class queue_cb {
@@ -175,8 +182,10 @@ private:
     int cbErrCode;		/* submission error code */
 
     aio_context_t qAioCtx;	/* per queue aio context */
+    int qEventFd;		/* completion notification for qAioCtx */
 
     std::thread qWorker;	/* aio batching thread */
+    const xrt_core::device *qDevice; /* device for placement of qWorker */
     std::mutex reqLock;		/* lock to protect i/o related info. */
     std::list<struct queued_io> reqList; /* queued up i/o request */
     std::condition_variable cv; /* for wait/wake up the batching thread */
@@ -272,6 +281,27 @@ private:
             cb->aio_offset = 0;
             cb->aio_nbytes = 2;
             cb->aio_data = priv_data;
+            if (qAioEn && qEventFd >= 0) {
+                cb->aio_flags = IOCB_FLAG_RESFD;
+                cb->aio_resfd = qEventFd;
+            }
+        }
+    }
+
+    /* convert io_event returned by io_getevents in place */
+    static void convert_completion(int num_evt, struct xclReqCompletion *comps)
+    {
+        /* io_event is smaller than xclReqCompletion, convert from the end */
+        for (int i = num_evt - 1; i >= 0; i--) {
+            comps[i].priv_data = (void *)((struct io_event *)comps)[i].data;
+            if (((struct io_event *)comps)[i].res < 0){
+                /* error returned by AIO framework */
+                comps[i].nbytes = 0;
+                comps[i].err_code = ((struct io_event *)comps)[i].res;
+            } else {
+                comps[i].nbytes = ((struct io_event *)comps)[i].res;
+                comps[i].err_code = ((struct io_event *)comps)[i].res2;
+            }
         }
     }
 
@@ -357,17 +387,19 @@ private:
         if (qAioEn && (byteThresh || pktThresh) && !qAioBatchEn) {
             std::lock_guard<std::mutex> lk(reqLock);
             qExit = false;
-            qWorker = std::thread(&queue_cb::queue_aio_worker, this);
+            qWorker = xrt_core::role_thread(xrt_core::thread_role::completion, qDevice,
+                                            &queue_cb::queue_aio_worker, this);
             qAioBatchEn = true;
         }
     }
 
 public:
-    queue_cb(struct xocl_qdma_ioc_create_queue *qinfo)
+    queue_cb(struct xocl_qdma_ioc_create_queue *qinfo, const xrt_core::device *device)
         : qAioEn{false}, qAioBatchEn{false}, qExit{false},
           h2c{qinfo->write ? true : false}, qhndl{qinfo->handle},
           aio_max_evts{0}, byteThresh{0}, pktThresh{0}, byteCnt{0}, bufCnt{0},
-          cbSubmitCnt{0}, cbPollCnt{0}, cbErrCnt{0}, cbErrCode{0}
+          cbSubmitCnt{0}, cbPollCnt{0}, cbErrCnt{0}, cbErrCode{0},
+          qEventFd{-1}, qDevice{device}
     {
        memset(&qAioCtx, 0, sizeof(qAioCtx));
     }
@@ -379,9 +411,12 @@ public:
 
         stop_aio_worker();
         io_destroy(qAioCtx);
+        if (qEventFd >= 0)
+            close(qEventFd);
     }
 
     const bool queue_aio_ctx_enabled(void) { return qAioEn; }
+    const int queue_event_fd(void) { return qEventFd; }
     const bool queue_is_h2c(void) { return h2c; }
     const int queue_get_handle(void) { return qhndl; }
 
@@ -397,6 +432,9 @@ public:
 		if (!rc) {
 		     qAioEn = true;
                      aio_max_evts = val;
+                     /* reuse the eventfd of an earlier setup of the queue */
+                     if (qEventFd < 0)
+                         qEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
                 }
                 return rc;
 	    }
@@ -445,17 +483,7 @@ public:
 
         cbPollCnt += rc;
         num_evt = rc;
-        for (int i = num_evt - 1; i >= 0; i--) {
-            comps[i].priv_data = (void *)((struct io_event *)comps)[i].data;
-            if (((struct io_event *)comps)[i].res < 0){
-                /* error returned by AIO framework */
-                comps[i].nbytes = 0;
-                comps[i].err_code = ((struct io_event *)comps)[i].res;
-            } else {
-                comps[i].nbytes = ((struct io_event *)comps)[i].res;
-                comps[i].err_code = ((struct io_event *)comps)[i].res2;
-            }
-        }
+        convert_completion(num_evt, comps);
 
         if (rc < min_compl && qAioBatchEn) {
              /* timeout happened, check if there is any io submission errors */
@@ -467,6 +495,30 @@ public:
         return 0;
     }
 
+    // get already completed aio events of the queue without waiting
+    int queue_reap_completion(int max_compl, struct xclReqCompletion *comps)
+    {
+        struct timespec time = {0, 0};
+
+        /* clear pending notification before reaping, a completion that
+         * races with the reap leaves the eventfd signaled */
+        uint64_t cnt;
+        if (qEventFd >= 0)
+            (void) read(qEventFd, &cnt, sizeof(cnt));
+
+        int rc = io_getevents(qAioCtx, 0, max_compl, (struct io_event *)comps, &time);
+        if (rc < 0)
+            return rc;
+
+        cbPollCnt += rc;
+        convert_completion(rc, comps);
+
+        if (rc < max_compl && qAioBatchEn)
+            rc += check_io_submission_error(max_compl - rc, comps + rc);
+
+        return rc;
+    }
+
     // submit the read/write i/o to the queue
     ssize_t queue_submit_io(xclQueueRequest *wr, aio_context_t *mAioCtx)
     {
@@ -1312,6 +1364,11 @@ int shim::xclLoadXclBin(const xclBin *buffer)
 {
     auto top = reinterpret_cast<const axlf*>(buffer);
     auto ret = xclLoadAxlf(top);
+    {
+      // ERT is reconfigured, re-read its CU shadow setting on next write
+      std::lock_guard<std::mutex> l(mCuMapLock);
+      mCuShadow = -1;
+    }
     if (ret != 0) {
       if (ret == -EOPNOTSUPP) {
         xrt_logmsg(XRT_ERROR, "Xclbin does not match shell on card.");
@@ -1778,7 +1835,7 @@ int shim::xclCreateWriteQueue(xclQueueContext *q_ctx, uint64_t *q_hdl)
         return -errno;
     }
 
-    queue_cb *qcb = new xocl::queue_cb(&q_info);
+    queue_cb *qcb = new xocl::queue_cb(&q_info, mCoreDevice.get());
     *q_hdl = reinterpret_cast<uint64_t>(qcb);
 
     return 0;
@@ -1803,7 +1860,7 @@ int shim::xclCreateReadQueue(xclQueueContext *q_ctx, uint64_t *q_hdl)
         return -errno;
     }
 
-    queue_cb *qcb = new xocl::queue_cb(&q_info);
+    queue_cb *qcb = new xocl::queue_cb(&q_info, mCoreDevice.get());
     *q_hdl = reinterpret_cast<uint64_t>(qcb);
 
     return 0;
@@ -1933,6 +1990,68 @@ int shim::xclPollQueue(uint64_t q_hdl, int min_compl, int max_compl, struct xclR
     return qcb->queue_poll_completion(min_compl, max_compl, comps, actual, timeout);
 }
 
+/*
+ * xclPollQueueSet()
+ *
+ * Reap completions of a set of queues with per-queue aio context
+ * straight into comps.  Wait on the queues' eventfds until min_compl
+ * completions were reaped or the timeout expires.
+ */
+int shim::xclPollQueueSet(int num_queues, const uint64_t *q_hdls, int min_compl, int max_compl,
+                          struct xclReqCompletion *comps, int* actual, int timeout /*ms*/)
+{
+    *actual = 0;
+    if (num_queues <= 0 || !q_hdls || max_compl < min_compl)
+        return -EINVAL;
+
+    std::vector<struct pollfd> fds(num_queues);
+    for (int i = 0; i < num_queues; i++) {
+        queue_cb *qcb = reinterpret_cast<queue_cb *>(q_hdls[i]);
+        if (!qcb->queue_aio_ctx_enabled() || qcb->queue_event_fd() < 0) {
+            xrt_logmsg(XRT_ERROR, "%s: per-queue AIO is not enabled", __func__);
+            return -EINVAL;
+        }
+        fds[i].fd = qcb->queue_event_fd();
+        fds[i].events = POLLIN;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    int num_evt = 0;
+    int next = 0;
+    while (true) {
+        /* start with a different queue each round so that one busy queue
+         * does not starve the others when max_compl is reached */
+        for (int n = 0; n < num_queues && num_evt < max_compl; n++) {
+            queue_cb *qcb = reinterpret_cast<queue_cb *>(q_hdls[(next + n) % num_queues]);
+            int rc = qcb->queue_reap_completion(max_compl - num_evt, comps + num_evt);
+            if (rc < 0) {
+                *actual = num_evt;
+                return rc;
+            }
+            num_evt += rc;
+        }
+        next = (next + 1) % num_queues;
+
+        if (num_evt >= min_compl)
+            break;
+
+        int wait_ms = -1;
+        if (timeout > 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>
+                (deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0)
+                break;
+            wait_ms = static_cast<int>(left);
+        }
+
+        if (poll(fds.data(), num_queues, wait_ms) < 0 && errno != EINTR)
+            return -errno;
+    }
+
+    *actual = num_evt;
+    return (num_evt >= min_compl) ? 0 : -ETIMEDOUT;
+}
+
 /*
  * xclSetQueueOpt()
  */
@@ -2212,10 +2331,24 @@ int shim::xclRegRW(bool rd, uint32_t ipIndex, uint32_t offset, uint32_t *datap)
         return -EINVAL;
     }
 
-    if (rd)
+    if (rd) {
         *datap = cumap[offset / sizeof(uint32_t)];
-    else
-        cumap[offset / sizeof(uint32_t)] = *datap;
+        return 0;
+    }
+
+    cumap[offset / sizeof(uint32_t)] = *datap;
+
+    // ERT skips unchanged argument registers when its CU register
+    // shadow is enabled, so it must be told about this write
+    if (offset >= 0x10) {
+        if (mCuShadow < 0) {
+            uint32_t enabled = 0;
+            mDev->sysfs_get<uint32_t>("ert_user", "ert_cu_shadow", errmsg, enabled, 0);
+            mCuShadow = (errmsg.empty() && enabled) ? 1 : 0;
+        }
+        if (mCuShadow)
+            mDev->sysfs_put("ert_user", "ert_cu_shadow_invalidate", errmsg, std::to_string(ipIndex));
+    }
     return 0;
 }
 
@@ -2348,14 +2481,25 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
 {
   LOAD_XCLBIN_CB ;
 
+  // xclbins can be loaded on several devices concurrently, but the
+  // profiling plugins keep process wide state that is not thread
+  // safe, so only the download itself runs in parallel
+  static std::mutex profile_mutex;
+
   try {
     xocl::shim *drv = xocl::shim::handleCheck(handle);
     if (!drv) {
         return -EINVAL;
     }
 
-    xdp::hal::flush_device(handle) ;
-    xdp::aie::flush_device(handle) ;
+    {
+      std::lock_guard<std::mutex> lk(profile_mutex);
+      xdp::hal::flush_device(handle) ;
+      xdp::aie::flush_device(handle) ;
+    }
+
+    // cached user memory registrations hold device memory
+    xrt_core::bo::release_userptr_cache(xrt_core::get_userpf_device(drv).get());
 
 #ifdef DISABLE_DOWNLOAD_XCLBIN
     int ret = 0;
@@ -2367,8 +2511,11 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
       auto core_device = xrt_core::get_userpf_device(drv);
       core_device->register_axlf(buffer);
 
-      xdp::hal::update_device(handle) ;
-      xdp::aie::update_device(handle);
+      {
+        std::lock_guard<std::mutex> lk(profile_mutex);
+        xdp::hal::update_device(handle) ;
+        xdp::aie::update_device(handle);
+      }
 
 #ifndef DISABLE_DOWNLOAD_XCLBIN
       //scheduler::init can not be skipped even for same_xclbin
@@ -2378,7 +2525,10 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
       //along with icap download in single command call and then below init step in user space
       //is ignored
       ret = xrt_core::scheduler::init(handle, buffer);
-      START_DEVICE_PROFILING_CB(handle);
+      {
+        std::lock_guard<std::mutex> lk(profile_mutex);
+        START_DEVICE_PROFILING_CB(handle);
+      }
 #endif
     }
     return ret;
@@ -2757,6 +2907,12 @@ int xclPollQueue(xclDeviceHandle handle, uint64_t q_hdl, int min_compl, int max_
         return drv ? drv->xclPollQueue(q_hdl, min_compl, max_compl, comps, actual, timeout) : -ENODEV;
 }
 
+int xclPollQueueSet(xclDeviceHandle handle, int num_queues, const uint64_t *q_hdls, int min_compl, int max_compl, xclReqCompletion *comps, int* actual, int timeout)
+{
+        xocl::shim *drv = xocl::shim::handleCheck(handle);
+        return drv ? drv->xclPollQueueSet(num_queues, q_hdls, min_compl, max_compl, comps, actual, timeout) : -ENODEV;
+}
+
 int xclPollCompletion(xclDeviceHandle handle, int min_compl, int max_compl, xclReqCompletion *comps, int* actual, int timeout)
 {
   try {
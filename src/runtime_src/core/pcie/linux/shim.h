@@ -143,6 +143,7 @@ public:
     int xclExecBuf(unsigned int cmdBO,size_t numdeps, unsigned int* bo_wait_list);
     int xclRegisterEventNotify(unsigned int userInterrupt, int fd);
     int xclExecWait(int timeoutMilliSec);
+    int getExecWaitFd() const { return mUserHandle; }
     int xclOpenContext(const uuid_t xclbinId, unsigned int ipIndex, bool shared) const;
     int xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex);
 
@@ -157,6 +158,7 @@ public:
     ssize_t xclWriteQueue(uint64_t q_hdl, xclQueueRequest *wr);
     ssize_t xclReadQueue(uint64_t q_hdl, xclQueueRequest *wr);
     int xclPollQueue(uint64_t q_hdl, int min_compl, int max_compl, xclReqCompletion *comps, int * actual, int timeout /*ms*/);
+    int xclPollQueueSet(int num_queues, const uint64_t *q_hdls, int min_compl, int max_compl, xclReqCompletion *comps, int * actual, int timeout /*ms*/);
     int xclSetQueueOpt(uint64_t q_hdl, int type, uint32_t val);
     int xclPollCompletion(int min_compl, int max_compl, xclReqCompletion *comps, int * actual, int timeout /*ms*/);
     int xclIPName2Index(const char *name);
@@ -184,6 +186,12 @@ private:
     std::vector<std::pair<uint32_t*, uint32_t>> mCuMaps;
     std::mutex mCuMapLock;
 
+    /*
+     * ERT CU register shadow is enabled, -1 if not known.  Direct
+     * writes of CU argument registers must invalidate the shadow.
+     */
+    int mCuShadow = -1;
+
     bool zeroOutDDR();
     bool isXPR() const {
         return ((mDeviceInfo.mSubsystemId >> 12) == 4);
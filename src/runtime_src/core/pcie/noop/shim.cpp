@@ -24,10 +24,18 @@
 #include "core/common/task.h"
 #include "core/common/thread.h"
 
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace { // private implementation details
 
@@ -36,23 +44,68 @@ namespace buffer {
 struct bo
 {
   void* hbuf = nullptr;
-  void* own = nullptr;
-  void* dbuf = reinterpret_cast<void*>(0xdeadbeef);
+  void* dbuf = nullptr;   // fake device address, see address()
   size_t size = 0;
   unsigned int flags = 0;
+  int fd = -1;          // memfd standing in for dma-buf, -1 for user ptr bo
 
   bo(void* uptr, size_t bytes, unsigned int flgs)
     : hbuf(uptr), size(bytes), flags(flgs)
   {}
 
+  // Host backing is a memfd so that the bo can be shared with other
+  // processes the way a dma-buf is shared.  The backing is created
+  // up front because the host buffer may be mapped by clients before
+  // the bo is exported, so it must not move.
   bo(size_t bytes, unsigned int flgs)
-    : hbuf(malloc(bytes)), own(hbuf), size(bytes), flags(flgs)
+    : size(bytes), flags(flgs)
   {
-    std::memset(hbuf, 0, size);
+    fd = memfd_create("xrt_noop_bo", MFD_CLOEXEC);
+    if (fd < 0)
+      throw std::runtime_error("memfd_create failed: " + std::string(strerror(errno)));
+    if (ftruncate(fd, size)) {
+      close(fd);
+      throw std::runtime_error("ftruncate failed: " + std::string(strerror(errno)));
+    }
+    try {
+      map();
+    }
+    catch (...) {
+      close(fd);
+      throw;
+    }
+  }
+
+  // bo imported from fd
+  bo(int memfd, size_t bytes)
+    : size(bytes), fd(memfd)
+  {
+    map();
   }
 
   ~bo()
-  { if (own) free(own); }
+  {
+    if (fd < 0)
+      return;
+    munmap(hbuf, size);
+    close(fd);
+  }
+
+  void
+  map()
+  {
+    hbuf = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hbuf == MAP_FAILED)
+      throw std::runtime_error("failed to map bo: " + std::string(strerror(errno)));
+  }
+
+  int
+  share() const
+  {
+    if (fd < 0)
+      throw std::runtime_error("cannot export user ptr bo");
+    return fd;
+  }
 };
 
 static std::mutex mutex;
@@ -76,20 +129,76 @@ get(unsigned int handle)
   return (*itr).second.get();
 }
 
+// Each bo gets a 4GB window of fake device address space so that
+// the bo of a device address is known from the address
+constexpr unsigned int address_shift = 32;
+
+void*
+address(unsigned int handle)
+{
+  return reinterpret_cast<void*>(static_cast<uint64_t>(handle + 1) << address_shift);
+}
+
 unsigned int
-alloc(size_t size, unsigned int flags)
+insert(std::unique_ptr<bo> bo)
 {
   std::lock_guard<std::mutex> lk(mutex);
-  h2b.insert(std::make_pair(handle, std::make_unique<bo>(size, flags)));
+  bo->dbuf = address(handle);
+  h2b.insert(std::make_pair(handle, std::move(bo)));
   return handle++;
 }
 
+unsigned int
+alloc(size_t size, unsigned int flags)
+{
+  return insert(std::make_unique<bo>(size, flags));
+}
+
 unsigned int
 alloc(void* uptr, size_t size, unsigned int flags)
 {
+  return insert(std::make_unique<bo>(uptr, size, flags));
+}
+
+// Device memory of a noop bo is its host buffer, sync is a no-op
+char*
+device_to_host(uint64_t addr, size_t size)
+{
+  auto handle = static_cast<unsigned int>(addr >> address_shift) - 1;
+  auto offset = addr & ((1ULL << address_shift) - 1);
+  auto bo = get(handle);
+  if (offset + size > bo->size)
+    throw std::runtime_error("device address range out of bo bounds");
+  return static_cast<char*>(bo->hbuf) + offset;
+}
+
+// Each export returns a new fd like DRM_IOCTL_PRIME_HANDLE_TO_FD
+int
+export_bo(unsigned int handle)
+{
+  auto bo = get(handle);
   std::lock_guard<std::mutex> lk(mutex);
-  h2b.insert(std::make_pair(handle, std::make_unique<bo>(uptr, size, flags)));
-  return handle++;
+  return dup(bo->share());
+}
+
+unsigned int
+import_bo(int fd)
+{
+  struct stat st;
+  if (fstat(fd, &st))
+    throw std::runtime_error("cannot stat exported bo: " + std::string(strerror(errno)));
+  auto memfd = dup(fd);
+  if (memfd < 0)
+    throw std::runtime_error("dup failed: " + std::string(strerror(errno)));
+  std::unique_ptr<bo> ibo;
+  try {
+    ibo = std::make_unique<bo>(memfd, st.st_size);
+  }
+  catch (...) {
+    close(memfd);
+    throw;
+  }
+  return insert(std::move(ibo));
 }
 
 void*
@@ -214,6 +323,11 @@ struct shim
   buffer_handle_type
   alloc_user_ptr_bo(void* userptr, size_t size, unsigned int flags)
   {
+    static auto pin_ns = xrt_core::config::get_noop_userptr_pin_ns_per_page();
+    if (pin_ns) {
+      auto pages = (size + getpagesize() - 1) / getpagesize();
+      std::this_thread::sleep_for(std::chrono::nanoseconds(pages * pin_ns));
+    }
     return buffer::alloc(userptr, size, flags);
   }
 
@@ -282,6 +396,8 @@ struct shim
   int
   load_xclbin(const struct axlf*)
   {
+    if (auto delay = xrt_core::config::get_noop_load_xclbin_delay_ms())
+      std::this_thread::sleep_for(std::chrono::milliseconds(delay));
     return 0;
   }
 
@@ -297,16 +413,19 @@ struct shim
     throw std::runtime_error("not implemented");
   }
 
+  // Unmanaged DMA to and from bo device addresses
   ssize_t
-  unmgd_pwrite(unsigned int, const void*, size_t, uint64_t)
+  unmgd_pwrite(unsigned int, const void* buf, size_t count, uint64_t offset)
   {
-    throw std::runtime_error("not implemented");
+    std::memcpy(buffer::device_to_host(offset, count), buf, count);
+    return 0;
   }
 
   ssize_t
-  unmgd_pread(unsigned int, void*, size_t, uint64_t)
+  unmgd_pread(unsigned int, void* buf, size_t count, uint64_t offset)
   {
-    throw std::runtime_error("not implemented");
+    std::memcpy(buf, buffer::device_to_host(offset, count), count);
+    return 0;
   }
 
   int
@@ -342,7 +461,7 @@ get_shim_object(xclDeviceHandle handle)
 unsigned int
 xclProbe()
 {
-  return 1;
+  return xrt_core::config::get_noop_devices();
 }
 
 xclDeviceHandle
@@ -495,16 +614,28 @@ xclBufferExportHandle
 xclExportBO(xclDeviceHandle handle, xclBufferHandle boHandle)
 {
   xrt_core::message::
-    send(xrt_core::message::severity_level::debug, "XRT", "xclExportBO() NOT IMPLEMENTED");
-  return XRT_NULL_BO_EXPORT;
+    send(xrt_core::message::severity_level::debug, "XRT", "xclExportBO()");
+  try {
+    return buffer::export_bo(boHandle);
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+    return XRT_NULL_BO_EXPORT;
+  }
 }
 
 xclBufferHandle
 xclImportBO(xclDeviceHandle handle, xclBufferExportHandle fd, unsigned flags)
 {
   xrt_core::message::
-    send(xrt_core::message::severity_level::debug, "XRT", "xclImportBO() NOT IMPLEMENTED");
-  return XRT_NULL_BO_EXPORT;
+    send(xrt_core::message::severity_level::debug, "XRT", "xclImportBO()");
+  try {
+    return buffer::import_bo(fd);
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+    return XRT_NULL_BO;
+  }
 }
 
 int
@@ -577,8 +708,14 @@ xclUnmgdPwrite(xclDeviceHandle handle, unsigned int flags, const void *buf, size
 {
   xrt_core::message::
     send(xrt_core::message::severity_level::debug, "XRT", "xclUnmgdPwrite()");
-  auto shim = get_shim_object(handle);
-  return shim->unmgd_pwrite(flags, buf, count, offset) ? 0 : 1;
+  try {
+    auto shim = get_shim_object(handle);
+    return shim->unmgd_pwrite(flags, buf, count, offset);
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+    return -EINVAL;
+  }
 }
 
 ssize_t
@@ -586,8 +723,14 @@ xclUnmgdPread(xclDeviceHandle handle, unsigned int flags, void *buf, size_t coun
 {
   xrt_core::message::
     send(xrt_core::message::severity_level::debug, "XRT", "xclUnmgdPread()");
-  auto shim = get_shim_object(handle);
-  return shim->unmgd_pread(flags, buf, count, offset) ? 0 : 1;
+  try {
+    auto shim = get_shim_object(handle);
+    return shim->unmgd_pread(flags, buf, count, offset);
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+    return -EINVAL;
+  }
 }
 
 size_t xclWriteBO(xclDeviceHandle handle, xclBufferHandle boHandle, const void *src, size_t size, size_t seek)
@@ -17,6 +17,7 @@
 #include "system_noop.h"
 #include "device_noop.h"
 #include "xrt.h"
+#include "core/common/config_reader.h"
 
 #include <memory>
 
@@ -52,7 +53,10 @@ std::pair<device::id_type, device::id_type>
 system::
 get_total_devices(bool is_user) const
 {
-  return {0,0};
+  if (!is_user)
+    return {0,0};
+  auto devices = xrt_core::config::get_noop_devices();
+  return {devices,devices};
 }
 
 std::shared_ptr<xrt_core::device>
@@ -202,6 +202,7 @@ static value_type cdma_enabled              = 0;
 static value_type dataflow_enabled          = 0;
 static value_type kds_30                    = 0;
 static value_type echo                      = 0;
+static value_type cu_shadow_enabled         = 0;
 
 // Struct slot_info is per command slot in command queue
 struct slot_info
@@ -250,6 +251,54 @@ static bitset_type slot_submitted;
 
 // Bitmask for interrupt enabled CUs.  (0) no interrupt (1) enabled
 static bitset_type cu_interrupt_mask;
+
+// Work list of slots with pending work, i.e. slots that are not free
+// and must be visited by the scheduler loop.  Owned by scheduler loop,
+// bits of slots freed by the interrupt handler are cleared lazily.
+static bitmask_type slot_work[4];
+
+// Slots transitioned to new by interrupt handler, merged into
+// slot_work by the scheduler loop with interrupts disabled.
+static volatile bitmask_type slot_new[4];
+
+////////////////////////////////////////////////////////////////
+// CU register shadow
+//
+// When enabled (configure feature cu_shadow), ERT keeps a copy of the
+// argument words last written to each CU and only writes the words
+// that differ from the new register map.  The shadow covers the first
+// max_shadow_words argument words (past the 4 control words) of the
+// first max_shadow_cus CUs.  Words outside the shadow are always
+// written.
+//
+// The configure command carries per CU a mask of the argument words
+// that only host writes.  Words the CU itself writes, e.g. output
+// scalars, are not in the mask and are never shadowed.
+//
+// The shadow is invalidated on (re)configuration, for a CU configured
+// by CUDMA since the DMA engine bypasses MB, and when a start command
+// has the shadow_invalidate header bit set because host has written
+// the CU registers directly (xclRegWrite).
+////////////////////////////////////////////////////////////////
+#ifdef ERT_VERBOSE
+const  size_type max_shadow_cus             = 8;
+const  size_type max_shadow_words           = 16;
+#else
+const  size_type max_shadow_cus             = 32;
+const  size_type max_shadow_words           = 32;
+#endif
+
+// Fixed sized map from cu_idx -> argument words last written to CU
+static value_type cu_shadow[max_shadow_cus][max_shadow_words];
+
+// Fixed sized map from cu_idx -> mask of valid words in cu_shadow
+static value_type cu_shadow_valid[max_shadow_cus];
+
+// Fixed sized map from cu_idx -> mask of words that may be shadowed
+static value_type cu_shadow_mask[max_shadow_cus];
+
+// ert_start_kernel_cmd header bit shadow_invalidate
+const  value_type shadow_invalidate_mask    = 0x20;
 #ifndef ERT_HW_EMU
 /**
  * Utility to read a 32 bit value from any axi-lite peripheral
@@ -377,6 +426,15 @@ idx_to_mask(size_type idx, size_type mask_idx)
     : 0;
 }
 
+/**
+ * first_set() - Index of least significant set bit in non-zero mask
+ */
+inline size_type
+first_set(bitmask_type mask)
+{
+  return __builtin_ctz(mask);
+}
+
 // scope guard for disabling interrupts
 struct disable_interrupt_guard
 {
@@ -455,6 +513,7 @@ setup()
   CTRL_DEBUGF("cq_int_enabled=%d\n",cq_status_enabled);
   CTRL_DEBUGF("mb_host_int_enabled=%d\n",mb_host_interrupt_enabled);
   CTRL_DEBUGF("dataflow_enabled=%d\n",dataflow_enabled);
+  CTRL_DEBUGF("cu_shadow_enabled=%d\n",cu_shadow_enabled);
 
   // Initialize command slots
   for (size_type i=0; i<num_slots; ++i) {
@@ -477,6 +536,16 @@ setup()
   cu_status.reset();
   slot_submitted.reset();
 
+  // Clear work lists
+  for (size_type i=0; i<4; ++i) {
+    slot_work[i] = 0;
+    slot_new[i] = 0;
+  }
+
+  // Invalidate CU register shadows
+  for (size_type i=0; i<max_shadow_cus; ++i)
+    cu_shadow_valid[i] = 0;
+
   // Initialize cu_slot_usage
   for (size_type i=0; i<num_cus; ++i) {
     cu_slot_usage[i] = no_index;
@@ -560,7 +629,8 @@ setup()
 
   // Enable interrupts from host to MB when new commands are ready
   // When enabled, MB will read CQ_STATUS_REGISTER(s) to determine new
-  // command slots.
+  // command slots.  Without interrupts, the free slots are polled by
+  // the scheduler loop.
   if (cq_status_enabled) {
     write_reg(ERT_CQ_STATUS_ENABLE_ADDR,1);   // enable feature
     intc_ier_mask |= 0x1;                     // acccept interrupts on bit 0 of the ier of intc
@@ -587,6 +657,15 @@ setup()
   CTRL_DEBUG("<- setup\n");
 }
 
+/**
+ * Slots other than slot (0) map to CUs in dataflow mode
+ */
+inline bool
+is_dataflow_slot(size_type slot_idx)
+{
+  return dataflow_enabled && slot_idx>0;
+}
+
 /**
  * Associate CUs with a command slot
  */
@@ -618,13 +697,80 @@ notify_host(size_type cmd_idx)
 #endif
 }
 
+/**
+ * Invalidate the register shadow of a CU
+ *
+ * Must be called when CU registers are written by other than
+ * configure_cu or configure_cu_ooo.
+ */
+inline void
+shadow_invalidate(size_type cu_idx)
+{
+  if (cu_idx < max_shadow_cus)
+    cu_shadow_valid[cu_idx] = 0;
+}
+
+/**
+ * Invalidate the register shadow of a CU if host requests it
+ *
+ * @param slot_idx
+ *  Index of start command about to configure its CU
+ */
+inline void
+shadow_check_invalidate(size_type slot_idx)
+{
+  auto& slot = command_slots[slot_idx];
+  if (slot.header_value & shadow_invalidate_mask)
+    shadow_invalidate(slot.cu_idx);
+}
+
+/**
+ * Check and update the register shadow of a CU
+ *
+ * @param cu_idx
+ *  Index of CU to be written
+ * @param offset
+ *  Byte offset of register in CU address space
+ * @param value
+ *  The value that is to be written to register at offset
+ * @return
+ *  True if the CU register is known to hold value already, in
+ *  which case the register write can be skipped, false otherwise
+ *
+ * A word becomes valid in the shadow when written, so that words
+ * never written are never skipped.  Words not in the shadow mask of
+ * the CU are always written.
+ */
+inline bool
+shadow_match(size_type cu_idx, addr_type offset, value_type value)
+{
+  if (!cu_shadow_enabled || cu_idx >= max_shadow_cus || offset < 0x10 || (offset & 0x3))
+    return false;
+
+  size_type sidx = (offset >> 2) - 4;
+  if (sidx >= max_shadow_words)
+    return false;
+
+  value_type bit = 1u << sidx;
+  if (!(cu_shadow_mask[cu_idx] & bit))
+    return false;
+
+  auto& word = cu_shadow[cu_idx][sidx];
+  if ((cu_shadow_valid[cu_idx] & bit) && word == value)
+    return true;
+
+  word = value;
+  cu_shadow_valid[cu_idx] |= bit;
+  return false;
+}
+
 /**
  * Configure a CU at argument address
  *
  * Write register map to CU control register at address
  *
- * @param cu_addr
- *  Address of CU control register
+ * @param cu_idx
+ *  Index of CU to configure
  * @param regmap_addr
  *  The address of the register map to copy into the CU control
  *  register
@@ -632,27 +778,40 @@ notify_host(size_type cmd_idx)
  *  The size of register map in 32 bit words
  */
 inline void
-configure_cu(addr_type cu_addr, addr_type regmap_addr, size_type regmap_size)
+configure_cu(size_type cu_idx, addr_type regmap_addr, size_type regmap_size)
 {
+  addr_type cu_addr = cu_idx_to_addr(cu_idx);
+
   // write register map, starting at base + 0x10
   // 0x4, 0x8, 0xc used for interrupt, which is initialized in setup
-  for (size_type idx = 4; idx < regmap_size; ++idx)
-    write_reg(cu_addr + (idx << 2), read_reg(regmap_addr + (idx << 2)));
+  for (size_type idx = 4; idx < regmap_size; ++idx) {
+    value_type value = read_reg(regmap_addr + (idx << 2));
+    if (shadow_match(cu_idx, idx << 2, value))
+      continue;
+    write_reg(cu_addr + (idx << 2), value);
+  }
   // start kernel at base + 0x0
   write_reg(cu_addr, 0x1);
 }
 
 /**
  * Configure CU with address value pairs (out-of-order)
+ *
+ * This is also the delta encoding of a start command where host
+ * sends only the registers that changed since the previous start.
  */
 inline void
-configure_cu_ooo(addr_type cu_addr, addr_type regmap_addr, size_type regmap_size)
+configure_cu_ooo(size_type cu_idx, addr_type regmap_addr, size_type regmap_size)
 {
+  addr_type cu_addr = cu_idx_to_addr(cu_idx);
+
   // write register map addr, value pairs starting 
   // past reserved 4 ctrl + 2 ctx 
   for (size_type idx = 6; idx < regmap_size; idx += 2) {
     addr_type offset = read_reg(regmap_addr + (idx << 2));
     value_type value = read_reg(regmap_addr + ((idx + 1) << 2));
+    if (shadow_match(cu_idx, offset, value))
+      continue;
     write_reg(cu_addr + offset, value);
   }
 
@@ -676,6 +835,9 @@ configure_cu_ooo(addr_type cu_addr, addr_type regmap_addr, size_type regmap_size
 inline void
 configure_cu_dma(size_type cu_idx, size_type slot_idx, addr_type slot_addr)
 {
+  // CUDMA writes the CU registers behind the back of MB
+  shadow_invalidate(cu_idx);
+
   if (cu_dma_52) {
     // Write cu address to command queue slot.  This is used by DMA engine
     ERT_DEBUGF("writing cu_addr(0x%x) to slot cu_mask at address 0x%x\n",cu_idx_to_addr(cu_idx),cu_section_addr(slot_addr));
@@ -723,16 +885,18 @@ start_cu(size_type slot_idx)
   ERT_DEBUGF("start_cu cu(%d) for slot_idx(%d)\n",cu_idx,slot_idx);
   ERT_ASSERT(read_reg(cu_idx_to_addr(cu_idx))==AP_IDLE,"cu not ready");
 
+  shadow_check_invalidate(slot_idx);
+
   if (slot.opcode==ERT_EXEC_WRITE)
     // Out of order configuration
-    configure_cu_ooo(cu_idx_to_addr(cu_idx),slot.regmap_addr,slot.regmap_size);
+    configure_cu_ooo(cu_idx,slot.regmap_addr,slot.regmap_size);
   else if (cu_dma_enabled && (cu_dma_52 || regmap_size(slot.header_value)<(127+4)))
     // Use CUDMA and adjust for 5.1 DSAs that have a bug and supports
     // at most 127 word copy excluding the 4 control words
     configure_cu_dma(cu_idx,slot_idx,slot.slot_addr);
   else
     // manually configure and start cu
-    configure_cu(cu_idx_to_addr(cu_idx),slot.regmap_addr,slot.regmap_size);
+    configure_cu(cu_idx,slot.regmap_addr,slot.regmap_size);
   
   cu_status[cu_idx] = !cu_status[cu_idx];     // toggle cu status bit, it is now busy
   set_cu_info(cu_idx,slot_idx); // record which slot cu associated with
@@ -837,6 +1001,7 @@ configure_mb(size_type slot_idx)
   dataflow_enabled = (features & 0x40)!=0;
   kds_30 = (features & 0x100)!=0;
   echo = (features & 0x400)!=0;
+  cu_shadow_enabled = (features & 0x1000)!=0;
 #ifndef ERT_HW_EMU
   cu_dma_52 = (features & 0x80000000)!=0;
 #else
@@ -850,6 +1015,10 @@ configure_mb(size_type slot_idx)
     CTRL_DEBUGF("cu(%d) addr(0x%x) handshake(0x%x) encodedaddr(0x%x)\n", i, CU_ADDR(addr), CU_HANDSHAKE(addr), addr);
   }
 
+  // CU shadow masks follow the CU base addresses
+  for (size_type i=0; i<max_shadow_cus; ++i)
+    cu_shadow_mask[i] = (cu_shadow_enabled && i<num_cus) ? read_reg(slot.slot_addr + 0x18 + ((num_cus+i)<<2)) : 0;
+
   // (Re)initilize MB
   setup();
 
@@ -1164,10 +1333,11 @@ cu_execution(size_type slot_idx)
   if (!cu_status[slot.cu_idx]) {
     if (slot_cache[slot_idx] & AP_START) {
 
+      shadow_check_invalidate(slot_idx);
       if (slot.opcode==ERT_EXEC_WRITE) // Out of order configuration
-        configure_cu_ooo(cu_idx_to_addr(slot.cu_idx),slot.regmap_addr,slot.regmap_size);
+        configure_cu_ooo(slot.cu_idx,slot.regmap_addr,slot.regmap_size);
       else
-        configure_cu(cu_idx_to_addr(slot.cu_idx),slot.regmap_addr,slot.regmap_size);
+        configure_cu(slot.cu_idx,slot.regmap_addr,slot.regmap_size);
 
       cu_status[slot.cu_idx] = !cu_status[slot.cu_idx];
       set_cu_info(slot.cu_idx,slot_idx); // record which slot cu associated with
@@ -1176,18 +1346,177 @@ cu_execution(size_type slot_idx)
   }
 }
 /**
- * Main routine executed by embedded scheduler loop
+ * Poll CU associated with slot in dataflow mode
  *
- * For each command slot do
- *  1. If status is free (0x4), then read new command header
- *     Status remains free (0x4), or transitions to new (0x1)
- *  2. If status is new (0x1), then read CUs in command
+ * In dataflow mode ERT is polling CUs for completion after host has
+ * started CU or acknowleged completion.  Slot (0) is reserved for
+ * ctrl commands, which are processed in normal flow.  With cq
+ * interrupts, the slot is read only after host has flagged it in the
+ * CQ status register, and is polled until its CU is done.
+ */
+static inline void
+dataflow_poll(size_type slot_idx)
+{
+  auto& slot = command_slots[slot_idx];
+  size_type cuidx = slot_idx-1;  // compensate for reserved slot (0)
+
+  // Check if host has started or continued this CU
+  if (!cu_status[cuidx]) {
+    auto cqvalue = read_reg(slot.slot_addr);
+    if (cqvalue & (AP_START|AP_CONTINUE)) {
+      write_reg(slot.slot_addr,0x0); // clear
+      ERT_DEBUGF("enable cu(%d) cqvalue(0x%x)\n",cuidx,cqvalue);
+      cu_status[cuidx] = !cu_status[cuidx]; // enable polling of this CU
+    }
+  }
+
+  if (!cu_status[cuidx])
+    return; // CU is not used
+
+  /* For dataflow kernel, KDS and ERT will check the CUs from both sides.
+   * It's likely that ERT checks the CUs after the CUs are completed by KDS.
+   * So here ERT should check both AP_DONE and AP_IDLE bits or ERT will keep
+   * polling CU status register and never get AP_DONE. It may cause firewall
+   * tripped if we freeze the axi gate of the dynamic region.
+   *
+   * For some CUs have no cmd to execute but AP_IDLE remain 0x0
+   * We should turn off ert and let KDS be in charge of this alone
+   */
+  auto cuvalue = read_reg(cu_idx_to_addr(cuidx));
+  if (!(cuvalue & (AP_DONE|AP_IDLE)))
+    return;
+
+  cu_status[cuidx] = !cu_status[cuidx]; // disable polling until host re-enables
+  ERT_DEBUGF("polled cu(%d) cuvalue(0x%x)\n",cuidx,cuvalue);
+
+  // wake up host
+  notify_host(slot_idx);
+}
+
+/**
+ * Process command in slot per slot state
+ *
+ *  1. If status is new (0x1), then read CUs in command
  *     Status transitions to queued (0x2)
- *  3. If status is queued (0x2), then start command on available CU
+ *  2. If status is queued (0x2), then start command on available CU
  *     Status remains queued if no CUs available, or transitions to running (0x3)
- *  4. If status is running (0x4), then check CU status
- *     Status remains running (0x4) if CU is still running, or
+ *  3. If status is running (0x3), then check CU status
+ *     Status remains running (0x3) if CU is still running, or
  *     transitions to free if CU is done
+ *
+ * In dataflow mode slot (0) is processed as above, while the other
+ * slots map to CUs.  In kds 3.0 dataflow mode, the command cached
+ * from the slot is started when its CU is available.  In kds 2.0
+ * dataflow mode, the CU of the slot is polled (dataflow_poll) until
+ * it is done.
+ *
+ * @return
+ *   True if slot has pending work, false if slot is free
+ */
+static inline bool
+process_slot(size_type slot_idx)
+{
+  auto& slot = command_slots[slot_idx];
+
+  if (is_dataflow_slot(slot_idx)) {
+    if (!kds_30) {
+      dataflow_poll(slot_idx);
+      return cu_status[slot_idx-1];
+    }
+
+    if (!slot_cache[slot_idx])
+      command_queue_fetch(slot_idx);
+
+    // we have nothing else to do
+    if (!slot_cache[slot_idx])
+      return false;
+
+    cu_state_check(slot_idx);
+    cu_execution(slot_idx);
+    return slot_cache[slot_idx] != 0;
+  }
+
+  if ((slot.header_value & 0xF) == 0x1) { // new
+    if (!new_to_queued(slot_idx))
+      return (slot.header_value & 0xF) != 0x4;
+  }
+
+  if ((slot.header_value & 0xF) == 0x2) { // queued
+    if (!queued_to_running(slot_idx))
+      return true;
+  }
+
+  if (!cu_interrupt_enabled && ((slot.header_value & 0xF) == 0x3)) { // running
+    if (!running_to_free(slot_idx))
+      return true;
+  }
+
+  // slot can be freed asynchronously by interrupt handler
+  return (slot.header_value & 0xF) != 0x4;
+}
+
+/**
+ * Add slot to slot work list if it has a new command
+ */
+static inline void
+gather_slot(size_type slot_idx, size_type w)
+{
+  if (is_dataflow_slot(slot_idx)) {
+    // kds 2.0 CU slot is polled by dataflow_poll every iteration
+    if (kds_30 && !slot_cache[slot_idx])
+      command_queue_fetch(slot_idx);
+    if (!kds_30 || slot_cache[slot_idx])
+      slot_work[w] |= idx_to_mask(slot_idx,w);
+    return;
+  }
+
+  if ((command_slots[slot_idx].header_value & 0xF) == 0x4 && free_to_new(slot_idx))
+    slot_work[w] |= idx_to_mask(slot_idx,w);
+}
+
+/**
+ * Add slots with new commands to slot work list
+ *
+ * With cq interrupts enabled, host writes the slot mask of a new
+ * command to CQ_STATUS_REGISTER and the interrupt handler has already
+ * transitioned the slots to new.  Dataflow slots flagged by host are
+ * added as is, their commands are fetched by process_slot.
+ * Otherwise host writes only the slot header, and the slots not in
+ * the work list are polled here.
+ */
+static inline void
+gather_new_slots()
+{
+  if (cq_status_enabled) {
+    disable_interrupt_guard guard;
+    for (size_type w=0; w<num_slot_masks; ++w) {
+      slot_work[w] |= slot_new[w];
+      slot_new[w] = 0;
+    }
+    return;
+  }
+
+  for (size_type w=0,offset=0; w<num_slot_masks; ++w,offset+=32) {
+    size_type end = (offset+32 < num_slots) ? offset+32 : num_slots;
+    for (size_type slot_idx=offset; slot_idx<end; ++slot_idx)
+      if (!(slot_work[w] & idx_to_mask(slot_idx,w)))
+        gather_slot(slot_idx,w);
+  }
+}
+
+/**
+ * Main routine executed by embedded scheduler loop
+ *
+ * The loop visits only slots with pending work.  New commands are
+ * found from the CQ status bitmap, or by polling free slots when cq
+ * interrupts are disabled (gather_new_slots), slots with
+ * pending work are visited in order of find-first-set over the slot
+ * work list (process_slot), and are removed from the work list when
+ * free.  Processing therefore scales with active work rather than
+ * number of slots.
+ *
+ * Dataflow CU slots go through the same work list.  Without cq
+ * interrupts they are polled every iteration.
  */
 static void
 scheduler_loop()
@@ -1202,85 +1531,19 @@ scheduler_loop()
   setup();
 
   while (1) {
-    for (size_type slot_idx=0; slot_idx<num_slots; ++slot_idx) {
-      auto& slot = command_slots[slot_idx];
-
 #ifdef ERT_HW_EMU
-      reg_access_wait();
+    reg_access_wait();
 #endif
-      // In dataflow mode ERT is polling CUs for completion after
-      // host has started CU or acknowleged completion.  Ctrl cmds
-      // are processed in normal flow.
-      if (dataflow_enabled && slot_idx>0 && !kds_30) {
-        size_type cuidx = slot_idx-1;  // compensate for reserved slot (0)
-
-        // Check if host has started or continued this CU
-        if (!cu_status[cuidx]) {
-          auto cqvalue = read_reg(slot.slot_addr);
-          if (cqvalue & (AP_START|AP_CONTINUE)) {
-            write_reg(slot.slot_addr,0x0); // clear
-            ERT_DEBUGF("enable cu(%d) cqvalue(0x%x)\n",cuidx,cqvalue);
-            cu_status[cuidx] = !cu_status[cuidx]; // enable polling of this CU
-          }
-        }
-
-        if (!cu_status[cuidx])
-          continue; // CU is not used
-
-        /* For dataflow kernel, KDS and ERT will check the CUs from both sides.
-         * It's likely that ERT checks the CUs after the CUs are completed by KDS.
-         * So here ERT should check both AP_DONE and AP_IDLE bits or ERT will keep
-         * polling CU status register and never get AP_DONE. It may cause firewall
-         * tripped if we freeze the axi gate of the dynamic region.
-         *
-         * For some CUs have no cmd to execute but AP_IDLE remain 0x0
-         * We should turn off ert and let KDS be in charge of this alone
-         */
-        auto cuvalue = read_reg(cu_idx_to_addr(cuidx));
-        if (!(cuvalue & (AP_DONE|AP_IDLE)))
-          continue;
-
-        cu_status[cuidx] = !cu_status[cuidx]; // disable polling until host re-enables
-        ERT_DEBUGF("polled cu(%d) cuvalue(0x%x)\n",cuidx,cuvalue);
-
-        // wake up host
-        notify_host(slot_idx);
-        continue;
-      }
-
-      if (dataflow_enabled && slot_idx>0 && kds_30) {
-        if (!slot_cache[slot_idx])
-            command_queue_fetch(slot_idx);
-
-        // we have nothing else to do
-        if (!slot_cache[slot_idx])
-          continue;
-
-        cu_state_check(slot_idx);
-
-        cu_execution(slot_idx);
-        
-        continue;
-      }
+    gather_new_slots();
 
-      if (!cq_status_enabled && ((slot.header_value & 0xF) == 0x4)) { // free
-        if (!free_to_new(slot_idx))
-          continue;
-      }
-
-      if ((slot.header_value & 0xF) == 0x1) { // new
-        if (!new_to_queued(slot_idx))
-          continue;
-      }
-
-      if ((slot.header_value & 0xF) == 0x2) { // queued
-        if (!queued_to_running(slot_idx))
-          continue;
-      }
-
-      if (!cu_interrupt_enabled && ((slot.header_value & 0xF) == 0x3)) { // running
-        if (!running_to_free(slot_idx))
-          continue;
+    for (size_type w=0,offset=0; w<num_slot_masks; ++w,offset+=32) {
+      auto work_mask = slot_work[w];
+      while (work_mask) {
+        auto slot_idx = offset + first_set(work_mask);
+        auto mask = work_mask & -work_mask;
+        work_mask &= work_mask - 1;
+        if (!process_slot(slot_idx))
+          slot_work[w] &= ~mask;
       }
     }
   } // while
@@ -1318,10 +1581,11 @@ cu_interrupt_handler()
     for (size_type w=0,offset=0; w<num_slot_masks; ++w,offset+=32) {
       auto slot_mask = read_reg(CQ_STATUS_REGISTER_ADDR[w]);
       ERT_DEBUGF("command queue interrupt from host: 0x%x\n",slot_mask);
-      // Transition each new command into new state
+      // Transition each new command into new state, dataflow CU
+      // slots are fetched by the scheduler loop
       for (size_type slot_idx=offset; slot_mask; slot_mask >>= 1, ++slot_idx)
-        if (slot_mask & 0x1)
-          free_to_new(slot_idx);
+        if ((slot_mask & 0x1) && (is_dataflow_slot(slot_idx) || free_to_new(slot_idx)))
+          slot_new[w] |= idx_to_mask(slot_idx,w);
     }
   }
 
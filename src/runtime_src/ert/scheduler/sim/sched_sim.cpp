@@ -0,0 +1,564 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * Host build of the embedded scheduler over a simulated register space
+ *
+ * The scheduler is compiled with ERT_HW_EMU which makes it call out
+ * to read_reg(), write_reg() and reg_access_wait() defined here.  The
+ * simulated register space counts register transactions per region,
+ * models CUs that complete immediately when started, and plays the
+ * role of host by writing commands into the command queue from
+ * reg_access_wait().
+ *
+ * % make
+ * % ./sched_sim [-n <launches>] [-r <regmap words>] [-c <changed words>] [-u <cus>]
+ * % ./sched_sim -l 1
+ * % ./sched_sim -k 6 -x 7
+ *
+ * The number of register transactions per command is reported per
+ * region, and in total as a proxy for submit to completion latency
+ * since a single command is in flight at any time.  Commands are
+ * submitted to the last command queue slot.  With -l 1 the latency
+ * is reported as function of number of command queue slots.
+ *
+ * With -k the CU itself writes a register map word on completion,
+ * like an output scalar, which is excluded from the CU shadow mask
+ * host passes in the configure command.  With -x host writes a CU
+ * argument register directly every so many launches, like
+ * xclRegWrite, and sets shadow_invalidate in the next start command.
+ * The CU argument registers are verified against what host expects
+ * on every CU start and mismatches are reported as errors.
+ *
+ * The dataflow modes run kds 3.0 dataflow where each CU has its own
+ * command queue slot, without and with cq interrupts.  With cq
+ * interrupts host writes the CQ status register and the interrupt
+ * handler is called directly.  A scheduler that does not pick up a
+ * command is reported as hung.
+ */
+
+#include "core/include/ert.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern "C" void scheduler_loop();
+extern "C" void cu_interrupt_handler();
+
+namespace {
+
+using addr_type = uint32_t;
+using value_type = uint32_t;
+
+const addr_type cu_base_address = 0x01000000;
+const size_t cu_shift = 16;
+
+// HLS AXI-lite control bits
+const value_type ap_done = 0x2;
+const value_type ap_idle = 0x4;
+const value_type ap_ctrl_hs = 0x0;
+
+// Register transactions per region
+struct counters
+{
+  uint64_t cu_reads = 0;
+  uint64_t cu_writes = 0;
+  uint64_t cq_reads = 0;
+  uint64_t cq_writes = 0;
+  uint64_t csr_reads = 0;
+  uint64_t csr_writes = 0;
+
+  uint64_t
+  total() const
+  {
+    return cu_reads + cu_writes + cq_reads + cq_writes + csr_reads + csr_writes;
+  }
+
+  void
+  reset()
+  {
+    *this = counters();
+  }
+};
+
+struct done_exception {};
+
+enum class mode { full, shadow, delta, dataflow, dataflow_cqint };
+
+struct options
+{
+  size_t launches = 1000;
+  size_t regmap_words = 64;  // register map size in words including ctrl
+  size_t changed_words = 2;  // argument words changed per launch
+  size_t num_cus = 1;
+  value_type slot_size = 0x1000;
+  size_t cu_written_word = 0; // regmap word written by CU, 0 for none
+  size_t raw_write_period = 0; // launches between direct CU writes, 0 for none
+  bool latency_sweep = false;
+  mode run_mode = mode::full;
+};
+
+std::unordered_map<addr_type, value_type> regs;
+std::vector<bool> cu_started;
+counters cnt;
+options opt;
+
+// Host state
+size_t launched = 0;
+size_t completed = 0;
+bool configured = false;
+bool pending = false;
+size_t pending_slot = 0;
+size_t pending_polls = 0;
+bool hung = false;
+
+// MB state
+bool mb_interrupts = false;
+
+// Scheduler polls host this many times for a command before it is hung
+const size_t max_pending_polls = 100000;
+std::vector<std::vector<value_type>> prev_regmap;
+size_t errors = 0;
+
+inline bool
+is_cu(addr_type addr)
+{
+  return addr >= cu_base_address && addr < cu_base_address + (opt.num_cus << cu_shift);
+}
+
+inline bool
+is_cq(addr_type addr)
+{
+  return addr >= ERT_CQ_BASE_ADDR && addr < ERT_CQ_BASE_ADDR + ERT_CQ_SIZE;
+}
+
+inline bool
+is_cq_status(addr_type addr)
+{
+  return addr >= ERT_CQ_STATUS_REGISTER_ADDR0 && addr <= ERT_CQ_STATUS_REGISTER_ADDR3;
+}
+
+inline size_t
+cu_index(addr_type addr)
+{
+  return (addr - cu_base_address) >> cu_shift;
+}
+
+inline addr_type
+cu_reg(size_t cu, size_t idx)
+{
+  return cu_base_address + (cu << cu_shift) + (idx << 2);
+}
+
+// Host writes a command into slot of command queue
+void
+host_write(addr_type addr, value_type value)
+{
+  regs[addr] = value;
+}
+
+value_type
+host_read(addr_type addr)
+{
+  auto itr = regs.find(addr);
+  return itr == regs.end() ? 0 : itr->second;
+}
+
+inline bool
+is_dataflow(mode m)
+{
+  return m == mode::dataflow || m == mode::dataflow_cqint;
+}
+
+// Host always writes the CQ status register like the driver does,
+// which interrupts MB if MB has enabled interrupts
+void
+host_submit(size_t slot_idx)
+{
+  if (!mb_interrupts)
+    return;
+
+  regs[ERT_CQ_STATUS_REGISTER_ADDR0 + ((slot_idx >> 5) << 2)] |= 1u << (slot_idx & 0x1F);
+  regs[ERT_INTC_IPR_ADDR] = 0x1;
+  cu_interrupt_handler();
+  regs[ERT_INTC_IPR_ADDR] = 0;
+}
+
+void
+host_configure()
+{
+  addr_type slot = ERT_CQ_BASE_ADDR;
+  value_type features = 0x1 | 0x2; // ert, polling
+  if (opt.run_mode == mode::shadow || opt.run_mode == mode::delta)
+    features |= 0x1000;            // cu_shadow
+  if (is_dataflow(opt.run_mode))
+    features |= 0x40 | 0x100;      // dataflow, kds_30
+  if (opt.run_mode == mode::dataflow_cqint)
+    features |= 0x10;              // cq_int
+
+  host_write(slot + 0x4, opt.slot_size);
+  host_write(slot + 0x8, opt.num_cus);
+  host_write(slot + 0xC, cu_shift);
+  host_write(slot + 0x10, cu_base_address);
+  host_write(slot + 0x14, features);
+  for (size_t cu = 0; cu < opt.num_cus; ++cu)
+    host_write(slot + 0x18 + (cu << 2), (cu_base_address + (cu << cu_shift)) | ap_ctrl_hs);
+
+  value_type count = 5 + opt.num_cus;
+  if (features & 0x1000) {
+    // Shadow masks follow CU addresses, CU written word is excluded
+    value_type mask = 0xFFFFFFFF;
+    if (opt.cu_written_word && opt.cu_written_word - 4 < 32)
+      mask &= ~(1u << (opt.cu_written_word - 4));
+    for (size_t cu = 0; cu < opt.num_cus; ++cu)
+      host_write(slot + 0x18 + ((opt.num_cus + cu) << 2), mask);
+    count += opt.num_cus;
+  }
+  host_write(slot, (ERT_CTRL << 28) | (ERT_CONFIGURE << 23) | (count << 12) | ERT_CMD_STATE_NEW);
+  host_submit(0);
+}
+
+size_t
+num_slots()
+{
+  return ERT_CQ_SIZE / opt.slot_size;
+}
+
+// Argument values for launch, changed_words change with every launch
+value_type
+arg_value(size_t launch, size_t idx)
+{
+  return (idx - 4 < opt.changed_words) ? static_cast<value_type>(launch * 0x1000 + idx) : static_cast<value_type>(idx);
+}
+
+void
+host_start()
+{
+  // Use last slot, worst case for scheduler visiting slots in order.
+  // In dataflow mode CUs use the slots following ctrl slot (0).
+  size_t cu = launched % opt.num_cus;
+  size_t slot_idx = is_dataflow(opt.run_mode) ? cu + 1 : num_slots() - 1;
+  addr_type slot = ERT_CQ_BASE_ADDR + slot_idx * opt.slot_size;
+  addr_type regmap = slot + 0x8; // past header and cu mask
+  auto& prev = prev_regmap[cu];
+
+  std::vector<value_type> curr(opt.regmap_words, 0);
+  for (size_t idx = 4; idx < opt.regmap_words; ++idx)
+    curr[idx] = arg_value(launched, idx);
+
+  host_write(slot + 0x4, cu);  // cu index written by KDS
+
+  // Direct write of an argument register that does not change per
+  // launch, the shadow of the CU is stale after this
+  value_type invalidate = 0;
+  if (opt.raw_write_period && launched % opt.raw_write_period == opt.raw_write_period - 1) {
+    size_t widx = std::min(4 + opt.changed_words, opt.regmap_words - 1);
+    host_write(cu_reg(cu, widx), 0xBAD00000 | static_cast<value_type>(launched));
+    invalidate = 0x20;  // shadow_invalidate
+    prev.clear();       // delta must be against what is in the CU
+  }
+
+  value_type count = 0;
+  value_type opc = ERT_START_CU;
+  if (opt.run_mode == mode::delta) {
+    // 4 ctrl + 2 ctx reserved words followed by {offset, value} pairs
+    opc = ERT_EXEC_WRITE;
+    size_t idx = 6;
+    for (size_t widx = 4; widx < opt.regmap_words; ++widx) {
+      // The CU written word is part of every launch
+      if (!prev.empty() && prev[widx] == curr[widx] && widx != opt.cu_written_word)
+        continue;
+      host_write(regmap + (idx++ << 2), widx << 2);
+      host_write(regmap + (idx++ << 2), curr[widx]);
+    }
+    count = 1 + idx;
+  }
+  else {
+    for (size_t idx = 4; idx < opt.regmap_words; ++idx)
+      host_write(regmap + (idx << 2), curr[idx]);
+    count = 1 + opt.regmap_words;
+  }
+
+  prev = std::move(curr);
+  // Without cq interrupts, host writes only the slot header and
+  // does not write the slot mask to CQ status register
+  host_write(slot, (ERT_CU << 28) | (opc << 23) | (count << 12) | invalidate | ERT_CMD_STATE_NEW);
+  pending = true;
+  pending_slot = slot_idx;
+  pending_polls = 0;
+  ++launched;
+  host_submit(slot_idx);
+}
+
+// Called by MB for completed slots
+void
+host_notify(size_t mask_idx, value_type mask)
+{
+  if (!configured && mask_idx == 0 && (mask & 0x1)) {
+    configured = true;
+    cnt.reset();  // count only start commands
+    return;
+  }
+
+  auto slot_idx = pending_slot;
+  if (mask_idx == (slot_idx >> 5) && (mask & (1 << (slot_idx & 0x1F)))) {
+    pending = false;
+    ++completed;
+  }
+}
+
+const char*
+to_string(mode m)
+{
+  switch (m) {
+  case mode::full: return "full";
+  case mode::shadow: return "shadow";
+  case mode::delta: return "delta";
+  case mode::dataflow: return "dataflow";
+  case mode::dataflow_cqint: return "dataflow_cqint";
+  }
+  return "";
+}
+
+size_t
+run(mode m)
+{
+  opt.run_mode = m;
+  regs.clear();
+  cu_started.assign(opt.num_cus, false);
+  prev_regmap.assign(opt.num_cus, {});
+  launched = completed = errors = 0;
+  configured = pending = hung = false;
+  cnt.reset();
+
+  try {
+    scheduler_loop();
+  }
+  catch (const done_exception&) {
+  }
+
+  if (hung) {
+    std::cout << std::left << std::setw(14) << to_string(m)
+              << " hung at launch " << launched << "\n";
+    return errors + 1;
+  }
+
+  auto n = static_cast<double>(completed);
+  std::cout << std::left << std::setw(14) << to_string(m)
+            << " slots=" << num_slots()
+            << " launches=" << completed
+            << " regs/cmd=" << cnt.total() / n
+            << " cu_writes/cmd=" << cnt.cu_writes / n
+            << " cu_reads/cmd=" << cnt.cu_reads / n
+            << " cq_reads/cmd=" << cnt.cq_reads / n
+            << " cq_writes/cmd=" << cnt.cq_writes / n
+            << " csr_writes/cmd=" << cnt.csr_writes / n
+            << " errors=" << errors
+            << "\n";
+  return errors;
+}
+
+void
+usage()
+{
+  std::cout << "usage: sched_sim [options]\n"
+            << "  -n <launches>       number of launches per mode\n"
+            << "  -r <regmap words>   register map size in words including 4 ctrl words\n"
+            << "  -c <changed words>  argument words changed per launch\n"
+            << "  -u <cus>            number of CUs used round robin\n"
+            << "  -s <slot size>      command queue slot size in bytes\n"
+            << "  -k <word>           regmap word written by CU on completion\n"
+            << "  -x <launches>       host writes CU registers directly every <launches>\n"
+            << "  -l 1                report latency for 16 through 128 slots\n";
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////
+// Functions required by scheduler.cpp in ERT_HW_EMU mode
+////////////////////////////////////////////////////////////////
+uint32_t
+read_reg(uint32_t addr)
+{
+  if (is_cu(addr)) {
+    ++cnt.cu_reads;
+    auto cu = cu_index(addr);
+    if (addr == cu_base_address + (cu << cu_shift)) {
+      // CU completes immediately, ap_done is clear on read
+      if (cu_started[cu]) {
+        cu_started[cu] = false;
+        if (opt.cu_written_word)
+          regs[cu_reg(cu, opt.cu_written_word)] = 0xC0000000 | static_cast<value_type>(completed);
+        return ap_done | ap_idle;
+      }
+      return ap_idle;
+    }
+  }
+  else if (is_cq(addr))
+    ++cnt.cq_reads;
+  else
+    ++cnt.csr_reads;
+
+  if (is_cq_status(addr)) {
+    // Clear on read
+    auto val = regs[addr];
+    regs[addr] = 0;
+    return val;
+  }
+
+  if (addr == ERT_CUDMA_STATE || addr == ERT_CUISR_STATE)
+    return ERT_HLS_MODULE_IDLE;
+
+  auto itr = regs.find(addr);
+  return itr == regs.end() ? 0 : itr->second;
+}
+
+void
+write_reg(uint32_t addr, uint32_t val)
+{
+  if (is_cu(addr)) {
+    ++cnt.cu_writes;
+    auto cu = cu_index(addr);
+    if (addr == cu_base_address + (cu << cu_shift) && (val & 0x1)) {
+      cu_started[cu] = true;
+      // CU must see the register map host expects
+      auto& expected = prev_regmap[cu];
+      for (size_t idx = 4; idx < expected.size(); ++idx)
+        if (regs[cu_reg(cu, idx)] != expected[idx])
+          ++errors;
+    }
+  }
+  else if (is_cq(addr))
+    ++cnt.cq_writes;
+  else {
+    ++cnt.csr_writes;
+    for (size_t w = 0; w < 4; ++w)
+      if (addr == ERT_STATUS_REGISTER_ADDR + (w << 2))
+        host_notify(w, val);
+  }
+  regs[addr] = val;
+}
+
+void
+microblaze_enable_interrupts()
+{
+  mb_interrupts = true;
+}
+
+void
+microblaze_disable_interrupts()
+{
+  mb_interrupts = false;
+}
+
+// Called by scheduler for every slot it visits, play host
+void
+reg_access_wait()
+{
+  if (pending) {
+    if (++pending_polls == max_pending_polls) {
+      hung = true;
+      throw done_exception();
+    }
+    return;
+  }
+
+  if (!configured) {
+    if (!(host_read(ERT_CQ_BASE_ADDR) & 0xF))
+      host_configure();
+    return;
+  }
+
+  if (launched == opt.launches)
+    throw done_exception();
+
+  host_start();
+}
+
+int
+main(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    auto val = std::strtoul(argv[++i], nullptr, 0);
+    if (arg == "-n")
+      opt.launches = val;
+    else if (arg == "-r")
+      opt.regmap_words = val;
+    else if (arg == "-c")
+      opt.changed_words = val;
+    else if (arg == "-u")
+      opt.num_cus = val;
+    else if (arg == "-s")
+      opt.slot_size = val;
+    else if (arg == "-l")
+      opt.latency_sweep = (val != 0);
+    else if (arg == "-k")
+      opt.cu_written_word = val;
+    else if (arg == "-x")
+      opt.raw_write_period = val;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (opt.regmap_words < 4 || opt.num_cus == 0 || opt.num_cus > 128
+      || opt.slot_size < 8 + (opt.regmap_words << 2) || num_slots() > 128
+      || (opt.cu_written_word && (opt.cu_written_word < 4 || opt.cu_written_word >= opt.regmap_words))) {
+    usage();
+    return 1;
+  }
+
+  std::cout << "regmap_words=" << opt.regmap_words
+            << " changed_words=" << opt.changed_words
+            << " cus=" << opt.num_cus << "\n";
+
+  if (opt.latency_sweep) {
+    for (size_t slots = 16; slots <= 128; slots <<= 1) {
+      opt.slot_size = ERT_CQ_SIZE / slots;
+      run(mode::full);
+    }
+    return 0;
+  }
+
+  size_t errs = 0;
+  errs += run(mode::full);
+  errs += run(mode::shadow);
+  errs += run(mode::delta);
+
+  // Dataflow CU slots follow ctrl slot (0)
+  if (opt.num_cus < num_slots()) {
+    errs += run(mode::dataflow);
+    errs += run(mode::dataflow_cqint);
+  }
+  return errs ? 1 : 0;
+}
@@ -0,0 +1,410 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "XclBinDelta.h"
+
+#include "xclbin.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+  #include <openssl/evp.h>
+#endif
+
+#ifdef _WIN32
+# pragma warning ( disable : 4100 4505 )
+#endif
+
+#include "XclBinUtilities.h"
+namespace XUtil = XclBinUtilities;
+
+// A delta package describes an xclbin image as a sequence of segments: the
+// axlf header with its section headers, the section data, and any padding
+// or signature between and after the sections.  Each segment is identified
+// by the SHA-256 of its content and is either copied from the base image
+// (at any offset, sections may have moved) or stored in the package.
+//
+// Layout: DeltaHeader, DeltaSegment[m_numSegments], segment data
+
+#ifndef _WIN32
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+  #define EVP_MD_CTX_new EVP_MD_CTX_create
+  #define EVP_MD_CTX_free EVP_MD_CTX_destroy
+#endif
+
+namespace {
+
+static const char DELTA_MAGIC[8] = "xdelta1";
+static const unsigned int HASH_SIZE = 32;
+static const uint64_t CHUNK_SIZE = 1024 * 1024;
+
+enum DeltaSource : uint32_t {
+  DS_BASE = 0,                      // Segment is copied from the base image
+  DS_PACKAGE = 1,                   // Segment is stored in the package
+};
+
+struct DeltaHeader {
+  char m_magic[8];                  // Should be "xdelta1\0"
+  uint64_t m_baseSize;              // Size of the base image
+  uint64_t m_targetSize;            // Size of the reconstructed image
+  unsigned char m_targetHash[32];   // SHA-256 of the reconstructed image
+  uint64_t m_numSegments;           // Segment entries following the header
+};
+
+struct DeltaSegment {
+  uint64_t m_size;                  // Size of the segment
+  uint64_t m_offset;                // Offset in the base image or in the package
+  uint32_t m_source;                // DeltaSource
+  uint32_t m_reserved;
+  unsigned char m_hash[32];         // SHA-256 of the segment
+};
+
+struct Segment {
+  uint64_t offset;
+  uint64_t size;
+};
+
+class Sha256 {
+ public:
+  Sha256() : m_ctx(EVP_MD_CTX_new()) {
+    if ((m_ctx == nullptr) || (EVP_DigestInit_ex(m_ctx, EVP_sha256(), nullptr) != 1)) {
+      EVP_MD_CTX_free(m_ctx);
+      throw std::runtime_error("ERROR: Unable to initialize the SHA-256 digest.");
+    }
+  }
+
+  ~Sha256() { EVP_MD_CTX_free(m_ctx); }
+
+  Sha256(const Sha256&) = delete;
+  Sha256& operator=(const Sha256&) = delete;
+
+  void update(const char * _pData, uint64_t _size) {
+    if (EVP_DigestUpdate(m_ctx, _pData, _size) != 1)
+      throw std::runtime_error("ERROR: Unable to update the SHA-256 digest.");
+  }
+
+  std::string final() {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int size = 0;
+    if (EVP_DigestFinal_ex(m_ctx, digest, &size) != 1)
+      throw std::runtime_error("ERROR: Unable to finalize the SHA-256 digest.");
+    return std::string(reinterpret_cast<const char *>(digest), size);
+  }
+
+ private:
+  EVP_MD_CTX* m_ctx;
+};
+
+static void
+openInput(std::ifstream & _stream, const std::string & _sFile)
+{
+  _stream.open(_sFile, std::ifstream::in | std::ifstream::binary);
+  if (!_stream.is_open()) {
+    std::string errMsg = "ERROR: Unable to open the file for reading: " + _sFile;
+    throw std::runtime_error(errMsg);
+  }
+}
+
+static void
+readAt(std::istream & _stream, uint64_t _offset, char * _pBuffer, uint64_t _size, const std::string & _sFile)
+{
+  _stream.clear();
+  _stream.seekg(_offset);
+  _stream.read(_pBuffer, _size);
+  if (static_cast<uint64_t>(_stream.gcount()) != _size) {
+    std::string errMsg = XUtil::format("ERROR: Unable to read 0x%lx bytes at offset 0x%lx from the file: '%s'", _size, _offset, _sFile.c_str());
+    throw std::runtime_error(errMsg);
+  }
+}
+
+// Streams a segment in chunks, optionally copying it to the output and
+// adding it to the image digest.  Returns the SHA-256 of the segment.
+static std::string
+streamSegment(std::istream & _stream, const Segment & _segment, const std::string & _sFile,
+              std::ostream * _pOutput, Sha256 * _pImageHash)
+{
+  Sha256 segmentHash;
+  std::vector<char> buffer(std::min(CHUNK_SIZE, _segment.size));
+  for (uint64_t done = 0; done < _segment.size; ) {
+    uint64_t size = std::min<uint64_t>(buffer.size(), _segment.size - done);
+    readAt(_stream, _segment.offset + done, buffer.data(), size, _sFile);
+    segmentHash.update(buffer.data(), size);
+    if (_pImageHash != nullptr)
+      _pImageHash->update(buffer.data(), size);
+    if (_pOutput != nullptr)
+      _pOutput->write(buffer.data(), size);
+    done += size;
+  }
+  return segmentHash.final();
+}
+
+// Splits an xclbin image into the header, each section, and the gaps
+// between and after the sections
+static std::vector<Segment>
+getSegments(std::istream & _stream, uint64_t _fileSize, const std::string & _sFile)
+{
+  if (_fileSize < sizeof(axlf)) {
+    std::string errMsg = "ERROR: File is too small to be an xclbin image: " + _sFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  axlf top;
+  readAt(_stream, 0, reinterpret_cast<char *>(&top), sizeof(axlf), _sFile);
+  if (std::strncmp(top.m_magic, "xclbin2", sizeof(top.m_magic)) != 0) {
+    std::string errMsg = "ERROR: File is not an xclbin image: " + _sFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  uint64_t headerEnd = offsetof(axlf, m_sections) + static_cast<uint64_t>(top.m_header.m_numSections) * sizeof(axlf_section_header);
+  if (headerEnd > _fileSize) {
+    std::string errMsg = "ERROR: The section headers exceed the size of the file: " + _sFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  std::vector<axlf_section_header> sections(top.m_header.m_numSections);
+  if (!sections.empty())
+    readAt(_stream, offsetof(axlf, m_sections), reinterpret_cast<char *>(sections.data()),
+           sections.size() * sizeof(axlf_section_header), _sFile);
+
+  std::set<uint64_t> bounds = { 0, headerEnd, _fileSize };
+  for (const auto & section : sections) {
+    uint64_t begin = std::min(section.m_sectionOffset, _fileSize);
+    uint64_t end = (section.m_sectionSize > _fileSize - begin) ? _fileSize : begin + section.m_sectionSize;
+    // Sections overlapping the header are malformed, keep the header whole
+    if (begin < headerEnd)
+      continue;
+    bounds.insert(begin);
+    bounds.insert(end);
+  }
+
+  std::vector<Segment> segments;
+  for (auto itr = bounds.begin(), itrNext = std::next(itr); itrNext != bounds.end(); itr = itrNext++)
+    segments.push_back({*itr, *itrNext - *itr});
+
+  return segments;
+}
+
+} // namespace
+
+#endif
+
+void
+createDeltaPackage(const std::string & _baseFile,
+                   const std::string & _targetFile,
+                   const std::string & _deltaFile,
+                   XclBinDeltaStats & _stats)
+#ifdef _WIN32
+{
+  throw std::runtime_error("ERROR: createDeltaPackage not implemented on windows");
+}
+#else
+{
+  XUtil::TRACE("Creating delta package: " + _deltaFile);
+  _stats = XclBinDeltaStats();
+
+  // -- Index the content of the base image --
+  std::ifstream baseStream;
+  openInput(baseStream, _baseFile);
+  uint64_t baseSize = boost::filesystem::file_size(_baseFile);
+
+  std::map<std::string, uint64_t> baseContent;   // SHA-256 -> offset
+  for (const auto & segment : getSegments(baseStream, baseSize, _baseFile))
+    baseContent.emplace(streamSegment(baseStream, segment, _baseFile, nullptr, nullptr), segment.offset);
+
+  // -- Find the target segments not in the base image --
+  std::ifstream targetStream;
+  openInput(targetStream, _targetFile);
+  uint64_t targetSize = boost::filesystem::file_size(_targetFile);
+  auto segments = getSegments(targetStream, targetSize, _targetFile);
+
+  uint64_t dataOffset = sizeof(DeltaHeader) + segments.size() * sizeof(DeltaSegment);
+  uint64_t packageSize = dataOffset;
+  std::map<std::string, uint64_t> packageContent;  // SHA-256 -> offset
+  std::vector<Segment> shipped;
+  std::vector<DeltaSegment> entries;
+  Sha256 imageHash;
+
+  for (const auto & segment : segments) {
+    auto hash = streamSegment(targetStream, segment, _targetFile, nullptr, &imageHash);
+
+    DeltaSegment entry = {};
+    entry.m_size = segment.size;
+    std::memcpy(entry.m_hash, hash.data(), HASH_SIZE);
+
+    auto itr = baseContent.find(hash);
+    if (itr != baseContent.end()) {
+      entry.m_source = DS_BASE;
+      entry.m_offset = itr->second;
+      ++_stats.base_segments;
+    } else {
+      // Content that repeats in the target image is stored once
+      entry.m_source = DS_PACKAGE;
+      auto inserted = packageContent.emplace(hash, packageSize);
+      entry.m_offset = inserted.first->second;
+      if (inserted.second) {
+        packageSize += segment.size;
+        shipped.push_back(segment);
+        ++_stats.shipped_segments;
+        _stats.shipped_bytes += segment.size;
+      }
+    }
+    entries.push_back(entry);
+  }
+
+  DeltaHeader header = {};
+  std::memcpy(header.m_magic, DELTA_MAGIC, sizeof(header.m_magic));
+  header.m_baseSize = baseSize;
+  header.m_targetSize = targetSize;
+  std::memcpy(header.m_targetHash, imageHash.final().data(), HASH_SIZE);
+  header.m_numSegments = entries.size();
+
+  // -- Write the package --
+  std::fstream oDeltaFile;
+  oDeltaFile.open(_deltaFile, std::ifstream::out | std::ifstream::binary);
+  if (!oDeltaFile.is_open()) {
+    std::string errMsg = "ERROR: Unable to open the file for writing: " + _deltaFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  oDeltaFile.write(reinterpret_cast<const char *>(&header), sizeof(DeltaHeader));
+  oDeltaFile.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(DeltaSegment));
+  for (const auto & segment : shipped)
+    streamSegment(targetStream, segment, _targetFile, &oDeltaFile, nullptr);
+  oDeltaFile.close();
+  if (oDeltaFile.fail()) {
+    std::string errMsg = "ERROR: Unable to write the delta package: " + _deltaFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  _stats.target_size = targetSize;
+  _stats.package_size = packageSize;
+  _stats.segments = segments.size();
+
+  XUtil::QUIET(XUtil::format("Delta package: %ld of %ld segments stored (%ld of %ld bytes), package size: %ld bytes",
+                             _stats.shipped_segments, _stats.segments, _stats.shipped_bytes, targetSize, packageSize));
+}
+#endif
+
+void
+applyDeltaPackage(const std::string & _baseFile,
+                  const std::string & _deltaFile,
+                  const std::string & _outputFile)
+#ifdef _WIN32
+{
+  throw std::runtime_error("ERROR: applyDeltaPackage not implemented on windows");
+}
+#else
+{
+  XUtil::TRACE("Applying delta package: " + _deltaFile);
+
+  std::ifstream deltaStream;
+  openInput(deltaStream, _deltaFile);
+  uint64_t deltaSize = boost::filesystem::file_size(_deltaFile);
+
+  DeltaHeader header = {};
+  if (deltaSize < sizeof(DeltaHeader)) {
+    std::string errMsg = "ERROR: File is too small to be a delta package: " + _deltaFile;
+    throw std::runtime_error(errMsg);
+  }
+  readAt(deltaStream, 0, reinterpret_cast<char *>(&header), sizeof(DeltaHeader), _deltaFile);
+  if (std::memcmp(header.m_magic, DELTA_MAGIC, sizeof(header.m_magic)) != 0) {
+    std::string errMsg = "ERROR: File is not a delta package: " + _deltaFile;
+    throw std::runtime_error(errMsg);
+  }
+  if (header.m_numSegments > (deltaSize - sizeof(DeltaHeader)) / sizeof(DeltaSegment)) {
+    std::string errMsg = "ERROR: The segment table exceeds the size of the delta package: " + _deltaFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  std::vector<DeltaSegment> entries(header.m_numSegments);
+  if (!entries.empty())
+    readAt(deltaStream, sizeof(DeltaHeader), reinterpret_cast<char *>(entries.data()),
+           entries.size() * sizeof(DeltaSegment), _deltaFile);
+
+  std::ifstream baseStream;
+  openInput(baseStream, _baseFile);
+  uint64_t baseSize = boost::filesystem::file_size(_baseFile);
+  if (baseSize != header.m_baseSize) {
+    std::string errMsg = XUtil::format("ERROR: The base image size (%ld bytes) does not match the delta package base image size (%ld bytes): %s",
+                                       baseSize, header.m_baseSize, _baseFile.c_str());
+    throw std::runtime_error(errMsg);
+  }
+
+  // -- Reconstruct the image, verifying each segment as it is streamed --
+  std::fstream oOutputFile;
+  oOutputFile.open(_outputFile, std::ifstream::out | std::ifstream::binary);
+  if (!oOutputFile.is_open()) {
+    std::string errMsg = "ERROR: Unable to open the file for writing: " + _outputFile;
+    throw std::runtime_error(errMsg);
+  }
+
+  try {
+    Sha256 imageHash;
+    uint64_t outputSize = 0;
+    for (uint64_t index = 0; index < entries.size(); ++index) {
+      const auto & entry = entries[index];
+      if ((entry.m_source != DS_BASE) && (entry.m_source != DS_PACKAGE)) {
+        std::string errMsg = XUtil::format("ERROR: Unknown source (%d) of segment %ld in the delta package.", entry.m_source, index);
+        throw std::runtime_error(errMsg);
+      }
+
+      bool fromBase = (entry.m_source == DS_BASE);
+      auto & stream = fromBase ? baseStream : deltaStream;
+      const auto & sFile = fromBase ? _baseFile : _deltaFile;
+      uint64_t sourceSize = fromBase ? baseSize : deltaSize;
+      if ((entry.m_offset > sourceSize) || (entry.m_size > sourceSize - entry.m_offset)) {
+        std::string errMsg = XUtil::format("ERROR: Segment %ld exceeds the size of the file: %s", index, sFile.c_str());
+        throw std::runtime_error(errMsg);
+      }
+
+      auto hash = streamSegment(stream, {entry.m_offset, entry.m_size}, sFile, &oOutputFile, &imageHash);
+      if (std::memcmp(hash.data(), entry.m_hash, HASH_SIZE) != 0) {
+        std::string errMsg = XUtil::format("ERROR: Segment %ld (0x%lx bytes at offset 0x%lx) of the %s does not match its SHA-256.",
+                                           index, entry.m_size, entry.m_offset, fromBase ? "base image" : "delta package");
+        throw std::runtime_error(errMsg);
+      }
+      outputSize += entry.m_size;
+    }
+
+    if ((outputSize != header.m_targetSize) ||
+        (std::memcmp(imageHash.final().data(), header.m_targetHash, HASH_SIZE) != 0))
+      throw std::runtime_error("ERROR: The reconstructed image does not match the SHA-256 of the delta package.");
+
+    oOutputFile.close();
+    if (oOutputFile.fail()) {
+      std::string errMsg = "ERROR: Unable to write the file: " + _outputFile;
+      throw std::runtime_error(errMsg);
+    }
+  } catch (...) {
+    oOutputFile.close();
+    boost::filesystem::remove(_outputFile);
+    throw;
+  }
+
+  XUtil::QUIET(XUtil::format("Reconstructed and verified %ld bytes from %ld segments: %s",
+                             header.m_targetSize, entries.size(), _outputFile.c_str()));
+}
+#endif
@@ -0,0 +1,50 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __XclBinDelta_h_
+#define __XclBinDelta_h_
+
+// ----------------------- I N C L U D E S -----------------------------------
+
+// #includes here - please keep these to a bare minimum!
+#include <string>
+#include <cstdint>
+
+// ------------ F O R W A R D - D E C L A R A T I O N S ----------------------
+
+// ---------------------- F U N C T I O N S ----------------------------------
+
+// Delta package statistics
+typedef struct {
+  uint64_t target_size;           // Size of the reconstructed xclbin image
+  uint64_t package_size;          // Size of the delta package
+  uint64_t segments;              // Segments (header, sections, padding) of the image
+  uint64_t base_segments;         // Segments found in the base image
+  uint64_t shipped_segments;      // Segments stored in the package
+  uint64_t shipped_bytes;         // Bytes of segments stored in the package
+} XclBinDeltaStats;
+
+// Writes a delta package of the target xclbin image against a base image.
+// The package holds the SHA-256 of every segment of the target image and
+// only the segments whose content is not found in the base image.
+void createDeltaPackage(const std::string & _baseFile, const std::string & _targetFile, const std::string & _deltaFile, XclBinDeltaStats & _stats);
+
+// Reconstructs the target xclbin image from the base image and a delta
+// package.  Segments are verified as they are streamed to the output, an
+// incomplete or mismatching output file is removed.
+void applyDeltaPackage(const std::string & _baseFile, const std::string & _deltaFile, const std::string & _outputFile);
+
+#endif
@@ -22,6 +22,7 @@
 #include "ParameterSectionData.h"
 #include "FormattedOutput.h"
 #include "XclBinSignature.h"
+#include "XclBinDelta.h"
 #include "xclbin.h"
 
 // 3rd Party Library - Include Files
@@ -154,6 +155,9 @@ int main_(int argc, const char** argv) {
 
   std::string sTarget;
 
+  std::string sDeltaBase;
+  std::string sApplyDelta;
+
   std::string sInputFile;
   std::string sOutputFile;
 
@@ -182,6 +186,9 @@ int main_(int argc, const char** argv) {
       ("digest-algorithm", boost::program_options::value<std::string>(&sDigestAlgorithm), "Digest algorithm. Default: sha512")
       ("validate-signature", boost::program_options::bool_switch(&bValidateSignature), "Validates the signature for the given xclbin archive.")
 
+      ("create-delta", boost::program_options::value<std::string>(&sDeltaBase), "Writes a delta package of the input xclbin against the given base xclbin to the output file.")
+      ("apply-delta", boost::program_options::value<std::string>(&sApplyDelta), "Reconstructs an xclbin from the input (base) xclbin and the given delta package, and writes it to the output file.")
+
       ("verbose,v", boost::program_options::bool_switch(&bVerbose), "Display verbose/debug information.")
       ("quiet,q", boost::program_options::bool_switch(&bQuiet),     "Minimize reporting information.")
 
@@ -238,6 +245,8 @@ int main_(int argc, const char** argv) {
       std::cout << "  3) Extracting the build metadata : xclbinutil --dump-section BUILD_METADATA:HTML:buildMetadata.json --input binary_container_1.xclbin" << std::endl;
       std::cout << "  4) Removing a section            : xclbinutil --remove-section BITSTREAM --input binary_container_1.xclbin --output binary_container_modified.xclbin" << std::endl;
       std::cout << "  5) Signing xclbin                : xclbinutil --private-key key.priv --certificate cert.pem --input binary_container_1.xclbin --output signed.xclbin" << std::endl;
+      std::cout << "  6) Creating a delta package      : xclbinutil --create-delta base.xclbin --input binary_container_1.xclbin --output binary_container_1.xdelta" << std::endl;
+      std::cout << "  7) Applying a delta package      : xclbinutil --apply-delta binary_container_1.xdelta --input base.xclbin --output binary_container_1.xclbin" << std::endl;
 
       std::cout << std::endl
                 << "Command Line Options" << std::endl
@@ -345,6 +354,17 @@ int main_(int argc, const char** argv) {
     throw std::runtime_error("ERROR: The options '-add-signature' (a private signature) and '-private-key' (a PKCS signature) are mutually exclusive.");
   }
 
+  // Delta package DRCs
+  if (!sDeltaBase.empty() || !sApplyDelta.empty()) {
+    if (!sDeltaBase.empty() && !sApplyDelta.empty()) {
+      throw std::runtime_error("ERROR: The options '--create-delta' and '--apply-delta' are mutually exclusive.");
+    }
+
+    if (sInputFile.empty() || sOutputFile.empty()) {
+      throw std::runtime_error("ERROR: Delta packages require both an input and an output file.");
+    }
+  }
+
   // Actions requiring --input
 
   // Check to see if there any file conflicts
@@ -362,6 +382,14 @@ int main_(int argc, const char** argv) {
        inputFiles.push_back(sPrivateKey);
     }
 
+    if (!sDeltaBase.empty()) {
+       inputFiles.push_back(sDeltaBase);
+    }
+
+    if (!sApplyDelta.empty()) {
+       inputFiles.push_back(sApplyDelta);
+    }
+
     for (auto section : sectionsToAdd) {
       ParameterSectionData psd(section);
       inputFiles.push_back(psd.getFile());
@@ -433,6 +461,20 @@ int main_(int argc, const char** argv) {
     return RC_SUCCESS;
   }
 
+  // Create or apply a delta package
+  if (!sDeltaBase.empty()) {
+    XclBinDeltaStats stats;
+    createDeltaPackage(sDeltaBase, sInputFile, sOutputFile, stats);
+    XUtil::QUIET("Exiting");
+    return RC_SUCCESS;
+  }
+
+  if (!sApplyDelta.empty()) {
+    applyDeltaPackage(sInputFile, sApplyDelta, sOutputFile);
+    XUtil::QUIET("Exiting");
+    return RC_SUCCESS;
+  }
+
   if (bGetSignature) {
     if(sInputFile.empty()) {
       std::string errMsg = "ERROR: Cannot read signature.  Missing input file.";
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "XclBinDelta.h"
+#include "xclbin.h"
+
+#include "globals.h"
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct SyntheticSection {
+  axlf_section_kind kind;
+  std::vector<char> data;
+};
+
+std::vector<char>
+randomData(size_t size, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::vector<char> data(size);
+  for (auto & byte : data)
+    byte = static_cast<char>(gen());
+  return data;
+}
+
+// Writes a synthetic xclbin image with the sections 8 byte aligned
+void
+writeSyntheticXclbin(const std::string & _sFile, const std::vector<SyntheticSection> & _sections)
+{
+  std::vector<char> header(offsetof(axlf, m_sections) + _sections.size() * sizeof(axlf_section_header), 0);
+  auto top = reinterpret_cast<axlf *>(header.data());
+  std::memcpy(top->m_magic, "xclbin2", 8);
+  top->m_signature_length = -1;
+  top->m_header.m_numSections = static_cast<uint32_t>(_sections.size());
+
+  uint64_t offset = (header.size() + 7) & ~7ULL;
+  for (size_t index = 0; index < _sections.size(); ++index) {
+    auto & sectionHeader = top->m_sections[index];
+    sectionHeader.m_sectionKind = _sections[index].kind;
+    sectionHeader.m_sectionOffset = offset;
+    sectionHeader.m_sectionSize = _sections[index].data.size();
+    offset = (offset + _sections[index].data.size() + 7) & ~7ULL;
+  }
+  top->m_header.m_length = offset;
+
+  std::ofstream oFile(_sFile, std::ios::binary);
+  oFile.write(header.data(), header.size());
+  for (size_t index = 0; index < _sections.size(); ++index) {
+    oFile.seekp(top->m_sections[index].m_sectionOffset);
+    oFile.write(_sections[index].data.data(), _sections[index].data.size());
+  }
+  // Padding of the last section
+  oFile.seekp(offset - 1);
+  oFile.put(0);
+}
+
+bool
+filesEqual(const std::string & _sFile1, const std::string & _sFile2)
+{
+  std::ifstream file1(_sFile1, std::ios::binary);
+  std::ifstream file2(_sFile2, std::ios::binary);
+  return std::equal(std::istreambuf_iterator<char>(file1), std::istreambuf_iterator<char>(),
+                    std::istreambuf_iterator<char>(file2), std::istreambuf_iterator<char>());
+}
+
+double
+elapsedMs(std::chrono::steady_clock::time_point _start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+}
+
+std::vector<SyntheticSection>
+baseSections()
+{
+  return {
+    { BITSTREAM, randomData(64 * 1024 * 1024, 1) },
+    { MEM_TOPOLOGY, randomData(4 * 1024, 2) },
+    { IP_LAYOUT, randomData(2 * 1024, 3) },
+    { EMBEDDED_METADATA, randomData(256 * 1024, 4) },
+    { SOFT_KERNEL, randomData(4 * 1024 * 1024, 5) },
+  };
+}
+
+} // namespace
+
+TEST(Delta, ReconstructChangedSections) {
+  auto base = baseSections();
+  writeSyntheticXclbin("DeltaBase.xclbin", base);
+
+  struct Variant {
+    std::string name;
+    std::vector<SyntheticSection> sections;
+  };
+
+  // Changed metadata grows, moving the sections that follow it
+  auto metadata = base;
+  metadata[3].data = randomData(300 * 1024, 6);
+
+  auto psKernel = base;
+  psKernel[4].data = randomData(4 * 1024 * 1024, 7);
+
+  auto bitstream = base;
+  bitstream[0].data = randomData(64 * 1024 * 1024, 8);
+
+  std::vector<Variant> variants = {
+    { "unchanged", base },
+    { "metadata", metadata },
+    { "ps kernel", psKernel },
+    { "bitstream", bitstream },
+  };
+
+  for (const auto & variant : variants) {
+    writeSyntheticXclbin("DeltaTarget.xclbin", variant.sections);
+    boost::filesystem::remove("DeltaTarget.xdelta");
+    boost::filesystem::remove("DeltaOutput.xclbin");
+
+    XclBinDeltaStats stats;
+    auto start = std::chrono::steady_clock::now();
+    createDeltaPackage("DeltaBase.xclbin", "DeltaTarget.xclbin", "DeltaTarget.xdelta", stats);
+    auto createMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    applyDeltaPackage("DeltaBase.xclbin", "DeltaTarget.xdelta", "DeltaOutput.xclbin");
+    auto applyMs = elapsedMs(start);
+
+    ASSERT_TRUE(filesEqual("DeltaTarget.xclbin", "DeltaOutput.xclbin")) << variant.name;
+    EXPECT_EQ(stats.package_size, boost::filesystem::file_size("DeltaTarget.xdelta"));
+    EXPECT_EQ(stats.target_size, boost::filesystem::file_size("DeltaTarget.xclbin"));
+    EXPECT_LT(stats.package_size, stats.target_size) << variant.name;
+
+    if (!TestUtilities::isQuiet())
+      std::cout << "Delta " << variant.name << ": image " << stats.target_size
+                << " bytes, package " << stats.package_size << " bytes ("
+                << stats.shipped_segments << " of " << stats.segments << " segments), create "
+                << createMs << " ms, reconstruct " << applyMs << " ms" << std::endl;
+  }
+}
+
+TEST(Delta, CorruptBase) {
+  auto base = baseSections();
+  writeSyntheticXclbin("DeltaBase.xclbin", base);
+
+  auto target = base;
+  target[3].data = randomData(256 * 1024, 9);
+  writeSyntheticXclbin("DeltaTarget.xclbin", target);
+
+  XclBinDeltaStats stats;
+  boost::filesystem::remove("DeltaTarget.xdelta");
+  createDeltaPackage("DeltaBase.xclbin", "DeltaTarget.xclbin", "DeltaTarget.xdelta", stats);
+
+  // Flip one byte of the bitstream in the base image
+  {
+    std::fstream file("DeltaBase.xclbin", std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(4096);
+    char byte = static_cast<char>(file.get());
+    file.seekp(4096);
+    file.put(static_cast<char>(byte ^ 0xff));
+  }
+
+  boost::filesystem::remove("DeltaOutput.xclbin");
+  EXPECT_THROW(applyDeltaPackage("DeltaBase.xclbin", "DeltaTarget.xdelta", "DeltaOutput.xclbin"), std::runtime_error);
+  EXPECT_FALSE(boost::filesystem::exists("DeltaOutput.xclbin"));
+
+  // A base image with a different bitstream of the same size is rejected
+  auto other = base;
+  other[0].data = randomData(64 * 1024 * 1024, 10);
+  writeSyntheticXclbin("DeltaBase.xclbin", other);
+  EXPECT_THROW(applyDeltaPackage("DeltaBase.xclbin", "DeltaTarget.xdelta", "DeltaOutput.xclbin"), std::runtime_error);
+}
@@ -22,6 +22,8 @@
 
 #include "core/common/time.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace xdp {
@@ -41,6 +43,10 @@ namespace xdp {
       std::lock_guard<std::mutex> lock(aieLock) ;
       for(auto mapEntry : aieTraceData) {
         for(auto info : mapEntry.second) {
+          if(nullptr == info)
+            continue;
+          for(auto buf : info->buffer)
+            delete [] static_cast<char*>(buf);
           delete info;
         }
         mapEntry.second.clear();
@@ -394,7 +400,11 @@ namespace xdp {
     if(nullptr == aieTraceData[deviceId][strmIndex]) {
       aieTraceData[deviceId][strmIndex] = new AIETraceDataType;
     }
-    aieTraceData[deviceId][strmIndex]->buffer.push_back(buffer);
+    // The trace buffer on the device is reused by continuous offload
+    //  and released at the end of the run, so keep a copy
+    char* data = new char[bufferSz];
+    std::memcpy(data, buffer, bufferSz);
+    aieTraceData[deviceId][strmIndex]->buffer.push_back(data);
     aieTraceData[deviceId][strmIndex]->bufferSz.push_back(bufferSz);
 #if 0
     aieTraceData[deviceId][strmIndex] = new AIETraceDataType;
@@ -439,30 +449,26 @@ namespace xdp {
     return powerSamples[deviceId] ;
   }
 
-  void VPDynamicDatabase::addAIESample(uint64_t deviceId, double timestamp,
-          const std::vector<uint64_t>& values)
+  void VPDynamicDatabase::addAIESamples(uint64_t deviceId,
+          const AIECounterSample* samples, size_t num)
   {
     std::lock_guard<std::mutex> lock(aieLock) ;
 
-    if (aieSamples.find(deviceId) == aieSamples.end())
-    {
-      std::vector<CounterSample> blank ;
-      aieSamples[deviceId] = blank ;
+    // Grow in large steps so the sampling thread rarely reallocates
+    auto& deviceSamples = aieSamples[deviceId] ;
+    if (deviceSamples.capacity() - deviceSamples.size() < num) {
+      auto grow = std::max(deviceSamples.size(), num * aieSampleReserve) ;
+      deviceSamples.reserve(deviceSamples.size() + grow) ;
     }
 
-    aieSamples[deviceId].push_back(std::make_pair(timestamp, values)) ;
+    deviceSamples.insert(deviceSamples.end(), samples, samples + num) ;
   }
 
-  std::vector<VPDynamicDatabase::CounterSample>
+  std::vector<AIECounterSample>
   VPDynamicDatabase::getAIESamples(uint64_t deviceId)
   {
     std::lock_guard<std::mutex> lock(aieLock) ;
 
-    if (aieSamples.find(deviceId) == aieSamples.end()) {
-      std::vector<CounterSample> empty;
-      aieSamples[deviceId] = empty;
-    }
-
     return aieSamples[deviceId] ;
   }
 
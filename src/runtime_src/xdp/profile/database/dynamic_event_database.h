@@ -52,6 +52,19 @@ namespace xdp {
 //  typedef std::pair<void* /*buffer*/, uint64_t /*bufferSz*/> AIETraceDataType;
   typedef std::vector<AIETraceDataType*> AIETraceDataVector;
 
+  // AIE profile counter sample.  Fixed layout so samples can be
+  //  filled in place by the sampling thread and appended in batches.
+  struct AIECounterSample {
+    double timestamp;
+    uint32_t value;
+    uint16_t column;
+    uint16_t row;
+    uint8_t startEvent;
+    uint8_t endEvent;
+    uint8_t resetEvent;
+    uint8_t counterNumber;
+  };
+
   // The Dynamic Database will own all VTFEvents and is responsible
   //  for cleaning up this memory.
   class VPDynamicDatabase
@@ -82,7 +95,9 @@ namespace xdp {
     // For all plugins that read counters, we will store that information
     //  here.
     std::map<uint64_t, std::vector<CounterSample>> powerSamples ;
-    std::map<uint64_t, std::vector<CounterSample>> aieSamples ;
+    std::map<uint64_t, std::vector<AIECounterSample>> aieSamples ;
+    // Number of sweeps worth of AIE samples reserved when growing
+    static constexpr size_t aieSampleReserve = 1024 ;
     std::map<uint64_t, std::vector<CounterSample>> nocSamples ;
     std::map<uint64_t, CounterNames> nocNames ;
 
@@ -214,9 +229,9 @@ namespace xdp {
 				   const std::vector<uint64_t>& values) ;
     XDP_EXPORT std::vector<CounterSample> getPowerSamples(uint64_t deviceId) ;
 
-    XDP_EXPORT void addAIESample(uint64_t deviceId, double timestamp,
-				   const std::vector<uint64_t>& values) ;
-    XDP_EXPORT std::vector<CounterSample> getAIESamples(uint64_t deviceId) ;
+    XDP_EXPORT void addAIESamples(uint64_t deviceId,
+				  const AIECounterSample* samples, size_t num) ;
+    XDP_EXPORT std::vector<AIECounterSample> getAIESamples(uint64_t deviceId) ;
 
     XDP_EXPORT void addNOCSample(uint64_t deviceId, double timestamp, std::string name,
 				   const std::vector<uint64_t>& values) ;
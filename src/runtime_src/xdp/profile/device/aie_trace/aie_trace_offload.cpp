@@ -23,6 +23,10 @@
 #include "xdp/profile/device/aie_trace/aie_trace_offload.h"
 #include "xdp/profile/device/aie_trace/aie_trace_logger.h"
 
+#include "core/common/message.h"
+#include "core/common/thread.h"
+
+#include <chrono>
 #include <iostream>
 #ifdef XRT_ENABLE_AIE
 #include <sys/mman.h>
@@ -42,20 +46,32 @@ AIETraceOffload::AIETraceOffload(void* handle, uint64_t id,
                                  AIETraceLogger* logger,
                                  bool isPlio,
                                  uint64_t totalSize,
-                                 uint64_t numStrm)
+                                 uint64_t numStrm,
+                                 bool continuous,
+                                 uint64_t offloadInterval)
                : deviceHandle(handle),
                  deviceId(id),
                  deviceIntf(dInt),
                  traceLogger(logger),
                  isPLIO(isPlio),
                  totalSz(totalSize),
-                 numStream(numStrm)
+                 numStream(numStrm),
+                 isContinuous(continuous),
+                 offloadIntervalms(offloadInterval)
 {
   bufAllocSz = (totalSz / numStream) & 0xfffffffffffff000;
+
+  // GMIO trace is written by shim DMA which has no count of data
+  // written, so it can only be read at the end
+  if (isContinuous && !isPLIO) {
+    xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", AIE_TRACE_WARN_MSG_PERIODIC_OFFLOAD_GMIO);
+    isContinuous = false;
+  }
 }
 
 AIETraceOffload::~AIETraceOffload()
 {
+  stopOffload();
 }
 
 bool AIETraceOffload::initReadTrace()
@@ -63,6 +79,12 @@ bool AIETraceOffload::initReadTrace()
   buffers.clear();
   buffers.resize(numStream);
 
+  // With periodic offload the data movers wrap around the end of the
+  // buffers, which is possible only if all data movers support it
+  useCircularBuf = isContinuous;
+  for(uint64_t i = 0; useCircularBuf && i < numStream; ++i)
+    useCircularBuf = deviceIntf->supportsCircBufAIETs2mm(i);
+
   uint8_t  memIndex = 0;
   if(isPLIO) {
     memIndex = deviceIntf->getAIETs2mmMemIndex(0); // all the AIE Ts2mm s will have same memory index selected
@@ -78,7 +100,7 @@ bool AIETraceOffload::initReadTrace()
     // Data Mover will write input stream to this address
     uint64_t bufAddr = deviceIntf->getDeviceAddr(buffers[i].boHandle);
     if(isPLIO) {
-      deviceIntf->initAIETs2mm(bufAllocSz, bufAddr, i);
+      deviceIntf->initAIETs2mm(bufAllocSz, bufAddr, i, useCircularBuf);
     } else {
 #ifdef XRT_ENABLE_AIE
       VPDatabase* db = VPDatabase::Instance();
@@ -136,6 +158,8 @@ bool AIETraceOffload::initReadTrace()
 
 void AIETraceOffload::endReadTrace()
 {
+  stopOffload();
+
   // reset
   for(uint64_t i = 0; i < numStream ; ++i) {
     if(!buffers[i].boHandle) {
@@ -178,23 +202,25 @@ void AIETraceOffload::endReadTrace()
 
 void AIETraceOffload::readTrace()
 {
-  for(uint64_t i = 0; i < numStream; ++i) {
-    if(isPLIO) {
-      configAIETs2mm(i);
-    } else { 
+  std::lock_guard<std::mutex> lock(readLock);
+
+  for(uint64_t i = 0; i < buffers.size(); ++i) {
+    if(!isPLIO) {
       buffers[i].usedSz = bufAllocSz;
+      while (readPartialTrace(i) == CHUNK_SZ)
+        ;
+      continue;
     }
-    while (1) {
-      auto bytes = readPartialTrace(i);
-
-      if (buffers[i].usedSz == bufAllocSz) {
-        buffers[i].isFull = true;
-        break;
-      }
 
-      if (bytes != CHUNK_SZ)
-        break;
+    // Only newly written data is synced.  In a circular buffer the new
+    // data can wrap around the end of the buffer.
+    while (configAIETs2mm(i)) {
+      while (readPartialTrace(i) == CHUNK_SZ)
+        ;
     }
+
+    if (!useCircularBuf && buffers[i].usedSz == bufAllocSz)
+      buffers[i].isFull = true;
   }
 }
 
@@ -232,17 +258,57 @@ bool AIETraceOffload::isTraceBufferFull()
   return false;
 }
 
-void AIETraceOffload::configAIETs2mm(uint64_t i /*index*/)
+bool AIETraceOffload::configAIETs2mm(uint64_t i /*index*/)
 {
-  uint64_t wordCount = deviceIntf->getWordCountAIETs2mm(i);
-  uint64_t usedSize  = wordCount * TRACE_PACKET_SIZE;
-  if(usedSize <= bufAllocSz) {
-    buffers[i].usedSz = usedSize;
-  } else {
-    buffers[i].usedSz = bufAllocSz;
+  uint64_t bytesWritten = deviceIntf->getWordCountAIETs2mm(i) * TRACE_PACKET_SIZE;
+  bool ready = buffers[i].configRead(bytesWritten, bufAllocSz, useCircularBuf);
+
+  if (buffers[i].offloadDone && useCircularBuf && !overwriteReported) {
+    overwriteReported = true;
+    xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", AIE_TS2MM_WARN_MSG_CIRC_BUF_OVERWRITE);
   }
+  return ready;
 }
 
+void AIETraceOffload::startOffload()
+{
+  if (!isContinuous || buffers.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(statusLock);
+  if (offloadStatus == AIEOffloadThreadStatus::RUNNING)
+    return;
+  offloadStatus = AIEOffloadThreadStatus::RUNNING;
+  offloadThread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &AIETraceOffload::offloadContinuous, this);
+}
 
+void AIETraceOffload::stopOffload()
+{
+  {
+    std::lock_guard<std::mutex> lock(statusLock);
+    if (offloadStatus != AIEOffloadThreadStatus::RUNNING)
+      return;
+    offloadStatus = AIEOffloadThreadStatus::STOPPING;
+  }
+  if (offloadThread.joinable())
+    offloadThread.join();
+
+  std::lock_guard<std::mutex> lock(statusLock);
+  offloadStatus = AIEOffloadThreadStatus::STOPPED;
 }
 
+bool AIETraceOffload::keepOffloading()
+{
+  std::lock_guard<std::mutex> lock(statusLock);
+  return offloadStatus == AIEOffloadThreadStatus::RUNNING;
+}
+
+void AIETraceOffload::offloadContinuous()
+{
+  while (keepOffloading()) {
+    readTrace();
+    std::this_thread::sleep_for(std::chrono::milliseconds(offloadIntervalms));
+  }
+}
+
+}
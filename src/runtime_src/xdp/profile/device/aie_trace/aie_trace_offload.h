@@ -17,6 +17,12 @@
 #ifndef XDP_PROFILE_AIE_TRACE_OFFLOAD_H_
 #define XDP_PROFILE_AIE_TRACE_OFFLOAD_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "xdp/config.h"
 
 namespace xdp {
@@ -24,13 +30,54 @@ namespace xdp {
 class DeviceIntf;
 class AIETraceLogger;
 
+enum class AIEOffloadThreadStatus {
+  IDLE,
+  RUNNING,
+  STOPPING,
+  STOPPED
+};
+
 struct AIETraceBufferInfo
 {
   size_t   boHandle;
 //  uint64_t allocSz;	// currently all the buffers are equal size
-  uint64_t usedSz;
-  uint64_t offset;
+  uint64_t usedSz;        // end of data to read in current pass over buffer
+  uint64_t offset;        // start of unread data in current pass over buffer
+  uint32_t rollover;      // completed passes over circular buffer
   bool     isFull;
+  bool     offloadDone;
+
+  /*
+   * Set [offset, usedSz) to the next region written by the data mover.
+   * bytesWritten is the total written since the data mover was started.
+   * Data in a circular buffer can wrap, so a caller reads until this
+   * returns false.  Sets offloadDone if unread data was overwritten.
+   */
+  bool configRead(uint64_t bytesWritten, uint64_t allocSz, bool circular)
+  {
+    uint64_t bytesRead = rollover * allocSz + offset;
+    if (offloadDone || bytesWritten <= bytesRead)
+      return false;
+
+    if (circular && bytesWritten > bytesRead + allocSz) {
+      // Offload did not keep up with the data mover
+      isFull = true;
+      offloadDone = true;
+      return false;
+    }
+
+    if (offset == allocSz) {
+      if (!circular) {
+        isFull = true;
+        return false;
+      }
+      ++rollover;
+      offset = 0;
+    }
+
+    usedSz = std::min(bytesWritten - rollover * allocSz, allocSz);
+    return offset < usedSz;
+  }
 };
 
 class AIETraceOffload 
@@ -41,7 +88,9 @@ class AIETraceOffload
                     DeviceIntf*, AIETraceLogger*,
                     bool     isPlio,
                     uint64_t totalSize,
-                    uint64_t numStrm);
+                    uint64_t numStrm,
+                    bool     isContinuous = false,
+                    uint64_t offloadIntervalms = 0);
 
     XDP_EXPORT
     virtual ~AIETraceOffload();
@@ -54,6 +103,13 @@ public:
     XDP_EXPORT
     virtual bool isTraceBufferFull();
 
+    // Periodically read new trace data in a separate thread.  Requires
+    // initReadTrace.  Stopping joins the thread.
+    XDP_EXPORT
+    void startOffload();
+    XDP_EXPORT
+    void stopOffload();
+
 public:
 #if 0
     bool traceBufferFull() {
@@ -62,11 +118,14 @@ public:
     }
 #endif
 
+    // Read all trace data written since previous read
+    XDP_EXPORT
     void readTrace();
 
     AIETraceLogger* getAIETraceLogger() { return traceLogger; }
 
-    // no circular buffer for now
+    bool continuousOffload() { return isContinuous; }
+    bool usingCircularBuffer() { return useCircularBuf; }
 
 private:
 
@@ -83,11 +142,20 @@ private:
 
     std::vector<AIETraceBufferInfo> buffers;
 
-    uint64_t readPartialTrace(uint64_t);
-    void configAIETs2mm(uint64_t wordCount);
-    //void offload_device_continuous();
+    // Continuous offload
+    bool     isContinuous;
+    bool     useCircularBuf = false;
+    bool     overwriteReported = false;
+    uint64_t offloadIntervalms;
+    std::mutex readLock;
+    std::mutex statusLock;
+    AIEOffloadThreadStatus offloadStatus = AIEOffloadThreadStatus::IDLE;
+    std::thread offloadThread;
 
-    //Circular Buffer Tracking : Not for now
+    uint64_t readPartialTrace(uint64_t);
+    bool configAIETs2mm(uint64_t index);
+    bool keepOffloading();
+    void offloadContinuous();
 };
 
 }
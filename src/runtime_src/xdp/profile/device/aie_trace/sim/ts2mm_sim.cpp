@@ -0,0 +1,230 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Simulated AIE TS2MM data mover for AIE trace offload.
+//
+// A producer writes consecutive 64-bit trace words into a buffer,
+// wrapping at the end in circular mode, and publishes the total word
+// count like the TS2MM written count register.  The consumer reads new
+// data the same way AIETraceOffload does, using
+// AIETraceBufferInfo::configRead and partial copies in chunks, and
+// verifies that the offloaded words are consecutive.
+//
+// Producer and consumer are stepped on a simulated millisecond clock,
+// so the result depends only on the options and not on scheduling of
+// threads on the host running the simulation.
+//
+// % ts2mm_sim [-b <buffer bytes>] [-r <words per ms>] [-i <offload interval ms>]
+//             [-t <run time ms>] [-c <circular 0|1>] [-o <expect overwrite 0|1>]
+//
+// An overwrite of unread data in circular mode fails the test unless
+// it is expected with -o 1, in which case not detecting it fails.
+
+#include "xdp/profile/device/aie_trace/aie_trace_offload.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t packet_size = 8;
+constexpr uint64_t chunk_size = 0x1000;
+
+struct ts2mm
+{
+  std::vector<uint64_t> buffer;
+  uint64_t word_count = 0;
+  bool circular = false;
+
+  // Write words_per_ms words for one ms, stops when full
+  void
+  produce(uint64_t words_per_ms)
+  {
+    uint64_t words = buffer.size();
+    for (uint64_t w = 0; w < words_per_ms; ++w) {
+      if (!circular && word_count == words)
+        return;
+      buffer[word_count % words] = word_count;
+      ++word_count;
+    }
+  }
+};
+
+struct consumer
+{
+  ts2mm& dma;
+  uint64_t alloc_sz;
+  bool circular;
+  xdp::AIETraceBufferInfo info = {};
+  std::vector<uint64_t> offloaded;
+  uint64_t syncs = 0;
+  uint64_t synced_bytes = 0;
+
+  consumer(ts2mm& d, bool circ)
+    : dma(d), alloc_sz(d.buffer.size() * packet_size), circular(circ)
+  {}
+
+  // Same as AIETraceOffload::readPartialTrace with memcpy as sync
+  uint64_t
+  read_partial()
+  {
+    if (info.offset >= info.usedSz)
+      return 0;
+    uint64_t bytes = std::min(chunk_size, info.usedSz - info.offset);
+    auto src = reinterpret_cast<const char*>(dma.buffer.data()) + info.offset;
+    auto sz = offloaded.size();
+    offloaded.resize(sz + bytes / packet_size);
+    std::memcpy(offloaded.data() + sz, src, bytes);
+    info.offset += bytes;
+    ++syncs;
+    synced_bytes += bytes;
+    return bytes;
+  }
+
+  // Same as AIETraceOffload::readTrace for one PLIO stream
+  void
+  read()
+  {
+    uint64_t written = dma.word_count * packet_size;
+    while (info.configRead(written, alloc_sz, circular)) {
+      while (read_partial() == chunk_size)
+        ;
+    }
+  }
+};
+
+static void
+usage()
+{
+  std::cout << "usage: ts2mm_sim [options]\n\n";
+  std::cout << "  -b <buffer bytes>, default 65536\n";
+  std::cout << "  -r <words per ms>, default 500\n";
+  std::cout << "  -i <offload interval ms>, default 10\n";
+  std::cout << "  -t <run time ms>, default 1000\n";
+  std::cout << "  -c <circular 0|1>, default 1\n";
+  std::cout << "  -o <expect overwrite 0|1>, default 0\n";
+  std::cout << "  -h\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  uint64_t buffer_bytes = 65536;
+  uint64_t rate = 500;
+  uint64_t interval = 10;
+  uint64_t runtime = 1000;
+  bool circular = true;
+  bool expect_overwrite = false;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-b")
+      buffer_bytes = std::stoull(arg);
+    else if (cur == "-r")
+      rate = std::stoull(arg);
+    else if (cur == "-i")
+      interval = std::stoull(arg);
+    else if (cur == "-t")
+      runtime = std::stoull(arg);
+    else if (cur == "-c")
+      circular = std::stoul(arg) != 0;
+    else if (cur == "-o")
+      expect_overwrite = std::stoul(arg) != 0;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (buffer_bytes < chunk_size || buffer_bytes % chunk_size)
+    throw std::runtime_error("buffer size must be a multiple of " + std::to_string(chunk_size));
+
+  ts2mm dma;
+  dma.buffer.resize(buffer_bytes / packet_size);
+  dma.circular = circular;
+  consumer offload(dma, circular);
+
+  for (uint64_t ms = 1; ms <= runtime && !offload.info.offloadDone; ++ms) {
+    dma.produce(rate);
+    if (interval && ms % interval == 0)
+      offload.read();
+  }
+
+  // Final read at end of run
+  offload.read();
+
+  uint64_t written = dma.word_count;
+  std::cout << "buffer: " << buffer_bytes << " bytes, circular: " << circular
+            << ", rate: " << rate << " words/ms, interval: " << interval << " ms\n";
+  std::cout << "written: " << written << " words, offloaded: " << offload.offloaded.size()
+            << " words, passes over buffer: " << offload.info.rollover + 1
+            << ", syncs: " << offload.syncs << "\n";
+
+  // Offloaded data must be the consecutive words from the start
+  for (uint64_t idx = 0; idx < offload.offloaded.size(); ++idx) {
+    if (offload.offloaded[idx] != idx) {
+      if (offload.info.offloadDone)
+        break;
+      throw std::runtime_error("offloaded word " + std::to_string(idx)
+                               + " is " + std::to_string(offload.offloaded[idx]));
+    }
+  }
+
+  if (offload.info.offloadDone) {
+    std::cout << "circular buffer overwrite detected, offload stopped\n";
+    if (!expect_overwrite)
+      throw std::runtime_error("trace data was overwritten before it was offloaded");
+    return 0;
+  }
+
+  if (expect_overwrite)
+    throw std::runtime_error("expected overwrite was not detected");
+
+  if (offload.info.isFull)
+    std::cout << "trace buffer full\n";
+  else if (offload.offloaded.size() != written)
+    throw std::runtime_error("offloaded words do not match written words");
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "FAILED: " << ex.what() << "\n";
+  }
+  return 1;
+}
@@ -956,11 +956,19 @@ DeviceIntf::~DeviceIntf()
   }
 
   // Initialize an AIE trace data mover
-  void DeviceIntf::initAIETs2mm(uint64_t bufSz, uint64_t bufAddr, uint64_t index)
+  void DeviceIntf::initAIETs2mm(uint64_t bufSz, uint64_t bufAddr, uint64_t index, bool circular)
   {
     if(index >= mAieTraceDmaList.size())
       return;
-    mAieTraceDmaList[index]->init(bufSz, bufAddr, false);
+    mAieTraceDmaList[index]->init(bufSz, bufAddr, circular);
+  }
+
+  // Check if an AIE trace data mover can write as circular buffer
+  bool DeviceIntf::supportsCircBufAIETs2mm(uint64_t index)
+  {
+    if(index >= mAieTraceDmaList.size())
+      return false;
+    return mAieTraceDmaList[index]->supportsCircBuf();
   }
 
   // Get word count written by AIE trace data mover
@@ -152,7 +152,9 @@ class DeviceIntf {
     XDP_EXPORT
     void resetAIETs2mm(uint64_t index);
     XDP_EXPORT
-    void initAIETs2mm(uint64_t bufferSz, uint64_t bufferAddr, uint64_t index);
+    void initAIETs2mm(uint64_t bufferSz, uint64_t bufferAddr, uint64_t index, bool circular = false);
+    XDP_EXPORT
+    bool supportsCircBufAIETs2mm(uint64_t index);
 
     XDP_EXPORT
     uint64_t getWordCountAIETs2mm(uint64_t index);
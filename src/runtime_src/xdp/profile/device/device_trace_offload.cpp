@@ -20,6 +20,7 @@
 #include "xdp/profile/device/device_trace_logger.h"
 
 #include "core/common/message.h"
+#include "core/common/thread.h"
 
 namespace xdp {
 
@@ -97,9 +98,9 @@ void DeviceTraceOffload::start_offload(OffloadThreadType type)
   status = OffloadThreadStatus::RUNNING;
 
   if (type == OffloadThreadType::TRACE)
-    offload_thread = std::thread(&DeviceTraceOffload::offload_device_continuous, this);
+    offload_thread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &DeviceTraceOffload::offload_device_continuous, this);
   else if (type == OffloadThreadType::CLOCK_TRAIN)
-    offload_thread = std::thread(&DeviceTraceOffload::train_clock_continuous, this);
+    offload_thread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &DeviceTraceOffload::train_clock_continuous, this);
 }
 
 void DeviceTraceOffload::stop_offload()
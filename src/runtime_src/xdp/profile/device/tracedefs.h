@@ -67,6 +67,9 @@ Recommended settings are : 'coarse' option for data transfer trace and no stall
 
 // aie trace
 #define AIE_TS2MM_WARN_MSG_BUF_FULL       "AIE Trace Buffer is full. Device trace could be incomplete."
+#define AIE_TS2MM_WARN_MSG_CIRC_BUF_OVERWRITE "Circular buffer overwrite was detected in AIE trace. Device trace could be incomplete. \
+Please increase aie_trace_buffer_size and/or reduce aie_trace_buffer_offload_interval_ms."
+#define AIE_TRACE_WARN_MSG_PERIODIC_OFFLOAD_GMIO "Periodic offload of AIE trace is only supported for PLIO trace. Trace will be read at the end of the run."
 
 #define TS2MM_WARN_MSG_CIRC_BUF       "Unable to use circular buffer for continuous trace offload. Please increase trace \
 buffer size and/or reduce continuous trace interval."
@@ -17,12 +17,14 @@
 #define XDP_SOURCE
 
 #include "xdp/profile/plugin/aie/aie_plugin.h"
+#include "xdp/profile/plugin/aie/aie_sampler.h"
 #include "xdp/profile/writer/aie/aie_writer.h"
 
 #include "core/common/message.h"
 #include "core/common/system.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
+#include "core/common/thread.h"
 #include "core/include/experimental/xrt-next.h"
 #include "core/edge/user/shim.h"
 #include "core/edge/common/aie_parser.h"
@@ -75,6 +77,9 @@ namespace xdp {
     if (it == thread_ctrl_map.end())
       return;
 
+    std::unique_ptr<AIECounterSampler> sampler;
+    xrt_core::uuid samplerUuid;
+    uint64_t samplerCounters = 0;
     auto& should_continue = it->second;
     while (should_continue) {
       // Wait until xclbin has been loaded and device has been updated in database
@@ -84,30 +89,36 @@ namespace xdp {
       if (!aieArray)
         continue;
 
-      // Iterate over all AIE Counters
+      // Build the sweep plan once per xclbin and set of counters.
+      // The plan holds only the valid counters, so it is keyed on the
+      // xclbin and the number of counters it was built from.
+      auto deviceInfo = db->getStaticInfo().getDeviceInfo(index);
+      if (!deviceInfo)
+        continue;
+      auto uuid = deviceInfo->currentXclbinUUID();
       auto numCounters = db->getStaticInfo().getNumAIECounter(index);
-      for (uint64_t c=0; c < numCounters; c++) {
-        auto aie = db->getStaticInfo().getAIECounter(index, c);
-        if (!aie)
-          continue;
-
-        std::vector<uint64_t> values;
-        values.push_back(aie->column);
-        values.push_back(aie->row);
-        values.push_back(aie->startEvent);
-        values.push_back(aie->endEvent);
-        values.push_back(aie->resetEvent);
-
-        // Read counter value from device
-        XAie_LocType tileLocation = XAie_TileLoc(aie->column, aie->row+1);
-        uint32_t counterValue;
-        XAie_PerfCounterGet(aieArray->getDevInst(), tileLocation, XAIE_CORE_MOD, aie->counterNumber, &counterValue);
-        values.push_back(counterValue);
-
-        // Get timestamp in milliseconds
-        double timestamp = xrt_core::time_ns() / 1.0e6;
-        db->getDynamicInfo().addAIESample(index, timestamp, values);
+      if (!sampler || uuid != samplerUuid || numCounters != samplerCounters) {
+        std::vector<AIECounterSampler::Counter> counters;
+        counters.reserve(numCounters);
+        for (uint64_t c=0; c < numCounters; c++) {
+          auto aie = db->getStaticInfo().getAIECounter(index, c);
+          if (!aie)
+            continue;
+          counters.push_back({aie->column, aie->row, aie->counterNumber,
+                              aie->startEvent, aie->endEvent, aie->resetEvent,
+                              aie->module});
+        }
+        sampler = std::make_unique<AIECounterSampler>(counters);
+        samplerUuid = uuid;
+        samplerCounters = numCounters;
       }
+
+      // Read all counters with one timestamp (in milliseconds) per sweep
+      double timestamp = xrt_core::time_ns() / 1.0e6;
+      auto& samples = sampler->sweep(aieArray->getDevInst(), timestamp);
+      if (!samples.empty())
+        db->getDynamicInfo().addAIESamples(index, samples.data(), samples.size());
+
       std::this_thread::sleep_for(std::chrono::microseconds(mPollingInterval));     
     }
   }
@@ -162,7 +173,7 @@ namespace xdp {
 
     // Start the AIE profiling thread
     thread_ctrl_map[handle] = true;
-    auto device_thread = std::thread(&AIEProfilingPlugin::pollAIECounters, this, mIndex, handle);
+    auto device_thread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &AIEProfilingPlugin::pollAIECounters, this, mIndex, handle);
     thread_map[handle] = std::move(device_thread);
 
     ++mIndex;
@@ -21,6 +21,7 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <iostream>
 
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
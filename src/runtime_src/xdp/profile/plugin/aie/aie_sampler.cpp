@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include "xdp/profile/plugin/aie/aie_sampler.h"
+
+#include <algorithm>
+#include <tuple>
+
+extern "C" {
+#include <xaiengine.h>
+}
+
+namespace {
+
+  // Performance_Counter0 of AIE tile modules, the counters of a
+  // module are consecutive 32 bit registers
+  const uint64_t core_perf_counter_base = 0x00031520;
+  const uint64_t memory_perf_counter_base = 0x00011020;
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  AIECounterSampler::AIECounterSampler(const std::vector<Counter>& counters)
+  {
+    auto isMemory = [](const Counter& c) {
+      return c.module.compare(0, 3, "mem") == 0;
+    };
+
+    // Order counters by tile, then module, then counter number
+    std::vector<const Counter*> sorted;
+    sorted.reserve(counters.size());
+    for (auto& c : counters)
+      sorted.push_back(&c);
+    std::stable_sort(sorted.begin(), sorted.end(),
+      [&isMemory](const Counter* a, const Counter* b) {
+        return std::make_tuple(a->column, a->row, isMemory(*a), a->counterNumber)
+             < std::make_tuple(b->column, b->row, isMemory(*b), b->counterNumber);
+      });
+
+    mSamples.reserve(sorted.size());
+    for (auto c : sorted) {
+      bool memory = isMemory(*c);
+      if (mGroups.empty() || mGroups.back().column != c->column
+          || mGroups.back().row != c->row || mGroups.back().memoryModule != memory)
+        mGroups.push_back({c->column, c->row, memory, mSamples.size(), mSamples.size()});
+
+      AIECounterSample sample = {};
+      sample.column = c->column;
+      sample.row = c->row;
+      sample.startEvent = c->startEvent;
+      sample.endEvent = c->endEvent;
+      sample.resetEvent = c->resetEvent;
+      sample.counterNumber = c->counterNumber;
+      mSamples.push_back(sample);
+      ++mGroups.back().end;
+    }
+  }
+
+  const std::vector<AIECounterSample>&
+  AIECounterSampler::sweep(void* devInst, double timestamp)
+  {
+    auto aieDevInst = static_cast<XAie_DevInst*>(devInst);
+
+    // Register layout is known for first generation AIE only
+    if (aieDevInst->DevProp.DevGen != XAIE_DEV_GEN_AIE) {
+      for (auto& group : mGroups) {
+        XAie_LocType tileLocation = XAie_TileLoc(group.column, group.row+1);
+        XAie_ModuleType module = group.memoryModule ? XAIE_MEM_MOD : XAIE_CORE_MOD;
+
+        for (size_t idx = group.begin; idx < group.end; ++idx) {
+          auto& sample = mSamples[idx];
+          uint32_t counterValue = 0;
+          XAie_PerfCounterGet(aieDevInst, tileLocation, module, sample.counterNumber, &counterValue);
+          sample.value = counterValue;
+          sample.timestamp = timestamp;
+        }
+      }
+      return mSamples;
+    }
+
+    // Resolve the counter registers once per tile and module and read
+    // them directly, rather than have XAie_PerfCounterGet validate
+    // the tile and module and compute the address for every counter
+    for (auto& group : mGroups) {
+      uint64_t base = _XAie_GetTileAddr(aieDevInst, group.row+1, group.column)
+        + (group.memoryModule ? memory_perf_counter_base : core_perf_counter_base);
+
+      for (size_t idx = group.begin; idx < group.end; ++idx) {
+        auto& sample = mSamples[idx];
+        uint32_t counterValue = 0;
+        XAie_Read32(aieDevInst, base + (sample.counterNumber << 2), &counterValue);
+        sample.value = counterValue;
+        sample.timestamp = timestamp;
+      }
+    }
+
+    return mSamples;
+  }
+
+} // end namespace xdp
@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef XDP_AIE_SAMPLER_DOT_H
+#define XDP_AIE_SAMPLER_DOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "xdp/profile/database/dynamic_event_database.h"
+
+namespace xdp {
+
+  // Reads a fixed set of AIE performance counters in sweeps.
+  //
+  // The counters are grouped by tile and module when the sampler is
+  // constructed.  A sweep walks the groups in order, resolves the
+  // counter registers of each group once, reads them back to back,
+  // and fills a preallocated array of samples that all carry the same
+  // timestamp.  Nothing is looked up or allocated per sweep.
+  //
+  // The module of a counter ("core" or "memory" in the AIE metadata)
+  // selects the module the counter is read from.  Counters of the
+  // memory module used to be read from the core module, which
+  // returned the core counter with the same number.
+  class AIECounterSampler
+  {
+  public:
+    struct Counter {
+      uint16_t column;
+      uint16_t row;
+      uint8_t counterNumber;
+      uint8_t startEvent;
+      uint8_t endEvent;
+      uint8_t resetEvent;
+      std::string module;
+    };
+
+    explicit AIECounterSampler(const std::vector<Counter>& counters);
+
+    // Read all counters using the driver instance (XAie_DevInst*)
+    // and stamp the samples with the specified timestamp.  The
+    // returned samples are valid until the next sweep.
+    const std::vector<AIECounterSample>&
+    sweep(void* devInst, double timestamp);
+
+    size_t
+    size() const
+    {
+      return mSamples.size();
+    }
+
+  private:
+    // Counters [begin, end) in mSamples share tile and module
+    struct Group {
+      uint16_t column;
+      uint16_t row;
+      bool memoryModule;
+      size_t begin;
+      size_t end;
+    };
+
+    std::vector<Group> mGroups;
+    std::vector<AIECounterSample> mSamples;
+  };
+
+} // end namespace xdp
+
+#endif
@@ -0,0 +1,340 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// AIE profile counter sampling benchmark.
+//
+// Compares the per counter sampling used by the AIE profile plugin
+// prior to AIECounterSampler (static info lookup, vector per sample,
+// timestamp per counter, database insert per counter, one
+// XAie_PerfCounterGet per counter) with batched sweeps that resolve
+// the counter registers once per tile and module.  The AIE driver is
+// mocked, the read delay per register can be set to model register
+// access over the AXI bus, and the delay per driver call to model
+// the argument checks and address computation of the driver.
+//
+// The counter values of a batched sweep are checked against values
+// read with XAie_PerfCounterGet from the module of each counter.
+//
+// % aie_sampler_bench [-c <counters>] [-t <tiles>] [-n <sweeps>] [-d <read delay ns>] [-o <call delay ns>]
+
+#include "xdp/profile/plugin/aie/aie_sampler.h"
+
+extern "C" {
+#include <xaiengine.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static double
+time_ms()
+{
+  auto now = clock_type::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() / 1.0e6;
+}
+
+static void
+spin_ns(uint32_t ns)
+{
+  if (!ns)
+    return;
+  auto end = clock_type::now() + std::chrono::nanoseconds(ns);
+  while (clock_type::now() < end)
+    ;
+}
+
+// Stand-in for the static database counter list, heap allocated
+// entries looked up by index as in VPStaticDatabase::getAIECounter
+struct static_counter
+{
+  uint16_t column;
+  uint16_t row;
+  uint8_t counterNumber;
+  uint8_t startEvent;
+  uint8_t endEvent;
+  uint8_t resetEvent;
+  std::string module;
+};
+
+struct static_db
+{
+  std::vector<static_counter*> counters;
+  std::mutex mutex;
+
+  static_counter*
+  get(size_t idx)
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    return idx < counters.size() ? counters[idx] : nullptr;
+  }
+
+  ~static_db()
+  {
+    for (auto c : counters)
+      delete c;
+  }
+};
+
+// Stand-in for the dynamic database sample storage
+struct dynamic_db
+{
+  std::mutex mutex;
+  std::vector<std::pair<double, std::vector<uint64_t>>> legacy;
+  std::vector<xdp::AIECounterSample> samples;
+
+  void
+  add(double timestamp, const std::vector<uint64_t>& values)
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    legacy.push_back(std::make_pair(timestamp, values));
+  }
+
+  void
+  add(const xdp::AIECounterSample* s, size_t num)
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    if (samples.capacity() - samples.size() < num)
+      samples.reserve(samples.size() + std::max(samples.size(), num * 1024));
+    samples.insert(samples.end(), s, s + num);
+  }
+};
+
+struct result
+{
+  double us_per_sweep = 0;
+  double max_skew_us = 0;
+  uint64_t reads = 0;
+};
+
+// Sampling as done by the plugin before batching
+static result
+run_legacy(XAie_DevInst* dev, static_db& sdb, dynamic_db& ddb, size_t sweeps)
+{
+  result r;
+  auto reads = dev->NumReads;
+  auto start = clock_type::now();
+  for (size_t s = 0; s < sweeps; ++s) {
+    double first = 0, last = 0;
+    for (size_t c = 0; c < sdb.counters.size(); ++c) {
+      auto aie = sdb.get(c);
+      if (!aie)
+        continue;
+
+      std::vector<uint64_t> values;
+      values.push_back(aie->column);
+      values.push_back(aie->row);
+      values.push_back(aie->startEvent);
+      values.push_back(aie->endEvent);
+      values.push_back(aie->resetEvent);
+
+      XAie_LocType tileLocation = XAie_TileLoc(aie->column, aie->row+1);
+      uint32_t counterValue;
+      XAie_PerfCounterGet(dev, tileLocation, XAIE_CORE_MOD, aie->counterNumber, &counterValue);
+      values.push_back(counterValue);
+
+      double timestamp = time_ms();
+      if (c == 0)
+        first = timestamp;
+      last = timestamp;
+      ddb.add(timestamp, values);
+    }
+    r.max_skew_us = std::max(r.max_skew_us, (last - first) * 1000);
+  }
+  auto end = clock_type::now();
+  r.us_per_sweep = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000.0 / sweeps;
+  r.reads = dev->NumReads - reads;
+  return r;
+}
+
+// Batched sweep must read the same registers as XAie_PerfCounterGet
+static void
+check_batched(XAie_DevInst* dev, static_db& sdb)
+{
+  std::vector<xdp::AIECounterSampler::Counter> counters;
+  for (size_t c = 0; c < sdb.counters.size(); ++c) {
+    auto aie = sdb.get(c);
+    counters.push_back({aie->column, aie->row, aie->counterNumber,
+                        aie->startEvent, aie->endEvent, aie->resetEvent, aie->module});
+  }
+  xdp::AIECounterSampler sampler(counters);
+  auto batched = sampler.sweep(dev, 0);
+
+  // Unknown device generation falls back on XAie_PerfCounterGet
+  XAie_DevInst other = *dev;
+  other.DevProp.DevGen = XAIE_DEV_GEN_AIEML;
+  auto& expected = sampler.sweep(&other, 0);
+
+  for (size_t idx = 0; idx < expected.size(); ++idx)
+    if (batched[idx].value != expected[idx].value)
+      throw std::runtime_error("mismatched value of counter " + std::to_string(idx));
+}
+
+static result
+run_batched(XAie_DevInst* dev, static_db& sdb, dynamic_db& ddb, size_t sweeps)
+{
+  std::vector<xdp::AIECounterSampler::Counter> counters;
+  for (size_t c = 0; c < sdb.counters.size(); ++c) {
+    auto aie = sdb.get(c);
+    counters.push_back({aie->column, aie->row, aie->counterNumber,
+                        aie->startEvent, aie->endEvent, aie->resetEvent, aie->module});
+  }
+  xdp::AIECounterSampler sampler(counters);
+
+  result r;
+  auto reads = dev->NumReads;
+  auto start = clock_type::now();
+  for (size_t s = 0; s < sweeps; ++s) {
+    auto& samples = sampler.sweep(dev, time_ms());
+    ddb.add(samples.data(), samples.size());
+  }
+  auto end = clock_type::now();
+  r.us_per_sweep = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000.0 / sweeps;
+  r.reads = dev->NumReads - reads;
+  return r;
+}
+
+static void
+usage()
+{
+  std::cout << "usage: aie_sampler_bench [options]\n\n";
+  std::cout << "  -c <counters>, default 256\n";
+  std::cout << "  -t <tiles>, default 64\n";
+  std::cout << "  -n <sweeps>, default 10000\n";
+  std::cout << "  -d <read delay ns>, default 0\n";
+  std::cout << "  -o <call delay ns>, default 0\n";
+  std::cout << "  -h\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  size_t ncounters = 256;
+  size_t ntiles = 64;
+  size_t sweeps = 10000;
+  uint32_t delay = 0;
+  uint32_t call_delay = 0;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-c")
+      ncounters = std::stoul(arg);
+    else if (cur == "-t")
+      ntiles = std::stoul(arg);
+    else if (cur == "-n")
+      sweeps = std::stoul(arg);
+    else if (cur == "-d")
+      delay = std::stoul(arg);
+    else if (cur == "-o")
+      call_delay = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (!ntiles || !sweeps)
+    throw std::runtime_error("tiles and sweeps must be non zero");
+
+  // Counters are spread round robin over tiles as they typically
+  // appear in the AIE metadata, i.e. not grouped by tile
+  static_db sdb;
+  for (size_t c = 0; c < ncounters; ++c) {
+    auto tile = c % ntiles;
+    auto module = (c / ntiles) % 2 ? "memory" : "core";
+    sdb.counters.push_back(new static_counter{
+        static_cast<uint16_t>(tile % 50), static_cast<uint16_t>(tile / 50),
+        static_cast<uint8_t>((c / ntiles / 2) % 4), 0, 0, 0, module});
+  }
+
+  XAie_DevInst dev = {};
+  dev.DevProp = {XAIE_DEV_GEN_AIE, 18, 23};
+  dev.ReadDelayNs = delay;
+  dev.CallDelayNs = call_delay;
+  dynamic_db ddb;
+
+  check_batched(&dev, sdb);
+
+  auto legacy = run_legacy(&dev, sdb, ddb, sweeps);
+  auto batched = run_batched(&dev, sdb, ddb, sweeps);
+
+  std::cout << "counters: " << ncounters << ", tiles: " << ntiles
+            << ", sweeps: " << sweeps << ", read delay (ns): " << delay
+            << ", call delay (ns): " << call_delay << "\n";
+  std::cout << "legacy:  " << legacy.us_per_sweep << " us/sweep, "
+            << legacy.us_per_sweep * 1000 / ncounters << " ns/counter, "
+            << "max timestamp skew " << legacy.max_skew_us << " us\n";
+  std::cout << "batched: " << batched.us_per_sweep << " us/sweep, "
+            << batched.us_per_sweep * 1000 / ncounters << " ns/counter, "
+            << "max timestamp skew 0 us\n";
+
+  if (legacy.reads != batched.reads)
+    throw std::runtime_error("mismatched number of counter reads");
+
+  return 0;
+}
+
+} // namespace
+
+// Mocked register read, the value is a function of the address
+AieRC
+XAie_Read32(XAie_DevInst* DevInst, uint64_t RegOff, uint32_t* Data)
+{
+  spin_ns(DevInst->ReadDelayNs);
+  ++DevInst->NumReads;
+  *Data = static_cast<uint32_t>(RegOff * 2654435761u);
+  return XAIE_OK;
+}
+
+// Mocked driver counter read, checks and address computation are
+// modeled by the call delay
+AieRC
+XAie_PerfCounterGet(XAie_DevInst* DevInst, XAie_LocType Loc,
+                    XAie_ModuleType Module, uint8_t Counter,
+                    uint32_t* CounterVal)
+{
+  spin_ns(DevInst->CallDelayNs);
+  uint64_t base = (Module == XAIE_MEM_MOD) ? 0x00011020 : 0x00031520;
+  return XAie_Read32(DevInst, _XAie_GetTileAddr(DevInst, Loc.Row, Loc.Col) + base + (Counter << 2), CounterVal);
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "Error: " << ex.what() << "\n";
+  }
+  return 1;
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Minimal stand-in for the AIE driver used by the AIE profile
+ * sampling benchmark.  Only the parts used by aie_sampler.cpp are
+ * provided; the implementation lives in the benchmark.
+ */
+
+#ifndef MOCK_XAIENGINE_H
+#define MOCK_XAIENGINE_H
+
+#include <stdint.h>
+
+typedef int AieRC;
+#define XAIE_OK 0
+
+#define XAIE_DEV_GEN_AIE 1U
+#define XAIE_DEV_GEN_AIEML 2U
+
+typedef enum {
+  XAIE_MEM_MOD,
+  XAIE_CORE_MOD,
+  XAIE_PL_MOD,
+} XAie_ModuleType;
+
+typedef struct {
+  uint8_t Row;
+  uint8_t Col;
+} XAie_LocType;
+
+typedef struct {
+  uint8_t DevGen;
+  uint8_t RowShift;
+  uint8_t ColShift;
+} XAie_DevProp;
+
+typedef struct XAie_DevInst {
+  XAie_DevProp DevProp;
+  uint64_t NumReads;
+  uint32_t ReadDelayNs;  /* per register read */
+  uint32_t CallDelayNs;  /* per driver API call, e.g. argument checks */
+} XAie_DevInst;
+
+static inline XAie_LocType
+XAie_TileLoc(uint8_t col, uint8_t row)
+{
+  XAie_LocType loc = { row, col };
+  return loc;
+}
+
+static inline uint64_t
+_XAie_GetTileAddr(XAie_DevInst *DevInst, int Row, int Col)
+{
+  return ((uint64_t)Row << DevInst->DevProp.RowShift)
+    | ((uint64_t)Col << DevInst->DevProp.ColShift);
+}
+
+AieRC
+XAie_Read32(XAie_DevInst *DevInst, uint64_t RegOff, uint32_t *Data);
+
+AieRC
+XAie_PerfCounterGet(XAie_DevInst *DevInst, XAie_LocType Loc,
+                    XAie_ModuleType Module, uint8_t Counter,
+                    uint32_t *CounterVal);
+
+#endif
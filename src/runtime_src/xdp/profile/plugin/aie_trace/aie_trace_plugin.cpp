@@ -28,6 +28,7 @@
 #include "xdp/profile/device/aie_trace/aie_trace_offload.h"
 #include "xdp/profile/database/events/creator/aie_trace_data_logger.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/message.h"
 #include <iostream>
 
@@ -177,11 +178,18 @@ namespace xdp {
 
     AIETraceDataLogger* aieTraceLogger = new AIETraceDataLogger(deviceId);
 
+    // Periodic offload reads trace while the design runs, so the trace
+    // buffers can be used as circular buffers
+    bool isContinuous = xrt_core::config::get_aie_trace_periodic_offload();
+    uint64_t offloadInterval = xrt_core::config::get_aie_trace_buffer_offload_interval_ms();
+
     AIETraceOffload* aieTraceOffloader = new AIETraceOffload(handle, deviceId,
                                               deviceIntf, aieTraceLogger,
                                               isPLIO,          // isPLIO 
                                               aieTraceBufSz,   // total trace buffer size
-                                              numAIETraceOutput);  // numStream
+                                              numAIETraceOutput,  // numStream
+                                              isContinuous,
+                                              offloadInterval);
 
     if(!aieTraceOffloader->initReadTrace()) {
       std::string msg = "Allocation of buffer for AIE trace failed. AIE trace will not be available.";
@@ -190,6 +198,7 @@ namespace xdp {
       delete aieTraceLogger;
       return;
     }
+    aieTraceOffloader->startOffload();
     aieOffloaders[deviceId] = std::make_tuple(aieTraceOffloader, aieTraceLogger, deviceIntf);
   }
 
@@ -226,6 +235,7 @@ namespace xdp {
       auto offloader = std::get<0>(aieOffloaders[deviceId]);
       auto logger    = std::get<1>(aieOffloaders[deviceId]);
 
+      offloader->stopOffload();
       offloader->readTrace();
       if (offloader->isTraceBufferFull())
         xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", AIE_TS2MM_WARN_MSG_BUF_FULL);
@@ -246,6 +256,7 @@ namespace xdp {
       auto offloader = std::get<0>(o.second);
       auto logger    = std::get<1>(o.second);
 
+      offloader->stopOffload();
       offloader->readTrace();
       if (offloader->isTraceBufferFull())
         xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", AIE_TS2MM_WARN_MSG_BUF_FULL);
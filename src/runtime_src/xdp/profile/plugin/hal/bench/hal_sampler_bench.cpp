@@ -0,0 +1,227 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// HAL API trace sampling benchmark.
+//
+// Drives HALSampler the way the HAL plugin does for each callback, with
+// call latencies modeled on the noop shim: a log-normal distribution
+// around a few us with rare calls that are 100 times slower.  The noop
+// shim does not dispatch HAL callbacks, so the sampler is driven
+// directly with simulated timestamps.
+//
+// Reports the sampler overhead per call and the error of the estimated
+// latency quantiles against the exact quantiles of all calls for a
+// range of sampling rates.  The error is reported both as latency and
+// as rank, the fraction of all calls between estimated and requested
+// quantile, which is what sampling bounds where the distribution has
+// a cliff such as the slow calls.
+//
+// % hal_sampler_bench [-t <threads>] [-n <calls per thread>] [-s <slow call us>]
+
+#include "xdp/profile/plugin/hal/hal_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// CPU time of the calling thread, so that overhead is not inflated
+// when there are more threads than cores
+static double
+thread_cpu_ns()
+{
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1.0e9 + ts.tv_nsec;
+}
+
+// ExecWait in HalCallbackType order
+constexpr unsigned int exec_wait_api = 10;
+
+static void
+usage()
+{
+  std::cout << "usage: hal_sampler_bench [options]\n\n";
+  std::cout << "  -t <threads>, default 4\n";
+  std::cout << "  -n <calls per thread>, default 1000000\n";
+  std::cout << "  -s <slow call us>, default 1000\n";
+  std::cout << "  -h\n";
+}
+
+static std::vector<uint64_t>
+make_latencies(size_t calls, unsigned int seed)
+{
+  std::mt19937_64 gen(seed);
+  std::lognormal_distribution<double> lognormal(std::log(5000.0), 0.6);
+  std::bernoulli_distribution spike(0.001);
+  std::vector<uint64_t> latencies(calls);
+  for (auto& ns : latencies)
+    ns = static_cast<uint64_t>(lognormal(gen) * (spike(gen) ? 100 : 1));
+  return latencies;
+}
+
+// Feed one thread's calls to the sampler, returns CPU ns
+static double
+drive(xdp::HALSampler* sampler, const std::vector<uint64_t>& latencies, uint64_t id, uint64_t stride)
+{
+  uint64_t ts = 0;
+  uint64_t slow = 0;
+  auto begin = thread_cpu_ns();
+  for (auto ns : latencies) {
+    if (sampler) {
+      uint64_t start = 0;
+      sampler->start(exec_wait_api, id, ts);
+      if (sampler->end(exec_wait_api, id, ts + ns, start) == xdp::HALSampler::result::slow)
+        ++slow;
+    }
+    ts += ns;
+    id += stride;
+  }
+  auto end = thread_cpu_ns();
+  if (slow == UINT64_MAX)  // keep the loop from being optimized away
+    std::cout << ts;
+  return end - begin;
+}
+
+static double
+run_threads(xdp::HALSampler* sampler, const std::vector<std::vector<uint64_t>>& latencies)
+{
+  std::vector<double> elapsed(latencies.size());
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < latencies.size(); ++t)
+    threads.emplace_back([&, t] { elapsed[t] = drive(sampler, latencies[t], t, latencies.size()); });
+  for (auto& thread : threads)
+    thread.join();
+  return std::accumulate(elapsed.begin(), elapsed.end(), 0.0);
+}
+
+static int
+run(int argc, char** argv)
+{
+  size_t threads = 4;
+  size_t calls = 1000000;
+  std::string slow_us = "1000";
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-t")
+      threads = std::stoul(arg);
+    else if (cur == "-n")
+      calls = std::stoul(arg);
+    else if (cur == "-s")
+      slow_us = arg;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (!threads || !calls)
+    throw std::runtime_error("threads and calls must be non zero");
+
+  std::vector<std::vector<uint64_t>> latencies;
+  std::vector<uint64_t> all;
+  for (size_t t = 0; t < threads; ++t) {
+    latencies.push_back(make_latencies(calls, static_cast<unsigned int>(t + 1)));
+    all.insert(all.end(), latencies.back().begin(), latencies.back().end());
+  }
+  std::sort(all.begin(), all.end());
+
+  const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+  auto exact = [&all](double q) {
+    auto rank = static_cast<size_t>(q * all.size() + 0.5);
+    return static_cast<double>(all[std::max<size_t>(rank, 1) - 1]);
+  };
+
+  // Fraction of all calls with latency below ns
+  auto rank = [&all](double ns) {
+    auto it = std::lower_bound(all.begin(), all.end(), static_cast<uint64_t>(ns));
+    return static_cast<double>(it - all.begin()) / all.size();
+  };
+
+  auto baseline = run_threads(nullptr, latencies);
+
+  std::cout << "calls: " << threads * calls << " on " << threads << " threads"
+            << ", slow call threshold: " << slow_us << " us\n";
+  std::cout << "exact (ns)";
+  for (auto q : quantiles)
+    std::cout << " p" << q * 100 << ": " << exact(q);
+  std::cout << "\n\n";
+
+  bool failed = false;
+  for (auto rate : {1.0, 0.1, 0.01, 0.001}) {
+    xdp::HALSampler sampler(std::to_string(rate), slow_us);
+    auto elapsed = run_threads(&sampler, latencies) - baseline;
+
+    std::cout << "rate " << rate << ": overhead "
+              << std::max(elapsed, 0.0) / (threads * calls) << " ns/call\n";
+    for (auto q : quantiles) {
+      auto estimate = static_cast<double>(sampler.quantile(exec_wait_api, q));
+      auto error = std::abs(estimate - exact(q)) / exact(q);
+      std::cout << "  p" << q * 100 << ": " << estimate << " ns, error " << error * 100 << "%"
+                << ", rank error " << std::abs(rank(estimate) - q) * 100 << "%\n";
+
+      // Without sampling the only error is the histogram resolution
+      if (rate == 1.0 && error > 1.0 / (1 << xdp::HALSampler::sub_bits))
+        failed = true;
+    }
+  }
+
+  std::cout << "\n";
+  xdp::HALSampler sampler("0.01", slow_us);
+  run_threads(&sampler, latencies);
+  sampler.write(std::cout);
+
+  if (failed)
+    throw std::runtime_error("quantile error exceeds histogram resolution");
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
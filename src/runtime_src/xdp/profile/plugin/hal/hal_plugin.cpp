@@ -21,6 +21,7 @@
 #include "xdp/profile/plugin/hal/hal_plugin.h"
 #include "xdp/profile/writer/hal/hal_host_trace_writer.h"
 #include "xdp/profile/writer/hal/hal_summary_writer.h"
+#include "xdp/profile/writer/hal/hal_latency_writer.h"
 
 #include "xdp/profile/plugin/vp_base/utility.h"
 #include "xdp/profile/device/tracedefs.h"
@@ -29,6 +30,7 @@
 
 #include "core/common/xrt_profiling.h"
 #include "core/common/message.h"
+#include "core/common/config_reader.h"
 
 #define MAX_PATH_SZ 512
 
@@ -55,6 +57,19 @@ namespace xdp {
     writers.push_back(new HALSummaryWriter("hal_summary.csv"));
 #endif
 
+    auto rates = xrt_core::config::get_xrt_trace_sampling() ;
+    if (!rates.empty()) {
+      try {
+        sampler = std::make_unique<HALSampler>(rates, xrt_core::config::get_xrt_trace_slow_call_us()) ;
+        writers.push_back(new HALLatencyWriter("hal_api_latency.csv", sampler.get())) ;
+      }
+      catch (const std::exception& ex) {
+        std::string msg = "Invalid HAL API trace sampling configuration, tracing all calls: " ;
+        msg += ex.what() ;
+        xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg) ;
+      }
+    }
+
   }
 
   HALPlugin::~HALPlugin()
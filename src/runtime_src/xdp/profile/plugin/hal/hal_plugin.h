@@ -17,13 +17,18 @@
 #ifndef HAL_PLUGIN_DOT_H
 #define HAL_PLUGIN_DOT_H
 
+#include <memory>
+
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
+#include "xdp/profile/plugin/hal/hal_sampler.h"
 
 namespace xdp {
 
   class HALPlugin : public XDPPlugin
   {
   private:
+    // Set when only a sample of HAL API calls is traced
+    std::unique_ptr<HALSampler> sampler ;
 
   public:
     XDP_EXPORT
@@ -34,6 +39,8 @@ namespace xdp {
 
     XDP_EXPORT
     virtual void writeAll(bool openNewFiles) ;
+
+    inline HALSampler* getSampler() { return sampler.get() ; }
   } ;
 
 }
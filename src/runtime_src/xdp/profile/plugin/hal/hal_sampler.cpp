@@ -0,0 +1,331 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xdp/profile/plugin/hal/hal_sampler.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Names in HalCallbackType order, same as used for the trace events
+static const char* api_names[xdp::HALSampler::num_apis] = {
+  "AllocBO", "AllocUserPtrBO", "FreeBO", "WriteBO", "ReadBO", "MapBO",
+  "SyncBO", "CopyBO", "GetBOProp", "ExecBuf", "ExecWait", "UnmgdRead",
+  "UnmgdWrite", "xclRead", "xclWrite", "RegRead", "RegWrite", "Probe",
+  "LockDevice", "UnLockDevice", "Open", "Close", "OpenContext",
+  "CloseContext", "xclLoadXclbin"
+};
+
+// Calls in progress on this thread.  HAL calls nest rarely and not
+// deeply, calls beyond max_depth are counted but not sampled.
+struct pending_call
+{
+  uint64_t idcode;
+  uint64_t start;
+  unsigned int api;
+  bool sampled;
+};
+
+constexpr size_t max_depth = 8;
+
+static std::atomic<unsigned int> next_shard {0};
+
+struct thread_state
+{
+  pending_call calls[max_depth];
+  size_t depth = 0;
+  unsigned int shard;
+  uint64_t random;
+
+  thread_state()
+    : shard(next_shard++ % xdp::HALSampler::num_shards)
+    , random(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+             ^ reinterpret_cast<uintptr_t>(this))
+  {
+    if (!random)
+      random = 0x9e3779b97f4a7c15ULL;
+  }
+
+  // xorshift64*
+  uint64_t
+  next()
+  {
+    random ^= random >> 12;
+    random ^= random << 25;
+    random ^= random >> 27;
+    return random * 0x2545f4914f6cdd1dULL;
+  }
+};
+
+static thread_state&
+get_thread_state()
+{
+  static thread_local thread_state state;
+  return state;
+}
+
+static std::vector<std::string>
+split(const std::string& str)
+{
+  std::vector<std::string> tokens;
+  size_t pos = 0;
+  while (pos <= str.size()) {
+    auto end = str.find(',', pos);
+    if (end == std::string::npos)
+      end = str.size();
+    auto token = str.substr(pos, end - pos);
+    auto first = token.find_first_not_of(" \t");
+    if (first != std::string::npos)
+      tokens.push_back(token.substr(first, token.find_last_not_of(" \t") - first + 1));
+    pos = end + 1;
+  }
+  return tokens;
+}
+
+static unsigned int
+api_index(const std::string& name)
+{
+  for (unsigned int api = 0; api < xdp::HALSampler::num_apis; ++api)
+    if (name == api_names[api])
+      return api;
+  throw std::runtime_error("unknown HAL API '" + name + "'");
+}
+
+// Apply a value to all apis that are not explicitly listed in the
+// specification, then to the listed apis
+template <typename Apply>
+static void
+parse(const std::string& spec, Apply apply)
+{
+  auto tokens = split(spec);
+  for (auto& token : tokens)
+    if (token.find(':') == std::string::npos)
+      for (unsigned int api = 0; api < xdp::HALSampler::num_apis; ++api)
+        apply(api, std::stod(token));
+
+  for (auto& token : tokens) {
+    auto colon = token.find(':');
+    if (colon != std::string::npos)
+      apply(api_index(token.substr(0, colon)), std::stod(token.substr(colon + 1)));
+  }
+}
+
+} // namespace
+
+namespace xdp {
+
+// Remove when c++17
+constexpr unsigned int HALSampler::num_apis;
+constexpr unsigned int HALSampler::sub_bits;
+constexpr unsigned int HALSampler::max_bits;
+constexpr unsigned int HALSampler::num_buckets;
+constexpr unsigned int HALSampler::num_shards;
+
+HALSampler::
+HALSampler(const std::string& rates, const std::string& slow_us)
+{
+  parse(rates, [this](unsigned int api, double rate) {
+    if (rate < 0.0 || rate > 1.0)
+      throw std::runtime_error("HAL API sampling rate must be in [0, 1]");
+    auto& stats = m_apis[api];
+    stats.rate = rate;
+    stats.threshold = (rate >= 1.0)
+      ? UINT64_MAX
+      : static_cast<uint64_t>(rate * 18446744073709551616.0);
+  });
+
+  parse(slow_us, [this](unsigned int api, double us) {
+    if (us < 0.0)
+      throw std::runtime_error("HAL API slow call threshold must not be negative");
+    m_apis[api].slow_ns = static_cast<uint64_t>(us * 1000);
+  });
+}
+
+bool
+HALSampler::
+start(unsigned int api, uint64_t idcode, uint64_t ts)
+{
+  auto& stats = m_apis[api];
+  auto& state = get_thread_state();
+  stats.calls[state.shard].calls.fetch_add(1, std::memory_order_relaxed);
+
+  if (state.depth == max_depth)
+    return false;
+
+  bool sampled = stats.threshold == UINT64_MAX || state.next() < stats.threshold;
+  state.calls[state.depth++] = {idcode, ts, api, sampled};
+  return sampled;
+}
+
+HALSampler::result
+HALSampler::
+end(unsigned int api, uint64_t idcode, uint64_t ts, uint64_t& start_ts)
+{
+  auto& state = get_thread_state();
+
+  // Almost always the innermost call
+  size_t idx = state.depth;
+  while (idx && state.calls[idx - 1].idcode != idcode)
+    --idx;
+  if (!idx)
+    return result::drop;
+
+  auto call = state.calls[idx - 1];
+  std::memmove(&state.calls[idx - 1], &state.calls[idx], (state.depth - idx) * sizeof(pending_call));
+  --state.depth;
+
+  auto& stats = m_apis[api];
+  auto ns = ts - call.start;
+  if (call.sampled) {
+    record(stats, ns);
+    return result::traced;
+  }
+
+  if (stats.slow_ns && ns >= stats.slow_ns) {
+    stats.slow.fetch_add(1, std::memory_order_relaxed);
+    start_ts = call.start;
+    return result::slow;
+  }
+
+  return result::drop;
+}
+
+void
+HALSampler::
+record(api_stats& stats, uint64_t ns)
+{
+  stats.sampled.fetch_add(1, std::memory_order_relaxed);
+  stats.sum_ns.fetch_add(ns, std::memory_order_relaxed);
+  stats.buckets[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+
+  auto max = stats.max_ns.load(std::memory_order_relaxed);
+  while (ns > max && !stats.max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+    ;
+}
+
+unsigned int
+HALSampler::
+bucket(uint64_t ns)
+{
+  if (ns < (1ULL << sub_bits))
+    return static_cast<unsigned int>(ns);
+
+  unsigned int msb = sub_bits;
+  while (msb < 63 && (ns >> (msb + 1)))
+    ++msb;
+  if (msb >= max_bits)
+    return num_buckets - 1;
+
+  auto sub = static_cast<unsigned int>(ns >> (msb - sub_bits)) & ((1U << sub_bits) - 1);
+  return ((msb - sub_bits + 1) << sub_bits) + sub;
+}
+
+uint64_t
+HALSampler::
+bucket_low(unsigned int idx)
+{
+  if (idx < (1U << sub_bits))
+    return idx;
+
+  unsigned int msb = (idx >> sub_bits) + sub_bits - 1;
+  uint64_t sub = idx & ((1U << sub_bits) - 1);
+  return (1ULL << msb) + (sub << (msb - sub_bits));
+}
+
+uint64_t
+HALSampler::
+quantile(unsigned int api, double q) const
+{
+  auto& stats = m_apis[api];
+  uint64_t total = 0;
+  for (auto& count : stats.buckets)
+    total += count.load(std::memory_order_relaxed);
+  if (!total)
+    return 0;
+
+  // Midpoint of the bucket holding the sample of rank ceil(q * total)
+  auto rank = static_cast<uint64_t>(q * total + 0.5);
+  if (!rank)
+    rank = 1;
+  uint64_t seen = 0;
+  for (unsigned int idx = 0; idx < num_buckets; ++idx) {
+    seen += stats.buckets[idx].load(std::memory_order_relaxed);
+    if (seen >= rank)
+      return idx + 1 < num_buckets
+        ? (bucket_low(idx) + bucket_low(idx + 1) - 1) / 2
+        : bucket_low(idx);
+  }
+  return stats.max_ns.load(std::memory_order_relaxed);
+}
+
+uint64_t
+HALSampler::
+calls(unsigned int api) const
+{
+  uint64_t sum = 0;
+  for (auto& shard : m_apis[api].calls)
+    sum += shard.calls.load(std::memory_order_relaxed);
+  return sum;
+}
+
+const char*
+HALSampler::
+name(unsigned int api)
+{
+  return api < num_apis ? api_names[api] : "Unknown";
+}
+
+void
+HALSampler::
+write(std::ostream& ostr) const
+{
+  ostr << "HAL API Latency\n";
+  ostr << "API,Calls,Sampling Rate,Sampled Calls,Slow Calls,"
+       << "Average (ns),P50 (ns),P90 (ns),P99 (ns),P99.9 (ns),Max Sampled (ns)\n";
+  for (unsigned int api = 0; api < num_apis; ++api) {
+    auto& stats = m_apis[api];
+    auto count = calls(api);
+    if (!count)
+      continue;
+    auto sampled = stats.sampled.load(std::memory_order_relaxed);
+    ostr << api_names[api] << "," << count << "," << stats.rate << ","
+         << sampled << "," << stats.slow.load(std::memory_order_relaxed) << ","
+         << (sampled ? stats.sum_ns.load(std::memory_order_relaxed) / sampled : 0) << ","
+         << quantile(api, 0.5) << "," << quantile(api, 0.9) << ","
+         << quantile(api, 0.99) << "," << quantile(api, 0.999) << ","
+         << stats.max_ns.load(std::memory_order_relaxed) << "\n";
+  }
+
+  ostr << "\nHAL API Latency Histogram\n";
+  ostr << "API,Low (ns),High (ns),Sampled Calls\n";
+  for (unsigned int api = 0; api < num_apis; ++api) {
+    auto& stats = m_apis[api];
+    for (unsigned int idx = 0; idx < num_buckets; ++idx) {
+      auto count = stats.buckets[idx].load(std::memory_order_relaxed);
+      if (!count)
+        continue;
+      ostr << api_names[api] << "," << bucket_low(idx) << ",";
+      if (idx + 1 < num_buckets)
+        ostr << bucket_low(idx + 1) - 1;
+      ostr << "," << count << "\n";
+    }
+  }
+}
+
+} // end namespace xdp
@@ -0,0 +1,126 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef XDP_HAL_SAMPLER_DOT_H
+#define XDP_HAL_SAMPLER_DOT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace xdp {
+
+  // Sampling mode for HAL API trace.
+  //
+  // Every HAL API call is timed and counted, but only a random sample
+  // of calls, selected independently per call with a per API rate, is
+  // traced and added to the latency histogram of the API.  Since the
+  // selection does not depend on the latency, the histogram of sampled
+  // calls is an unbiased estimate of the latency distribution of all
+  // calls.  Calls that take longer than a per API threshold are traced
+  // even when not sampled, but are counted separately and not added to
+  // the histogram.
+  //
+  // Calls are identified by API index, which is the HalCallbackType of
+  // the start callback divided by two, and by the idcode of the call.
+  // Start and end of a call are reported from the same thread.
+  class HALSampler
+  {
+  public:
+    static constexpr unsigned int num_apis = 25;
+
+    // Log-linear histogram buckets, 2^sub_bits buckets per power of
+    // two, covering latencies up to 2^max_bits ns
+    static constexpr unsigned int sub_bits = 4;
+    static constexpr unsigned int max_bits = 40;
+    static constexpr unsigned int num_buckets = (max_bits - sub_bits + 1) << sub_bits;
+
+    // Every call is counted, so threads count in separate cache lines
+    static constexpr unsigned int num_shards = 16;
+
+    enum class result { drop, traced, slow };
+
+    // Rates and thresholds are strings of comma separated values, a
+    // default value optionally followed by <api name>:<value>.  Slow
+    // call thresholds are in us, 0 disables the threshold.
+    HALSampler(const std::string& rates, const std::string& slow_us);
+
+    // Start of a call at time ts (ns).  Returns true if the call is
+    // sampled and should be traced from start to end.
+    bool
+    start(unsigned int api, uint64_t idcode, uint64_t ts);
+
+    // End of a call at time ts (ns).  Returns traced if the call was
+    // sampled, slow if the call was not sampled but exceeded the slow
+    // call threshold, in which case start_ts is the start time of the
+    // call, and drop otherwise.
+    result
+    end(unsigned int api, uint64_t idcode, uint64_t ts, uint64_t& start_ts);
+
+    // Latency (ns) at quantile q, 0 <= q <= 1, estimated from sampled
+    // calls of an api
+    uint64_t
+    quantile(unsigned int api, double q) const;
+
+    static const char*
+    name(unsigned int api);
+
+    static unsigned int
+    bucket(uint64_t ns);
+
+    // Smallest latency (ns) in a bucket
+    static uint64_t
+    bucket_low(unsigned int idx);
+
+    // Per API summary and histogram of sampled latencies as csv
+    void
+    write(std::ostream& ostr) const;
+
+    // Calls of an api, all threads
+    uint64_t
+    calls(unsigned int api) const;
+
+  private:
+    struct shard
+    {
+      std::atomic<uint64_t> calls {0};
+      char pad[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    struct api_stats
+    {
+      double rate = 1.0;
+      uint64_t threshold = UINT64_MAX;  // sampled if random < threshold
+      uint64_t slow_ns = 0;
+      std::array<shard, num_shards> calls;
+      std::atomic<uint64_t> sampled {0};
+      std::atomic<uint64_t> slow {0};
+      std::atomic<uint64_t> sum_ns {0};
+      std::atomic<uint64_t> max_ns {0};
+      std::array<std::atomic<uint64_t>, num_buckets> buckets {};
+    };
+
+    void
+    record(api_stats& stats, uint64_t ns);
+
+    std::array<api_stats, num_apis> m_apis;
+  };
+
+} // end namespace xdp
+
+#endif
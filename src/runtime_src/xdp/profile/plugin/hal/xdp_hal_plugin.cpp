@@ -391,6 +391,40 @@ namespace xdp {
     return;
   }
 
+  // A slow call that was not sampled is traced when it ends, so both
+  // the start and end events are added at once.
+  static void log_slow_call(unsigned int api, uint64_t start, uint64_t end)
+  {
+    const char* functionName = HALSampler::name(api) ;
+    VPDatabase* db = halPluginInstance.getDatabase() ;
+
+    (db->getStats()).logFunctionCallStart(functionName, static_cast<double>(start)) ;
+    (db->getStats()).logFunctionCallEnd(functionName, static_cast<double>(end)) ;
+
+    auto name = (db->getDynamicInfo()).addString(functionName) ;
+    VTFEvent* event = new HALAPICall(0, static_cast<double>(start), name) ;
+    (db->getDynamicInfo()).addEvent(event) ;
+    (db->getDynamicInfo()).addEvent(new HALAPICall(event->getEventId(), static_cast<double>(end), name)) ;
+  }
+
+  // In sampling mode, returns true if the callback should be traced.
+  // Every payload starts with CBPayload and start callbacks are even.
+  static bool sample(HALSampler* sampler, HalCallbackType cb_type, void* payload)
+  {
+    auto timestamp = xrt_core::time_ns() ;
+    auto idcode = reinterpret_cast<CBPayload*>(payload)->idcode ;
+    unsigned int api = static_cast<unsigned int>(cb_type) / 2 ;
+
+    if (static_cast<unsigned int>(cb_type) % 2 == 0)
+      return sampler->start(api, idcode, timestamp) ;
+
+    uint64_t start = 0 ;
+    auto result = sampler->end(api, idcode, timestamp, start) ;
+    if (result == HALSampler::result::slow)
+      log_slow_call(api, start, timestamp) ;
+    return result == HALSampler::result::traced ;
+  }
+
 } //  xdp
 
 void hal_level_xdp_cb_func(HalCallbackType cb_type, void* payload)
@@ -399,6 +433,11 @@ void hal_level_xdp_cb_func(HalCallbackType cb_type, void* payload)
     return;
   }
 
+  auto sampler = xdp::halPluginInstance.getSampler() ;
+  if (sampler && !xdp::sample(sampler, cb_type, payload)) {
+    return;
+  }
+
   switch (cb_type) {
     case HalCallbackType::ALLOC_BO_START:
       xdp::alloc_bo_start(payload);
@@ -22,6 +22,7 @@
 #include "core/common/system.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
+#include "core/common/thread.h"
 #include "core/include/experimental/xrt-next.h"
 
 #include <boost/algorithm/string.hpp>
@@ -59,7 +60,7 @@ namespace xdp {
     mPollingInterval = xrt_core::config::get_noc_profile_interval_ms();
 
     // Start the NOC profiling thread
-    mPollingThread = std::thread(&NOCProfilingPlugin::pollNOCCounters, this);
+    mPollingThread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &NOCProfilingPlugin::pollNOCCounters, this);
   }
 
   NOCProfilingPlugin::~NOCProfilingPlugin()
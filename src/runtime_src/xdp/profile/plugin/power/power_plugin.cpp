@@ -21,6 +21,7 @@
 #include "core/common/system.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
+#include "core/common/thread.h"
 #include "core/include/experimental/xrt-next.h"
 
 namespace xdp {
@@ -95,7 +96,7 @@ namespace xdp {
     }
 
     // Start the power profiling thread
-    pollingThread = std::thread(&PowerProfilingPlugin::pollPower, this) ;
+    pollingThread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &PowerProfilingPlugin::pollPower, this) ;
   }
 
   PowerProfilingPlugin::~PowerProfilingPlugin()
@@ -25,6 +25,7 @@
 #include "core/common/config_reader.h"
 #include "core/common/message.h"
 #include "core/common/time.h"
+#include "core/common/thread.h"
 
 #ifdef _WIN32
 #pragma warning(disable : 4996)
@@ -121,7 +122,7 @@ namespace xdp {
   {
     if (is_write_thread_active)
       return;
-    write_thread = std::thread(&XDPPlugin::writeContinuous, this, interval, type);
+    write_thread = xrt_core::role_thread(xrt_core::thread_role::profile, nullptr, &XDPPlugin::writeContinuous, this, interval, type);
   }
 
   void XDPPlugin::endWrite(bool openNewFiles)
@@ -54,15 +54,18 @@ namespace xdp {
          << std::endl;
 
     // Write all data elements
-    std::vector<VPDynamicDatabase::CounterSample> samples = 
+    std::vector<AIECounterSample> samples =
       (db->getDynamicInfo()).getAIESamples(mDeviceIndex);
 
-    for (auto sample : samples) {
-      fout << sample.first << ","; // Timestamp
-      for (auto value : sample.second) {
-        fout << value << ",";
-      }
-      fout << std::endl;
+    for (auto& sample : samples) {
+      fout << sample.timestamp << ","
+           << sample.column << ","
+           << sample.row << ","
+           << static_cast<uint32_t>(sample.startEvent) << ","
+           << static_cast<uint32_t>(sample.endEvent) << ","
+           << static_cast<uint32_t>(sample.resetEvent) << ","
+           << sample.value << ","
+           << std::endl;
     }
     return true;
   }
@@ -69,8 +69,9 @@ namespace xdp {
         return;
       }
 
+      // Buffer size is in bytes
       uint32_t* dataBuffer = static_cast<uint32_t*>(buf);
-      for(uint64_t i = 0; i < bufferSz; i++) {
+      for(uint64_t i = 0; i < bufferSz / sizeof(uint32_t); i++) {
         fout << "0x" << std::hex << dataBuffer[i] << std::endl;
       }
     }
@@ -0,0 +1,40 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xdp/profile/writer/hal/hal_latency_writer.h"
+#include "xdp/profile/plugin/hal/hal_sampler.h"
+
+namespace xdp {
+
+  HALLatencyWriter::HALLatencyWriter(const char* filename,
+                                     const HALSampler* s) :
+    VPSummaryWriter(filename), sampler(s)
+  {
+  }
+
+  HALLatencyWriter::~HALLatencyWriter()
+  {
+  }
+
+  bool HALLatencyWriter::write(bool openNewFile)
+  {
+    sampler->write(fout) ;
+
+    if (openNewFile) switchFiles() ;
+    return true;
+  }
+
+}
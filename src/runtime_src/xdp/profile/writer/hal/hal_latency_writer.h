@@ -0,0 +1,42 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef HAL_LATENCY_WRITER_DOT_H
+#define HAL_LATENCY_WRITER_DOT_H
+
+#include "xdp/profile/writer/vp_base/vp_summary_writer.h"
+
+namespace xdp {
+
+  class HALSampler ;
+
+  // Per API call counts and latency histograms of HAL API trace in
+  // sampling mode
+  class HALLatencyWriter : public VPSummaryWriter
+  {
+  private:
+    HALLatencyWriter() = delete ;
+
+    const HALSampler* sampler ;
+  public:
+    HALLatencyWriter(const char* filename, const HALSampler* s) ;
+    ~HALLatencyWriter() ;
+
+    virtual bool write(bool openNewFile) ;
+  } ;
+}
+
+#endif
@@ -26,12 +26,16 @@
 #include "detail/context.h"
 #include "detail/device.h"
 
+#include "xrt/util/config_reader.h"
+
 #include "core/include/xclbin.h"
 #include "core/include/experimental/xclbin_util.h"
 
 #include <exception>
 #include <string>
 #include <algorithm>
+#include <future>
+#include <vector>
 
 #include "plugin/xdp/profile_v2.h"
 
@@ -49,6 +53,60 @@ loadProgramBinary(xocl::program* program, xocl::device* device)
   device->load_program(program);
 }
 
+// Load program onto all devices, concurrently unless disabled.  Each
+// device is attempted, the error of a device is recorded in errors at
+// the index of the device.
+static void
+loadProgramBinaries(xocl::program* program, const cl_device_id* device_list, cl_uint num_devices,
+                    std::vector<std::exception_ptr>& errors)
+{
+  auto load = [&](size_t idx) {
+    try {
+      loadProgramBinary(program,xocl::xocl(device_list[idx]));
+    }
+    catch (...) {
+      errors[idx] = std::current_exception();
+    }
+  };
+
+  if (num_devices < 2 || !xrt_xocl::config::get_parallel_xclbin_load()) {
+    for (size_t idx = 0; idx < num_devices; ++idx)
+      load(idx);
+    return;
+  }
+
+  // The calling thread loads the first device.  A future returned
+  // by std::async joins its thread when destructed, so the started
+  // loaders are joined also if starting a later one throws.
+  std::vector<std::future<void>> loaders;
+  loaders.reserve(num_devices - 1);
+  for (size_t idx = 1; idx < num_devices; ++idx)
+    loaders.emplace_back(std::async(std::launch::async,load,idx));
+  load(0);
+  for (auto& loader : loaders)
+    loader.get();
+}
+
+static std::string
+errorMessage(const std::exception_ptr& eptr, cl_int& code)
+{
+  try {
+    std::rethrow_exception(eptr);
+  }
+  catch (const xocl::error& ex) {
+    code = ex.get_code();
+    return ex.what();
+  }
+  catch (const std::exception& ex) {
+    code = CL_OUT_OF_HOST_MEMORY;
+    return ex.what();
+  }
+  catch (...) {
+    code = CL_OUT_OF_HOST_MEMORY;
+    return "unknown error";
+  }
+}
+
 } //namespace
 
 namespace xocl {
@@ -156,24 +214,42 @@ clCreateProgramWithBinary(cl_context                      context ,
   // Construct program object
   auto program = std::make_unique<xocl::program>(xocl::xocl(context),num_devices,device_list,binaries,lengths);
 
-  // Assign binaries to all devices in the list
-  size_t idx = 0;
-  for (auto device : xocl::get_range(device_list,device_list+num_devices)) {
-    try {
-      if (xocl(device)->is_active())
-        xocl::profile::flush_device(xocl(device)->get_xdevice()) ;
-      loadProgramBinary(program.get(),xocl(device));
-      xocl::profile::update_device(xocl(device)->get_xdevice()) ;
-      if (binary_status)
-        xocl::assign(&binary_status[idx++],CL_SUCCESS);
-    }
-    catch (const xocl::error&) {
+  // Assign binaries to all devices in the list.  Devices are loaded
+  // concurrently and all devices are attempted even if one fails.
+  for (auto device : xocl::get_range(device_list,device_list+num_devices))
+    if (xocl(device)->is_active())
+      xocl::profile::flush_device(xocl(device)->get_xdevice()) ;
+
+  std::vector<std::exception_ptr> errors(num_devices);
+  loadProgramBinaries(program.get(),device_list,num_devices,errors);
+
+  cl_int code = CL_SUCCESS;
+  std::string message;
+  size_t failed = 0;
+  for (size_t idx = 0; idx < num_devices; ++idx) {
+    auto device = xocl(device_list[idx]);
+    if (!errors[idx]) {
+      xocl::profile::update_device(device->get_xdevice()) ;
       if (binary_status)
-        xocl::assign(&binary_status[idx],CL_INVALID_BINARY);
-      throw;
+        xocl::assign(&binary_status[idx],CL_SUCCESS);
+      continue;
     }
+
+    cl_int dcode = CL_SUCCESS;
+    auto dmessage = errorMessage(errors[idx],dcode);
+    if (binary_status)
+      xocl::assign(&binary_status[idx],CL_INVALID_BINARY);
+    if (!failed++)
+      code = dcode;
+    message.append("\n  device '" + device->get_bdf() + "': " + dmessage);
   }
 
+  if (failed == 1 && num_devices == 1)
+    std::rethrow_exception(errors[0]);
+  if (failed)
+    throw xocl::error(code,"Failed to load xclbin on " + std::to_string(failed) + " of "
+                      + std::to_string(num_devices) + " devices:" + message);
+
   xocl::assign(errcode_ret,CL_SUCCESS);
 
   return program.release();
@@ -67,23 +67,23 @@ clGetKernelArgInfo(cl_kernel          kernel ,
   validOrError(kernel,arg_indx,param_name,param_value_size,param_value,param_value_size_ret);
 
   xocl::param_buffer buffer { param_value, param_value_size, param_value_size_ret };
-  const xrt_core::xclbin::kernel_argument* arginfo = xocl::xocl(kernel)->get_arg_info(arg_indx);
+  auto& arginfo = xocl::xocl(kernel)->get_info().args.at(arg_indx);
 
   switch(param_name) {
     case CL_KERNEL_ARG_ADDRESS_QUALIFIER:
-      buffer.as<cl_kernel_arg_address_qualifier>() = static_cast<cl_kernel_arg_address_qualifier>(arginfo->type);
+      buffer.as<cl_kernel_arg_address_qualifier>() = arginfo.address_qualifier;
       break;
     case CL_KERNEL_ARG_ACCESS_QUALIFIER:
       buffer.as<cl_kernel_arg_access_qualifier>() = 0;
       break;
     case CL_KERNEL_ARG_TYPE_NAME:
-      buffer.as<char>() = arginfo->hosttype;
+      buffer.as<char>() = arginfo.type_name;
       break;
     case CL_KERNEL_ARG_NAME:
-      buffer.as<char>() = arginfo->name;
+      buffer.as<char>() = arginfo.name;
       break;
     case CL_KERNEL_ARG_OFFSET:
-      buffer.as<size_t>() = arginfo->offset;
+      buffer.as<size_t>() = arginfo.offset;
       break;
     default:
       throw error(CL_INVALID_VALUE,"clGetKernelArgInfo: invalid param_name");
@@ -71,10 +71,10 @@ clGetKernelInfo(cl_kernel        kernel,
 
   switch(param_name){
     case CL_KERNEL_FUNCTION_NAME:
-      buffer.as<char>() = xocl(kernel)->get_name();
+      buffer.as<char>() = xocl(kernel)->get_info().function_name;
       break;
     case CL_KERNEL_NUM_ARGS:
-      buffer.as<cl_uint>() = xocl(kernel)->get_indexed_xargument_range().size();
+      buffer.as<cl_uint>() = xocl(kernel)->get_info().num_args;
       break;
     case CL_KERNEL_REFERENCE_COUNT:
       buffer.as<cl_uint>() = xocl(kernel)->count();
@@ -86,10 +86,11 @@ clGetKernelInfo(cl_kernel        kernel,
       buffer.as<cl_program>() = xocl(kernel)->get_program();
       break;
     case CL_KERNEL_ATTRIBUTES:
-      buffer.as<char>() = xocl(kernel)->get_attributes();
+      buffer.as<char>() = xocl(kernel)->get_info().attributes;
       break;
     case CL_KERNEL_COMPUTE_UNIT_COUNT:
-      buffer.as<cl_uint>() = xocl(kernel)->get_cus().size();
+      // CUs are trimmed as arguments are set, not precomputed
+      buffer.as<cl_uint>() = xocl(kernel)->get_num_cus();
       break;
     case CL_KERNEL_INSTANCE_BASE_ADDRESS:
       for (auto cu : xocl(kernel)->get_cus())
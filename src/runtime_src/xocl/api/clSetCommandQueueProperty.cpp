@@ -78,6 +78,15 @@ clSetCommandQueueProperty(cl_command_queue command_queue,
       xocl(command_queue)->get_properties() &= (~CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
   }
 
+  //XCL_QUEUE_PRIORITY_HIGH, XCL_QUEUE_PRIORITY_LOW
+  //applies to DMA operations scheduled after the change
+  auto priority = properties & (XCL_QUEUE_PRIORITY_HIGH | XCL_QUEUE_PRIORITY_LOW);
+  if (priority) {
+    xocl(command_queue)->get_properties() &= (~(XCL_QUEUE_PRIORITY_HIGH | XCL_QUEUE_PRIORITY_LOW));
+    if (enable)
+      xocl(command_queue)->get_properties() |= priority;
+  }
+
   return CL_SUCCESS;
 }
 
@@ -21,6 +21,7 @@
 #include "xocl/core/error.h"
 #include "xocl/api/api.h"
 #include <CL/cl.h>
+#include <CL/cl_ext_xilinx.h>
 
 #ifdef _WIN32
 # pragma warning( disable : 4245)
@@ -42,9 +43,12 @@ validOrError(const cl_command_queue command_queue)
 void
 validOrError(cl_command_queue_properties properties)
 {
-  cl_bitfield valid = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE;
+  cl_bitfield valid = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE
+    | XCL_QUEUE_PRIORITY_HIGH | XCL_QUEUE_PRIORITY_LOW;
   if(properties & (~valid))
     throw error(CL_INVALID_VALUE, "Invalid command queue property");
+  if((properties & XCL_QUEUE_PRIORITY_HIGH) && (properties & XCL_QUEUE_PRIORITY_LOW))
+    throw error(CL_INVALID_VALUE, "Conflicting command queue priority properties");
 }
 
 void
@@ -52,8 +56,11 @@ validOrError(const cl_device_id device, cl_command_queue_properties properties)
 {
   validOrError(properties);
 
-  cl_command_queue_properties supported = 0;
-  api::clGetDeviceInfo(device,CL_DEVICE_QUEUE_PROPERTIES,sizeof(cl_command_queue_properties),&supported,nullptr);
+  // Priority hints are supported by all devices
+  cl_command_queue_properties supported = XCL_QUEUE_PRIORITY_HIGH | XCL_QUEUE_PRIORITY_LOW;
+  cl_command_queue_properties device_supported = 0;
+  api::clGetDeviceInfo(device,CL_DEVICE_QUEUE_PROPERTIES,sizeof(cl_command_queue_properties),&device_supported,nullptr);
+  supported |= device_supported;
   if(properties & (~supported))
     throw error(CL_INVALID_QUEUE_PROPERTIES, "Invalid command queue property");
 }
@@ -20,6 +20,7 @@
 #include "xocl/core/memory.h"
 #include "xocl/core/error.h"
 #include "xocl/core/property.h"
+#include <CL/cl_ext_xilinx.h>
 
 namespace xocl { namespace detail {
 
@@ -51,6 +52,8 @@ validOrError(const cl_context_properties* properties)
       ;
     else if (key==CL_CONTEXT_INTEROP_USER_SYNC)
       ;
+    else if (key==XCL_CONTEXT_PREFER_LOCAL_DEVICES)
+      ;
     else
       throw error(CL_INVALID_PROPERTY,"bad context property '" + std::to_string(key) + "'");
   }
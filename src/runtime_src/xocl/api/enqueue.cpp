@@ -78,6 +78,15 @@ throw_if_error()
 
 using async_type = xrt_xocl::device::queue_type;
 
+// Size and command queue priority of a DMA operation, used by the
+// device to schedule small and high priority operations first.  Size
+// is 0 if not known up front.
+inline xrt_xocl::dma_queue::hint
+dma_hint(const xocl::command_queue* command_queue, size_t size)
+{
+  return xrt_xocl::dma_queue::hint(size, command_queue->get_dma_priority());
+}
+
 auto event_completer = [](xocl::event* ev)
 {
   ev->set_status(CL_COMPLETE);
@@ -326,7 +335,7 @@ action_ndrange_migrate(cl_event event,cl_kernel kernel)
 
       // only migrate if not already resident on device
       if (!mem->is_resident(device)) {
-        xdevice->schedule(migrate_buffer,async_type::write,ec,device,mem,0);
+        xdevice->schedule_dma(migrate_buffer,async_type::write,dma_hint(command_queue,mem->get_size()),ec,device,mem,0);
       }
     }
   };
@@ -341,7 +350,7 @@ action_read_buffer(cl_mem buffer,size_t offset, size_t size, const void* ptr)
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(read_buffer,async_type::read,ev,device,buffer,offset,size,const_cast<void*>(ptr));
+    xdevice->schedule_dma(read_buffer,async_type::read,dma_hint(command_queue,size),ev,device,buffer,offset,size,const_cast<void*>(ptr));
   };
 }
 
@@ -365,7 +374,7 @@ action_map_buffer(cl_event event,cl_mem buffer,cl_map_flags map_flags,size_t off
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(map_buffer,async_type::read,ev,device,buffer,map_flags,offset,size,userptr);
+    xdevice->schedule_dma(map_buffer,async_type::read,dma_hint(command_queue,size),ev,device,buffer,map_flags,offset,size,userptr);
   };
 }
 
@@ -378,7 +387,7 @@ action_map_svm_buffer(cl_event event,cl_map_flags map_flags,void* svm_ptr,size_t
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(map_svm_buffer,async_type::read,ev,device,map_flags,svm_ptr,size);
+    xdevice->schedule_dma(map_svm_buffer,async_type::read,dma_hint(command_queue,size),ev,device,map_flags,svm_ptr,size);
   };
 }
 
@@ -391,7 +400,7 @@ action_write_buffer(cl_mem buffer,size_t offset, size_t size, const void* ptr)
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(write_buffer,async_type::write,ev,device,buffer,offset,size,ptr);
+    xdevice->schedule_dma(write_buffer,async_type::write,dma_hint(command_queue,size),ev,device,buffer,offset,size,ptr);
   };
 }
 
@@ -404,7 +413,7 @@ action_unmap_buffer(cl_mem memobj,void* mapped_ptr)
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(unmap_buffer,async_type::write,ev,device,memobj,mapped_ptr);
+    xdevice->schedule_dma(unmap_buffer,async_type::write,dma_hint(command_queue,0),ev,device,memobj,mapped_ptr);
   };
 }
 
@@ -417,7 +426,7 @@ action_unmap_svm_buffer(void* svm_ptr)
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(unmap_svm_buffer,async_type::write,ev,device,svm_ptr);
+    xdevice->schedule_dma(unmap_svm_buffer,async_type::write,dma_hint(command_queue,0),ev,device,svm_ptr);
   };
 }
 
@@ -430,7 +439,7 @@ action_read_image(cl_mem image,const size_t* origin,const size_t* region, size_t
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(read_image,async_type::read,ev,device,image,origin,region,row_pitch,slice_pitch,const_cast<void*>(ptr));
+    xdevice->schedule_dma(read_image,async_type::read,dma_hint(command_queue,0),ev,device,image,origin,region,row_pitch,slice_pitch,const_cast<void*>(ptr));
   };
 }
 
@@ -443,7 +452,7 @@ action_write_image(cl_mem image,const size_t* origin,const size_t* region,size_t
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
-    xdevice->schedule(write_image,async_type::write,ev,device,image,origin,region,row_pitch,slice_pitch,ptr);
+    xdevice->schedule_dma(write_image,async_type::write,dma_hint(command_queue,0),ev,device,image,origin,region,row_pitch,slice_pitch,ptr);
   };
 }
 
@@ -470,7 +479,7 @@ action_migrate_memobjects(size_t num, const cl_mem* memobjs, cl_mem_migration_fl
       }
 
       auto at = (flags & CL_MIGRATE_MEM_OBJECT_HOST) ? async_type::read : async_type::write;
-      xdevice->schedule(migrate_buffer,at,ec,device,mem,flags);
+      xdevice->schedule_dma(migrate_buffer,at,dma_hint(command_queue,xocl::xocl(mem)->get_size()),ec,device,mem,flags);
     }
   };
 }
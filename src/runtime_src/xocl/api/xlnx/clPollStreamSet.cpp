@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xocl/config.h"
+#include "xocl/core/stream.h"
+#include "xocl/core/error.h"
+#include "plugin/xdp/profile_v2.h"
+#include "xocl/core/device.h"
+#include <CL/opencl.h>
+#include <vector>
+
+namespace xocl {
+
+static void
+validOrError(const cl_stream*           streams,
+	cl_uint                         num_streams,
+	cl_streams_poll_req_completions*completions,
+	cl_int                          min_num_completion,
+	cl_int                          max_num_completion,
+	cl_int*                         actual_num_completion,
+	cl_int                          timeout,
+	cl_int*                         errcode_ret)
+{
+  if (!config::api_checks())
+    return;
+
+  if (!streams || !num_streams)
+    throw error(CL_INVALID_VALUE,"no streams specified");
+  if (min_num_completion <= 0)
+    throw error(CL_INVALID_VALUE,"minimum number of completion must be > 0");
+  if (max_num_completion < min_num_completion)
+    throw error(CL_INVALID_VALUE,"maximum number of completion must be >= minimum");
+
+  auto device = xocl::xocl(streams[0])->get_device();
+  for (cl_uint idx = 0; idx < num_streams; ++idx) {
+    if (!streams[idx])
+      throw error(CL_INVALID_VALUE,"invalid stream");
+    if (xocl::xocl(streams[idx])->get_device() != device)
+      throw error(CL_INVALID_VALUE,"streams must be on the same device");
+  }
+}
+
+static cl_int
+clPollStreamSet(const cl_stream*         streams,
+	cl_uint                         num_streams,
+	cl_streams_poll_req_completions*completions,
+	cl_int                          min,
+	cl_int                          max,
+	cl_int*                         actual,
+	cl_int                          timeout,
+	cl_int*                         errcode_ret)
+{
+  validOrError(streams,num_streams,completions,min,max,actual,timeout,errcode_ret);
+
+  std::vector<xrt_xocl::device::stream_handle> handles;
+  handles.reserve(num_streams);
+  for (cl_uint idx = 0; idx < num_streams; ++idx)
+    handles.push_back(xocl::xocl(streams[idx])->get_handle());
+
+  auto device = xocl::xocl(streams[0])->get_device();
+  int ret = device->poll_stream_set(handles.data(),num_streams,completions,min,max,actual,timeout);
+  xocl::assign(errcode_ret, ret);
+  return ret;
+}
+
+} //xocl
+
+CL_API_ENTRY cl_int CL_API_CALL
+clPollStreamSet(const cl_stream*          streams,
+	cl_uint                          num_streams,
+       	cl_streams_poll_req_completions* completions,
+	cl_int                           min_num_completion,
+	cl_int                           max_num_completion,
+	cl_int*                          actual_num_completion,
+	cl_int                           timeout,
+	cl_int * errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clPollStreamSet
+      (streams,num_streams,completions,min_num_completion,max_num_completion,
+       actual_num_completion,timeout,errcode_ret);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    xocl::assign(errcode_ret,ex.get_code());
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    xocl::assign(errcode_ret,CL_INVALID_VALUE);
+  }
+  return CL_INVALID_VALUE;
+}
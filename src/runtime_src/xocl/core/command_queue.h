@@ -22,6 +22,8 @@
 #include "xocl/core/refcount.h"
 #include "xocl/core/property.h"
 
+#include <CL/cl_ext_xilinx.h>
+
 #include <vector>
 #include <set>
 #include <unordered_set>
@@ -102,6 +104,20 @@ public:
     return m_props.test(CL_QUEUE_PROFILING_ENABLE);
   }
 
+  /**
+   * Priority of DMA operations of this command queue
+   *
+   * @return
+   *   1 if XCL_QUEUE_PRIORITY_HIGH, -1 if XCL_QUEUE_PRIORITY_LOW, 0 otherwise
+   */
+  int
+  get_dma_priority() const
+  {
+    return m_props.test(XCL_QUEUE_PRIORITY_HIGH) ? 1
+      : m_props.test(XCL_QUEUE_PRIORITY_LOW) ? -1
+      : 0;
+  }
+
   /**
    * Get range with events that are queued or submitted
    */
@@ -16,7 +16,12 @@
 
 #include "context.h"
 #include "device.h"
+#include "event.h"
 #include "platform.h"
+
+#include "xrt/util/config_reader.h"
+#include "core/common/numa.h"
+#include <CL/cl_ext_xilinx.h>
 #include <iostream>
 
 namespace xocl {
@@ -26,6 +31,7 @@ context(const cl_context_properties* properties
         ,size_t num_devices, const cl_device_id* devices
         ,const notify_action& notify)
   : m_props(properties), m_notify(notify)
+  , m_event_pool(std::make_shared<event_pool>(xrt_xocl::config::get_event_pool_size()))
 {
   static unsigned int uid_count = 0;
   m_uid = uid_count++;
@@ -42,6 +48,27 @@ context(const cl_context_properties* properties
                  ,[](cl_device_id dev) {
                    return xocl::xocl(dev);
                  });
+
+  if (std::none_of(m_props.begin(),m_props.end()
+                   ,[](const auto& prop) {
+                     return prop.get_key()==XCL_CONTEXT_PREFER_LOCAL_DEVICES
+                       && prop.get_value()!=CL_FALSE;
+                   }))
+    return;
+
+  // Devices attached to the node of the calling thread first
+  auto node = xrt_core::numa::get_current_node();
+  if (node >= 0)
+    std::stable_partition(m_devices.begin(),m_devices.end()
+                          ,[node](const ptr<device>& dev) {
+                            return dev->get_numa_node() == node;
+                          });
+
+  // Host memory of buffers is placed on the node of the devices
+  auto first = m_devices.empty() ? -1 : m_devices.front()->get_numa_node();
+  if (std::all_of(m_devices.begin(),m_devices.end()
+                  ,[first](const ptr<device>& dev) { return dev->get_numa_node() == first; }))
+    m_numa_node = first;
 }
 
 context::
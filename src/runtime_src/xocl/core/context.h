@@ -23,9 +23,12 @@
 #include "xocl/core/property.h"
 #include <vector>
 #include <functional>
+#include <memory>
 
 namespace xocl {
 
+class event_pool;
+
 class context : public refcount, public _cl_context
 {
   using property_element_type = cl_context_properties;
@@ -158,12 +161,33 @@ public:
   platform*
   get_platform() const;
 
+  /**
+   * @return
+   *   NUMA node of the context devices if all devices are attached to
+   *   the same node and the context prefers local devices, -1 otherwise
+   */
+  int
+  get_numa_node() const
+  {
+    return m_numa_node;
+  }
+
+  /**
+   * Pool of event memory for events in this context
+   */
+  const std::shared_ptr<event_pool>&
+  get_event_pool() const
+  {
+    return m_event_pool;
+  }
+
 private:
   unsigned int m_uid = 0;
   property_list_type m_props;
   notify_action m_notify;
 
   platform* m_platform = nullptr;
+  int m_numa_node = -1;
 
   // The context owns
   device_vector_type m_devices;
@@ -177,6 +201,9 @@ private:
   // However, the program shares ownership of this context.
   program_vector_type m_programs;
   std::mutex m_program_mutex;
+
+  // Shared with events allocated from the pool
+  std::shared_ptr<event_pool> m_event_pool;
 };
 
 } // xocl
@@ -27,6 +27,7 @@
 #include "core/common/api/bo.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
+#include "core/common/numa.h"
 #include "core/common/query_requests.h"
 #include "core/common/xclbin_parser.h"
 
@@ -44,6 +45,12 @@ namespace {
 
 static unsigned int uid_count = 0;
 
+// Serialize use of the debug plugin while loading programs
+static std::mutex debug_mutex;
+
+// Device address and size granularity of direct DMA
+constexpr size_t direct_dma_alignment = 64;
+
 static
 std::string
 to_hex(void* addr)
@@ -237,6 +244,22 @@ is_nodma() const
   return core_device->is_nodma();
 }
 
+int
+device::
+get_numa_node() const
+{
+  if (m_parent)
+    return m_parent->get_numa_node();
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_numa_node == -2) {
+    m_numa_node = -1;
+    if (m_xdevice)
+      m_numa_node = xrt_core::numa::get_device_node(m_xdevice->get_core_device().get());
+  }
+  return m_numa_node;
+}
+
 void*
 device::
 get_handle() const
@@ -414,6 +437,13 @@ poll_stream(xrt_xocl::device::stream_handle stream, xrt_xocl::device::stream_xfe
   return m_xdevice->pollStream(stream, comps, min,max,actual,timeout);
 }
 
+int
+device::
+poll_stream_set(const xrt_xocl::device::stream_handle* streams, int num, xrt_xocl::device::stream_xfer_completions* comps, int min, int max, int* actual, int timeout)
+{
+  return m_xdevice->pollStreamSet(streams, num, comps, min,max,actual,timeout);
+}
+
 int
 device::
 set_stream_opt(xrt_xocl::device::stream_handle stream, int type, uint32_t val)
@@ -651,20 +681,16 @@ map_buffer(memory* buffer, cl_map_flags map_flags, size_t offset, size_t size, v
   if (!boh)
     boh = buffer->get_buffer_object(this);
 
+  // The host memory of boh is mapped for the lifetime of boh, no
+  // need to track the mapping
+  auto hbuf = boh.map();
   auto ubuf = buffer->get_host_ptr();
-  if (!ubuf || !is_aligned_ptr(ubuf)) {
-    // boh was created with it's own alloced host_ptr
-    auto hbuf = m_xdevice->map(boh);
-    m_xdevice->unmap(boh);
-    assert(ubuf!=hbuf);
-    if (ubuf && !nosync) {
-      auto dst = static_cast<char*>(ubuf) + offset;
-      auto src = static_cast<char*>(hbuf) + offset;
-      memcpy(dst,src,size);
-    }
-    else if (!ubuf)
-      ubuf = hbuf;
-  }
+  if (!ubuf)
+    ubuf = hbuf;
+  else if (ubuf!=hbuf && !nosync && !(map_flags & CL_MAP_WRITE_INVALIDATE_REGION))
+    // boh was created with it's own pinned host memory which stages
+    // the user buffer, copy just the mapped window
+    std::memcpy(static_cast<char*>(ubuf)+offset,static_cast<char*>(hbuf)+offset,size);
 
   void* result = static_cast<char*>(ubuf) + offset;
   assert(!assert_result || result==assert_result);
@@ -672,15 +698,17 @@ map_buffer(memory* buffer, cl_map_flags map_flags, size_t offset, size_t size, v
   // If this buffer is being mapped for writing, then a following
   // unmap will have to sync the data to device, so record this.  We
   // will not enforce that map is followed by unmap, so two maps of
-  // same buffer for write without corresponding unmaps will simply
-  // override previous map value.  We do however keep track of the
-  // map with largest size to subsume small maps into the largest.
-  // That way largest chunk is synced to device if necessary.
+  // same buffer without corresponding unmaps are merged.  The flags
+  // accumulate and the largest size mapped for write is what is
+  // written back and synced to device, a region mapped for read
+  // only is not written back even if larger.
   std::lock_guard<std::mutex> lk(m_mutex);
   auto& mapinfo = m_mapped[result];
-  mapinfo.flags = map_flags;
+  mapinfo.flags |= map_flags;
   mapinfo.offset = offset;
   mapinfo.size = std::max(mapinfo.size,size);
+  if (map_flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION))
+    mapinfo.write_size = std::max(mapinfo.write_size,size);
   return result;
 }
 
@@ -690,7 +718,7 @@ unmap_buffer(memory* buffer, void* mapped_ptr)
 {
   cl_map_flags flags = 0; // flags of mapped_ptr
   size_t offset = 0;      // offset of mapped_ptr wrt BO
-  size_t size = 0;        // size of mapped_ptr
+  size_t size = 0;        // size of mapped_ptr written by host
   {
     // There is no checking that map/unmap match.  Only one active
     // map of a mapped_ptr is maintained and is erased on first unmap
@@ -699,19 +727,24 @@ unmap_buffer(memory* buffer, void* mapped_ptr)
     if (itr!=m_mapped.end()) {
       flags = (*itr).second.flags;
       offset = (*itr).second.offset;
-      size = (*itr).second.size;
+      size = (*itr).second.write_size;
       m_mapped.erase(itr);
     }
   }
 
   auto boh = buffer->get_buffer_object_or_error(this);
 
-  // Sync data to boh if write flags, and sync to device if resident
-  if (flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION)) {
-    if (auto ubuf = static_cast<char*>(buffer->get_host_ptr()))
+  // Sync data to boh if write flags, and sync to device if resident.
+  // Only a user buffer that is staged in the host memory of boh must
+  // be copied.
+  if ((flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION)) && size) {
+    auto ubuf = static_cast<char*>(buffer->get_host_ptr());
+    if (ubuf && ubuf!=boh.map())
       m_xdevice->write(boh,ubuf+offset,size,offset,false);
     if (buffer->is_resident(this) && !buffer->no_host_memory())
       m_xdevice->sync(boh,size,offset,xrt_xocl::hal::device::direction::HOST2DEVICE,false);
+    else
+      buffer->clear_resident_range(this,offset,size);
   }
 }
 
@@ -729,6 +762,8 @@ migrate_buffer(memory* buffer,cl_mem_migration_flags flags)
     auto boh = buffer->get_buffer_object_or_error(this);
     m_xdevice->sync(boh,buffer->get_size(),0,xrt_xocl::hal::device::direction::DEVICE2HOST,false);
     sync_to_ubuf(buffer,0,buffer->get_size(),m_xdevice,boh);
+    if (!buffer->get_sub_buffer_parent())
+      buffer->set_host_stale(false);
     return;
   }
 
@@ -736,17 +771,107 @@ migrate_buffer(memory* buffer,cl_mem_migration_flags flags)
   // Get or create the buffer object on this device.
   buffer_object_handle boh = buffer->get_buffer_object(this);
 
-  // Sync from host to device to make make buffer resident of this device
-  sync_to_hbuf(buffer,0,buffer->get_size(),m_xdevice,boh);
-  m_xdevice->sync(boh,buffer->get_size(), 0, xrt_xocl::hal::device::direction::HOST2DEVICE,false);
+  // Device memory written by direct DMA is newer than the host side
+  // buffer, refresh the host side buffer from the device holding the
+  // written copy before syncing it to this device
+  auto parent = buffer->get_sub_buffer_parent();
+  if ((parent ? parent : buffer)->is_host_stale()) {
+    auto src = buffer->get_resident_device();
+    if (!src && buffer->is_resident(this))
+      src = this;
+    if (auto src_boh = src ? buffer->get_buffer_object_or_null(src) : buffer_object_handle{}) {
+      src->get_xdevice()->sync(src_boh,buffer->get_size(),0,xrt_xocl::hal::device::direction::DEVICE2HOST,false);
+      if (!parent)
+        buffer->set_host_stale(false);
+    }
+  }
+
+  // Sync from host to device to make make buffer resident of this
+  // device.  Ranges made resident by migration of sub buffers are
+  // current and skipped.  The ranges are synced in chunks spread over
+  // the DMA workers, so migration of disjoint sub buffers overlap.
+  auto ranges = buffer->is_resident(this)
+    ? std::vector<memory::range_type>{{0,buffer->get_size()}}
+    : buffer->get_nonresident_ranges(this,0,buffer->get_size());
+  for (auto& range : ranges) {
+    m_xdevice->split_dma(xrt_xocl::device::queue_type::write, range.second, [&](size_t off, size_t len) {
+      off += range.first;
+      sync_to_hbuf(buffer,off,len,m_xdevice,boh);
+      m_xdevice->sync(boh,len,off,xrt_xocl::hal::device::direction::HOST2DEVICE,false);
+    });
+  }
+
   // Now buffer is resident on this device and migrate is complete
   buffer->set_resident(this);
 }
 
+bool
+device::
+direct_dma(memory* buffer, size_t offset, size_t size, void* ptr, bool write)
+{
+  if (!m_direct_dma || !xrt_xocl::config::get_direct_dma())
+    return false;
+
+  if (size < xrt_xocl::config::get_direct_dma_min_size() || !is_aligned_ptr(ptr))
+    return false;
+
+  // Device memory must be current and the host side buffer must not
+  // mirror a separate user buffer
+  if (!buffer->is_resident(this) || buffer->no_host_memory() || buffer->need_extra_sync())
+    return false;
+
+  // Host memory banks are host memory already, nothing to bypass
+  auto boh = buffer->get_buffer_object_or_error(this);
+  if (buffer->is_host_only() || get_boh_banktag(boh).compare(0,4,"HOST") == 0)
+    return false;
+
+  auto addr = boh.address() + offset;
+  if ((addr | size) % direct_dma_alignment)
+    return false;
+
+  try {
+    // Large transfers are split over the DMA workers
+    auto core_device = m_xdevice->get_core_device();
+    auto data = static_cast<char*>(ptr);
+    if (write) {
+      // Mark stale before the write, the host side buffer of a sub
+      // buffer is part of its parent's
+      auto parent = buffer->get_sub_buffer_parent();
+      (parent ? parent : buffer)->set_host_stale(true);
+
+      // The written device memory is the only valid copy
+      buffer->clear_resident();
+      buffer->set_resident(this);
+      m_xdevice->split_dma(xrt_xocl::device::queue_type::write, size, [&](size_t off, size_t len) {
+        core_device->unmgd_pwrite(data + off, len, addr + off);
+      });
+    }
+    else {
+      m_xdevice->split_dma(xrt_xocl::device::queue_type::read, size, [&](size_t off, size_t len) {
+        core_device->unmgd_pread(data + off, len, addr + off);
+      });
+    }
+    return true;
+  }
+  catch (const std::exception& ex) {
+    // Unmanaged DMA fails up front when not supported, stage from now on
+    m_direct_dma = false;
+    xrt_xocl::message::send(xrt_xocl::message::severity_level::info,
+                            std::string("direct DMA disabled, reverting to staged buffer transfers: ")
+                            + ex.what());
+    return false;
+  }
+}
+
 void
 device::
 write_buffer(memory* buffer, size_t offset, size_t size, const void* ptr)
 {
+  // Device memory is written directly and the stale host side
+  // buffer is refreshed by sync before it is used
+  if (direct_dma(buffer, offset, size, const_cast<void*>(ptr), true))
+    return;
+
   auto boh = buffer->get_buffer_object(this);
 
   // Write data to buffer object at offset
@@ -759,12 +884,18 @@ write_buffer(memory* buffer, size_t offset, size_t size, const void* ptr)
     // Sync new written data to device at offset
     // HAL performs read/modify write if necesary
     m_xdevice->sync(boh,size,offset,xrt_xocl::hal::device::direction::HOST2DEVICE,false);
+  else
+    // Range is no longer current if resident through a sub buffer
+    buffer->clear_resident_range(this,offset,size);
 }
 
 void
 device::
 read_buffer(memory* buffer, size_t offset, size_t size, void* ptr)
 {
+  if (direct_dma(buffer, offset, size, ptr, false))
+    return;
+
   auto boh = buffer->get_buffer_object(this);
 
   if (buffer->is_resident(this) && !buffer->no_host_memory())
@@ -936,6 +1067,10 @@ load_program(program* program)
 
   auto top = reinterpret_cast<const axlf*>(binary_data.first);
 
+  // Devices of a context are loaded concurrently, the debug plugin is
+  // shared by all devices
+  std::unique_lock<std::mutex> debug_lock(debug_mutex);
+
   // Kernel debug is enabled based on if there is debug_data in the
   // binary it does not have an xrt.ini attribute. If there is
   // debug_data then make sure xdp kernel debug is loaded
@@ -949,6 +1084,7 @@ load_program(program* program)
   }
 
   xocl::debug::reset(top);
+  debug_lock.unlock();
 
   // programmming
   if (xrt_xocl::config::get_xclbin_programing()) {
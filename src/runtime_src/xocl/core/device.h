@@ -26,6 +26,7 @@
 #include "core/common/unistd.h"
 #include "core/common/scope_guard.h"
 
+#include <atomic>
 #include <cassert>
 
 namespace xocl {
@@ -154,6 +155,17 @@ public:
   bool
   is_nodma() const;
 
+  /**
+   * Get the NUMA node this device is attached to
+   *
+   * A sub device is attached to the node of its root device.
+   *
+   * @return
+   *  Node number, or -1 if not known
+   */
+  int
+  get_numa_node() const;
+
   /**
    * Get underlying driver device handle
    */
@@ -349,7 +361,9 @@ public:
    * @param buffer
    *  Buffer to write to.  The underlying buffer object will
    *  receive the data.  The data will be synced to device if
-   *  and only of the buffer is currently resident on the device
+   *  and only of the buffer is currently resident on the device.
+   *  Large page aligned writes to a resident buffer are DMAed
+   *  directly from data to device memory.
    * @param offset
    *  The offset in buffer to write to
    * @param size
@@ -366,6 +380,8 @@ public:
    * @param buffer
    *  Buffer read from.  The buffer will synced from device first if
    *  and only of the buffer is currently resident on the device.
+   *  Large page aligned reads from a resident buffer are DMAed
+   *  directly from device memory to data.
    * @param offset
    *  The offset in buffer read from
    * @param size
@@ -447,6 +463,15 @@ public:
   int
   poll_streams(xrt_xocl::device::stream_xfer_completions* comps, int min, int max, int* actual, int timeout);
 
+  /**
+   * Poll a set of streams that have per-stream completion queues
+   *
+   * Completions are reaped directly into @comps, no other streams
+   * on the device are serviced.
+   */
+  int
+  poll_stream_set(const xrt_xocl::device::stream_handle* streams, int num, xrt_xocl::device::stream_xfer_completions* comps, int min, int max, int* actual, int timeout);
+
   /**
    * Read a device register at specified offset
    *
@@ -717,11 +742,24 @@ private:
   buffer_object_handle
   alloc(memory* mem, memidx_type memidx);
 
+  /**
+   * Transfer size bytes between user memory and device memory of a
+   * resident buffer without staging through the host side buffer of
+   * the buffer object.
+   *
+   * @return
+   *  true if transferred, false if the transfer is not eligible in
+   *  which case nothing was transferred
+   */
+  bool
+  direct_dma(memory* buffer, size_t offset, size_t size, void* ptr, bool write);
+
 private:
   struct mapinfo {
     cl_map_flags flags = 0; // mapflags
     size_t offset = 0;      // boh:hbuf offset
     size_t size = 0;        // max size mapped
+    size_t write_size = 0;  // max size mapped for write
   };
 
   unsigned int m_uid = 0;
@@ -739,10 +777,13 @@ private:
   mutable std::mutex m_mutex;
 
   // Track how a region of a buffer object is mapped.  There is
-  // no tracking of matching map and unmap.  Last map of a region
-  // is what is stored and first unmap of a region erases the content.
+  // no tracking of matching map and unmap.  Maps of a region are
+  // merged and first unmap of a region erases the content.
   std::map<const void*,mapinfo> m_mapped;
 
+  // Cleared if shim or platform does not support unmanaged DMA
+  std::atomic<bool> m_direct_dma {true};
+
   // Track memory objects allocated on this device
   std::set<const memory*> m_memobjs;
 
@@ -751,6 +792,7 @@ private:
 
   // Caching.  Purely implementation detail (-2 => not initialized)
   mutable memidx_type m_cu_memidx = -2;
+  mutable int m_numa_node = -2;
 };
 
 } // xocl
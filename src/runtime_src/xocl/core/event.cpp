@@ -25,6 +25,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <memory>
 
 #ifdef _WIN32
 #pragma warning ( disable : 4189 4505 )
@@ -53,6 +54,41 @@ to_string(cl_int status)
 
 static xocl::event::event_callback_list sg_constructor_callbacks;
 static xocl::event::event_callback_list sg_destructor_callbacks;
+
+// Precedes the memory of an event, records the pool (if any) to
+// return the memory to when the event is deleted.  The header shares
+// ownership of the pool since the event's context may be deleted as
+// part of deleting the event.
+struct alignas(alignof(std::max_align_t)) event_header
+{
+  std::shared_ptr<xocl::event_pool> pool;
+  size_t bytes;
+};
+
+static void*
+allocate_event(std::shared_ptr<xocl::event_pool> pool, size_t sz)
+{
+  auto bytes = sz + sizeof(event_header);
+  auto block = pool ? pool->allocate(bytes) : ::operator new(bytes);
+  auto hdr = new (block) event_header{std::move(pool), bytes};
+  return hdr + 1;
+}
+
+static void
+deallocate_event(void* ptr)
+{
+  if (!ptr)
+    return;
+  auto hdr = static_cast<event_header*>(ptr) - 1;
+  auto pool = std::move(hdr->pool);
+  auto bytes = hdr->bytes;
+  hdr->~event_header();
+  if (pool)
+    pool->deallocate(hdr, bytes);
+  else
+    ::operator delete(hdr);
+}
+
 } // namespace
 
 namespace xocl {
@@ -91,6 +127,92 @@ event::
     cb(this);
 }
 
+void*
+event::
+operator new(size_t sz, context* ctx)
+{
+  return allocate_event(ctx ? ctx->get_event_pool() : nullptr, sz);
+}
+
+void*
+event::
+operator new(size_t sz)
+{
+  return allocate_event(nullptr, sz);
+}
+
+void
+event::
+operator delete(void* ptr)
+{
+  deallocate_event(ptr);
+}
+
+void
+event::
+operator delete(void* ptr, context*)
+{
+  deallocate_event(ptr);
+}
+
+// Remove when c++17
+constexpr size_t event_pool::granularity;
+constexpr size_t event_pool::buckets;
+
+event_pool::
+event_pool(size_t max_cached)
+  : m_max_cached(max_cached)
+{}
+
+event_pool::
+~event_pool()
+{
+  for (auto head : m_free) {
+    while (head) {
+      auto next = head->next;
+      ::operator delete(head);
+      head = next;
+    }
+  }
+}
+
+void*
+event_pool::
+allocate(size_t bytes)
+{
+  auto bucket = get_bucket(bytes);
+  if (bucket == buckets || !m_max_cached)
+    return ::operator new(bytes);
+
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (auto block = m_free[bucket]) {
+      m_free[bucket] = block->next;
+      --m_cached;
+      return block;
+    }
+  }
+
+  // Size of all blocks in a bucket is the same
+  return ::operator new((bucket + 1) * granularity);
+}
+
+void
+event_pool::
+deallocate(void* block, size_t bytes)
+{
+  auto bucket = get_bucket(bytes);
+  if (bucket < buckets) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_cached < m_max_cached) {
+      m_free[bucket] = new (block) free_block{m_free[bucket]};
+      ++m_cached;
+      return;
+    }
+  }
+  ::operator delete(block);
+}
+
 cl_int
 event::
 set_status(cl_int s)
@@ -438,22 +560,22 @@ create_event(command_queue* cq, context* ctx, cl_command_type cmd, cl_uint num_d
   if (cq && cq->is_profiling_enabled()) {
     if (num_deps)
       retval = app_debug
-        ? new edpw_event(cq,ctx,cmd,num_deps,deps)
-        : new epw_event(cq,ctx,cmd,num_deps,deps);
+        ? new (ctx) edpw_event(cq,ctx,cmd,num_deps,deps)
+        : new (ctx) epw_event(cq,ctx,cmd,num_deps,deps);
     else
       retval = app_debug
-        ? new edp_event(cq,ctx,cmd)
-        : new ep_event(cq,ctx,cmd);
+        ? new (ctx) edp_event(cq,ctx,cmd)
+        : new (ctx) ep_event(cq,ctx,cmd);
   }
   else {
     if (num_deps)
       retval = app_debug
-        ? new edw_event(cq,ctx,cmd,num_deps,deps)
-        : new ew_event(cq,ctx,cmd,num_deps,deps);
+        ? new (ctx) edw_event(cq,ctx,cmd,num_deps,deps)
+        : new (ctx) ew_event(cq,ctx,cmd,num_deps,deps);
     else
       retval = app_debug
-        ? new ed_event(cq,ctx,cmd)
-        : new event(cq,ctx,cmd);
+        ? new (ctx) ed_event(cq,ctx,cmd)
+        : new (ctx) event(cq,ctx,cmd);
   }
 
   // Release the refcount returned by event ctor, it is now captured
@@ -24,12 +24,16 @@
 #include "xocl/core/debug.h"
 #include "xocl/core/error.h"
 #include "xocl/core/execution_context.h"
+#include "xocl/core/small_function.h"
 
 #include "xrt/config.h"
 
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <mutex>
 
 namespace xocl {
 
@@ -56,7 +60,11 @@ public:
   using event_callback_type = std::function<void(event*)>;
   using event_callback_list = std::vector<event_callback_type>;
 
-  using action_enqueue_type = std::function<void (event*)>;
+  // The enqueue action is set for every command and is stored inline
+  // in the event.  The profile, debug, and LOP actions are set only
+  // when the feature is enabled, they are std::function and part of
+  // the XDP plugin interfaces.
+  using action_enqueue_type = small_function<void (event*)>;
   using action_profile_type = std::function<void (event*, cl_int, const std::string&)>;
   using action_debug_type = std::function<void (event*)>;
   using action_lop_type = std::function<void (event*, cl_int)>;
@@ -65,6 +73,25 @@ public:
   event(command_queue* cq, context* ctx, cl_command_type cmd, cl_uint num_deps, const cl_event* deps);
   virtual ~event();
 
+  /**
+   * Allocate event from the event pool of a context
+   *
+   * Memory of a deleted event is returned to the pool it was
+   * allocated from and reused for the next event of same size.
+   * Events allocated without a context are not pooled.
+   */
+  static void*
+  operator new(size_t sz, context* ctx);
+
+  static void*
+  operator new(size_t sz);
+
+  static void
+  operator delete(void* ptr);
+
+  static void
+  operator delete(void* ptr, context* ctx);
+
   /**
    */
   unsigned int
@@ -562,6 +589,50 @@ private:
   unsigned int m_wait_count = 0;
 };
 
+/**
+ * Cache of event memory, one per context
+ *
+ * Memory of deleted events is kept on free lists by size, such that
+ * steady state enqueueing reuses the memory of completed events
+ * rather than allocating new events.  At most max_cached blocks are
+ * kept, Runtime.event_pool_size=0 disables caching.
+ */
+class event_pool
+{
+public:
+  explicit
+  event_pool(size_t max_cached);
+
+  ~event_pool();
+
+  void*
+  allocate(size_t bytes);
+
+  void
+  deallocate(void* block, size_t bytes);
+
+private:
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  static constexpr size_t granularity = 64;
+  static constexpr size_t buckets = 16;
+
+  // Free list index of blocks of argument size, or buckets if too large
+  static size_t
+  get_bucket(size_t bytes)
+  {
+    return bytes ? std::min((bytes - 1) / granularity, buckets) : 0;
+  }
+
+  std::mutex m_mutex;
+  std::array<free_block*, buckets> m_free {};
+  size_t m_cached = 0;
+  size_t m_max_cached = 0;
+};
+
 /**
  * Event with profiling enabled
  *
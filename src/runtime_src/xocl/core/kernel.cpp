@@ -27,6 +27,7 @@
 #include <iostream>
 #include <memory>
 #include <algorithm>
+#include <cstring>
 #include <regex>
 
 #ifdef _WIN32
@@ -165,6 +166,9 @@ kernel(program* prog, const std::string& name, const xclbin::symbol& symbol)
   // parameters from any of the run objects associated with this
   // kernel.
   m_arginfo = std::move(xrt_core::kernel_int::get_args(get_xrt_kernel()));
+  m_argvalues.resize(m_arginfo.size());
+  for (auto& v : m_xruns)
+    v.second.dirty.resize(m_arginfo.size());
   size_t idx = 0;
   for (auto itr = m_arginfo.begin(); itr != m_arginfo.end(); ++itr, ++idx) {
     auto arg = (*itr);
@@ -217,6 +221,45 @@ kernel(program* prog, const std::string& name, const xclbin::symbol& symbol)
   if (m_cus.empty())
     throw std::runtime_error("No kernel compute units matching '" + name + "'");
 
+  init_info();
+}
+
+void
+kernel::
+init_info()
+{
+  // Pack all strings first, then refer to them once the buffer no
+  // longer grows
+  std::vector<std::pair<size_t,size_t>> strings; // offset,size
+  auto pack = [this, &strings](const std::string& str) {
+    strings.emplace_back(m_info.strings.size(), str.size() + 1);
+    m_info.strings.insert(m_info.strings.end(), str.c_str(), str.c_str() + str.size() + 1);
+  };
+  auto unpack = [this, &strings](size_t idx) {
+    auto data = m_info.strings.data() + strings[idx].first;
+    return info_type::string_type(data, data + strings[idx].second);
+  };
+
+  pack(m_name);
+  pack(m_symbol.attributes);
+  for (auto& arg : m_indexed_xargs) {
+    pack(arg->get_hosttype());
+    pack(arg->get_name());
+  }
+
+  m_info.function_name = unpack(0);
+  m_info.attributes = unpack(1);
+  m_info.num_args = static_cast<cl_uint>(m_indexed_xargs.size());
+  m_info.args.reserve(m_indexed_xargs.size());
+  size_t idx = 2;
+  for (auto& arg : m_indexed_xargs) {
+    info_type::arg_type info;
+    info.address_qualifier = static_cast<cl_kernel_arg_address_qualifier>(arg->get_argtype());
+    info.offset = arg->get_offset();
+    info.type_name = unpack(idx++);
+    info.name = unpack(idx++);
+    m_info.args.push_back(info);
+  }
 }
 
 kernel::
@@ -229,10 +272,37 @@ void
 kernel::
 set_run_arg_at_index(unsigned long idx, const void* cvalue, size_t sz)
 {
-  for (const auto& v : m_xruns) {
-    auto& run = v.second.xrun;
-    xrt_core::kernel_int::set_arg_at_index(run, idx, cvalue, sz);
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto& value = m_argvalues.at(idx);
+  auto bytes = static_cast<const char*>(cvalue);
+  if (value.size() == sz && std::memcmp(value.data(), bytes, sz) == 0)
+    return;
+
+  value.assign(bytes, bytes + sz);
+  for (auto& v : m_xruns) {
+    auto& kr = v.second;
+    if (!kr.dirty[idx]) {
+      kr.dirty[idx] = true;
+      ++kr.ndirty;
+    }
+  }
+}
+
+void
+kernel::
+apply_dirty_args(xkr& kr) const
+{
+  if (!kr.ndirty)
+    return;
+
+  for (size_t idx = 0; idx < kr.dirty.size(); ++idx) {
+    if (!kr.dirty[idx])
+      continue;
+    auto& value = m_argvalues[idx];
+    xrt_core::kernel_int::set_arg_at_index(kr.xrun, idx, value.data(), value.size());
+    kr.dirty[idx] = false;
   }
+  kr.ndirty = 0;
 }
 
 void
@@ -289,6 +359,9 @@ get_xrt_run(const device* device) const
   auto itr = device ? m_xruns.find(device) : m_xruns.begin();
   if (itr == m_xruns.end())
     throw std::runtime_error("No kernel run object for device");
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  apply_dirty_args((*itr).second);
   return (*itr).second.xrun;
 }
  
@@ -27,6 +27,7 @@
 
 #include "xrt/util/td.h"
 #include <limits>
+#include <mutex>
 
 #include <iostream>
 
@@ -77,6 +78,7 @@ class kernel : public refcount, public _cl_kernel
 
     size_t get_argidx() const { return m_arginfo->index; }
     size_t get_hostsize() const { return m_arginfo->hostsize; }
+    size_t get_offset() const { return m_arginfo->offset; }
     bool is_set() const { return m_set; }
     std::string get_name() const { return m_arginfo->name; }
     std::string get_hosttype() const { return m_arginfo->hosttype; }
@@ -152,6 +154,34 @@ class kernel : public refcount, public _cl_kernel
     size_t m_arginfo_idx;
   };
 
+  // Values of clGetKernelInfo and clGetKernelArgInfo that do not
+  // change over the lifetime of the kernel.  Computed once when the
+  // kernel is constructed, so that a query is a copy.  Strings are
+  // packed nul terminated in one buffer, a string range includes the
+  // nul.  Not copyable, the ranges refer to the buffer.
+  struct info_type
+  {
+    using string_type = range<const char*>;
+
+    struct arg_type
+    {
+      cl_kernel_arg_address_qualifier address_qualifier;
+      size_t offset;
+      string_type type_name;
+      string_type name;
+    };
+
+    string_type function_name;
+    string_type attributes;
+    cl_uint num_args = 0;
+    std::vector<arg_type> args;
+    std::vector<char> strings;
+
+    info_type() = default;
+    info_type(const info_type&) = delete;
+    info_type& operator=(const info_type&) = delete;
+  };
+
 private:
   using xargument_value_type = std::unique_ptr<xargument>;
   using xargument_vector_type = std::vector<xargument_value_type>;
@@ -174,6 +204,13 @@ public:
     return m_uid;
   }
 
+  // Get precomputed values for OpenCL kernel queries
+  const info_type&
+  get_info() const
+  {
+    return m_info;
+  }
+
   // Get unique id for the kernel symbol associated with this object
   unsigned int
   get_symbol_uid() const
@@ -244,9 +281,11 @@ public:
     return false;
   }
 
-  // Arguments (except global cl_mem) are set directly on the run
-  // object in the kernel register map.  This avoids any local copies
-  // of the data and simplifies starting of the kernel
+  // Arguments (except global cl_mem) are recorded by the kernel and
+  // marked dirty for all run objects.  A value identical to current
+  // argument value is ignored.  Dirty arguments are written to the
+  // register map of a run object only when the run object is used
+  // for a launch, see get_xrt_run().
   void
   set_run_arg_at_index(unsigned long idx, const void* cvalue, size_t sz);
 
@@ -315,7 +354,8 @@ public:
   get_xrt_kernel(const device* device = nullptr) const;
 
   // The the underlying xrt::run object for specified device
-  // Default to first run object.
+  // Default to first run object.  Arguments changed since the run
+  // object was last retrieved are applied before it is returned.
   const xrt::run&
   get_xrt_run(const device* device = nullptr) const;
 
@@ -382,13 +422,35 @@ private:
   xargument_vector_type m_rtinfo_xargs;
   xargument_vector_type m_printf_xargs;
 
-  // One run object per device in m_program
-  struct xkr { xrt::kernel xkernel; xrt::run xrun; };
-  std::map<const device*, xkr> m_xruns;
+  // One run object per device in m_program.  The dirty mask
+  // tracks arguments not yet applied to the run object.
+  struct xkr
+  {
+    xrt::kernel xkernel;
+    xrt::run xrun;
+    std::vector<bool> dirty;
+    size_t ndirty = 0;
+  };
+  mutable std::map<const device*, xkr> m_xruns;
+
+  // Current argument values indexed by argument index, applied to
+  // run objects lazily
+  std::vector<std::vector<char>> m_argvalues;
+  mutable std::mutex m_mutex;
+
+  // Write dirty arguments to run object
+  void
+  apply_dirty_args(xkr& kr) const;
 
   // Arguments in indexed order per xrt::kernel object
   using xarg = xrt_core::xclbin::kernel_argument;
   std::vector<const xarg*> m_arginfo;
+
+  // Compute m_info after arguments are constructed
+  void
+  init_info();
+
+  info_type m_info;
 };
 
 namespace kernel_utils {
@@ -127,6 +127,13 @@ memory::
   catch (...) {}
 }
 
+int
+memory::
+get_host_numa_node() const
+{
+  return m_context ? m_context->get_numa_node() : -1;
+}
+
 bool
 memory::
 set_kernel_argidx(const kernel* kernel, unsigned int argidx)
@@ -237,6 +244,104 @@ try_get_buffer_object_or_error(const device* device) const
   return (*itr).second;
 }
 
+void
+memory::
+set_resident_range(const device* device, size_t offset, size_t size)
+{
+  std::lock_guard<std::mutex> lk(m_boh_mutex);
+  if (!size || std::find(m_resident.begin(),m_resident.end(),device) != m_resident.end())
+    return;
+
+  // Merge [begin,end) with the ranges it overlaps or touches
+  auto& ranges = m_resident_ranges[device];
+  auto begin = offset;
+  auto end = offset + size;
+  auto itr = ranges.upper_bound(begin);
+  if (itr != ranges.begin() && std::prev(itr)->second >= begin)
+    --itr;
+  while (itr != ranges.end() && itr->first <= end) {
+    begin = std::min(begin,itr->first);
+    end = std::max(end,itr->second);
+    itr = ranges.erase(itr);
+  }
+  ranges.emplace(begin,end);
+
+  // Whole buffer is resident when one range covers it
+  if (begin == 0 && end >= get_size()) {
+    m_resident_ranges.erase(device);
+    m_resident.push_back(device);
+  }
+}
+
+void
+memory::
+clear_resident_range(const device* device, size_t offset, size_t size)
+{
+  std::lock_guard<std::mutex> lk(m_boh_mutex);
+  auto ditr = m_resident_ranges.find(device);
+  if (ditr == m_resident_ranges.end() || !size)
+    return;
+
+  // Cut [begin,end) out of the ranges it overlaps
+  auto& ranges = (*ditr).second;
+  auto begin = offset;
+  auto end = offset + size;
+  auto itr = ranges.upper_bound(begin);
+  if (itr != ranges.begin() && std::prev(itr)->second > begin)
+    --itr;
+  while (itr != ranges.end() && itr->first < end) {
+    auto rbegin = itr->first;
+    auto rend = itr->second;
+    itr = ranges.erase(itr);
+    if (rbegin < begin)
+      ranges.emplace(rbegin,begin);
+    if (rend > end)
+      ranges.emplace(end,rend);
+  }
+  if (ranges.empty())
+    m_resident_ranges.erase(ditr);
+}
+
+bool
+memory::
+is_resident_range(const device* device, size_t offset, size_t size) const
+{
+  if (is_resident(device))
+    return true;
+  return get_nonresident_ranges(device,offset,size).empty();
+}
+
+std::vector<memory::range_type>
+memory::
+get_nonresident_ranges(const device* device, size_t offset, size_t size) const
+{
+  std::vector<range_type> gaps;
+  if (!size || is_resident(device))
+    return gaps;
+
+  std::lock_guard<std::mutex> lk(m_boh_mutex);
+  auto ditr = m_resident_ranges.find(device);
+  if (ditr == m_resident_ranges.end()) {
+    gaps.emplace_back(offset,size);
+    return gaps;
+  }
+
+  auto& ranges = (*ditr).second;
+  auto pos = offset;
+  auto end = offset + size;
+  auto itr = ranges.upper_bound(pos);
+  if (itr != ranges.begin() && std::prev(itr)->second > pos)
+    --itr;
+  for (; itr != ranges.end() && itr->first < end && pos < end; ++itr) {
+    if (itr->first > pos)
+      gaps.emplace_back(pos,itr->first - pos);
+    pos = std::max(pos,itr->second);
+  }
+  if (pos < end)
+    gaps.emplace_back(pos,end - pos);
+  return gaps;
+}
+
 // private
 memory::memidx_type
 memory::
@@ -24,10 +24,12 @@
 #include "xrt/device/device.h"
 
 #include "core/common/memalign.h"
+#include "core/common/numa.h"
 #include "core/common/unistd.h"
 #include "core/common/api/bo.h"
 #include "core/include/experimental/xrt_bo.h"
 
+#include <atomic>
 #include <map>
 
 #ifdef _WIN32
@@ -53,6 +55,15 @@ protected:
   using bomap_type = std::map<const device*,buffer_object_handle>;
   using bomap_value_type = bomap_type::value_type;
   using bomap_iterator_type = bomap_type::iterator;
+  using range_type = std::pair<size_t,size_t>; // offset,size
+
+  /**
+   * NUMA node on which to place host memory allocated by the runtime,
+   * the node of the context devices if the context prefers local
+   * devices, -1 if the memory is not placed
+   */
+  int
+  get_host_numa_node() const;
 public:
   using memory_callback_type = std::function<void (memory*)>;
   using memory_callback_list = std::vector<memory_callback_type>;
@@ -425,12 +436,13 @@ public:
   /**
    * Set device resident
    */
-  void
+  virtual void
   set_resident(const device* device)
   {
     std::lock_guard<std::mutex> lk(m_boh_mutex);
     if (std::find(m_resident.begin(),m_resident.end(),device) == m_resident.end())
       m_resident.push_back(device);
+    m_resident_ranges.erase(device);
   }
 
   /**
@@ -441,6 +453,58 @@ public:
   {
     std::lock_guard<std::mutex> lk(m_boh_mutex);
     m_resident.clear();
+    m_resident_ranges.clear();
+  }
+
+  /**
+   * Record that a range of this buffer is current on device
+   *
+   * A buffer that is not resident in whole can have ranges that are
+   * resident because sub buffers of the range were migrated.
+   */
+  void
+  set_resident_range(const device* device, size_t offset, size_t size);
+
+  /**
+   * Record that a range of this buffer is no longer current on device
+   *
+   * Called when the host side of a range is written while the buffer
+   * is not resident in whole.
+   */
+  virtual void
+  clear_resident_range(const device* device, size_t offset, size_t size);
+
+  /**
+   * Check if a range of this buffer is current on device
+   */
+  bool
+  is_resident_range(const device* device, size_t offset, size_t size) const;
+
+  /**
+   * Get the sub ranges of [offset,offset+size) that are not current
+   * on device, in increasing order of offset.
+   *
+   * These are the ranges that must be synced to make the range
+   * resident.
+   */
+  virtual std::vector<range_type>
+  get_nonresident_ranges(const device* device, size_t offset, size_t size) const;
+
+  /**
+   * Mark host side buffer stale after device memory was written
+   * directly by DMA from user memory.  A stale host side buffer must
+   * be refreshed from device before it is synced to device in whole.
+   */
+  void
+  set_host_stale(bool stale)
+  {
+    m_host_stale = stale;
+  }
+
+  bool
+  is_host_stale() const
+  {
+    return m_host_stale;
   }
 
   /**
@@ -501,6 +565,8 @@ private:
   mutable std::mutex m_boh_mutex;
   bomap_type m_bomap;
   std::vector<const device*> m_resident;
+  std::map<const device*,std::map<size_t,size_t>> m_resident_ranges; // begin -> end
+  std::atomic<bool> m_host_stale {false};
   connidx_type m_connidx = -1;
 };
 
@@ -513,10 +579,16 @@ public:
     // device is unknown so alignment requirement has to be hardwired
     const size_t alignment = xrt_core::bo::alignment();
 
-    if (flags & (CL_MEM_COPY_HOST_PTR | CL_MEM_ALLOC_HOST_PTR))
-      // allocate sufficiently aligned memory and reassign m_host_ptr
-      if (xrt_core::posix_memalign(&m_host_ptr,alignment,sz))
+    if (flags & (CL_MEM_COPY_HOST_PTR | CL_MEM_ALLOC_HOST_PTR)) {
+      // allocate sufficiently aligned memory and reassign m_host_ptr,
+      // whole pages if the allocation is placed on a NUMA node
+      auto node = get_host_numa_node();
+      auto bytes = node < 0 ? sz : xrt_core::numa::page_roundup(sz);
+      if (xrt_core::posix_memalign(&m_host_ptr,alignment,bytes))
         throw error(CL_MEM_OBJECT_ALLOCATION_FAILURE,"Could not allocate host ptr");
+      if (node >= 0)
+        xrt_core::numa::bind(m_host_ptr,bytes,node);
+    }
     if (flags & CL_MEM_COPY_HOST_PTR && host_ptr)
       std::memcpy(m_host_ptr,host_ptr,sz);
 
@@ -624,14 +696,40 @@ public:
     if (memory::is_resident(device))
       return true;
 
-    // or, if parent is resident
-    if (m_parent->is_resident(device)) {
+    // or, if its range of the parent is resident
+    if (m_parent->is_resident_range(device,m_offset,get_size())) {
       // make sub buffer explicit resident, logically const
       const_cast<sub_buffer*>(this)->make_resident(device);
       return true;
     }
     return false;
   }
+
+  virtual void
+  set_resident(const device* device)
+  {
+    memory::set_resident(device);
+    m_parent->set_resident_range(device,m_offset,get_size());
+  }
+
+  virtual void
+  clear_resident_range(const device* device, size_t offset, size_t size)
+  {
+    // device side of sub buffer is part of its parent's
+    m_parent->clear_resident_range(device,m_offset+offset,size);
+  }
+
+  virtual std::vector<range_type>
+  get_nonresident_ranges(const device* device, size_t offset, size_t size) const
+  {
+    if (memory::is_resident(device))
+      return {};
+    auto ranges = m_parent->get_nonresident_ranges(device,m_offset+offset,size);
+    for (auto& range : ranges)
+      range.first -= m_offset;
+    return ranges;
+  }
+
 private:
   void
   make_resident(const device* device)
@@ -0,0 +1,236 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xocl_core_small_function_h_
+#define xocl_core_small_function_h_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace xocl {
+
+/**
+ * Move only function wrapper with inline storage
+ *
+ * A callable that fits in Size bytes and is nothrow move
+ * constructible is stored inline, a larger callable is stored on
+ * the heap.  This is used for actions that are set for every
+ * enqueued command where std::function would allocate for most
+ * capturing lambdas.
+ */
+template <typename Signature, std::size_t Size = 64>
+class small_function;
+
+template <typename R, typename ...Args, std::size_t Size>
+class small_function<R(Args...), Size>
+{
+  using storage_type = typename std::aligned_storage<Size, alignof(std::max_align_t)>::type;
+
+  struct ops_type
+  {
+    R    (*call)(void*, Args&&...);
+    void (*move)(void* dst, void* src);  // move construct dst, destroy src
+    void (*destroy)(void*);
+  };
+
+  template <typename F>
+  struct local
+  {
+    static F*
+    get(void* p)
+    {
+      return static_cast<F*>(p);
+    }
+
+    template <typename Fn>
+    static void
+    create(void* p, Fn&& f)
+    {
+      new (p) F(std::forward<Fn>(f));
+    }
+
+    static R
+    call(void* p, Args&&... args)
+    {
+      return (*get(p))(std::forward<Args>(args)...);
+    }
+
+    static void
+    move(void* dst, void* src)
+    {
+      new (dst) F(std::move(*get(src)));
+      get(src)->~F();
+    }
+
+    static void
+    destroy(void* p)
+    {
+      get(p)->~F();
+    }
+  };
+
+  template <typename F>
+  struct remote
+  {
+    static F*&
+    get(void* p)
+    {
+      return *static_cast<F**>(p);
+    }
+
+    template <typename Fn>
+    static void
+    create(void* p, Fn&& f)
+    {
+      new (p) F*(new F(std::forward<Fn>(f)));
+    }
+
+    static R
+    call(void* p, Args&&... args)
+    {
+      return (*get(p))(std::forward<Args>(args)...);
+    }
+
+    static void
+    move(void* dst, void* src)
+    {
+      new (dst) F*(get(src));
+    }
+
+    static void
+    destroy(void* p)
+    {
+      delete get(p);
+    }
+  };
+
+  template <typename F>
+  using is_local = std::integral_constant<bool,
+    sizeof(F) <= Size
+    && alignof(F) <= alignof(std::max_align_t)
+    && std::is_nothrow_move_constructible<F>::value>;
+
+  template <typename F>
+  using impl = typename std::conditional<is_local<F>::value, local<F>, remote<F>>::type;
+
+  template <typename F>
+  static const ops_type*
+  get_ops()
+  {
+    static const ops_type ops = { &impl<F>::call, &impl<F>::move, &impl<F>::destroy };
+    return &ops;
+  }
+
+  template <typename F>
+  static bool
+  is_null(const F&)
+  {
+    return false;
+  }
+
+  template <typename Sig>
+  static bool
+  is_null(const std::function<Sig>& f)
+  {
+    return !f;
+  }
+
+  template <typename Ret, typename ...FArgs>
+  static bool
+  is_null(Ret (*f)(FArgs...))
+  {
+    return f == nullptr;
+  }
+
+  mutable storage_type m_storage;
+  const ops_type* m_ops = nullptr;
+
+public:
+  small_function()
+  {}
+
+  small_function(std::nullptr_t)
+  {}
+
+  template <typename F,
+            typename = typename std::enable_if<
+              !std::is_same<typename std::decay<F>::type, small_function>::value>::type>
+  small_function(F&& f)
+  {
+    using fn_type = typename std::decay<F>::type;
+    if (is_null(f))
+      return;
+    impl<fn_type>::create(&m_storage, std::forward<F>(f));
+    m_ops = get_ops<fn_type>();
+  }
+
+  small_function(small_function&& rhs) noexcept
+    : m_ops(rhs.m_ops)
+  {
+    if (m_ops)
+      m_ops->move(&m_storage, &rhs.m_storage);
+    rhs.m_ops = nullptr;
+  }
+
+  small_function&
+  operator=(small_function&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      reset();
+      if ((m_ops = rhs.m_ops))
+        m_ops->move(&m_storage, &rhs.m_storage);
+      rhs.m_ops = nullptr;
+    }
+    return *this;
+  }
+
+  small_function(const small_function&) = delete;
+  small_function& operator=(const small_function&) = delete;
+
+  ~small_function()
+  {
+    reset();
+  }
+
+  void
+  reset()
+  {
+    if (m_ops)
+      m_ops->destroy(&m_storage);
+    m_ops = nullptr;
+  }
+
+  explicit
+  operator bool() const
+  {
+    return m_ops != nullptr;
+  }
+
+  R
+  operator()(Args... args) const
+  {
+    if (!m_ops)
+      throw std::bad_function_call();
+    return m_ops->call(&m_storage, std::forward<Args>(args)...);
+  }
+};
+
+} // xocl
+
+#endif
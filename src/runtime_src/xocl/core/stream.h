@@ -49,6 +49,8 @@ public:
   int get_stream(device* device); 
   int poll_stream(xrt_xocl::device::stream_xfer_completions *comps, int min, int max, int *actual, int timeout); 
   int set_stream_opt(int type, uint32_t val);
+  stream_handle get_handle() const { return m_handle; }
+  device* get_device() const { return m_device; }
   ssize_t read(void* ptr, size_t size, stream_xfer_req* req );
   ssize_t write(const void* ptr, size_t size, stream_xfer_req* req);
   int close();
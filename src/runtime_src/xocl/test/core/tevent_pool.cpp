@@ -0,0 +1,146 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of heap allocations made when creating the event of
+// an enqueued command.  Global operator new is replaced to count
+// allocations.
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "xocl/core/event.h"
+#include "xocl/core/context.h"
+#include "xocl/core/command_queue.h"
+#include "xocl/core/small_function.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> counting {false};
+std::atomic<unsigned int> allocations {0};
+
+// Number of heap allocations made by argument function
+template <typename F>
+unsigned int
+count_allocations(F&& f)
+{
+  allocations = 0;
+  counting = true;
+  f();
+  counting = false;
+  return allocations;
+}
+
+} // namespace
+
+void*
+operator new(size_t sz)
+{
+  if (counting)
+    ++allocations;
+  if (auto ptr = std::malloc(sz ? sz : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+BOOST_AUTO_TEST_SUITE ( test_event_pool )
+
+// Enqueue actions capture a few pointers and are stored inline
+BOOST_AUTO_TEST_CASE( test_enqueue_action_inline )
+{
+  int a = 0, b = 1, c = 2, d = 3;
+  auto n = count_allocations([&] {
+    xocl::event::action_enqueue_type action([&a, &b, &c, &d](xocl::event*) { a = b + c + d; });
+    auto moved = std::move(action);
+    moved(nullptr);
+  });
+  BOOST_CHECK_EQUAL(n, 0);
+  BOOST_CHECK_EQUAL(a, 6);
+}
+
+// Callables larger than the inline storage are stored on the heap
+BOOST_AUTO_TEST_CASE( test_enqueue_action_heap )
+{
+  std::array<char, 128> data {};
+  auto n = count_allocations([&] {
+    xocl::event::action_enqueue_type action([data](xocl::event*) { (void)data; });
+    auto moved = std::move(action);
+  });
+  BOOST_CHECK_EQUAL(n, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_event_pool_reuse )
+{
+  xocl::event_pool pool(4);
+  auto block = pool.allocate(200);
+  pool.deallocate(block, 200);
+
+  void* reused = nullptr;
+  auto n = count_allocations([&] { reused = pool.allocate(200); });
+  BOOST_CHECK_EQUAL(n, 0);
+  BOOST_CHECK_EQUAL(reused, block);
+  pool.deallocate(reused, 200);
+}
+
+BOOST_AUTO_TEST_CASE( test_event_pool_disabled )
+{
+  xocl::event_pool pool(0);
+  auto block = pool.allocate(200);
+  pool.deallocate(block, 200);
+
+  auto n = count_allocations([&] { block = pool.allocate(200); });
+  BOOST_CHECK_EQUAL(n, 1);
+  pool.deallocate(block, 200);
+}
+
+// Creating the event of a command with its enqueue action, as done
+// for every enqueued command, allocates the event itself only when
+// it is not pooled.  The allocations that remain in both cases are
+// made by event and command queue bookkeeping.
+BOOST_AUTO_TEST_CASE( test_event_enqueue_path )
+{
+  xocl::context c(nullptr,0,nullptr);
+  xocl::command_queue q(&c,nullptr,0);
+
+  int a = 0, b = 1, d = 2;
+  auto create = [&](bool pooled) {
+    auto ev = pooled
+      ? new (&c) xocl::event(&q,&c,0)
+      : new xocl::event(&q,&c,0);
+    ev->set_enqueue_action([&a, &b, &d, ev](xocl::event*) { a = b + d; });
+    delete ev;
+  };
+
+  // Warm up, the first pooled event fills the pool
+  create(true);
+  create(false);
+
+  auto pooled = count_allocations([&] { create(true); });
+  auto unpooled = count_allocations([&] { create(false); });
+  BOOST_CHECK_EQUAL(pooled + 1, unpooled);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -510,6 +510,12 @@ public:
     return m_hal->pollStream(stream, comps, min,max,actual,timeout);
   };
 
+  int
+  pollStreamSet(const hal::StreamHandle* streams, int num, hal::StreamXferCompletions* comps, int min, int max, int* actual, int timeout)
+  {
+    return m_hal->pollStreamSet(streams, num, comps, min,max,actual,timeout);
+  };
+
   hal::StreamBuf
   allocStreamBuf(size_t size, hal::StreamBufHandle *buf)
   {
@@ -834,11 +840,30 @@ public:
   template <typename F,typename ...Args>
   event
   schedule(F&& f,queue_type qt,Args&&... args)
+  {
+    return schedule_dma(std::forward<F>(f),qt,dma_queue::hint{},std::forward<Args>(args)...);
+  }
+
+  /**
+   * Schedule a function on the device's task queue with a hint of
+   * the size and priority of the DMA operation it performs.
+   *
+   * The hint is used by devices that schedule DMA operations by size
+   * and priority, and ignored otherwise.
+   */
+  template <typename F,typename ...Args>
+  event
+  schedule_dma(F&& f,queue_type qt,const dma_queue::hint& hint,Args&&... args)
   {
     // Ensure that the worker threads are running
     if (!m_setup_done)
       setup();
 
+    if (auto dq = m_hal->getDmaQueue(qt)) {
+      dma_queue::scheduler sched{*dq,hint};
+      return task::createF(sched,f,std::forward<Args>(args)...);
+    }
+
     task::queue* q = m_hal->getQueue(qt);
     return task::createF(*q,f,std::forward<Args>(args)...);
   }
@@ -855,10 +880,30 @@ public:
     if (!m_setup_done)
       setup();
 
+    if (auto dq = m_hal->getDmaQueue(qt)) {
+      dma_queue::scheduler sched{*dq,dma_queue::hint{}};
+      return task::createM(sched,f,c,std::forward<Args>(args)...);
+    }
+
     task::queue* q = m_hal->getQueue(qt);
     return task::createM(*q,f,c,std::forward<Args>(args)...);
   }
 
+  /**
+   * Perform a DMA operation of size bytes as calls fn(offset,size)
+   * over chunks of the operation, which are spread over the DMA
+   * workers for operations of type qt.  Returns when all chunks are
+   * done.
+   */
+  void
+  split_dma(queue_type qt,size_t size,const std::function<void(size_t,size_t)>& fn)
+  {
+    if (auto dq = m_hal->getDmaQueue(qt))
+      dq->split(size,fn);
+    else
+      fn(0,size);
+  }
+
 private:
 
   std::unique_ptr<hal::device> m_hal;
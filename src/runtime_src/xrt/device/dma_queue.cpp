@@ -0,0 +1,333 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#include "dma_queue.h"
+
+#include "xrt/util/config_reader.h"
+#include "xrt/util/debug.h"
+#include "xrt/util/time.h"
+#include "core/common/thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+// Tasks waiting longer than this are served before tasks of higher
+// priority and smaller size
+constexpr uint64_t aging_ns = 20 * 1000 * 1000;
+
+// Queue and hint of the task run by this thread, if any
+struct current_task
+{
+  xrt_xocl::dma_queue* queue = nullptr;
+  xrt_xocl::dma_queue::hint h;
+};
+
+static thread_local current_task s_current;
+
+} // namespace
+
+namespace xrt_xocl {
+
+// Chunks of a split transfer are claimed by the thread that split the
+// transfer and by helper tasks on other workers.  A helper that runs
+// after all chunks are claimed returns immediately.
+struct dma_queue::transfer
+{
+  const std::function<void(size_t, size_t)>& fn;
+  size_t size;
+  size_t chunk;
+  size_t chunks;
+  std::atomic<size_t> next {0};
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t done = 0;
+  std::exception_ptr error;
+
+  transfer(const std::function<void(size_t, size_t)>& f, size_t sz, size_t ch)
+    : fn(f), size(sz), chunk(ch), chunks((sz + ch - 1) / ch)
+  {}
+
+  // Run next chunk, returns false if all chunks are claimed
+  bool
+  run_one()
+  {
+    auto idx = next++;
+    if (idx >= chunks)
+      return false;
+
+    bool failed = false;
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      failed = (error != nullptr);
+    }
+
+    if (!failed) {
+      auto offset = idx * chunk;
+      try {
+        fn(offset, std::min(chunk, size - offset));
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lk(mutex);
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(mutex);
+    if (++done == chunks)
+      cv.notify_all();
+    return true;
+  }
+
+  void
+  run()
+  {
+    while (run_one())
+      ;
+  }
+
+  void
+  wait()
+  {
+    std::unique_lock<std::mutex> lk(mutex);
+    cv.wait(lk, [this] { return done == chunks; });
+    if (error)
+      std::rethrow_exception(error);
+  }
+};
+
+dma_queue::
+dma_queue()
+  : m_scheduler(config::get_dma_scheduler())
+  , m_small_size(config::get_dma_small_size())
+  , m_chunk_size(config::get_dma_chunk_size())
+{}
+
+dma_queue::
+~dma_queue()
+{
+  stop();
+}
+
+void
+dma_queue::
+start(unsigned int workers, const std::string& id, const xrt_core::device* device)
+{
+  m_id = id;
+  for (unsigned int i = 0; i < workers; ++i)
+    m_workers.emplace_back(xrt_core::role_thread(xrt_core::thread_role::dma, device, &dma_queue::worker, this));
+}
+
+void
+dma_queue::
+stop()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+    m_work.notify_all();
+  }
+  for (auto& t : m_workers)
+    t.join();
+  m_workers.clear();
+}
+
+dma_queue::lane
+dma_queue::
+to_lane(const hint& h, bool bulk) const
+{
+  if (!m_scheduler)
+    return lane::normal_bulk;
+
+  auto base = (h.priority > 0) ? lane::high_small
+    : (h.priority < 0) ? lane::low_small
+    : lane::normal_small;
+  bool small = !bulk && h.size && h.size <= m_small_size;
+  return static_cast<lane>(static_cast<ltype>(base) + (small ? 0 : 1));
+}
+
+void
+dma_queue::
+push(item&& it, lane l)
+{
+  m_lanes[static_cast<ltype>(l)].push_back(std::move(it));
+  ++m_size;
+}
+
+void
+dma_queue::
+addWork(task::task&& t, const hint& h)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  push({std::move(t), time_ns(), h, false}, to_lane(h, false));
+  m_work.notify_one();
+}
+
+dma_queue::lane
+dma_queue::
+pick(lane bound) const
+{
+  if (!m_size)
+    return lane::max;
+
+  auto end = static_cast<ltype>(bound);
+  auto oldest = lane::max;
+  uint64_t oldest_ts = 0;
+  for (ltype l = 0; l < end; ++l) {
+    auto& q = m_lanes[l];
+    if (!q.empty() && (oldest == lane::max || q.front().enqueued < oldest_ts)) {
+      oldest = static_cast<lane>(l);
+      oldest_ts = q.front().enqueued;
+    }
+  }
+
+  if (oldest == lane::max || time_ns() - oldest_ts > aging_ns)
+    return oldest;
+
+  for (ltype l = 0; l < end; ++l)
+    if (!m_lanes[l].empty())
+      return static_cast<lane>(l);
+
+  return lane::max;
+}
+
+dma_queue::item
+dma_queue::
+pop(lane l)
+{
+  auto& q = m_lanes[static_cast<ltype>(l)];
+  auto it = std::move(q.front());
+  q.pop_front();
+  --m_size;
+
+  if (!it.helper) {
+    auto& s = m_stats[static_cast<ltype>(l)];
+    auto wait = time_ns() - it.enqueued;
+    ++s.tasks;
+    s.total_ns += wait;
+    s.max_ns = std::max(s.max_ns, wait);
+  }
+  return it;
+}
+
+void
+dma_queue::
+execute(item& it)
+{
+  auto saved = s_current;
+  s_current.queue = this;
+  s_current.h = it.h;
+  it.t();
+  s_current = saved;
+}
+
+void
+dma_queue::
+worker()
+{
+  while (true) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    auto l = lane::max;
+    while (!m_stop && (l = pick(lane::max)) == lane::max)
+      m_work.wait(lk);
+    if (m_stop)
+      break;
+
+    auto it = pop(l);
+    lk.unlock();
+    execute(it);
+  }
+  XRT_DEBUG(std::cout,"dma worker (",m_id,") done\n");
+}
+
+bool
+dma_queue::
+yield(const hint& h)
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  auto l = pick(to_lane(h, true));
+  if (l == lane::max)
+    return false;
+
+  auto it = pop(l);
+  lk.unlock();
+  execute(it);
+  return true;
+}
+
+void
+dma_queue::
+split(size_t size, const std::function<void(size_t, size_t)>& fn)
+{
+  if (!m_scheduler || !m_chunk_size || size <= m_chunk_size || m_workers.empty()) {
+    fn(0, size);
+    return;
+  }
+
+  // Helpers take the priority of the task being run by the calling
+  // worker, the calling worker itself is not available as a helper
+  bool on_worker = (s_current.queue == this);
+  auto h = on_worker ? s_current.h : hint{};
+  auto xfer = std::make_shared<transfer>(fn, size, m_chunk_size);
+  auto helpers = std::min<size_t>(xfer->chunks - 1, m_workers.size() - (on_worker ? 1 : 0));
+  if (helpers) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto l = to_lane(h, true);
+    for (size_t i = 0; i < helpers; ++i)
+      push({task::task([xfer] { xfer->run(); }), time_ns(), h, true}, l);
+    m_work.notify_all();
+  }
+
+  // Serve small and higher priority tasks between chunks
+  while (xfer->run_one())
+    if (on_worker)
+      yield(h);
+
+  xfer->wait();
+}
+
+size_t
+dma_queue::
+size() const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return m_size;
+}
+
+dma_queue::stats
+dma_queue::
+get_stats(lane l) const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return m_stats[static_cast<ltype>(l)];
+}
+
+const char*
+dma_queue::
+lane_name(lane l)
+{
+  static const char* names[] = {
+    "high/small", "high/bulk", "normal/small", "normal/bulk", "low/small", "low/bulk"
+  };
+  return l < lane::max ? names[static_cast<ltype>(l)] : "unknown";
+}
+
+} // xrt_xocl
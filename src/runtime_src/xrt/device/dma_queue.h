@@ -0,0 +1,203 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xrt_device_dma_queue_h
+#define xrt_device_dma_queue_h
+
+#include "xrt/util/task.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xrt_core {
+class device;
+}
+
+namespace xrt_xocl {
+
+/**
+ * Task queue with workers for DMA operations in one direction.
+ *
+ * Tasks are scheduled with a hint of their transfer size and priority.
+ * A worker picks the next task from the highest priority that has
+ * work, and within a priority prefers small transfers over bulk
+ * transfers, so that a latency critical transfer does not wait behind
+ * a large transfer scheduled before it.  Tasks that have waited longer
+ * than an aging limit are served first regardless, which bounds the
+ * wait of low priority and bulk transfers.
+ *
+ * Large transfers are split into chunks by split(), which lets idle
+ * workers help with the transfer and lets the worker running it serve
+ * small and higher priority tasks between chunks.
+ *
+ * When the scheduler is disabled (Runtime.dma_scheduler=false) all
+ * tasks are served in FIFO order and transfers are not split.
+ */
+class dma_queue
+{
+public:
+  struct hint
+  {
+    size_t size = 0;  // transfer size in bytes, 0 if not known
+    int priority = 0; // > 0 is high, < 0 is low priority
+
+    hint() {}
+    hint(size_t sz, int prio = 0) : size(sz), priority(prio) {}
+  };
+
+  // Wait time from scheduling until a worker picks the task
+  struct stats
+  {
+    uint64_t tasks = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+  };
+
+  enum class lane { high_small, high_bulk, normal_small, normal_bulk, low_small, low_bulk, max };
+  using ltype = std::underlying_type<lane>::type;
+
+  // Adaptor for task::createF and task::createM
+  struct scheduler
+  {
+    dma_queue& queue;
+    hint h;
+
+    void
+    addWork(task::task&& t)
+    {
+      queue.addWork(std::move(t), h);
+    }
+  };
+
+  dma_queue();
+  ~dma_queue();
+
+  /**
+   * Start workers
+   *
+   * @param workers
+   *  Number of worker threads
+   * @param id
+   *  Name of queue, used in debug output and statistics
+   * @param device
+   *  Device served by the queue, if any, workers are placed on the
+   *  cpus local to the device unless configured otherwise
+   */
+  void
+  start(unsigned int workers, const std::string& id, const xrt_core::device* device = nullptr);
+
+  /**
+   * Stop queue and join workers.  Tasks not yet started are discarded.
+   */
+  void
+  stop();
+
+  void
+  addWork(task::task&& t, const hint& h);
+
+  /**
+   * Run fn over [0,size) in chunks of at most Runtime.dma_chunk_size
+   * bytes, fn(offset,size) per chunk.
+   *
+   * The calling thread runs chunks until all are claimed and then waits
+   * for chunks claimed by other workers to complete.  If fn throws, no
+   * more chunks are started and the first exception is rethrown.
+   */
+  void
+  split(size_t size, const std::function<void(size_t, size_t)>& fn);
+
+  size_t
+  size() const;
+
+  unsigned int
+  workers() const
+  {
+    return static_cast<unsigned int>(m_workers.size());
+  }
+
+  const std::string&
+  id() const
+  {
+    return m_id;
+  }
+
+  stats
+  get_stats(lane l) const;
+
+  static const char*
+  lane_name(lane l);
+
+private:
+  struct item
+  {
+    task::task t;
+    uint64_t enqueued;
+    hint h;
+    bool helper;  // part of a split transfer, not counted in stats
+  };
+
+  struct transfer;
+
+  // Lane of a task, split transfer helpers are always bulk
+  lane
+  to_lane(const hint& h, bool bulk) const;
+
+  void
+  push(item&& it, lane l);
+
+  // Pick the next lane to serve, or max if none is ready.  Only
+  // lanes that precede 'bound' are considered.
+  lane
+  pick(lane bound) const;
+
+  // Caller holds lock, lane has work
+  item
+  pop(lane l);
+
+  void
+  worker();
+
+  // Run one waiting task that precedes bulk transfers of the given
+  // priority, returns false if none
+  bool
+  yield(const hint& h);
+
+  void
+  execute(item& it);
+
+  std::array<std::deque<item>, static_cast<ltype>(lane::max)> m_lanes;
+  std::array<stats, static_cast<ltype>(lane::max)> m_stats;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::vector<std::thread> m_workers;
+  std::string m_id;
+  size_t m_size = 0;
+  bool m_stop = false;
+  bool m_scheduler = true;
+  size_t m_small_size = 0;
+  size_t m_chunk_size = 0;
+};
+
+} // xrt_xocl
+
+#endif
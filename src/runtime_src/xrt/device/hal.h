@@ -18,6 +18,7 @@
 #define xrt_device_hal_h
 
 #include "xrt/config.h"
+#include "xrt/device/dma_queue.h"
 #include "xrt/util/task.h"
 #include "xrt/util/event.h"
 #include "xrt/util/range.h"
@@ -315,6 +316,15 @@ public:
   virtual int
   pollStream(hal::StreamHandle stream, StreamXferCompletions* comps, int min, int max, int* actual, int timeout) = 0;
 
+  /**
+   * Poll a set of streams with per-stream completion queues
+   *
+   * Completions are reaped directly into @comps.  Returns -ENOSYS if
+   * the driver does not support per-stream completion queues.
+   */
+  virtual int
+  pollStreamSet(const hal::StreamHandle* streams, int num, StreamXferCompletions* comps, int min, int max, int* actual, int timeout) = 0;
+
   virtual int
   setStreamOpt(hal::StreamHandle stream, int type, uint32_t val) = 0;
 
@@ -657,6 +667,13 @@ public:
   virtual task::queue*
   getQueue(hal::queue_type qt) {return nullptr; }
 
+  /**
+   * Queue for DMA operations of type qt if the device schedules them
+   * by size and priority, nullptr otherwise.
+   */
+  virtual dma_queue*
+  getDmaQueue(hal::queue_type qt) {return nullptr; }
+
   virtual void*
   getHalDeviceHandle() {return nullptr;}
 };
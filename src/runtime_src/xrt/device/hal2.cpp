@@ -57,6 +57,23 @@ send_exception_message(const std::string& msg)
   send_exception_message(msg.c_str());
 }
 
+// Per lane wait time from scheduling to start of DMA operations
+static void
+report_wait_times(const xrt_xocl::dma_queue& queue)
+{
+  using lane = xrt_xocl::dma_queue::lane;
+  using ltype = xrt_xocl::dma_queue::ltype;
+  for (ltype l = 0; l < static_cast<ltype>(lane::max); ++l) {
+    auto stats = queue.get_stats(static_cast<lane>(l));
+    if (!stats.tasks)
+      continue;
+    auto fmt = boost::format("DMA queue '%s' %s: %d operations, average wait %.1f us, max wait %.1f us")
+      % queue.id() % xrt_xocl::dma_queue::lane_name(static_cast<lane>(l))
+      % stats.tasks % (stats.total_ns * 1e-3 / stats.tasks) % (stats.max_ns * 1e-3);
+    xrt_core::message::send(xrt_core::message::severity_level::info, "XRT", fmt.str());
+  }
+}
+
 }
 
 namespace xrt_xocl { namespace hal2 {
@@ -74,8 +91,11 @@ device::
     // xsim will not shutdown unless there is a guaranteed call to xclClose
     close();
 
-  for (auto& q : m_queue)
+  for (auto& q : m_dma_queue) {
     q.stop();
+    report_wait_times(q);
+  }
+  m_misc_queue.stop();
   for (auto& t : m_workers)
     t.join();
 }
@@ -167,13 +187,12 @@ setup()
     threads = 2;
 
   XRT_DEBUG(std::cout,"Creating ",2*threads," DMA worker threads\n");
-  for (unsigned int i=0; i<threads; ++i) {
-    // read and write queue workers
-    m_workers.emplace_back(xrt_core::thread(task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::read)]),"read"));
-    m_workers.emplace_back(xrt_core::thread(task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::write)]),"write"));
-  }
+  // read and write queue workers
+  auto core_device = get_core_device();
+  get_dma_queue(hal::queue_type::read).start(threads,"read",core_device.get());
+  get_dma_queue(hal::queue_type::write).start(threads,"write",core_device.get());
   // single misc queue worker
-  m_workers.emplace_back(xrt_core::thread(task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::misc)]),"misc"));
+  m_workers.emplace_back(xrt_core::role_thread(xrt_core::thread_role::dma,core_device.get(),task::worker2,std::ref(m_misc_queue),"misc"));
 }
 
 device::ExecBufferObject*
@@ -375,7 +394,13 @@ device::
 sync(const buffer_object_handle& boh, size_t sz, size_t offset, direction dir1, bool async)
 {
   auto dir = (dir1 == direction::HOST2DEVICE) ? XCL_BO_SYNC_BO_TO_DEVICE : XCL_BO_SYNC_BO_FROM_DEVICE;
-  const_cast<buffer_object_handle&>(boh).sync(dir, sz, offset);
+  auto qt = (dir1 == direction::HOST2DEVICE) ? hal::queue_type::write : hal::queue_type::read;
+  auto& bo = const_cast<buffer_object_handle&>(boh);
+
+  // Large transfers are split over the DMA workers
+  get_dma_queue(qt).split(sz, [&bo, dir, offset](size_t off, size_t len) {
+    bo.sync(dir, len, offset + off);
+  });
   return event(typed_event<int>(0));
 }
 
@@ -623,6 +648,16 @@ pollStream(hal::StreamHandle stream, hal::StreamXferCompletions* comps, int min,
   return m_ops->mPollQueue(m_handle,stream,min,max,req,actual,timeout);
 }
 
+int
+device::
+pollStreamSet(const hal::StreamHandle* streams, int num, hal::StreamXferCompletions* comps, int min, int max, int* actual, int timeout)
+{
+  if (!m_ops->mPollQueueSet)
+    return -ENOSYS;
+  xclReqCompletion* req = reinterpret_cast<xclReqCompletion*>(comps);
+  return m_ops->mPollQueueSet(m_handle,num,streams,min,max,req,actual,timeout);
+}
+
 int
 device::
 setStreamOpt(hal::StreamHandle stream, int type, uint32_t val)
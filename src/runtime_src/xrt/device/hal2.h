@@ -63,9 +63,11 @@ class device : public xrt_xocl::hal::device
 {
   // separate queues for read,write, and misc operations
   // primarily done so that independent operations can be serviced
-  // by a worker simultaneously
+  // by a worker simultaneously.  read and write operations are
+  // scheduled by size and priority, misc operations in FIFO order.
   using qtype = std::underlying_type<hal::queue_type>::type;
-  std::array<task::queue,static_cast<qtype>(hal::queue_type::max)> m_queue;
+  std::array<dma_queue,static_cast<qtype>(hal::queue_type::misc)> m_dma_queue;
+  task::queue m_misc_queue;
   std::vector<std::thread> m_workers;
   svmbomap_type m_svmbomap;
 
@@ -100,10 +102,10 @@ class device : public xrt_xocl::hal::device
   hal2::device_info*
   get_device_info_nolock() const;
 
-  task::queue&
-  get_queue(hal::queue_type qt)
+  dma_queue&
+  get_dma_queue(hal::queue_type qt)
   {
-    return m_queue[static_cast<qtype>(qt)];
+    return m_dma_queue[static_cast<qtype>(qt)];
   }
 
 public:
@@ -126,9 +128,12 @@ public:
    */
   template <typename F,typename ...Args>
   auto
-  addTaskM(F&& f,hal::queue_type qt,Args&&... args) -> decltype(task::createM(m_queue,f,*this,std::forward<Args>(args)...))
+  addTaskM(F&& f,hal::queue_type qt,Args&&... args) -> decltype(task::createM(m_misc_queue,f,*this,std::forward<Args>(args)...))
   {
-    return task::createM(get_queue(qt),f,*this,std::forward<Args>(args)...);
+    if (qt == hal::queue_type::misc)
+      return task::createM(m_misc_queue,f,*this,std::forward<Args>(args)...);
+    dma_queue::scheduler sched{get_dma_queue(qt),{}};
+    return task::createM(sched,f,*this,std::forward<Args>(args)...);
   }
 
 #ifdef __GNUC__
@@ -139,9 +144,12 @@ public:
 #endif
   template <typename F,typename ...Args>
   auto
-  addTaskF(F&& f,hal::queue_type qt,Args&&... args) -> decltype(task::createF(m_queue,f,std::forward<Args>(args)...))
+  addTaskF(F&& f,hal::queue_type qt,Args&&... args) -> decltype(task::createF(m_misc_queue,f,std::forward<Args>(args)...))
   {
-    return task::createF(get_queue(qt),f,std::forward<Args>(args)...);
+    if (qt == hal::queue_type::misc)
+      return task::createF(m_misc_queue,f,std::forward<Args>(args)...);
+    dma_queue::scheduler sched{get_dma_queue(qt),{}};
+    return task::createF(sched,f,std::forward<Args>(args)...);
   }
 #ifdef __GNUC__
 # pragma GCC diagnostic pop
@@ -199,7 +207,13 @@ public:
   virtual task::queue*
   getQueue(hal::queue_type qt)
   {
-    return &m_queue[static_cast<qtype>(qt)];
+    return (qt == hal::queue_type::misc) ? &m_misc_queue : nullptr;
+  }
+
+  virtual dma_queue*
+  getDmaQueue(hal::queue_type qt)
+  {
+    return (qt == hal::queue_type::misc) ? nullptr : &get_dma_queue(qt);
   }
 
   virtual std::string
@@ -334,6 +348,9 @@ public:
   virtual int
   pollStream(hal::StreamHandle stream, hal::StreamXferCompletions* comps, int min, int max, int* actual, int timeout);
 
+  virtual int
+  pollStreamSet(const hal::StreamHandle* streams, int num, hal::StreamXferCompletions* comps, int min, int max, int* actual, int timeout);
+
   virtual int
   setStreamOpt(hal::StreamHandle stream, int type, uint32_t val);
 
@@ -78,6 +78,7 @@ operations(const std::string &fileName, void *fileHandle, unsigned int count)
   ,mReadQueue(0)
   ,mPollQueues(0)
   ,mPollQueue(0)
+  ,mPollQueueSet(0)
   ,mSetQueueOpt(0)
   ,mGetDebugIpLayout(0)
   ,mGetNumLiveProcesses(0)
@@ -127,6 +128,7 @@ operations(const std::string &fileName, void *fileHandle, unsigned int count)
   mReadQueue = (readQueueFuncType)xrt_core::dlsym(const_cast<void *>(mDriverHandle), "xclReadQueue");
   mPollQueues = (pollQueuesFuncType)xrt_core::dlsym(const_cast<void *>(mDriverHandle), "xclPollCompletion");
   mPollQueue = (pollQueueFuncType)xrt_core::dlsym(const_cast<void *>(mDriverHandle), "xclPollQueue");
+  mPollQueueSet = (pollQueueSetFuncType)xrt_core::dlsym(const_cast<void *>(mDriverHandle), "xclPollQueueSet");
   mSetQueueOpt = (setQueueOptFuncType)xrt_core::dlsym(const_cast<void *>(mDriverHandle), "xclSetQueueOpt");
 
   // Profiling Functions
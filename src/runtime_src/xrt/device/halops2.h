@@ -132,6 +132,7 @@ private:
   typedef int     (*setQueueOptFuncType)(xclDeviceHandle handle,uint64_t q_hdl, int type, uint32_t val);
   typedef int     (*pollQueueFuncType)(xclDeviceHandle handle,uint64_t q_hdl, int min, int max, xclReqCompletion* completions, int* actual, int timeout);
   typedef int     (*pollQueuesFuncType)(xclDeviceHandle handle,int min, int max, xclReqCompletion* completions, int* actual, int timeout);
+  typedef int     (*pollQueueSetFuncType)(xclDeviceHandle handle,int num_queues, const uint64_t* q_hdls, int min, int max, xclReqCompletion* completions, int* actual, int timeout);
 //End Streaming
 
   typedef void (*getDebugIpLayoutType)(xclDeviceHandle hdl, char* buffer, size_t size, size_t* size_ret);
@@ -213,6 +214,7 @@ public:
   readQueueFuncType mReadQueue;
   pollQueuesFuncType mPollQueues;
   pollQueueFuncType mPollQueue;
+  pollQueueSetFuncType mPollQueueSet;
   setQueueOptFuncType mSetQueueOpt;
 //End Streaming
 
@@ -77,6 +77,7 @@ operations(const std::string &fileName, void *fileHandle, unsigned int count)
   ,mReadQueue(0)
   ,mPollQueues(0)
   ,mPollQueue(0)
+  ,mPollQueueSet(0)
   ,mSetQueueOpt(0)
   ,mGetDebugIpLayout(0)
   ,mGetNumLiveProcesses(0)
@@ -130,6 +131,7 @@ operations(const std::string &fileName, void *fileHandle, unsigned int count)
   mReadQueue = &xclReadQueue;
   mPollQueues = &xclPollCompletion;
   mPollQueue = &xclPollQueue;
+  mPollQueueSet = &xclPollQueueSet;
   mSetQueueOpt = &xclSetQueueOpt;
 
 #if 0
@@ -0,0 +1,198 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of xrt/device/dma_queue.h
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "xrt/device/dma_queue.h"
+#include "xrt/util/config_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE ( test_dma_queue )
+
+namespace {
+
+using hint = xrt_xocl::dma_queue::hint;
+
+// Holds the single worker of a queue until released, so that tasks
+// can be queued up before any is picked
+struct gate
+{
+  std::promise<void> entered;
+  std::promise<void> release;
+
+  void
+  close(xrt_xocl::dma_queue& queue)
+  {
+    xrt_xocl::dma_queue::scheduler sched{queue, hint{}};
+    auto f = release.get_future().share();
+    xrt_xocl::task::createF(sched, [this, f] { entered.set_value(); f.wait(); });
+    entered.get_future().wait();
+  }
+
+  void
+  open()
+  {
+    release.set_value();
+  }
+};
+
+struct order
+{
+  std::mutex mutex;
+  std::vector<int> ids;
+
+  void
+  add(int id)
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    ids.push_back(id);
+  }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( test_dma_queue_order )
+{
+  auto small = xrt_xocl::config::get_dma_small_size();
+
+  xrt_xocl::dma_queue queue;
+  queue.start(1, "test");
+  gate g;
+  g.close(queue);
+
+  order o;
+  std::vector<xrt_xocl::task::event<void>> events;
+  auto add = [&](int id, const hint& h) {
+    xrt_xocl::dma_queue::scheduler sched{queue, h};
+    events.push_back(xrt_xocl::task::createF(sched, [&o, id] { o.add(id); }));
+  };
+
+  add(0, hint(small * 1024));     // normal bulk
+  add(1, hint(small));            // normal small
+  add(2, hint(small * 1024, -1)); // low bulk
+  add(3, hint(0, 1));             // high, unknown size is bulk
+  add(4, hint(1, 1));             // high small
+  add(5, hint(small + 1));        // normal bulk
+
+  g.open();
+  for (auto& ev : events)
+    ev.wait();
+
+  using lane = xrt_xocl::dma_queue::lane;
+  if (xrt_xocl::config::get_dma_scheduler()) {
+    std::vector<int> expected = {4, 3, 1, 0, 5, 2};
+    BOOST_CHECK(o.ids == expected);
+    BOOST_CHECK_EQUAL(queue.get_stats(lane::high_small).tasks, 1);
+  }
+  else {
+    std::vector<int> expected = {0, 1, 2, 3, 4, 5};
+    BOOST_CHECK(o.ids == expected);
+    BOOST_CHECK_EQUAL(queue.get_stats(lane::normal_bulk).tasks, 7);
+  }
+  queue.stop();
+}
+
+BOOST_AUTO_TEST_CASE( test_dma_queue_aging )
+{
+  if (!xrt_xocl::config::get_dma_scheduler())
+    return;
+
+  xrt_xocl::dma_queue queue;
+  queue.start(1, "test");
+  gate g;
+  g.close(queue);
+
+  order o;
+  std::vector<xrt_xocl::task::event<void>> events;
+  auto add = [&](int id, const hint& h) {
+    xrt_xocl::dma_queue::scheduler sched{queue, h};
+    events.push_back(xrt_xocl::task::createF(sched, [&o, id] { o.add(id); }));
+  };
+
+  // Low priority bulk transfer waits past the aging limit
+  add(0, hint(0, -1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  add(1, hint(1, 1));
+
+  g.open();
+  for (auto& ev : events)
+    ev.wait();
+
+  std::vector<int> expected = {0, 1};
+  BOOST_CHECK(o.ids == expected);
+  queue.stop();
+}
+
+BOOST_AUTO_TEST_CASE( test_dma_queue_split )
+{
+  auto chunk = xrt_xocl::config::get_dma_chunk_size();
+  if (!chunk)
+    return;
+
+  xrt_xocl::dma_queue queue;
+  queue.start(4, "test");
+
+  // Every byte covered exactly once, from more than one thread when
+  // the scheduler is enabled
+  size_t size = chunk * 16 + 3;
+  std::vector<std::atomic<int>> covered(size / chunk + 1);
+  std::mutex mutex;
+  std::vector<std::thread::id> threads;
+  std::atomic<size_t> bytes {0};
+  queue.split(size, [&](size_t offset, size_t sz) {
+    BOOST_CHECK(sz <= chunk || !xrt_xocl::config::get_dma_scheduler());
+    for (auto off = offset; off < offset + sz; off += chunk)
+      ++covered[off / chunk];
+    bytes += sz;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lk(mutex);
+    threads.push_back(std::this_thread::get_id());
+  });
+  BOOST_CHECK_EQUAL(bytes, size);
+  for (auto& c : covered)
+    BOOST_CHECK_EQUAL(c, 1);
+  if (xrt_xocl::config::get_dma_scheduler()) {
+    std::sort(threads.begin(), threads.end());
+    BOOST_CHECK(std::unique(threads.begin(), threads.end()) - threads.begin() > 1);
+  }
+
+  // First exception is rethrown
+  bool exception = false;
+  try {
+    queue.split(size, [](size_t offset, size_t) {
+      if (offset)
+        throw std::runtime_error("chunk failed");
+    });
+  }
+  catch (const std::exception&) {
+    exception = true;
+  }
+  BOOST_CHECK_EQUAL(exception, xrt_xocl::config::get_dma_scheduler());
+
+  queue.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
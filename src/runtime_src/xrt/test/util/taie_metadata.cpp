@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of the parsed AIE metadata in core/edge/common/aie_parser.h
+// using synthetic metadata.  Also compares the latency of opening a
+// graph when the metadata is parsed per lookup with lookups in the
+// parsed metadata, for a large synthetic metadata file.
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "core/edge/common/aie_parser.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE ( test_aie_metadata )
+
+namespace {
+
+using metadata_type = xrt_core::edge::aie::metadata;
+
+static std::string
+make_array(size_t count, size_t value)
+{
+  std::string array = "[";
+  for (size_t i = 0; i < count; ++i)
+    array += (i ? ",\"" : "\"") + std::to_string(value + i) + "\"";
+  return array + "]";
+}
+
+// Synthetic metadata with graphs of tiles, rtps per graph, and gmios
+static std::string
+make_metadata(size_t graphs, size_t tiles, size_t rtps, size_t gmios, bool with_gmios = true)
+{
+  std::stringstream json;
+  json << "{\"aie_metadata\": {";
+  json << "\"driver_config\": {\"hw_gen\": \"1\", \"base_address\": \"536870912\", \"column_shift\": \"23\","
+       << " \"row_shift\": \"18\", \"num_columns\": \"50\", \"num_rows\": \"9\", \"shim_row\": \"0\","
+       << " \"reserved_row_start\": \"0\", \"reserved_num_rows\": \"0\", \"aie_tile_row_start\": \"1\","
+       << " \"aie_tile_num_rows\": \"8\"},";
+
+  json << "\"graphs\": {";
+  for (size_t g = 0; g < graphs; ++g) {
+    auto triggers = std::string("[");
+    for (size_t t = 0; t < tiles; ++t)
+      triggers += t ? ",\"false\"" : "\"false\"";
+    triggers += "]";
+    json << (g ? "," : "") << "\"graph" << g << "\": {\"id\": \"" << g << "\", \"name\": \"g" << g << "\","
+         << " \"core_columns\": " << make_array(tiles, 0) << ","
+         << " \"core_rows\": " << make_array(tiles, 1) << ","
+         << " \"iteration_memory_columns\": " << make_array(tiles, 0) << ","
+         << " \"iteration_memory_rows\": " << make_array(tiles, 1) << ","
+         << " \"iteration_memory_addresses\": " << make_array(tiles, 4096) << ","
+         << " \"multirate_triggers\": " << triggers << "}";
+  }
+  json << "},";
+
+  json << "\"RTPs\": {";
+  for (size_t g = 0; g < graphs; ++g) {
+    for (size_t r = 0; r < rtps; ++r) {
+      json << ((g || r) ? "," : "") << "\"rtp" << g << "_" << r << "\": {"
+           << "\"port_id\": \"" << r << "\", \"alias_id\": \"" << r << "\","
+           << " \"port_name\": \"g" << g << ".port" << r << "\", \"alias_name\": \"g" << g << ".alias" << r << "\","
+           << " \"graph_id\": \"" << g << "\", \"number_of_bytes\": \"4\","
+           << " \"selector_row\": \"1\", \"selector_column\": \"2\", \"selector_lock_id\": \"3\", \"selector_address\": \"4\","
+           << " \"ping_buffer_row\": \"1\", \"ping_buffer_column\": \"2\", \"ping_buffer_lock_id\": \"3\", \"ping_buffer_address\": \"4\","
+           << " \"pong_buffer_row\": \"1\", \"pong_buffer_column\": \"2\", \"pong_buffer_lock_id\": \"3\", \"pong_buffer_address\": \"4\","
+           << " \"is_PL_RTP\": \"false\", \"is_input\": \"true\", \"is_asynchronous\": \"false\","
+           << " \"is_connected\": \"false\", \"requires_lock\": \"true\"}";
+    }
+  }
+  json << "}";
+
+  if (with_gmios) {
+    json << ", \"GMIOs\": {";
+    for (size_t i = 0; i < gmios; ++i)
+      json << (i ? "," : "") << "\"gmio" << i << "\": {\"id\": \"" << i << "\", \"name\": \"gmio" << i << "\","
+           << " \"logical_name\": \"in" << i << "\", \"type\": \"" << (i % 2) << "\", \"shim_column\": \"" << i << "\","
+           << " \"channel_number\": \"0\", \"stream_id\": \"" << i << "\", \"burst_length_in_16byte\": \"4\"}";
+    json << "}";
+  }
+
+  json << "}}";
+  return json.str();
+}
+
+// Lookups done when a graph is opened
+static size_t
+open_graph(const metadata_type& meta, const std::string& name)
+{
+  auto graph = meta.get_graph(name);
+  if (!graph)
+    throw std::runtime_error("graph not found: " + name);
+  auto config = *graph;
+  auto rtps = meta.get_rtps(config.id);
+  return config.coreColumns.size() + rtps.size();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( test_lookup )
+{
+  auto json = make_metadata(4, 8, 3, 6);
+  metadata_type meta(json.data(), json.size());
+
+  BOOST_CHECK_EQUAL(meta.get_driver_config().num_columns, 50);
+
+  auto graph = meta.get_graph("g2");
+  BOOST_REQUIRE(graph);
+  BOOST_CHECK_EQUAL(graph->id, 2);
+  BOOST_CHECK_EQUAL(graph->coreColumns.size(), 8);
+  BOOST_CHECK_EQUAL(graph->iterMemAddrs[1], 4097);
+  BOOST_CHECK(meta.get_graph("nosuchgraph") == nullptr);
+
+  auto& rtps = meta.get_rtps(2);
+  BOOST_CHECK_EQUAL(rtps.size(), 3);
+  BOOST_CHECK(rtps.find("g2.port1") != rtps.end());
+  BOOST_CHECK_EQUAL(rtps.at("g2.port1").graphId, 2);
+  BOOST_CHECK(meta.get_rtps(42).empty());
+
+  BOOST_CHECK_EQUAL(meta.get_gmios().size(), 6);
+  BOOST_CHECK_EQUAL(meta.get_old_gmios().size(), 6);
+
+  // Optional sections
+  BOOST_CHECK(meta.get_plios().empty());
+  BOOST_CHECK(meta.get_profile_counters().empty());
+  BOOST_CHECK(meta.get_trace_gmios().empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_table_error )
+{
+  // GMIOs are required, error is thrown when accessed but graphs are
+  // still usable
+  auto json = make_metadata(2, 4, 1, 0, false);
+  metadata_type meta(json.data(), json.size());
+  BOOST_CHECK_THROW(meta.get_gmios(), std::exception);
+  BOOST_CHECK_THROW(meta.get_old_gmios(), std::exception);
+  BOOST_CHECK(meta.get_graph("g1"));
+
+  std::string bad = "{\"aie_metadata\": ";
+  BOOST_CHECK_THROW(metadata_type(bad.data(), bad.size()), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( test_graph_error )
+{
+  // Graphs are converted on lookup, a malformed graph throws only
+  // when it is looked up
+  auto json = make_metadata(3, 4, 1, 2);
+  auto pos = json.find("\"core_rows\"", json.find("\"name\": \"g1\""));
+  BOOST_REQUIRE(pos != std::string::npos);
+  json.replace(pos, 11, "\"core_rowz\"");
+  metadata_type meta(json.data(), json.size());
+  BOOST_CHECK_THROW(meta.get_graph("g1"), std::exception);
+  BOOST_CHECK(meta.get_graph("g0"));
+  BOOST_CHECK(meta.get_graph("g2"));
+  BOOST_CHECK_EQUAL(meta.get_graph("g2"), meta.get_graph("g2"));
+}
+
+BOOST_AUTO_TEST_CASE( test_open_latency )
+{
+  // Large design, 64 graphs of 64 tiles with 32 rtps each
+  const size_t graphs = 64;
+  auto json = make_metadata(graphs, 64, 32, 64);
+  std::cout << "metadata size: " << json.size() << " bytes\n";
+
+  // Parse per open, the metadata was previously parsed three times
+  // for each graph opened
+  const size_t parse_opens = 8;
+  size_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < parse_opens; ++i) {
+    for (int parse = 0; parse < 3; ++parse) {
+      metadata_type meta(json.data(), json.size());
+      if (parse == 2)
+        sum += open_graph(meta, "g" + std::to_string(i % graphs));
+    }
+  }
+  auto parse_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / parse_opens;
+
+  // Parse once, then lookup per open
+  const size_t lookup_opens = 10000;
+  start = std::chrono::steady_clock::now();
+  metadata_type meta(json.data(), json.size());
+  auto once_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < lookup_opens; ++i)
+    sum += open_graph(meta, "g" + std::to_string(i % graphs));
+  auto lookup_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / lookup_opens;
+
+  std::cout << "graph open, parse per lookup: " << parse_us << " us\n";
+  std::cout << "graph open, parsed metadata: " << lookup_us << " us (parsed once in " << once_us << " us)\n";
+
+  BOOST_CHECK(sum > 0);
+  BOOST_CHECK(lookup_us < parse_us);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
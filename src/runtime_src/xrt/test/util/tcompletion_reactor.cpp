@@ -0,0 +1,388 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of core/common/completion_reactor.h using eventfd
+// backed fake device descriptors.  Also compares a thread per
+// descriptor with the reactor as the number of descriptors grows.
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/completion_reactor.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+BOOST_AUTO_TEST_SUITE ( test_completion_reactor )
+
+namespace {
+
+using reactor_type = xrt_core::completion_reactor;
+
+// Fake device, an interrupt is a write to the eventfd and the
+// handler acknowledges by reading it
+struct fake_device
+{
+  int fd;
+  std::atomic<uint64_t> interrupts {0};
+
+  fake_device()
+    : fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+  {}
+
+  ~fake_device()
+  {
+    close(fd);
+  }
+
+  void
+  interrupt()
+  {
+    uint64_t one = 1;
+    if (write(fd, &one, sizeof(one)) != sizeof(one))
+      throw std::runtime_error("eventfd write failed");
+  }
+
+  void
+  acknowledge()
+  {
+    uint64_t value = 0;
+    if (read(fd, &value, sizeof(value)) == sizeof(value))
+      interrupts += value;
+  }
+};
+
+using device_list = std::vector<std::unique_ptr<fake_device>>;
+
+static device_list
+make_devices(size_t count)
+{
+  device_list devices;
+  for (size_t i = 0; i < count; ++i)
+    devices.emplace_back(std::make_unique<fake_device>());
+  return devices;
+}
+
+static uint64_t
+total_interrupts(const device_list& devices)
+{
+  uint64_t total = 0;
+  for (auto& dev : devices)
+    total += dev->interrupts;
+  return total;
+}
+
+static bool
+wait_for(const device_list& devices, uint64_t total)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (total_interrupts(devices) < total) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+// Interrupt all devices and wait for all to be acknowledged, repeat
+// for rounds, return usec per round
+static double
+run_rounds(const device_list& devices, size_t rounds)
+{
+  auto base = total_interrupts(devices);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 1; r <= rounds; ++r) {
+    for (auto& dev : devices)
+      dev->interrupt();
+    if (!wait_for(devices, base + r * devices.size()))
+      throw std::runtime_error("interrupts not acknowledged");
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+}
+
+// Baseline, one thread blocked in poll per device
+struct thread_per_device
+{
+  std::atomic<bool> stop {false};
+  std::atomic<uint64_t> wakeups {0};
+  std::vector<std::thread> threads;
+
+  explicit
+  thread_per_device(const device_list& devices)
+  {
+    for (auto& dev : devices) {
+      auto device = dev.get();
+      threads.emplace_back([this, device] {
+        pollfd pfd = {device->fd, POLLIN, 0};
+        while (!stop) {
+          if (poll(&pfd, 1, 10) > 0) {
+            ++wakeups;
+            device->acknowledge();
+          }
+        }
+      });
+    }
+  }
+
+  ~thread_per_device()
+  {
+    stop = true;
+    for (auto& t : threads)
+      t.join();
+  }
+};
+
+static std::vector<reactor_type::handle_type>
+add_devices(reactor_type& reactor, const device_list& devices)
+{
+  std::vector<reactor_type::handle_type> handles;
+  for (auto& dev : devices) {
+    auto device = dev.get();
+    handles.push_back(reactor.add(device->fd, [device] { device->acknowledge(); }));
+  }
+  return handles;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( test_dispatch )
+{
+  auto devices = make_devices(4);
+  reactor_type reactor({});
+  auto handles = add_devices(reactor, devices);
+
+  BOOST_CHECK_EQUAL(run_rounds(devices, 10) > 0, true);
+  BOOST_CHECK_EQUAL(total_interrupts(devices), 40);
+
+  // No handler is called after remove
+  reactor.remove(handles[0]);
+  devices[0]->interrupt();
+  devices[1]->interrupt();
+  BOOST_CHECK(wait_for(devices, 41));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(devices[0]->interrupts, 10);
+  BOOST_CHECK_EQUAL(devices[1]->interrupts, 11);
+}
+
+BOOST_AUTO_TEST_CASE( test_consume_one )
+{
+  // Handler consumes one completion per call like xocl poll, the
+  // descriptor stays ready until all are consumed
+  int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC | EFD_SEMAPHORE);
+  std::atomic<uint64_t> consumed {0};
+  reactor_type reactor({});
+  auto handle = reactor.add(fd, [fd, &consumed] {
+    uint64_t value = 0;
+    if (read(fd, &value, sizeof(value)) == sizeof(value))
+      ++consumed;
+  });
+
+  uint64_t three = 3;
+  BOOST_CHECK_EQUAL(write(fd, &three, sizeof(three)), sizeof(three));
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (consumed < 3 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::yield();
+  BOOST_CHECK_EQUAL(consumed, 3);
+
+  reactor.remove(handle);
+  close(fd);
+}
+
+BOOST_AUTO_TEST_CASE( test_coalesce_count )
+{
+  // Long coalesce time, wake up is by count
+  auto devices = make_devices(4);
+  reactor_type::options opt;
+  opt.coalesce_count = 4;
+  opt.coalesce_us = 5000000;
+  reactor_type reactor(opt);
+  add_devices(reactor, devices);
+
+  for (auto& dev : devices)
+    dev->interrupt();
+  BOOST_CHECK(wait_for(devices, 4));
+  BOOST_CHECK_EQUAL(reactor.get_wakeup_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_coalesce_time )
+{
+  // Count never reached, wake up is by time
+  auto devices = make_devices(2);
+  reactor_type::options opt;
+  opt.coalesce_count = 4;
+  opt.coalesce_us = 2000;
+  reactor_type reactor(opt);
+  add_devices(reactor, devices);
+
+  auto start = std::chrono::steady_clock::now();
+  devices[0]->interrupt();
+  BOOST_CHECK(wait_for(devices, 1));
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  BOOST_CHECK(elapsed >= std::chrono::microseconds(2000));
+  BOOST_CHECK_EQUAL(reactor.get_wakeup_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_coalesce_single )
+{
+  // A single descriptor is reported once per wake up, so the count
+  // can never be reached and it is not coalesced
+  auto devices = make_devices(1);
+  reactor_type::options opt;
+  opt.coalesce_count = 4;
+  opt.coalesce_us = 5000000;
+  reactor_type reactor(opt);
+  add_devices(reactor, devices);
+
+  auto start = std::chrono::steady_clock::now();
+  devices[0]->interrupt();
+  BOOST_CHECK(wait_for(devices, 1));
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  BOOST_CHECK(elapsed < std::chrono::seconds(1));
+}
+
+BOOST_AUTO_TEST_CASE( test_remove_waits_for_handler )
+{
+  // Handlers run without the reactor lock, remove from another
+  // thread waits for a running handler
+  auto device = std::make_unique<fake_device>();
+  std::atomic<bool> running {false};
+  std::atomic<bool> done {false};
+  reactor_type reactor({});
+  auto handle = reactor.add(device->fd, [&] {
+    device->acknowledge();
+    running = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    done = true;
+  });
+
+  device->interrupt();
+  while (!running)
+    std::this_thread::yield();
+  reactor.remove(handle);
+  BOOST_CHECK(done);
+}
+
+BOOST_AUTO_TEST_CASE( test_add_remove_in_handler )
+{
+  // A handler removes itself and adds another descriptor
+  auto devices = make_devices(2);
+  auto first = devices[0].get();
+  auto second = devices[1].get();
+  reactor_type reactor({});
+  reactor_type::handle_type handle = 0;
+  std::atomic<bool> added {false};
+  handle = reactor.add(first->fd, [&] {
+    first->acknowledge();
+    reactor.remove(handle);
+    reactor.add(second->fd, [second] { second->acknowledge(); });
+    added = true;
+  });
+
+  first->interrupt();
+  BOOST_CHECK(wait_for(devices, 1));
+  while (!added)
+    std::this_thread::yield();
+  second->interrupt();
+  first->interrupt();
+  BOOST_CHECK(wait_for(devices, 2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(first->interrupts, 1);
+  BOOST_CHECK_EQUAL(second->interrupts, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_closed_descriptor )
+{
+  // A descriptor closed without remove after it became ready fails
+  // to re-arm and is dropped, the other descriptors are unaffected
+  int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  std::atomic<uint64_t> closed_calls {0};
+  auto devices = make_devices(1);
+  reactor_type::options opt;
+  opt.coalesce_count = 2;
+  opt.coalesce_us = 5000000;
+  reactor_type reactor(opt);
+  reactor.add(fd, [&closed_calls] { ++closed_calls; });
+  add_devices(reactor, devices);
+
+  // The reactor waits for the second descriptor while fd is closed
+  uint64_t one = 1;
+  BOOST_CHECK_EQUAL(write(fd, &one, sizeof(one)), sizeof(one));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  close(fd);
+  devices[0]->interrupt();
+  BOOST_CHECK(wait_for(devices, 1));
+
+  // Reactor is still alive, one descriptor is left so no coalescing
+  devices[0]->interrupt();
+  BOOST_CHECK(wait_for(devices, 2));
+  BOOST_CHECK_EQUAL(closed_calls, 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_scalability )
+{
+  const size_t rounds = 200;
+  std::cout << "devices  threads(us/round, wakeups)  reactor(us/round, wakeups)  coalesced(us/round, wakeups)\n";
+  for (size_t count : {1, 4, 16}) {
+    auto devices = make_devices(count);
+
+    double thread_us = 0;
+    uint64_t thread_wakeups = 0;
+    {
+      thread_per_device threads(devices);
+      thread_us = run_rounds(devices, rounds);
+      thread_wakeups = threads.wakeups;
+    }
+
+    double reactor_us = 0;
+    uint64_t reactor_wakeups = 0;
+    {
+      reactor_type reactor({});
+      add_devices(reactor, devices);
+      reactor_us = run_rounds(devices, rounds);
+      reactor_wakeups = reactor.get_wakeup_count();
+    }
+
+    double coalesced_us = 0;
+    uint64_t coalesced_wakeups = 0;
+    {
+      reactor_type::options opt;
+      opt.coalesce_count = static_cast<unsigned int>(count);
+      opt.coalesce_us = 100;
+      reactor_type reactor(opt);
+      add_devices(reactor, devices);
+      coalesced_us = run_rounds(devices, rounds);
+      coalesced_wakeups = reactor.get_wakeup_count();
+    }
+
+    std::cout << count << "  " << thread_us << " " << thread_wakeups
+              << "  " << reactor_us << " " << reactor_wakeups
+              << "  " << coalesced_us << " " << coalesced_wakeups << "\n";
+
+    BOOST_CHECK_EQUAL(total_interrupts(devices), 3 * rounds * count);
+    BOOST_CHECK(coalesced_wakeups <= reactor_wakeups);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
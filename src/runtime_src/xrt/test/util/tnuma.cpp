@@ -0,0 +1,149 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of NUMA topology discovery in core/common/numa.h
+// against a fake sysfs tree
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/numa.h"
+
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE ( test_numa )
+
+namespace {
+
+namespace bfs = boost::filesystem;
+
+// Two nodes with four cpus each and three PCI devices:
+//  0000:65:00.1 reports numa_node 1
+//  0000:17:00.1 reports numa_node -1 but its local cpus are on node 0
+//  0000:b3:00.1 reports nothing
+struct fake_sysfs
+{
+  bfs::path root;
+
+  static void
+  write(const bfs::path& path, const std::string& value)
+  {
+    bfs::create_directories(path.parent_path());
+    std::ofstream ofs(path.string());
+    ofs << value << "\n";
+  }
+
+  fake_sysfs()
+    : root(bfs::temp_directory_path() / bfs::unique_path("xrt-numa-%%%%-%%%%"))
+  {
+    write(root / "devices/system/node/node0/cpulist", "0-3");
+    write(root / "devices/system/node/node1/cpulist", "4-7");
+    write(root / "devices/system/node/possible", "0-1");
+    write(root / "bus/pci/devices/0000:65:00.1/numa_node", "1");
+    write(root / "bus/pci/devices/0000:65:00.1/local_cpulist", "0-3");
+    write(root / "bus/pci/devices/0000:17:00.1/numa_node", "-1");
+    write(root / "bus/pci/devices/0000:17:00.1/local_cpulist", "0-3");
+    bfs::create_directories(root / "bus/pci/devices/0000:b3:00.1");
+  }
+
+  ~fake_sysfs()
+  {
+    boost::system::error_code ec;
+    bfs::remove_all(root, ec);
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( test_parse_cpulist )
+{
+  using cpus = std::vector<unsigned int>;
+  BOOST_CHECK(xrt_core::numa::parse_cpulist("0-3,8") == (cpus{0,1,2,3,8}));
+  BOOST_CHECK(xrt_core::numa::parse_cpulist("{4,5,2}") == (cpus{4,5,2}));
+  BOOST_CHECK(xrt_core::numa::parse_cpulist("").empty());
+  BOOST_CHECK_THROW(xrt_core::numa::parse_cpulist("3-1"), std::exception);
+  BOOST_CHECK_THROW(xrt_core::numa::parse_cpulist("a"), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( test_topology )
+{
+  fake_sysfs sysfs;
+  xrt_core::numa::topology topo(sysfs.root.string());
+
+  BOOST_CHECK_EQUAL(topo.num_nodes(), 2);
+  BOOST_CHECK_EQUAL(topo.get_cpu_node(2), 0);
+  BOOST_CHECK_EQUAL(topo.get_cpu_node(7), 1);
+  BOOST_CHECK_EQUAL(topo.get_cpu_node(8), -1);
+  BOOST_CHECK_EQUAL(topo.get_node_cpus(1).size(), 4);
+  BOOST_CHECK(topo.get_node_cpus(2).empty());
+
+  BOOST_CHECK_EQUAL(topo.get_cpulist_node("4,6"), 1);
+  BOOST_CHECK_EQUAL(topo.get_cpulist_node("3-4"), -1);   // spans nodes
+  BOOST_CHECK_EQUAL(topo.get_cpulist_node("8"), -1);     // unknown cpu
+  BOOST_CHECK_EQUAL(topo.get_cpulist_node("bad"), -1);
+}
+
+BOOST_AUTO_TEST_CASE( test_pci_node )
+{
+  fake_sysfs sysfs;
+  xrt_core::numa::topology topo(sysfs.root.string());
+
+  // numa_node wins over local_cpulist
+  BOOST_CHECK_EQUAL(topo.get_pci_node("0000:65:00.1"), 1);
+  // firmware did not report node, fall back on local cpus
+  BOOST_CHECK_EQUAL(topo.get_pci_node("0000:17:00.1"), 0);
+  BOOST_CHECK_EQUAL(topo.get_pci_node("0000:b3:00.1"), -1);
+  BOOST_CHECK_EQUAL(topo.get_pci_node("0000:00:00.0"), -1);
+}
+
+BOOST_AUTO_TEST_CASE( test_no_sysfs )
+{
+  xrt_core::numa::topology topo("/nonexistent");
+  BOOST_CHECK_EQUAL(topo.num_nodes(), 0);
+  BOOST_CHECK_EQUAL(topo.get_cpu_node(0), -1);
+  BOOST_CHECK_EQUAL(topo.get_pci_node("0000:65:00.1"), -1);
+}
+
+BOOST_AUTO_TEST_CASE( test_bind )
+{
+  std::vector<char> buf(4096);
+  // unknown node is never applied
+  BOOST_CHECK(!xrt_core::numa::bind(buf.data(), buf.size(), -1));
+  BOOST_CHECK(!xrt_core::numa::bind(nullptr, buf.size(), 0));
+
+  // partial pages are never applied
+  auto page = static_cast<size_t>(getpagesize());
+  auto ptr = static_cast<char*>(aligned_alloc(page, 2 * page));
+  BOOST_CHECK(!xrt_core::numa::bind(ptr + 8, page, 0));
+  BOOST_CHECK(!xrt_core::numa::bind(ptr, page + 8, 0));
+  free(ptr);
+}
+
+BOOST_AUTO_TEST_CASE( test_page_roundup )
+{
+  auto page = static_cast<size_t>(getpagesize());
+  BOOST_CHECK_EQUAL(xrt_core::numa::page_roundup(0), 0);
+  BOOST_CHECK_EQUAL(xrt_core::numa::page_roundup(1), page);
+  BOOST_CHECK_EQUAL(xrt_core::numa::page_roundup(page), page);
+  BOOST_CHECK_EQUAL(xrt_core::numa::page_roundup(page + 1), 2 * page);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
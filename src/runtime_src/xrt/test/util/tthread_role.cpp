@@ -0,0 +1,134 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of thread roles in core/common/thread.h
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/thread.h"
+#include "core/common/config_reader.h"
+
+#include <future>
+#include <iostream>
+
+#include <pthread.h>
+#include <sched.h>
+
+BOOST_AUTO_TEST_SUITE ( test_thread_role )
+
+namespace {
+
+using thread_role = xrt_core::thread_role;
+
+struct placement
+{
+  cpu_set_t cpus;
+  int policy = -1;
+};
+
+// Read the ini once before any role is used, values are cached
+static void
+init()
+{
+  static bool done = false;
+  if (done)
+    return;
+  std::string ini(__FILE__);
+  ini += ".ini";
+  xrt_core::config::detail::debug(std::cout,ini);
+  done = true;
+}
+
+// Placement observed by a thread of role after its role is set
+static placement
+run_role(thread_role role, const std::string& local_cpus)
+{
+  init();
+  std::promise<void> ready;
+  auto f = ready.get_future().share();
+  placement p;
+  std::thread t([f, &p] {
+    f.wait();
+    CPU_ZERO(&p.cpus);
+    sched_getaffinity(0, sizeof(cpu_set_t), &p.cpus);
+    sched_param sch;
+    pthread_getschedparam(pthread_self(), &p.policy, &sch);
+  });
+  xrt_core::detail::set_thread_role(t, role, local_cpus);
+  ready.set_value();
+  t.join();
+  return p;
+}
+
+static bool
+only_cpu0(const cpu_set_t& cpus)
+{
+  return CPU_COUNT(&cpus) == 1 && CPU_ISSET(0, &cpus);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_role_configured_affinity )
+{
+  // cpu_affinity_completion is used, local cpus are ignored
+  auto p = run_role(thread_role::completion, "");
+  BOOST_CHECK(only_cpu0(p.cpus));
+}
+
+BOOST_AUTO_TEST_CASE( test_role_numa_default )
+{
+  if (!xrt_core::config::get_numa_affinity())
+    return;
+
+  // dma threads are placed on the local cpus of the device
+  auto p = run_role(thread_role::dma, "0");
+  BOOST_CHECK(only_cpu0(p.cpus));
+}
+
+BOOST_AUTO_TEST_CASE( test_role_no_numa_default )
+{
+  // profile threads are not placed on the local cpus
+  cpu_set_t process;
+  CPU_ZERO(&process);
+  sched_getaffinity(0, sizeof(cpu_set_t), &process);
+  auto p = run_role(thread_role::profile, "0");
+  BOOST_CHECK(CPU_EQUAL(&p.cpus, &process));
+}
+
+BOOST_AUTO_TEST_CASE( test_role_policy )
+{
+  auto p = run_role(thread_role::xma, "");
+  BOOST_CHECK_EQUAL(p.policy, SCHED_OTHER);
+}
+
+BOOST_AUTO_TEST_CASE( test_role_thread )
+{
+  init();
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  auto t = xrt_core::role_thread(thread_role::completion, nullptr, [&cpus] {
+    // affinity is set after construction, wait for it
+    for (int i = 0; i < 1000 && !only_cpu0(cpus); ++i) {
+      sched_getaffinity(0, sizeof(cpu_set_t), &cpus);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  t.join();
+  BOOST_CHECK(only_cpu0(cpus));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
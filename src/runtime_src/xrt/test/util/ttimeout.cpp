@@ -0,0 +1,158 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+////////////////////////////////////////////////////////////////
+// Unit testing of core/common/api/timeout.h, in particular timers
+// that are destructed, canceled, or re-armed from callbacks.
+////////////////////////////////////////////////////////////////
+#include <boost/test/unit_test.hpp>
+
+#include "core/common/api/timeout.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE ( test_timeout )
+
+namespace {
+
+namespace timeout = xrt_core::timeout;
+using namespace std::chrono_literals;
+
+// Count of fired callbacks that can be waited on
+struct counter
+{
+  std::mutex mutex;
+  std::condition_variable cv;
+  int count = 0;
+
+  void
+  inc()
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    ++count;
+    cv.notify_all();
+  }
+
+  bool
+  wait(int expected, std::chrono::milliseconds ms = 2000ms)
+  {
+    std::unique_lock<std::mutex> lk(mutex);
+    return cv.wait_for(lk, ms, [this, expected] { return count >= expected; });
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( test_fire )
+{
+  counter c;
+  timeout::timer t([&c] { c.inc(); });
+  timeout::arm(&t, 5ms);
+  BOOST_CHECK(c.wait(1));
+  BOOST_CHECK(!timeout::cancel(&t));
+}
+
+BOOST_AUTO_TEST_CASE( test_cancel )
+{
+  counter c;
+  timeout::timer t([&c] { c.inc(); });
+  timeout::arm(&t, 1000ms);
+  BOOST_CHECK(timeout::cancel(&t));
+  BOOST_CHECK(!c.wait(1, 50ms));
+}
+
+// Callback destructs its own timer, service must not touch it after
+BOOST_AUTO_TEST_CASE( test_destruct_in_callback )
+{
+  const int num = 64;
+  counter c;
+  for (int i = 0; i < num; ++i) {
+    auto t = new timeout::timer;
+    t->set_callback([t, &c] {
+      auto& cnt = c;  // the lambda is destructed with its timer
+      delete t;
+      cnt.inc();
+    });
+    timeout::arm(t, 5ms);
+  }
+  BOOST_CHECK(c.wait(num));
+}
+
+// Callback destructs another timer that expired in the same tick,
+// whose callback then must not be called
+BOOST_AUTO_TEST_CASE( test_destruct_other_in_callback )
+{
+  const int num = 32;
+  counter c;
+  std::atomic<int> fired {0};
+  std::unique_ptr<timeout::timer> timers[num];
+  auto deadline = timeout::clock::now() + 10ms;
+  for (int i = 0; i < num; ++i) {
+    timers[i] = std::make_unique<timeout::timer>();
+    timers[i]->set_callback([i, &timers, &fired, &c] {
+      ++fired;
+      for (int j = 0; j < num; ++j)
+        if (j != i)
+          timers[j].reset();
+      c.inc();
+    });
+  }
+  for (int i = 0; i < num; ++i)
+    timeout::arm(timers[i].get(), deadline);
+
+  BOOST_CHECK(c.wait(1));
+  std::this_thread::sleep_for(20ms);
+  BOOST_CHECK_EQUAL(fired, 1);
+}
+
+// Callback re-arms its timer
+BOOST_AUTO_TEST_CASE( test_rearm_in_callback )
+{
+  counter c;
+  int n = 0;  // touched by callback only
+  timeout::timer t;
+  t.set_callback([&t, &c, &n] {
+    c.inc();
+    if (++n < 3)
+      timeout::arm(&t, 2ms);
+  });
+  timeout::arm(&t, 2ms);
+  BOOST_CHECK(c.wait(3));
+}
+
+// Cancel from another thread waits for running callback
+BOOST_AUTO_TEST_CASE( test_cancel_waits_for_callback )
+{
+  std::atomic<bool> running {false};
+  std::atomic<bool> done {false};
+  timeout::timer t([&running, &done] {
+    running = true;
+    std::this_thread::sleep_for(50ms);
+    done = true;
+  });
+  timeout::arm(&t, 1ms);
+  while (!running)
+    std::this_thread::yield();
+  BOOST_CHECK(!timeout::cancel(&t));
+  BOOST_CHECK(done);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
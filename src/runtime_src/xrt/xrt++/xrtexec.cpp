@@ -319,6 +319,20 @@ add(addr_type addr, value_type value)
   (*m_impl)[++m_impl->ert_pkt->count] = value;
 }
 
+size_t
+exec_write_command::
+add_delta(const value_type* regmap, const value_type* prev, size_t size)
+{
+  size_t count = 0;
+  for (size_t idx = 4; idx < size; ++idx) {
+    if (prev && prev[idx] == regmap[idx])
+      continue;
+    add(static_cast<addr_type>(idx << 2), regmap[idx]);
+    ++count;
+  }
+  return count;
+}
+
 void
 exec_write_command::
 clear()
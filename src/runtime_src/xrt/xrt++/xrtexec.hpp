@@ -184,6 +184,25 @@ public:
   void
   add(addr_type addr, value_type value);
 
+  /**
+   * Add {addr,value} pairs for register map words that changed
+   *
+   * @regmap: register map of this launch, index 0 is AP ctrl
+   * @prev: register map of previous launch of same CU, or nullptr
+   * @size: number of words in @regmap and @prev
+   * Return: number of {addr,value} pairs added
+   *
+   * This is the delta encoding of an ERT_START_CU command.  Only
+   * register map words past the 4 control words that differ from
+   * @prev are added.  With nullptr @prev, all words are added.  The
+   * delta is only meaningful if the command targets exactly one CU.
+   * Registers the CU itself writes (output scalars) are not covered
+   * by the delta and must be part of every launch, and @prev must be
+   * nullptr after the CU registers were written with xclRegWrite.
+   */
+  size_t
+  add_delta(const value_type* regmap, const value_type* prev, size_t size);
+
   /**
    * Clear current CUs and {addr,value} pairs if any
    */
@@ -32,6 +32,7 @@
 #include <thread>
 #include <algorithm>
 #include "core/common/config_reader.h"
+#include "core/common/thread.h"
 
 #define XMAAPI_MOD "xmaapi"
 
@@ -422,8 +423,8 @@ int32_t xma_initialize(XmaXclbinParameter *devXclbins, int32_t num_parms)
     g_xma_singleton->cpu_mode = xrt_core::config::get_xma_cpu_mode();
     xma_logmsg(XMA_DEBUG_LOG, XMAAPI_MOD, "XMA CPU Mode is: %d", g_xma_singleton->cpu_mode);
 
-    g_xma_singleton->xma_thread1 = std::thread(xma_thread1);
-    g_xma_singleton->xma_thread2 = std::thread(xma_thread2);
+    g_xma_singleton->xma_thread1 = xrt_core::role_thread(xrt_core::thread_role::xma, nullptr, xma_thread1);
+    g_xma_singleton->xma_thread2 = xrt_core::role_thread(xrt_core::thread_role::xma, nullptr, xma_thread2);
     //Detach threads to let them run independently
     g_xma_singleton->xma_thread1.detach();
     g_xma_singleton->xma_thread2.detach();
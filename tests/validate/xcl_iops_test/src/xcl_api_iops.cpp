@@ -5,6 +5,7 @@
 #include <memory>
 #include <chrono>
 #include <thread>
+#include <algorithm>
 
 #include "cmdlineparser.h"
 
@@ -33,6 +34,7 @@ typedef struct task_args {
     std::string xclbin_fn;
     Clock::time_point start;
     Clock::time_point end;
+    latency_histogram latency;
 } arg_t;
 
 struct krnl_info {
@@ -42,6 +44,10 @@ struct krnl_info {
 };
 
 bool verbose = false;
+/* Open loop mode when rate (commands per second per thread) is set */
+double rate = 0;
+bool poisson = false;
+std::string json_fn;
 barrier barrier;
 struct krnl_info krnl = {"hello", false};
 
@@ -53,6 +59,9 @@ static void usage(char *prog)
             << "    -t       number of threads\n"
             << "    -l       length of queue (send how many commands without waiting)\n"
             << "    -a       total amount of commands per thread\n"
+            << "    -r       open loop, target commands per second per thread\n"
+            << "    -p       open loop arrivals, constant or poisson\n"
+            << "    -o       write machine readable result to file, open loop only\n"
             << "    -v       verbose result\n"
             << std::endl;
 }
@@ -112,6 +121,80 @@ double runTest(xclDeviceHandle handle, std::vector<std::shared_ptr<task_info>>&
     return (std::chrono::duration_cast<ms_t>(arg.end - arg.start)).count();
 }
 
+/* Issue commands at their intended arrival times rather than when a
+ * previous command completes.  Latency is measured from the intended
+ * arrival time, so time spent waiting for a free command when all
+ * queueLength commands are in flight is included as queuing delay.
+ * Commands may complete in any order, the state of each command in
+ * flight is checked whenever xclExecWait reports a completion.
+ */
+double runTestOpenLoop(xclDeviceHandle handle, std::vector<std::shared_ptr<task_info>>& cmds,
+                       unsigned int total, arg_t &arg)
+{
+    std::vector<Clock::time_point> intended(cmds.size());
+    std::vector<size_t> free_slots, busy_slots;
+    for (size_t slot = 0; slot < cmds.size(); ++slot)
+        free_slots.push_back(slot);
+
+    arrival_generator arrivals(rate, poisson, arg.thread_id + 1);
+    unsigned int issued = 0, completed = 0;
+    arg.start = Clock::now();
+    auto next = arg.start + arrivals.next();
+
+    while (completed < total) {
+        auto now = Clock::now();
+        bool can_issue = issued < total && !free_slots.empty();
+        if (can_issue && now >= next) {
+            auto slot = free_slots.back();
+            free_slots.pop_back();
+            intended[slot] = next;
+            if (xclExecBuf(handle, cmds[slot]->exec_bo))
+                throw std::runtime_error("Unable to issue exec buf");
+            busy_slots.push_back(slot);
+            issued++;
+            next = arg.start + arrivals.next();
+            continue;
+        }
+
+        size_t done = 0;
+        for (auto it = busy_slots.begin(); it != busy_slots.end();) {
+            auto slot = *it;
+            auto state = cmds[slot]->ecmd->state;
+            if (state < ERT_CMD_STATE_COMPLETED) {
+                ++it;
+                continue;
+            }
+            arg.latency.record(Clock::now() - intended[slot]);
+            if (state != ERT_CMD_STATE_COMPLETED)
+                throw std::runtime_error("CU execution failed");
+            it = busy_slots.erase(it);
+            free_slots.push_back(slot);
+            completed++;
+            done++;
+        }
+        if (done)
+            continue;
+
+        if (busy_slots.empty()) {
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        /* Wait for a completion, but not much past the next arrival.
+         * The wait has millisecond resolution, an arrival can be
+         * issued up to 1ms late, which is counted as queuing delay.
+         */
+        int wait_ms = -1;
+        if (can_issue)
+            wait_ms = std::max<int>(1, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        next - now + std::chrono::microseconds(999)).count());
+        xclExecWait(handle, wait_ms);
+    }
+
+    arg.end = Clock::now();
+    return (std::chrono::duration_cast<ms_t>(arg.end - arg.start)).count();
+}
+
 void fillCmdVector(xclDeviceHandle handle, std::vector<std::shared_ptr<task_info>> &cmds,
         int bank, int expected_cmds)
 {
@@ -208,7 +291,7 @@ void runTestThread(arg_t &arg)
 
     barrier.wait();
 
-    double duration = runTest(handle, cmds, arg.total, arg);
+    double duration = rate > 0 ? runTestOpenLoop(handle, cmds, arg.total, arg) : runTest(handle, cmds, arg.total, arg);
 
     barrier.wait();
 
@@ -251,24 +334,43 @@ int testMultiThreads(std::string &dev, std::string &xclbin_fn, int threadNumber,
     /* calculate performance */
     int overallCommands = 0;
     double duration;
+    latency_histogram latency;
     for (int i = 0; i < threadNumber; i++) {
         if (verbose) {
             duration = (std::chrono::duration_cast<ms_t>(arg[i].end - arg[i].start)).count();
             std::cout << "Thread " << arg[i].thread_id
                 << " Commands: " << std::setw(7) << total
                 << std::setprecision(0) << std::fixed
-                << " IOPS: " << (total * 1000000.0 / duration)
-                << std::endl;
+                << " IOPS: " << (total * 1000000.0 / duration);
+            if (rate > 0)
+                std::cout << " Latency " << latency_summary(arg[i].latency);
+            std::cout << std::endl;
         }
         overallCommands += total;
+        latency.merge(arg[i].latency);
     }
 
     duration = (std::chrono::duration_cast<ms_t>(end - start)).count();
+    auto iops = overallCommands * 1000000.0 / duration;
     std::cout << "Overall Commands: " << std::setw(7) << overallCommands
               << std::setprecision(0) << std::fixed
-              << " IOPS: " << (overallCommands * 1000000.0 / duration)
+              << " IOPS: " << iops
               << " (" << krnl.name << ")"
               << std::endl;
+
+    if (rate > 0)
+        std::cout << "Overall Latency " << latency_summary(latency)
+                  << " target IOPS: " << rate * threadNumber
+                  << " (" << (poisson ? "poisson" : "constant") << ")"
+                  << std::endl;
+
+    if (!json_fn.empty()) {
+        std::ofstream json(json_fn);
+        json << latency_json("xcl_iops_test", poisson ? "poisson" : "constant",
+                             rate * threadNumber, iops, latency) << std::endl;
+        if (!json.good())
+            throw std::runtime_error("Could not write " + json_fn);
+    }
     return 0;
 }
 
@@ -289,6 +391,9 @@ int _main(int argc, char* argv[])
     parser.addSwitch("--threads", "-t", "number of threads", "2");
     parser.addSwitch("--length",  "-l", "length of queue", "128");
     parser.addSwitch("--total",   "-a", "total amount of commands per thread", "50000");
+    parser.addSwitch("--rate",    "-r", "open loop commands per second per thread", "0");
+    parser.addSwitch("--arrival", "-p", "open loop arrivals, constant or poisson", "constant");
+    parser.addSwitch("--output",  "-o", "machine readable result file (open loop)", "");
     parser.addSwitch("--verbose", "-v", "verbose output", "", true);
     parser.parse(argc, argv);
 
@@ -305,6 +410,12 @@ int _main(int argc, char* argv[])
         krnl.new_style = true;
     }
     verbose = parser.isValid("verbose");
+    rate = parser.value_to_double("rate");
+    json_fn = parser.value("output");
+    std::string arrival = parser.value("arrival");
+    if (arrival != "constant" && arrival != "poisson")
+        throw std::runtime_error("Unknown arrival " + arrival);
+    poisson = (arrival == "poisson");
 
     /* Sanity check */
     std::ifstream infile(xclbin_fn);
@@ -320,6 +431,13 @@ int _main(int argc, char* argv[])
     if (threadNumber <= 0)
         throw std::runtime_error("Invalid thread number");
 
+    if (rate < 0)
+        throw std::runtime_error("Negative command rate");
+
+    /* Latency is measured in open loop mode only */
+    if (!json_fn.empty() && rate == 0)
+        throw std::runtime_error("Machine readable result requires open loop mode (-r)");
+
     testMultiThreads(device_str, xclbin_fn, threadNumber, queueLength, total);
 
     return 0;
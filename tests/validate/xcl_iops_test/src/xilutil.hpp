@@ -5,6 +5,14 @@
 
 #include <mutex>
 #include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 /* std::barrier can be used since c++20
  * Thanks boost library. Modified a little bit with pure c++11 code
@@ -58,4 +66,151 @@ class barrier
     unsigned int m_count_reset_val;
 };
 
+/* Latency histogram with log-linear buckets, similar to HdrHistogram.
+ * Values below 128 are exact, above that each power of two is split
+ * into 64 buckets, so the reported value is within 1.6% of the
+ * recorded value.  Histograms of threads are merged for reporting.
+ */
+class latency_histogram
+{
+    static const unsigned int sub_bucket_bits = 6;
+    static const uint64_t sub_bucket_count = 1 << sub_bucket_bits;
+
+    static size_t index(uint64_t value) {
+        if (value < 2 * sub_bucket_count)
+            return value;
+        unsigned int shift = 63 - __builtin_clzll(value) - sub_bucket_bits;
+        return shift * sub_bucket_count + (value >> shift);
+    }
+
+    /* Highest value that is in the bucket of index */
+    static uint64_t value_of(size_t idx) {
+        if (idx < 2 * sub_bucket_count)
+            return idx;
+        unsigned int shift = idx / sub_bucket_count - 1;
+        uint64_t sub = idx - shift * sub_bucket_count;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    public:
+    latency_histogram()
+        : m_counts(index(UINT64_MAX) + 1, 0)
+    {}
+
+    void record(uint64_t value) {
+        m_counts[index(value)]++;
+        m_total++;
+        m_sum += value;
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    void record(std::chrono::nanoseconds value) {
+        record(static_cast<uint64_t>(std::max<int64_t>(value.count(), 0)));
+    }
+
+    void merge(const latency_histogram& other) {
+        for (size_t i = 0; i < m_counts.size(); ++i)
+            m_counts[i] += other.m_counts[i];
+        m_total += other.m_total;
+        m_sum += other.m_sum;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    uint64_t count() const { return m_total; }
+    uint64_t min() const { return m_total ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_total ? static_cast<double>(m_sum) / m_total : 0; }
+
+    /* Value at quantile q (0 < q <= 1), exact max for q == 1 */
+    uint64_t percentile(double q) const {
+        if (!m_total)
+            return 0;
+        auto rank = static_cast<uint64_t>(q * m_total + 0.5);
+        rank = std::max<uint64_t>(std::min(rank, m_total), 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < m_counts.size(); ++i) {
+            seen += m_counts[i];
+            if (seen >= rank)
+                return std::min(value_of(i), m_max);
+        }
+        return m_max;
+    }
+
+    private:
+    std::vector<uint64_t> m_counts;
+    uint64_t m_total = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = UINT64_MAX;
+    uint64_t m_max = 0;
+};
+
+/* Intended arrival times of commands in open loop mode, at a fixed
+ * interval or with exponentially distributed intervals (Poisson
+ * arrivals) for a target rate in commands per second.
+ */
+class arrival_generator
+{
+    public:
+    arrival_generator(double rate, bool poisson, unsigned int seed)
+        : m_poisson(poisson)
+        , m_interval(1e9 / rate)
+        , m_gen(seed)
+        , m_dist(rate / 1e9)
+    {
+        if (rate <= 0)
+            throw std::runtime_error("arrival rate must be positive");
+    }
+
+    std::chrono::nanoseconds next() {
+        m_elapsed += m_poisson ? m_dist(m_gen) : m_interval;
+        return std::chrono::nanoseconds(static_cast<int64_t>(m_elapsed));
+    }
+
+    private:
+    bool m_poisson;
+    double m_interval;
+    double m_elapsed = 0;
+    std::mt19937_64 m_gen;
+    std::exponential_distribution<double> m_dist;
+};
+
+/* One line of latency summary in microseconds */
+inline std::string
+latency_summary(const latency_histogram& hist)
+{
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "p50: " << hist.percentile(0.5) / 1000.0
+       << " p99: " << hist.percentile(0.99) / 1000.0
+       << " p99.9: " << hist.percentile(0.999) / 1000.0
+       << " max: " << hist.max() / 1000.0 << " (us)";
+    return os.str();
+}
+
+/* Machine readable result for regression tracking, latency in ns */
+inline std::string
+latency_json(const std::string& test, const std::string& arrival, double rate,
+             double achieved, const latency_histogram& hist)
+{
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "{\"test\": \"" << test << "\""
+       << ", \"arrival\": \"" << arrival << "\""
+       << ", \"target_iops\": " << rate
+       << ", \"achieved_iops\": " << achieved
+       << ", \"commands\": " << hist.count()
+       << ", \"latency_ns\": {\"min\": " << hist.min()
+       << ", \"mean\": " << hist.mean()
+       << ", \"p50\": " << hist.percentile(0.5)
+       << ", \"p90\": " << hist.percentile(0.9)
+       << ", \"p99\": " << hist.percentile(0.99)
+       << ", \"p99.9\": " << hist.percentile(0.999)
+       << ", \"max\": " << hist.max() << "}}";
+    return os.str();
+}
+
 #endif
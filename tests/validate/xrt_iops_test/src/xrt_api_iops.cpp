@@ -4,6 +4,8 @@
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "cmdlineparser.h"
 
@@ -21,6 +23,7 @@ typedef struct task_args {
   unsigned int total;
   Clock::time_point start;
   Clock::time_point end;
+  latency_histogram latency;
 } arg_t;
 
 struct krnl_info {
@@ -29,6 +32,10 @@ struct krnl_info {
 };
 
 bool verbose = false;
+/* Open loop mode when rate (commands per second per thread) is set */
+double rate = 0;
+bool poisson = false;
+std::string json_fn;
 barrier barrier;
 struct krnl_info krnl = {"hello", false};
 
@@ -40,6 +47,9 @@ static void usage(const char *prog)
     << "    -t       number of threads\n"
     << "    -l       length of queue (send how many commands without waiting)\n"
     << "    -a       total amount of commands per thread\n"
+    << "    -r       open loop, target commands per second per thread\n"
+    << "    -p       open loop arrivals, constant or poisson\n"
+    << "    -o       write machine readable result to file, open loop only\n"
     << "    -v       verbose result\n"
     << std::endl;
 }
@@ -73,6 +83,98 @@ double runTest(std::vector<xrt::run>& cmds, unsigned int total, arg_t &arg)
   return (std::chrono::duration_cast<ms_t>(arg.end - arg.start)).count();
 }
 
+/* Completions of the commands of one thread, queued by the run
+ * callbacks and consumed by the issuing thread.
+ */
+struct completion_queue {
+  struct completion {
+    size_t slot;
+    ert_cmd_state state;
+    Clock::time_point time;
+  };
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<completion> done;
+
+  void push(size_t slot, ert_cmd_state state)
+  {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lk(mutex);
+    done.push_back({slot, state, now});
+    cv.notify_one();
+  }
+};
+
+/* Issue commands at their intended arrival times rather than when a
+ * previous command completes.  Latency is measured from the intended
+ * arrival time, so time spent waiting for a free command when all
+ * queueLength commands are in flight is included as queuing delay.
+ * Commands may complete in any order, each command signals its own
+ * completion through a run callback.
+ */
+double runTestOpenLoop(std::vector<xrt::run>& cmds, unsigned int total, arg_t &arg)
+{
+  std::vector<Clock::time_point> intended(cmds.size());
+  std::vector<size_t> free_slots;
+  completion_queue queue;
+  for (size_t slot = 0; slot < cmds.size(); ++slot) {
+    free_slots.push_back(slot);
+    cmds[slot].add_callback(ERT_CMD_STATE_COMPLETED,
+                            [&queue, slot](const void*, ert_cmd_state state, void*) { queue.push(slot, state); },
+                            nullptr);
+  }
+
+  arrival_generator arrivals(rate, poisson, arg.thread_id + 1);
+  unsigned int issued = 0, completed = 0;
+  bool failed = false;
+  std::vector<completion_queue::completion> done;
+  arg.start = Clock::now();
+  auto next = arg.start + arrivals.next();
+
+  while (completed < total) {
+    /* Stop issuing after a failure, but drain commands in flight */
+    bool can_issue = !failed && issued < total && !free_slots.empty();
+    if (can_issue && Clock::now() >= next) {
+      auto slot = free_slots.back();
+      free_slots.pop_back();
+      intended[slot] = next;
+      cmds[slot].start();
+      issued++;
+      next = arg.start + arrivals.next();
+      continue;
+    }
+
+    if (failed && completed == issued)
+      break;
+
+    /* Wait for a completion, but not past the next arrival */
+    {
+      std::unique_lock<std::mutex> lk(queue.mutex);
+      auto ready = [&queue] { return !queue.done.empty(); };
+      if (can_issue)
+        queue.cv.wait_until(lk, next, ready);
+      else
+        queue.cv.wait(lk, ready);
+      done.swap(queue.done);
+    }
+
+    for (auto& c : done) {
+      arg.latency.record(c.time - intended[c.slot]);
+      if (c.state != ERT_CMD_STATE_COMPLETED)
+        failed = true;
+      free_slots.push_back(c.slot);
+      completed++;
+    }
+    done.clear();
+  }
+
+  arg.end = Clock::now();
+  if (failed)
+    throw std::runtime_error("CU execution failed");
+  return (std::chrono::duration_cast<ms_t>(arg.end - arg.start)).count();
+}
+
 void runTestThread(const xrt::device& device, const xrt::kernel& hello, arg_t& arg)
 {
   std::vector<xrt::run> cmds;
@@ -84,7 +186,7 @@ void runTestThread(const xrt::device& device, const xrt::kernel& hello, arg_t& a
   }
   barrier.wait();
 
-  double duration = runTest(cmds, arg.total, arg);
+  double duration = rate > 0 ? runTestOpenLoop(cmds, arg.total, arg) : runTest(cmds, arg.total, arg);
 
   barrier.wait();
 }
@@ -121,24 +223,43 @@ int testMultiThreads(const std::string& dev, const std::string& xclbin_fn, int t
   /* calculate performance */
   int overallCommands = 0;
   double duration;
+  latency_histogram latency;
   for (int i = 0; i < threadNumber; i++) {
     if (verbose) {
       duration = (std::chrono::duration_cast<ms_t>(arg[i].end - arg[i].start)).count();
       std::cout << "Thread " << arg[i].thread_id
                 << " Commands: " << std::setw(7) << total
                 << std::setprecision(0) << std::fixed
-                << " IOPS: " << (total * 1000000.0 / duration)
-                << std::endl;
+                << " IOPS: " << (total * 1000000.0 / duration);
+      if (rate > 0)
+        std::cout << " Latency " << latency_summary(arg[i].latency);
+      std::cout << std::endl;
     }
     overallCommands += total;
+    latency.merge(arg[i].latency);
   }
 
   duration = (std::chrono::duration_cast<ms_t>(end - start)).count();
+  auto iops = overallCommands * 1000000.0 / duration;
   std::cout << "Overall Commands: " << std::setw(7) << overallCommands
             << std::setprecision(0) << std::fixed
-            << " IOPS: " << (overallCommands * 1000000.0 / duration)
+            << " IOPS: " << iops
             << " (" << krnl.name << ")"
             << std::endl;
+
+  if (rate > 0)
+    std::cout << "Overall Latency " << latency_summary(latency)
+              << " target IOPS: " << rate * threadNumber
+              << " (" << (poisson ? "poisson" : "constant") << ")"
+              << std::endl;
+
+  if (!json_fn.empty()) {
+    std::ofstream json(json_fn);
+    json << latency_json("xrt_iops_test", poisson ? "poisson" : "constant",
+                         rate * threadNumber, iops, latency) << std::endl;
+    if (!json.good())
+      throw std::runtime_error("Could not write " + json_fn);
+  }
   return 0;
 }
 
@@ -159,6 +280,9 @@ int _main(int argc, char* argv[])
   parser.addSwitch("--threads", "-t", "number of threads", "2");
   parser.addSwitch("--length",  "-l", "length of queue", "128");
   parser.addSwitch("--total",   "-a", "total amount of commands per thread", "50000");
+  parser.addSwitch("--rate",    "-r", "open loop commands per second per thread", "0");
+  parser.addSwitch("--arrival", "-p", "open loop arrivals, constant or poisson", "constant");
+  parser.addSwitch("--output",  "-o", "machine readable result file (open loop)", "");
   parser.addSwitch("--verbose", "-v", "verbose output", "", true);
   parser.parse(argc, argv);
 
@@ -175,6 +299,12 @@ int _main(int argc, char* argv[])
       krnl.new_style = true;
   }
   verbose = parser.isValid("verbose");
+  rate = parser.value_to_double("rate");
+  json_fn = parser.value("output");
+  std::string arrival = parser.value("arrival");
+  if (arrival != "constant" && arrival != "poisson")
+    throw std::runtime_error("Unknown arrival " + arrival);
+  poisson = (arrival == "poisson");
 
   /* Sanity check */
   std::ifstream infile(xclbin_fn);
@@ -190,6 +320,13 @@ int _main(int argc, char* argv[])
   if (threadNumber <= 0)
     throw std::runtime_error("Invalid thread number");
 
+  if (rate < 0)
+    throw std::runtime_error("Negative command rate");
+
+  /* Latency is measured in open loop mode only */
+  if (!json_fn.empty() && rate == 0)
+    throw std::runtime_error("Machine readable result requires open loop mode (-r)");
+
   testMultiThreads(device_str, xclbin_fn, threadNumber, queueLength, total);
 
   return 0;
@@ -0,0 +1,37 @@
+# Common build rules of the host only perf_* benchmarks
+#
+# Each benchmark is one executable built from the .cpp file of the
+# same name.  The benchmark Makefile names the executable and the
+# libraries it links with, then includes this file:
+#
+#   PERF_EXE := run_timeout
+#   PERF_LIBS := -lxrt_coreutil -luuid
+#   include ../perf.mk
+#
+# % make [debug=1]
+# % make clean
+
+ifndef XILINX_XRT
+$(error XILINX_XRT is not set)
+endif
+
+ifndef PERF_EXE
+$(error PERF_EXE is not set)
+endif
+
+CXXFLAGS := -std=c++14 -O2 -I$(XILINX_XRT)/include
+LDFLAGS := -L$(XILINX_XRT)/lib
+
+ifeq ($(debug), 1)
+CXXFLAGS += -g
+endif
+
+.PHONY: all clean
+
+all: $(PERF_EXE)
+
+$(PERF_EXE): $(PERF_EXE).cpp
+	g++ $(CXXFLAGS) -o $@ $< $(LDFLAGS) $(PERF_LIBS) -lpthread
+
+clean:
+	rm -f $(PERF_EXE) *.o
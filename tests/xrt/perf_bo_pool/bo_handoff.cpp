@@ -0,0 +1,375 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Cross process buffer handoff latency.
+//
+// % bo_handoff [-d <device>] [-n <frames>] [-s <buffer size>] [-c <pool buffers>] [-t <buffer type>]
+
+#include "experimental/xrt_bo_pool.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct frame_header
+{
+  uint64_t number;
+  uint64_t stamp_ns;
+};
+
+static uint64_t
+now_ns()
+{
+  // steady_clock is CLOCK_MONOTONIC which is the same in all processes
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+static void
+send_fd(int sock, int fd)
+{
+  char byte = 0;
+  char cbuf[CMSG_SPACE(sizeof(int))];
+  std::memset(cbuf, 0, sizeof(cbuf));
+  iovec iov = {&byte, 1};
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cbuf;
+  msg.msg_controllen = sizeof(cbuf);
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  if (sendmsg(sock, &msg, 0) != 1)
+    throw std::runtime_error("sendmsg failed");
+}
+
+static int
+receive_fd(int sock)
+{
+  char byte = 0;
+  char cbuf[CMSG_SPACE(sizeof(int))];
+  iovec iov = {&byte, 1};
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cbuf;
+  msg.msg_controllen = sizeof(cbuf);
+  if (recvmsg(sock, &msg, 0) != 1)
+    throw std::runtime_error("recvmsg failed");
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS)
+    throw std::runtime_error("no handle received");
+  int fd;
+  std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  return fd;
+}
+
+static void
+put_byte(int sock)
+{
+  char byte = 0;
+  if (write(sock, &byte, 1) != 1)
+    throw std::runtime_error("write failed");
+}
+
+static void
+get_byte(int sock)
+{
+  char byte;
+  if (read(sock, &byte, 1) != 1)
+    throw std::runtime_error("read failed");
+}
+
+struct options
+{
+  unsigned int device = 0;
+  size_t frames = 10000;
+  size_t size = 1024 * 1024;
+  size_t count = 4;
+  xrt::bo::flags flags = xrt::bo::flags::normal;
+};
+
+// Consumer latency statistics in ns, sent back to the producer
+struct stats
+{
+  double avg = 0;
+  uint64_t p50 = 0;
+  uint64_t p99 = 0;
+  uint64_t max = 0;
+};
+
+static stats
+to_stats(std::vector<uint64_t>& lat)
+{
+  stats s;
+  std::sort(lat.begin(), lat.end());
+  uint64_t sum = 0;
+  for (auto l : lat)
+    sum += l;
+  s.avg = double(sum) / lat.size();
+  s.p50 = lat[lat.size() / 2];
+  s.p99 = lat[lat.size() * 99 / 100];
+  s.max = lat.back();
+  return s;
+}
+
+static void
+send_stats(int sock, std::vector<uint64_t>& lat)
+{
+  auto s = to_stats(lat);
+  if (write(sock, &s, sizeof(s)) != sizeof(s))
+    throw std::runtime_error("write failed");
+}
+
+static stats
+receive_stats(int sock)
+{
+  stats s;
+  if (read(sock, &s, sizeof(s)) != sizeof(s))
+    throw std::runtime_error("read failed");
+  return s;
+}
+
+static void
+check_frame(const frame_header* hdr, size_t number)
+{
+  if (hdr->number != number)
+    throw std::runtime_error("unexpected frame " + std::to_string(hdr->number)
+                             + " expected " + std::to_string(number));
+}
+
+// Export, import, and map per frame
+static void
+export_producer(const options& opt, int sock)
+{
+  xrt::device device(opt.device);
+  xrt::bo bo(device, opt.size, opt.flags, 0);
+  auto hdr = bo.map<frame_header*>();
+  for (size_t n = 0; n < opt.frames; ++n) {
+    hdr->number = n;
+    hdr->stamp_ns = now_ns();
+    auto ehdl = bo.export_buffer();
+    send_fd(sock, ehdl);
+    close(ehdl);
+    get_byte(sock);
+  }
+}
+
+static void
+export_consumer(const options& opt, int sock)
+{
+  xrt::device device(opt.device);
+  std::vector<uint64_t> lat(opt.frames);
+  for (size_t n = 0; n < opt.frames; ++n) {
+    auto ehdl = receive_fd(sock);
+    {
+      xrt::bo bo(device, ehdl);
+      auto hdr = bo.map<const frame_header*>();
+      check_frame(hdr, n);
+      lat[n] = now_ns() - hdr->stamp_ns;
+    }
+    close(ehdl);
+    put_byte(sock);
+  }
+  send_stats(sock, lat);
+}
+
+// Hand off by index through bo_pool
+static void
+pool_producer(const options& opt, int sock, const std::string& name)
+{
+  xrt::device device(opt.device);
+  xrt::bo_pool pool(device, name, opt.count, opt.size, opt.flags, 0);
+  std::vector<frame_header*> hdrs;
+  for (size_t idx = 0; idx < pool.size(); ++idx)
+    hdrs.push_back(pool.buffer(idx).map<frame_header*>());
+  put_byte(sock);  // pool is ready
+  get_byte(sock);  // consumer attached
+
+  for (size_t n = 0; n < opt.frames; ++n) {
+    auto idx = pool.acquire();
+    hdrs[idx]->number = n;
+    hdrs[idx]->stamp_ns = now_ns();
+    pool.send(idx);
+    get_byte(sock);
+  }
+}
+
+static void
+pool_consumer(const options& opt, int sock, const std::string& name)
+{
+  xrt::device device(opt.device);
+  get_byte(sock);
+  xrt::bo_pool pool(device, name);
+  std::vector<const frame_header*> hdrs;
+  for (size_t idx = 0; idx < pool.size(); ++idx)
+    hdrs.push_back(pool.buffer(idx).map<const frame_header*>());
+  put_byte(sock);
+
+  std::vector<uint64_t> lat(opt.frames);
+  for (size_t n = 0; n < opt.frames; ++n) {
+    auto idx = pool.receive();
+    check_frame(hdrs[idx], n);
+    lat[n] = now_ns() - hdrs[idx]->stamp_ns;
+    pool.release(idx);
+    put_byte(sock);
+  }
+  send_stats(sock, lat);
+}
+
+template <typename Producer, typename Consumer>
+static stats
+run_pair(Producer producer, Consumer consumer)
+{
+  int socks[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, socks))
+    throw std::runtime_error("socketpair failed");
+
+  // Device is opened after fork in both processes
+  auto pid = fork();
+  if (pid < 0)
+    throw std::runtime_error("fork failed");
+  if (pid == 0) {
+    close(socks[0]);
+    int ret = 0;
+    try {
+      consumer(socks[1]);
+    }
+    catch (const std::exception& ex) {
+      std::cout << "consumer error: " << ex.what() << "\n";
+      ret = 1;
+    }
+    _exit(ret);
+  }
+
+  close(socks[1]);
+  stats s;
+  std::string err;
+  try {
+    producer(socks[0]);
+    s = receive_stats(socks[0]);
+  }
+  catch (const std::exception& ex) {
+    err = ex.what();
+  }
+  close(socks[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (!err.empty() || !WIFEXITED(status) || WEXITSTATUS(status))
+    throw std::runtime_error("handoff failed " + err);
+  return s;
+}
+
+static void
+print(const std::string& what, const stats& s)
+{
+  std::cout << what << "avg " << s.avg / 1000 << " us, p50 " << s.p50 / 1000.0
+            << " us, p99 " << s.p99 / 1000.0 << " us, max " << s.max / 1000.0 << " us\n";
+}
+
+static void
+usage()
+{
+  std::cout << "usage: bo_handoff [options]\n\n";
+  std::cout << "  -d <device>, default 0\n";
+  std::cout << "  -n <frames>, default 10000\n";
+  std::cout << "  -s <buffer size>, default 1048576\n";
+  std::cout << "  -c <pool buffers>, default 4\n";
+  std::cout << "  -t <normal|host_only>, buffer type, default normal\n";
+  std::cout << "  -h\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  options opt;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-d")
+      opt.device = std::stoul(arg);
+    else if (cur == "-n")
+      opt.frames = std::stoul(arg);
+    else if (cur == "-s")
+      opt.size = std::stoul(arg);
+    else if (cur == "-c")
+      opt.count = std::stoul(arg);
+    else if (cur == "-t" && arg == "normal")
+      opt.flags = xrt::bo::flags::normal;
+    else if (cur == "-t" && arg == "host_only")
+      opt.flags = xrt::bo::flags::host_only;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (!opt.frames || !opt.count || opt.size < sizeof(frame_header))
+    throw std::runtime_error("bad frames, pool buffers, or buffer size");
+
+  auto name = "bo_handoff." + std::to_string(getpid());
+
+  auto exp = run_pair([&](int sock) { export_producer(opt, sock); },
+                      [&](int sock) { export_consumer(opt, sock); });
+  auto pool = run_pair([&](int sock) { pool_producer(opt, sock, name); },
+                       [&](int sock) { pool_consumer(opt, sock, name); });
+
+  std::cout << "frames: " << opt.frames << ", buffer size: " << opt.size
+            << ", pool buffers: " << opt.count << "\n";
+  print("export: ", exp);
+  print("pool:   ", pool);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  return 1;
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure clEnqueueWriteBuffer/clEnqueueReadBuffer bandwidth and
+// count host side copies per transfer.
+//
+// % XCL_EMULATION_MODE=noop ./cl_rw -k <xclbin> [-s <bytes>] [-i <iterations>]
+//
+// A buffer is migrated to the device once, then written and read
+// with blocking transfers from a page aligned and from an unaligned
+// host pointer.  memcpy is interposed to count copies of at least a
+// page made by the runtime.  Copies made by the noop shim stand in
+// for DMA and are not counted.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+
+namespace {
+
+std::atomic<bool> counting {false};
+std::atomic<uint64_t> copies {0};
+
+static void
+count(const void* caller, size_t n)
+{
+  if (!counting || n < 4096)
+    return;
+  Dl_info info;
+  if (dladdr(caller, &info) && info.dli_fname && std::strstr(info.dli_fname, "xrt_noop"))
+    return;
+  ++copies;
+}
+
+} // namespace
+
+// Interpose memcpy for the runtime libraries.  The copy itself is
+// done by memmove which is not interposed.
+extern "C" void*
+memcpy(void* dst, const void* src, size_t n)
+{
+  count(__builtin_return_address(0), n);
+  return memmove(dst, src, n);
+}
+
+extern "C" void*
+__memcpy_chk(void* dst, const void* src, size_t n, size_t)
+{
+  count(__builtin_return_address(0), n);
+  return memmove(dst, src, n);
+}
+
+namespace {
+
+static void
+usage()
+{
+  std::cout << "usage: cl_rw [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -s <transfer size in bytes>, default 16MB\n";
+  std::cout << "  -i <iterations>, default 100\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+  std::cout << "* Use XRT_INI_PATH=direct.ini to enable direct DMA\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+struct result
+{
+  double gbps;
+  double copies;  // per transfer
+};
+
+static result
+transfer(cl_command_queue queue, cl_mem buffer, void* ptr, size_t size, size_t iterations, bool write)
+{
+  copies = 0;
+  counting = true;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    auto err = write
+      ? clEnqueueWriteBuffer(queue, buffer, CL_TRUE, 0, size, ptr, 0, nullptr, nullptr)
+      : clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0, size, ptr, 0, nullptr, nullptr);
+    throw_if_error(err, write ? "clEnqueueWriteBuffer" : "clEnqueueReadBuffer");
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  counting = false;
+
+  double sec = std::chrono::duration<double>(end - start).count();
+  return {size * iterations / sec / 1.0e9, static_cast<double>(copies) / iterations};
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  size_t size = 16 * 1024 * 1024;
+  size_t iterations = 100;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!size || !iterations)
+    throw std::runtime_error("size and iterations must be non zero");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+  auto queue = clCreateCommandQueue(context, device, 0, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  const unsigned char* binary = xclbin.data();
+  size_t binary_size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  throw_if_error(clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr), "clBuildProgram");
+
+  // Make the buffer resident so that transfers go to device memory
+  auto buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, size, nullptr, &err);
+  throw_if_error(err, "clCreateBuffer");
+  throw_if_error(clEnqueueMigrateMemObjects(queue, 1, &buffer, 0, 0, nullptr, nullptr), "clEnqueueMigrateMemObjects");
+  throw_if_error(clFinish(queue), "clFinish");
+
+  const size_t page = 4096;
+  char* host = nullptr;
+  char* check = nullptr;
+  if (posix_memalign(reinterpret_cast<void**>(&host), page, size + page)
+      || posix_memalign(reinterpret_cast<void**>(&check), page, size + page))
+    throw std::runtime_error("host allocation failed");
+  for (size_t i = 0; i < size + page; ++i)
+    host[i] = static_cast<char>(i * 7);
+
+  std::cout << "transfer size: " << size << " bytes, iterations: " << iterations << "\n";
+  bool failed = false;
+  for (auto offset : {size_t(0), size_t(1)}) {
+    auto wr = transfer(queue, buffer, host + offset, size, iterations, true);
+    std::memset(check, 0, size + page);
+    auto rd = transfer(queue, buffer, check + offset, size, iterations, false);
+    if (std::memcmp(host + offset, check + offset, size))
+      failed = true;
+
+    std::cout << (offset ? "unaligned: " : "aligned:   ")
+              << "write " << wr.gbps << " GB/s, " << wr.copies << " copies/transfer; "
+              << "read " << rd.gbps << " GB/s, " << rd.copies << " copies/transfer\n";
+  }
+
+  clReleaseMemObject(buffer);
+  clReleaseProgram(program);
+  clReleaseCommandQueue(queue);
+  clReleaseContext(context);
+  free(host);
+  free(check);
+
+  if (failed)
+    throw std::runtime_error("data read back does not match data written");
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
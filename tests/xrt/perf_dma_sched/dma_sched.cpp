@@ -0,0 +1,254 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure latency of small buffer writes mixed with large buffer
+// writes, and throughput of the large writes.
+//
+// % XCL_EMULATION_MODE=noop ./dma_sched -k <xclbin> [-l <large bytes>]
+//       [-s <small bytes>] [-f <large writes in flight>] [-i <small writes>]
+//       [-p <0|1>]
+//
+// A bulk thread keeps the specified number of large non-blocking
+// writes in flight on one command queue.  The main thread issues
+// blocking small writes on another command queue, with high priority
+// unless -p 0, and records the latency of each small write.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+#include <CL/cl_ext_xilinx.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: dma_sched [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -l <large write size in bytes>, default 64MB\n";
+  std::cout << "  -s <small write size in bytes>, default 4KB\n";
+  std::cout << "  -f <large writes in flight>, default 4\n";
+  std::cout << "  -i <small writes>, default 1000\n";
+  std::cout << "  -p <0|1>, create small write queue with high priority, default 1\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side scheduling only\n";
+  std::cout << "* Use XRT_INI_PATH=fifo.ini to disable DMA scheduling\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+static char*
+host_alloc(size_t size)
+{
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, 4096, size))
+    throw std::runtime_error("host allocation failed");
+  std::memset(ptr, 0, size);
+  return static_cast<char*>(ptr);
+}
+
+static cl_mem
+resident_buffer(cl_context context, cl_command_queue queue, size_t size)
+{
+  cl_int err = CL_SUCCESS;
+  auto buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, size, nullptr, &err);
+  throw_if_error(err, "clCreateBuffer");
+  throw_if_error(clEnqueueMigrateMemObjects(queue, 1, &buffer, 0, 0, nullptr, nullptr), "clEnqueueMigrateMemObjects");
+  throw_if_error(clFinish(queue), "clFinish");
+  return buffer;
+}
+
+// Keep large writes in flight until stopped, returns bytes written
+static size_t
+bulk(cl_command_queue queue, cl_mem buffer, const char* data, size_t size, size_t inflight, std::atomic<bool>& stop)
+{
+  std::deque<cl_event> events;
+  size_t bytes = 0;
+  while (!stop || !events.empty()) {
+    if (!stop && events.size() < inflight) {
+      cl_event ev = nullptr;
+      throw_if_error(clEnqueueWriteBuffer(queue, buffer, CL_FALSE, 0, size, data, 0, nullptr, &ev), "clEnqueueWriteBuffer");
+      events.push_back(ev);
+      continue;
+    }
+    throw_if_error(clWaitForEvents(1, &events.front()), "clWaitForEvents");
+    clReleaseEvent(events.front());
+    events.pop_front();
+    bytes += size;
+  }
+  return bytes;
+}
+
+static double
+percentile(const std::vector<double>& sorted, double q)
+{
+  auto idx = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+  return sorted[idx];
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  size_t large = 64 * 1024 * 1024;
+  size_t small = 4096;
+  size_t inflight = 4;
+  size_t iterations = 1000;
+  bool priority = true;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-l")
+      large = std::stoul(arg);
+    else if (cur == "-s")
+      small = std::stoul(arg);
+    else if (cur == "-f")
+      inflight = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else if (cur == "-p")
+      priority = std::stoul(arg) != 0;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!large || !small || !inflight || !iterations)
+    throw std::runtime_error("sizes, writes in flight, and iterations must be non zero");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+  auto bulk_queue = clCreateCommandQueue(context, device, 0, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+  auto latency_queue = clCreateCommandQueue(context, device, priority ? XCL_QUEUE_PRIORITY_HIGH : 0, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  const unsigned char* binary = xclbin.data();
+  size_t binary_size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  throw_if_error(clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr), "clBuildProgram");
+
+  auto large_buffer = resident_buffer(context, bulk_queue, large);
+  auto small_buffer = resident_buffer(context, latency_queue, small);
+  auto large_data = host_alloc(large);
+  auto small_data = host_alloc(small);
+
+  auto small_write = [&] {
+    auto start = clock_type::now();
+    throw_if_error(clEnqueueWriteBuffer(latency_queue, small_buffer, CL_TRUE, 0, small, small_data, 0, nullptr, nullptr), "clEnqueueWriteBuffer");
+    return std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+  };
+
+  // Idle latency for reference
+  std::vector<double> idle;
+  for (size_t i = 0; i < std::min<size_t>(iterations, 100); ++i)
+    idle.push_back(small_write());
+  std::sort(idle.begin(), idle.end());
+
+  std::atomic<bool> stop {false};
+  size_t bytes = 0;
+  auto start = clock_type::now();
+  std::thread bulk_thread([&] { bytes = bulk(bulk_queue, large_buffer, large_data, large, inflight, stop); });
+
+  std::vector<double> latency;
+  for (size_t i = 0; i < iterations; ++i) {
+    latency.push_back(small_write());
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+  stop = true;
+  bulk_thread.join();
+  auto sec = std::chrono::duration<double>(clock_type::now() - start).count();
+  std::sort(latency.begin(), latency.end());
+
+  std::cout << "large writes: " << large << " bytes, " << inflight << " in flight, "
+            << bytes / sec / 1.0e9 << " GB/s\n";
+  std::cout << "small writes: " << small << " bytes, " << (priority ? "high" : "normal") << " priority\n";
+  std::cout << "  idle   latency (us) p50: " << percentile(idle, 0.5)
+            << " p99: " << percentile(idle, 0.99) << " max: " << idle.back() << "\n";
+  std::cout << "  loaded latency (us) p50: " << percentile(latency, 0.5)
+            << " p99: " << percentile(latency, 0.99) << " max: " << latency.back() << "\n";
+
+  clReleaseMemObject(large_buffer);
+  clReleaseMemObject(small_buffer);
+  clReleaseProgram(program);
+  clReleaseCommandQueue(bulk_queue);
+  clReleaseCommandQueue(latency_queue);
+  clReleaseContext(context);
+  free(large_data);
+  free(small_data);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure latency of opening a device, loading an xclbin, and closing
+// the device, as done by short running tests in emulation.
+//
+// % XCL_EMULATION_MODE=sw_emu ./emu_open -k <xclbin> [-i <iterations>]
+
+#include "xrt/xrt_device.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: emu_open [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -d <device index>, default 0\n";
+  std::cout << "  -i <iterations>, default 10\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Bitstream is required\n";
+}
+
+static double
+elapsed_ms(clock_type::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  size_t iterations = 10;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!iterations)
+    throw std::runtime_error("iterations must be non zero");
+
+  std::vector<double> open, close, total;
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = clock_type::now();
+    auto device = std::make_unique<xrt::device>(device_index);
+    device->load_xclbin(xclbin_fnm);
+    open.push_back(elapsed_ms(start));
+
+    auto close_start = clock_type::now();
+    device.reset();
+    close.push_back(elapsed_ms(close_start));
+    total.push_back(elapsed_ms(start));
+  }
+
+  auto report = [](const std::string& name, std::vector<double>& ms) {
+    std::sort(ms.begin(), ms.end());
+    std::cout << "  " << name << " (ms) min: " << ms.front()
+              << " median: " << ms[ms.size() / 2] << " max: " << ms.back() << "\n";
+  };
+
+  std::cout << "iterations: " << iterations << "\n";
+  report("open+load", open);
+  report("close", close);
+  report("total", total);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Count heap allocations per enqueued command and measure enqueue
+// throughput of small commands.
+//
+// % XCL_EMULATION_MODE=noop ./event_pool -k <xclbin> [-s <bytes>]
+//       [-b <batch>] [-i <iterations>]
+//
+// Small non-blocking writes are enqueued in batches, each batch is
+// completed with clFinish and its events are released.  malloc is
+// interposed to count allocations made while enqueueing.  A warm up
+// batch is run first such that steady state is measured.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+extern "C" void* __libc_malloc(size_t);
+
+namespace {
+
+std::atomic<bool> counting {false};
+std::atomic<uint64_t> allocations {0};
+
+} // namespace
+
+// Interpose malloc for the runtime libraries
+extern "C" void*
+malloc(size_t n)
+{
+  if (counting)
+    ++allocations;
+  return __libc_malloc(n);
+}
+
+namespace {
+
+static void
+usage()
+{
+  std::cout << "usage: event_pool [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -s <write size in bytes>, default 64\n";
+  std::cout << "  -b <commands per batch>, default 32\n";
+  std::cout << "  -i <batches>, default 1000\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+  std::cout << "* Use XRT_INI_PATH=nopool.ini to disable caching of event memory\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+struct result
+{
+  double allocations;  // per command
+  double usec;         // per command, including completion
+};
+
+static result
+run_batches(cl_command_queue queue, cl_mem buffer, const char* data, size_t size, size_t batch, size_t iterations)
+{
+  std::vector<cl_event> events(batch);
+  uint64_t allocs = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    allocations = 0;
+    counting = true;
+    for (auto& ev : events)
+      throw_if_error(clEnqueueWriteBuffer(queue, buffer, CL_FALSE, 0, size, data, 0, nullptr, &ev), "clEnqueueWriteBuffer");
+    counting = false;
+    allocs += allocations;
+
+    throw_if_error(clFinish(queue), "clFinish");
+    for (auto ev : events)
+      clReleaseEvent(ev);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  auto commands = static_cast<double>(batch * iterations);
+  return {allocs / commands, std::chrono::duration<double, std::micro>(end - start).count() / commands};
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  size_t size = 64;
+  size_t batch = 32;
+  size_t iterations = 1000;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else if (cur == "-b")
+      batch = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!size || !batch || !iterations)
+    throw std::runtime_error("size, batch, and iterations must be non zero");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+  auto queue = clCreateCommandQueue(context, device, 0, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  const unsigned char* binary = xclbin.data();
+  size_t binary_size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  throw_if_error(clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr), "clBuildProgram");
+
+  auto buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, size, nullptr, &err);
+  throw_if_error(err, "clCreateBuffer");
+  throw_if_error(clEnqueueMigrateMemObjects(queue, 1, &buffer, 0, 0, nullptr, nullptr), "clEnqueueMigrateMemObjects");
+  throw_if_error(clFinish(queue), "clFinish");
+
+  std::vector<char> data(size, 'x');
+
+  // Warm up, fills the event pool
+  run_batches(queue, buffer, data.data(), size, batch, 1);
+
+  auto res = run_batches(queue, buffer, data.data(), size, batch, iterations);
+  std::cout << "write size: " << size << " bytes, batch: " << batch << ", batches: " << iterations << "\n";
+  std::cout << "allocations per command: " << res.allocations << "\n";
+  std::cout << "usec per command: " << res.usec << "\n";
+
+  clReleaseMemObject(buffer);
+  clReleaseProgram(program);
+  clReleaseCommandQueue(queue);
+  clReleaseContext(context);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,194 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure the rate of kernel info, kernel argument info and kernel
+// work group info queries.
+//
+// % XCL_EMULATION_MODE=noop ./kernel_query -k <xclbin> [-i <iterations>]
+//
+// All kernels of the xclbin are created, and all their info and the
+// info of every argument is queried in each iteration.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: kernel_query [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -i <iterations>, default 10000\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+// Query a string as an application would, size first then value
+template <typename Query>
+static size_t
+query_string(Query&& query, std::vector<char>& value)
+{
+  size_t size = 0;
+  throw_if_error(query(0, nullptr, &size), "size query");
+  value.resize(size);
+  throw_if_error(query(size, value.data(), nullptr), "value query");
+  return 2;
+}
+
+// Query everything about kernel, return number of queries
+static size_t
+query_kernel(cl_kernel kernel, cl_device_id device, std::vector<char>& str)
+{
+  size_t queries = 0;
+  cl_uint num_args = 0;
+  throw_if_error(clGetKernelInfo(kernel, CL_KERNEL_NUM_ARGS, sizeof(num_args), &num_args, nullptr), "clGetKernelInfo");
+  ++queries;
+
+  for (auto param : {CL_KERNEL_FUNCTION_NAME, CL_KERNEL_ATTRIBUTES})
+    queries += query_string([=](size_t sz, void* value, size_t* ret) {
+      return clGetKernelInfo(kernel, param, sz, value, ret);
+    }, str);
+
+  for (cl_uint arg = 0; arg < num_args; ++arg) {
+    cl_kernel_arg_address_qualifier address = 0;
+    throw_if_error(clGetKernelArgInfo(kernel, arg, CL_KERNEL_ARG_ADDRESS_QUALIFIER, sizeof(address), &address, nullptr), "clGetKernelArgInfo");
+    cl_kernel_arg_access_qualifier access = 0;
+    throw_if_error(clGetKernelArgInfo(kernel, arg, CL_KERNEL_ARG_ACCESS_QUALIFIER, sizeof(access), &access, nullptr), "clGetKernelArgInfo");
+    queries += 2;
+
+    for (auto param : {CL_KERNEL_ARG_TYPE_NAME, CL_KERNEL_ARG_NAME})
+      queries += query_string([=](size_t sz, void* value, size_t* ret) {
+        return clGetKernelArgInfo(kernel, arg, param, sz, value, ret);
+      }, str);
+  }
+
+  size_t wg_size = 0;
+  throw_if_error(clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(wg_size), &wg_size, nullptr), "clGetKernelWorkGroupInfo");
+  size_t compile_wg_size[3] = {0};
+  throw_if_error(clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_COMPILE_WORK_GROUP_SIZE, sizeof(compile_wg_size), compile_wg_size, nullptr), "clGetKernelWorkGroupInfo");
+  queries += 2;
+
+  return queries;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  size_t iterations = 10000;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  const unsigned char* binary = xclbin.data();
+  size_t binary_size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  throw_if_error(clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr), "clBuildProgram");
+
+  cl_uint num_kernels = 0;
+  throw_if_error(clCreateKernelsInProgram(program, 0, nullptr, &num_kernels), "clCreateKernelsInProgram");
+  if (!num_kernels)
+    throw std::runtime_error("no kernels in xclbin");
+  std::vector<cl_kernel> kernels(num_kernels);
+  throw_if_error(clCreateKernelsInProgram(program, num_kernels, kernels.data(), nullptr), "clCreateKernelsInProgram");
+
+  std::vector<char> str;
+  size_t queries = 0;
+  auto start = clock_type::now();
+  for (size_t i = 0; i < iterations; ++i)
+    for (auto kernel : kernels)
+      queries += query_kernel(kernel, device, str);
+  auto usec = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+
+  std::cout << "kernels: " << num_kernels << ", iterations: " << iterations << "\n";
+  std::cout << "  queries: " << queries << " in " << usec / 1000 << " ms, "
+            << (queries / usec) << " M queries/s, " << (usec * 1000 / queries) << " ns per query\n";
+
+  for (auto kernel : kernels)
+    clReleaseKernel(kernel);
+  clReleaseProgram(program);
+  clReleaseContext(context);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure xrt::run launch rate with and without frozen command layout.
+//
+// % XCL_EMULATION_MODE=noop ./launch_rate -k <xclbin> [-n <kernel>]
+//       [-r <runs in flight>] [-i <iterations>]
+//
+// Each launch sets the global buffer argument of the run, alternating
+// between two buffers in the same memory bank, then starts the run.
+// Runs are waited for in order and restarted, keeping the specified
+// number of runs in flight.  The test is run once with regular runs
+// and once with frozen runs.
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+static void
+usage()
+{
+  std::cout << "usage: launch_rate [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -n <kernel name>, default 'hello'\n";
+  std::cout << "  -r <runs in flight>, default 16\n";
+  std::cout << "  -i <iterations>, default 100000\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+}
+
+static double
+launch(const xrt::device& device, const xrt::kernel& kernel, size_t runs, size_t iterations, bool freeze)
+{
+  xrt::bo bo[] = {
+    xrt::bo(device, 20, kernel.group_id(0)),
+    xrt::bo(device, 20, kernel.group_id(0))
+  };
+
+  std::vector<xrt::run> cmds;
+  for (size_t i = 0; i < runs; ++i) {
+    auto run = xrt::run(kernel);
+    run.set_arg(0, bo[0]);
+    if (freeze)
+      run.freeze();
+    cmds.push_back(std::move(run));
+  }
+
+  size_t issued = 0, completed = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for (auto& cmd : cmds) {
+    cmd.set_arg(0, bo[issued & 1]);
+    cmd.start();
+    if (++issued == iterations)
+      break;
+  }
+
+  size_t i = 0;
+  while (completed < iterations) {
+    cmds[i].wait();
+    ++completed;
+    if (issued < iterations) {
+      cmds[i].set_arg(0, bo[issued & 1]);
+      cmds[i].start();
+      ++issued;
+    }
+    if (++i == cmds.size())
+      i = 0;
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  std::string kernel_name = "hello";
+  size_t runs = 16;
+  size_t iterations = 100000;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-n")
+      kernel_name = arg;
+    else if (cur == "-r")
+      runs = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!runs)
+    throw std::runtime_error("runs in flight must be non zero");
+
+  auto device = xrt::device(0);
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  auto kernel = xrt::kernel(device, uuid, kernel_name);
+
+  for (auto freeze : {false, true}) {
+    auto us = launch(device, kernel, runs, iterations, freeze);
+    std::cout << (freeze ? "frozen:  " : "regular: ")
+              << "launches: " << iterations
+              << " runs in flight: " << runs
+              << " launches/s: " << (iterations * 1000000.0 / us)
+              << " us/launch: " << (us / iterations) << "\n";
+  }
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
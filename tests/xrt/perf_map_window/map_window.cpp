@@ -0,0 +1,223 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure map/unmap latency of small windows of a large buffer
+// created from an unaligned host pointer.
+//
+// % XCL_EMULATION_MODE=noop ./map_window -k <xclbin> [-s <buffer bytes>]
+//       [-w <window bytes>] [-i <iterations>] [-u <0|1>]
+//
+// The buffer is created with CL_MEM_USE_HOST_PTR from a host pointer
+// that is unaligned unless -u 0, and made resident on the device.
+// Windows at random offsets are mapped for read, for write, and for
+// read followed by a smaller write of the same pointer, and unmapped
+// again.  The latency of each map and unmap pair is recorded.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: map_window [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -s <buffer size in bytes>, default 256MB\n";
+  std::cout << "  -w <window size in bytes>, default 4KB\n";
+  std::cout << "  -i <iterations>, default 1000\n";
+  std::cout << "  -u <0|1>, unaligned host pointer, default 1\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+static double
+percentile(const std::vector<double>& sorted, double q)
+{
+  auto idx = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+  return sorted[idx];
+}
+
+enum class mode { read, write, read_then_write };
+
+static const char*
+to_string(mode m)
+{
+  switch (m) {
+  case mode::read: return "read";
+  case mode::write: return "write";
+  case mode::read_then_write: return "read+write";
+  }
+  return "";
+}
+
+static std::vector<double>
+run_mode(cl_command_queue queue, cl_mem buffer, mode m, size_t size, size_t window, size_t iterations)
+{
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<size_t> dist(0, (size - window) / window);
+  std::vector<double> latency;
+  cl_int err = CL_SUCCESS;
+
+  for (size_t i = 0; i < iterations; ++i) {
+    auto offset = dist(gen) * window;
+    auto start = clock_type::now();
+    void* ptr = nullptr;
+    if (m == mode::read || m == mode::read_then_write) {
+      ptr = clEnqueueMapBuffer(queue, buffer, CL_TRUE, CL_MAP_READ, offset, window, 0, nullptr, nullptr, &err);
+      throw_if_error(err, "clEnqueueMapBuffer");
+    }
+    if (m == mode::write || m == mode::read_then_write) {
+      // A smaller write window of the same pointer when read first
+      auto wsize = (m == mode::write) ? window : std::max<size_t>(window / 8, 1);
+      ptr = clEnqueueMapBuffer(queue, buffer, CL_TRUE, CL_MAP_WRITE, offset, wsize, 0, nullptr, nullptr, &err);
+      throw_if_error(err, "clEnqueueMapBuffer");
+      static_cast<char*>(ptr)[0] = static_cast<char>(i);
+    }
+    throw_if_error(clEnqueueUnmapMemObject(queue, buffer, ptr, 0, nullptr, nullptr), "clEnqueueUnmapMemObject");
+    throw_if_error(clFinish(queue), "clFinish");
+    latency.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - start).count());
+  }
+
+  std::sort(latency.begin(), latency.end());
+  return latency;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  size_t size = 256 * 1024 * 1024;
+  size_t window = 4096;
+  size_t iterations = 1000;
+  bool unaligned = true;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else if (cur == "-w")
+      window = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else if (cur == "-u")
+      unaligned = std::stoul(arg) != 0;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!window || !iterations || window > size)
+    throw std::runtime_error("window and iterations must be non zero, window must not exceed size");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+  auto queue = clCreateCommandQueue(context, device, 0, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  const unsigned char* binary = xclbin.data();
+  size_t binary_size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  throw_if_error(clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr), "clBuildProgram");
+
+  void* base = nullptr;
+  if (posix_memalign(&base, 4096, size + 64))
+    throw std::runtime_error("host allocation failed");
+  std::memset(base, 0, size + 64);
+  auto host_ptr = static_cast<char*>(base) + (unaligned ? 64 : 0);
+
+  auto buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, size, host_ptr, &err);
+  throw_if_error(err, "clCreateBuffer");
+  throw_if_error(clEnqueueMigrateMemObjects(queue, 1, &buffer, 0, 0, nullptr, nullptr), "clEnqueueMigrateMemObjects");
+  throw_if_error(clFinish(queue), "clFinish");
+
+  std::cout << "buffer: " << size << " bytes, " << (unaligned ? "unaligned" : "aligned")
+            << ", window: " << window << " bytes, iterations: " << iterations << "\n";
+  for (auto m : {mode::read, mode::write, mode::read_then_write}) {
+    auto latency = run_mode(queue, buffer, m, size, window, iterations);
+    std::cout << "  map " << to_string(m) << " + unmap latency (us) p50: " << percentile(latency, 0.5)
+              << " p99: " << percentile(latency, 0.99) << " max: " << latency.back() << "\n";
+  }
+
+  clReleaseMemObject(buffer);
+  clReleaseProgram(program);
+  clReleaseCommandQueue(queue);
+  clReleaseContext(context);
+  free(base);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,232 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Compare DMA bandwidth of host buffers placed on each NUMA node.
+//
+// % ./numa_bw -k <xclbin> [-d <device>] [-s <bytes>] [-i <iterations>]
+//
+// For each NUMA node of the host, the calling thread is pinned to the
+// cpus of the node and a host buffer is allocated and bound to the
+// node.  The buffer is wrapped in a user pointer xrt::bo and synced to
+// and from the device.  The node the device is attached to is marked
+// such that local and remote placement can be compared.
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: numa_bw [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -d <device index>, default 0\n";
+  std::cout << "  -s <buffer size in bytes>, default 256MB\n";
+  std::cout << "  -i <syncs per direction>, default 20\n";
+  std::cout << "  -h\n";
+}
+
+static std::string
+read_sysfs(const std::string& path)
+{
+  std::ifstream ifs(path);
+  std::string value;
+  std::getline(ifs, value);
+  return value;
+}
+
+static std::vector<int>
+parse_cpulist(const std::string& list)
+{
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) {
+    auto dash = tok.find('-');
+    auto first = std::stoi(tok.substr(0, dash));
+    auto last = (dash == std::string::npos) ? first : std::stoi(tok.substr(dash + 1));
+    for (auto cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+// Node number to cpus of node
+static std::map<int, std::vector<int>>
+get_nodes()
+{
+  std::map<int, std::vector<int>> nodes;
+  const std::string root = "/sys/devices/system/node";
+  auto dir = opendir(root.c_str());
+  if (!dir)
+    return nodes;
+  while (auto ent = readdir(dir)) {
+    std::string name = ent->d_name;
+    if (name.compare(0, 4, "node") || name.size() == 4
+        || name.find_first_not_of("0123456789", 4) != std::string::npos)
+      continue;
+    nodes[std::stoi(name.substr(4))] = parse_cpulist(read_sysfs(root + "/" + name + "/cpulist"));
+  }
+  closedir(dir);
+  return nodes;
+}
+
+static void
+pin_to(const std::vector<int>& cpus)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus)
+    CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set))
+    throw std::runtime_error("sched_setaffinity failed");
+}
+
+static void*
+node_alloc(size_t size, int node)
+{
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, 4096, size))
+    throw std::runtime_error("host allocation failed");
+
+  // MPOL_BIND before first touch such that the pages land on node
+  constexpr unsigned long mpol_bind = 2;
+  unsigned long mask[16] = {0};
+  mask[node / 64] = 1UL << (node % 64);
+  if (syscall(SYS_mbind, ptr, size, mpol_bind, mask, sizeof(mask) * 8 + 1, 0))
+    std::cout << "warning: could not bind buffer to node " << node << "\n";
+
+  std::memset(ptr, 0, size);
+  return ptr;
+}
+
+static double
+measure(xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t iterations)
+{
+  bo.sync(dir);  // warm up
+  auto start = clock_type::now();
+  for (size_t i = 0; i < iterations; ++i)
+    bo.sync(dir);
+  auto sec = std::chrono::duration<double>(clock_type::now() - start).count();
+  return size * iterations / sec / 1.0e9;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  size_t size = 256 * 1024 * 1024;
+  size_t iterations = 20;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!size || !iterations)
+    throw std::runtime_error("size and iterations must be non zero");
+
+  xrt::device device(device_index);
+  device.load_xclbin(xclbin_fnm);
+
+  auto bdf = device.get_info<xrt::info::device::bdf>();
+  auto value = read_sysfs("/sys/bus/pci/devices/" + bdf + "/numa_node");
+  auto device_node = value.empty() ? -1 : std::stoi(value);
+
+  auto nodes = get_nodes();
+  if (nodes.size() < 2)
+    std::cout << "warning: host has " << nodes.size() << " NUMA node(s), nothing to compare\n";
+
+  std::cout << "device " << bdf << " node " << device_node
+            << ", buffer " << size << " bytes, " << iterations << " syncs\n";
+  for (auto& node : nodes) {
+    if (node.second.empty())
+      continue;
+    pin_to(node.second);
+    auto ptr = node_alloc(size, node.first);
+    {
+      xrt::bo bo(device, ptr, size, 0);
+      auto h2c = measure(bo, XCL_BO_SYNC_BO_TO_DEVICE, size, iterations);
+      auto c2h = measure(bo, XCL_BO_SYNC_BO_FROM_DEVICE, size, iterations);
+      std::cout << "node " << node.first << (node.first == device_node ? " (local) " : "         ")
+                << "to device: " << h2c << " GB/s, from device: " << c2h << " GB/s\n";
+    }
+    free(ptr);
+  }
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure many concurrent runs with timed waits and deadlines.
+//
+// % XCL_EMULATION_MODE=noop ./run_timeout -k <xclbin> [-n <kernel>] [-t <threads>]
+//       [-r <runs per thread>] [-i <iterations>] [-w <wait timeout ms>]
+//       [-d <deadline ms>]
+//
+// Each thread keeps a number of runs in flight and waits for each
+// run with a timeout.  A run that is not complete when the wait
+// times out is waited for again.  With a deadline, each run also
+// has a timeout callback that records how late after the deadline
+// it was called.
+//
+// Use xrt.ini Runtime.noop_completion_delay_us to make the noop shim
+// complete commands after a delay, so that waits and deadlines expire.
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: run_timeout [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -n <kernel name>, default 'hello'\n";
+  std::cout << "  -t <threads>, default 8\n";
+  std::cout << "  -r <runs per thread>, default 32\n";
+  std::cout << "  -i <iterations per run>, default 100\n";
+  std::cout << "  -w <wait timeout ms>, default 1\n";
+  std::cout << "  -d <deadline ms>, default 0 (no deadline)\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop with Runtime.noop_completion_delay_us\n";
+}
+
+struct stats
+{
+  std::atomic<uint64_t> completed {0};
+  std::atomic<uint64_t> wait_timeouts {0};
+  std::atomic<uint64_t> deadlines {0};
+  std::mutex mutex;
+  std::vector<double> late_us;  // deadline callback lateness
+};
+
+// A run with the time it was started, used by deadline callback
+struct timed_run
+{
+  xrt::run run;
+  clock_type::time_point started;
+};
+
+static void
+run_thread(const xrt::kernel& kernel, const xrt::device& device, stats& st,
+           size_t runs, size_t iterations, unsigned int wait_ms, unsigned int deadline_ms)
+{
+  std::vector<timed_run> cmds(runs);
+  for (auto& cmd : cmds) {
+    cmd.run = xrt::run(kernel);
+    cmd.run.set_arg(0, xrt::bo(device, 20, kernel.group_id(0)));
+
+    // Completion callback makes the run managed, which is where
+    // the runtime tracks wait timeouts
+    cmd.run.add_callback(ERT_CMD_STATE_COMPLETED,
+                         [&st](const void*, ert_cmd_state, void*) { ++st.completed; },
+                         nullptr);
+
+    if (deadline_ms) {
+      auto deadline = std::chrono::milliseconds(deadline_ms);
+      cmd.run.set_timeout(deadline, [&st, deadline](const void*, ert_cmd_state, void* data) {
+        auto late = clock_type::now() - static_cast<timed_run*>(data)->started - deadline;
+        ++st.deadlines;
+        std::lock_guard<std::mutex> lk(st.mutex);
+        st.late_us.push_back(std::chrono::duration<double, std::micro>(late).count());
+      }, &cmd);
+    }
+  }
+
+  for (size_t it = 0; it < iterations; ++it) {
+    for (auto& cmd : cmds) {
+      cmd.started = clock_type::now();
+      cmd.run.start();
+    }
+    for (auto& cmd : cmds) {
+      while (cmd.run.wait(std::chrono::milliseconds(wait_ms)) < ERT_CMD_STATE_COMPLETED)
+        ++st.wait_timeouts;
+    }
+  }
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  std::string kernel_name = "hello";
+  size_t threads = 8;
+  size_t runs = 32;
+  size_t iterations = 100;
+  unsigned int wait_ms = 1;
+  unsigned int deadline_ms = 0;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-n")
+      kernel_name = arg;
+    else if (cur == "-t")
+      threads = std::stoul(arg);
+    else if (cur == "-r")
+      runs = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else if (cur == "-w")
+      wait_ms = std::stoul(arg);
+    else if (cur == "-d")
+      deadline_ms = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!wait_ms)
+    throw std::runtime_error("wait timeout must be non zero");
+
+  auto device = xrt::device(0);
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  auto kernel = xrt::kernel(device, uuid, kernel_name);
+
+  stats st;
+  auto start = clock_type::now();
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t)
+    workers.emplace_back(run_thread, std::cref(kernel), std::cref(device), std::ref(st),
+                         runs, iterations, wait_ms, deadline_ms);
+  for (auto& w : workers)
+    w.join();
+  auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+  auto total = threads * runs * iterations;
+  std::cout << "threads: " << threads << ", runs in flight: " << threads * runs
+            << ", total runs: " << total << "\n";
+  std::cout << "runs/s: " << total / elapsed
+            << ", wait timeouts: " << st.wait_timeouts
+            << ", completion callbacks: " << st.completed << "\n";
+
+  if (deadline_ms) {
+    auto& late = st.late_us;
+    std::sort(late.begin(), late.end());
+    std::cout << "deadline callbacks: " << st.deadlines;
+    if (!late.empty())
+      std::cout << ", late (us) median: " << late[late.size() / 2]
+                << " p99: " << late[late.size() * 99 / 100]
+                << " max: " << late.back();
+    std::cout << "\n";
+  }
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
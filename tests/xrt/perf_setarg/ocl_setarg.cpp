@@ -0,0 +1,229 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure clSetKernelArg + clEnqueueTask host overhead.
+//
+// % XCL_EMULATION_MODE=noop ./ocl_setarg -k <xclbin> [-n <kernel>] [-i <iterations>] [-c <changed>]
+//
+// All kernel arguments are set before every enqueue.  With -c 0 the
+// values never change, with -c N the first N scalar arguments get a
+// new value for every enqueue.
+
+#include <CL/cl_ext_xilinx.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+static void
+throw_if_error(cl_int errcode, const char* msg=nullptr)
+{
+  if (!errcode)
+    return;
+  std::string err = "errcode '";
+  err.append(std::to_string(errcode)).append("'");
+  if (msg)
+    err.append(" ").append(msg);
+  throw std::runtime_error(err);
+}
+
+static void
+usage()
+{
+  std::cout << "usage: %s [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -n <kernel name>, default 'hello'\n";
+  std::cout << "  -i <iterations>, default 10000\n";
+  std::cout << "  -c <number of scalar args changed per enqueue>, default 0\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+}
+
+static std::vector<char>
+read_xclbin(const std::string& fnm)
+{
+  std::ifstream stream(fnm, std::ios::binary);
+  if (!stream)
+    throw std::runtime_error("Failed to open " + fnm);
+  stream.seekg(0, stream.end);
+  auto size = stream.tellg();
+  stream.seekg(0, stream.beg);
+  std::vector<char> data(size);
+  stream.read(data.data(), size);
+  return data;
+}
+
+// Argument as set by clSetKernelArg
+struct argument
+{
+  cl_uint index;
+  bool global;
+  std::vector<char> value;
+};
+
+static std::vector<argument>
+get_arguments(cl_kernel kernel, cl_mem buffer)
+{
+  cl_uint nargs = 0;
+  throw_if_error(clGetKernelInfo(kernel,CL_KERNEL_NUM_ARGS,sizeof(nargs),&nargs,nullptr),"kernel info failed");
+
+  std::vector<argument> args;
+  for (cl_uint idx = 0; idx < nargs; ++idx) {
+    cl_kernel_arg_address_qualifier aq = 0;
+    throw_if_error(clGetKernelArgInfo(kernel,idx,CL_KERNEL_ARG_ADDRESS_QUALIFIER,sizeof(aq),&aq,nullptr),"arg info failed");
+
+    if (aq == CL_KERNEL_ARG_ADDRESS_GLOBAL || aq == CL_KERNEL_ARG_ADDRESS_CONSTANT) {
+      std::vector<char> value(sizeof(cl_mem));
+      std::memcpy(value.data(), &buffer, sizeof(cl_mem));
+      args.push_back({idx, true, std::move(value)});
+      continue;
+    }
+
+    size_t sz = 0;
+    throw_if_error(clGetKernelArgInfo(kernel,idx,CL_KERNEL_ARG_TYPE_NAME,0,nullptr,&sz),"arg info failed");
+    std::string type(sz, 0);
+    throw_if_error(clGetKernelArgInfo(kernel,idx,CL_KERNEL_ARG_TYPE_NAME,sz,&type[0],nullptr),"arg info failed");
+    size_t bytes = (type.find("long") != std::string::npos || type.find("64") != std::string::npos) ? 8 : 4;
+    args.push_back({idx, false, std::vector<char>(bytes, 0)});
+  }
+  return args;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::vector<std::string> args(argv+1,argv+argc);
+
+  std::string xclbin_fnm;
+  std::string kernel_name = "hello";
+  size_t iterations = 10000;
+  size_t changed = 0;
+
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-n")
+      kernel_name = arg;
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else if (cur == "-c")
+      changed = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1,&platform,nullptr),"no platform");
+
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform,CL_DEVICE_TYPE_ACCELERATOR,1,&device,nullptr),"no device");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr,1,&device,nullptr,nullptr,&err);
+  throw_if_error(err,"failed to create context");
+
+  auto queue = clCreateCommandQueue(context,device,CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE,&err);
+  throw_if_error(err,"failed to create command queue");
+
+  auto xclbin = read_xclbin(xclbin_fnm);
+  const unsigned char* data = reinterpret_cast<unsigned char*>(xclbin.data());
+  size_t size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context,1,&device,&size,&data,nullptr,&err);
+  throw_if_error(err,"failed to create program");
+
+  auto kernel = clCreateKernel(program,kernel_name.c_str(),&err);
+  throw_if_error(err,"failed to create kernel");
+
+  auto buffer = clCreateBuffer(context,CL_MEM_READ_WRITE,4096,nullptr,&err);
+  throw_if_error(err,"failed to create buffer");
+
+  auto arguments = get_arguments(kernel,buffer);
+
+  std::vector<cl_event> events(iterations);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    size_t count = 0;
+    for (auto& arg : arguments) {
+      if (!arg.global && count++ < changed)
+        std::memcpy(arg.value.data(), &it, std::min(arg.value.size(), sizeof(it)));
+      throw_if_error(clSetKernelArg(kernel,arg.index,arg.value.size(),arg.value.data()),"failed to set arg");
+    }
+    throw_if_error(clEnqueueTask(queue,kernel,0,nullptr,&events[it]),"failed to enqueue task");
+  }
+  auto enqueued = std::chrono::high_resolution_clock::now();
+  throw_if_error(clFinish(queue),"failed to finish");
+  auto end = std::chrono::high_resolution_clock::now();
+
+  for (auto event : events)
+    clReleaseEvent(event);
+
+  auto enqueue_us = std::chrono::duration_cast<std::chrono::microseconds>(enqueued - start).count();
+  auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  std::cout << "Kernel: " << kernel_name << ", arguments: " << arguments.size()
+            << ", changed per enqueue: " << changed << "\n";
+  std::cout << "Iterations: " << iterations << "\n";
+  std::cout << "setarg+enqueue: " << static_cast<double>(enqueue_us) / iterations << " us/iteration\n";
+  std::cout << "total: " << total_us << " us, " << (iterations * 1000000.0) / total_us << " IOPS\n";
+
+  clReleaseMemObject(buffer);
+  clReleaseKernel(kernel);
+  clReleaseProgram(program);
+  clReleaseCommandQueue(queue);
+  clReleaseContext(context);
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc,argv);
+    std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (std::exception const& ex) {
+    std::cout << "Exception: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "Exception\n";
+  }
+
+  std::cout << "FAILED TEST\n";
+  return 1;
+}
@@ -0,0 +1,243 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure migration of sub-buffers of one large parent buffer and
+// of the parent after its sub-buffers were migrated.
+//
+// % XCL_EMULATION_MODE=noop ./subbuf_migrate -k <xclbin> [-s <parent bytes>]
+//       [-n <sub-buffers>] [-i <iterations>]
+//
+// The parent is created with CL_MEM_USE_HOST_PTR from an unaligned
+// host pointer, so synced bytes are also staged on the host and the
+// time of a migration follows the bytes synced.  Each iteration uses
+// new parents, which are migrated
+//   - cold, in whole
+//   - after every other sub-buffer was migrated
+//   - after all sub-buffers were migrated
+// and the bytes synced and time of each migration are reported.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: subbuf_migrate [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -s <parent buffer size in bytes>, default 256MB\n";
+  std::cout << "  -n <number of sub-buffers>, default 16\n";
+  std::cout << "  -i <iterations>, default 10\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop to measure host side overhead only\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+struct result
+{
+  size_t bytes = 0;
+  double usec = 0;
+
+  void
+  add(size_t b, clock_type::time_point start)
+  {
+    bytes += b;
+    usec += std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+  }
+
+  void
+  print(const char* what, size_t iterations) const
+  {
+    auto mb = static_cast<double>(bytes) / iterations / (1024 * 1024);
+    auto us = usec / iterations;
+    std::cout << "  " << what << ": " << mb << " MB synced, " << us << " us";
+    if (bytes)
+      std::cout << ", " << (bytes / usec) / 1000 << " GB/s";
+    std::cout << "\n";
+  }
+};
+
+static void
+migrate(cl_command_queue queue, std::vector<cl_mem> mems)
+{
+  throw_if_error(clEnqueueMigrateMemObjects(queue, static_cast<cl_uint>(mems.size()), mems.data(), 0, 0, nullptr, nullptr), "clEnqueueMigrateMemObjects");
+  throw_if_error(clFinish(queue), "clFinish");
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  size_t size = 256 * 1024 * 1024;
+  size_t subbufs = 16;
+  size_t iterations = 10;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else if (cur == "-n")
+      subbufs = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+  if (!subbufs || !iterations)
+    throw std::runtime_error("sub-buffers and iterations must be non zero");
+
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  // Sub-buffer origins must be aligned to the device base address alignment
+  cl_uint align_bits = 0;
+  throw_if_error(clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(align_bits), &align_bits, nullptr), "clGetDeviceInfo");
+  size_t align = std::max<size_t>(align_bits / 8, 1);
+  size_t subsize = size / subbufs / align * align;
+  if (!subsize)
+    throw std::runtime_error("parent buffer too small for number of sub-buffers");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+  auto queue = clCreateCommandQueue(context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  const unsigned char* binary = xclbin.data();
+  size_t binary_size = xclbin.size();
+  auto program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  throw_if_error(clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr), "clBuildProgram");
+
+  // Unaligned host pointer, synced bytes are staged on host
+  void* base = nullptr;
+  if (posix_memalign(&base, 4096, size + 64))
+    throw std::runtime_error("host allocation failed");
+  std::memset(base, 0, size + 64);
+  auto host_ptr = static_cast<char*>(base) + 64;
+
+  result cold, subs_half, parent_half, subs_all, parent_all;
+  for (size_t i = 0; i < iterations; ++i) {
+    // Cold parent migration, whole buffer is synced
+    {
+      auto parent = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, size, host_ptr, &err);
+      throw_if_error(err, "clCreateBuffer");
+      auto start = clock_type::now();
+      migrate(queue, {parent});
+      cold.add(size, start);
+      clReleaseMemObject(parent);
+    }
+
+    // Every other sub-buffer and then all sub-buffers, followed by
+    // the parent, which syncs only what the sub-buffers did not
+    for (size_t step : {2, 1}) {
+      auto parent = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, size, host_ptr, &err);
+      throw_if_error(err, "clCreateBuffer");
+
+      std::vector<cl_mem> subs;
+      for (size_t s = 0; s < subbufs; s += step) {
+        cl_buffer_region region = {s * subsize, subsize};
+        auto sub = clCreateSubBuffer(parent, CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+        throw_if_error(err, "clCreateSubBuffer");
+        subs.push_back(sub);
+      }
+
+      auto start = clock_type::now();
+      migrate(queue, subs);
+      (step == 2 ? subs_half : subs_all).add(subs.size() * subsize, start);
+
+      start = clock_type::now();
+      migrate(queue, {parent});
+      (step == 2 ? parent_half : parent_all).add(size - subs.size() * subsize, start);
+
+      for (auto sub : subs)
+        clReleaseMemObject(sub);
+      clReleaseMemObject(parent);
+    }
+  }
+
+  std::cout << "parent: " << size << " bytes, sub-buffers: " << subbufs << " x " << subsize
+            << " bytes, iterations: " << iterations << "\n";
+  cold.print("cold parent", iterations);
+  subs_half.print("every other sub-buffer", iterations);
+  parent_half.print("parent after every other sub-buffer", iterations);
+  subs_all.print("all sub-buffers", iterations);
+  parent_all.print("parent after all sub-buffers", iterations);
+
+  clReleaseProgram(program);
+  clReleaseCommandQueue(queue);
+  clReleaseContext(context);
+  free(base);
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
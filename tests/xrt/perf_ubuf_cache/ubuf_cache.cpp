@@ -0,0 +1,152 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure create/destroy latency of buffer objects created from
+// long-lived user memory.
+//
+// % XCL_EMULATION_MODE=noop ./ubuf_cache [-s <buffer bytes>]
+//       [-n <buffers>] [-i <iterations>]
+//
+// The test allocates a working set of page aligned host buffers and
+// then repeatedly wraps one of them, round robin, in a new xrt::bo
+// that is destroyed right away.  With Runtime.ubuf_cache_mb the user
+// memory stays registered and is not pinned again, unless the working
+// set exceeds the cache budget.  Use Runtime.noop_userptr_pin_ns_per_page
+// to emulate the pinning cost of the driver.
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "experimental/xrt_bo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: ubuf_cache [options]\n\n";
+  std::cout << "  -d <device index>, default 0\n";
+  std::cout << "  -s <buffer size in bytes>, default 16MB\n";
+  std::cout << "  -n <buffers in working set>, default 8\n";
+  std::cout << "  -i <iterations>, default 1000\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop with Runtime.noop_userptr_pin_ns_per_page\n";
+  std::cout << "  to emulate the cost of pinning user memory\n";
+}
+
+static double
+percentile(const std::vector<double>& sorted, double q)
+{
+  auto idx = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+  return sorted[idx];
+}
+
+static int
+run(int argc, char** argv)
+{
+  unsigned int device_index = 0;
+  size_t size = 16 * 1024 * 1024;
+  size_t buffers = 8;
+  size_t iterations = 1000;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-d")
+      device_index = std::stoul(arg);
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else if (cur == "-n")
+      buffers = std::stoul(arg);
+    else if (cur == "-i")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (!size || !buffers || !iterations)
+    throw std::runtime_error("size, buffers, and iterations must be non zero");
+
+  xrt::device device(device_index);
+
+  std::vector<void*> host(buffers);
+  for (auto& ptr : host)
+    if (posix_memalign(&ptr, getpagesize(), size))
+      throw std::runtime_error("host allocation failed");
+
+  std::vector<double> latency;
+  latency.reserve(iterations);
+  for (size_t i = 0; i < iterations; ++i) {
+    auto ptr = host[i % buffers];
+    auto start = clock_type::now();
+    {
+      xrt::bo bo(device, ptr, size, 0);
+    }
+    latency.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - start).count());
+  }
+  std::sort(latency.begin(), latency.end());
+
+  std::cout << "buffers: " << buffers << " x " << size << " bytes, iterations: " << iterations << "\n";
+  std::cout << "  create+destroy latency (us) p50: " << percentile(latency, 0.5)
+            << " p99: " << percentile(latency, 0.99) << " max: " << latency.back() << "\n";
+
+  // Cached registrations must be released before the memory is freed
+  for (auto ptr : host) {
+    xrt::release_userptr(ptr, size);
+    free(ptr);
+  }
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
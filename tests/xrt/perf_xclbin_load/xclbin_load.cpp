@@ -0,0 +1,212 @@
+/**
+ * Copyright (C) 2021 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Measure the time to load an xclbin onto all devices.
+//
+// % XCL_EMULATION_MODE=noop ./xclbin_load -k <xclbin> [-d <devices>]
+//       [-m <native|opencl>]
+//
+// Native mode loads the xclbin with xrt::device::load_xclbin() on
+// one device after the other, and then with load_xclbin_async() on
+// all devices concurrently.  OpenCL mode times clCreateProgramWithBinary
+// for a context of all devices.
+//
+// Use Runtime.noop_devices and Runtime.noop_load_xclbin_delay_ms to
+// emulate a host with many devices that are slow to load.
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include "xrt/xrt_device.h"
+#include "experimental/xrt_xclbin.h"
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: xclbin_load [options]\n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -d <number of devices>, native mode, default all devices\n";
+  std::cout << "  -m <native|opencl>, default native\n";
+  std::cout << "  -h\n\n";
+  std::cout << "* Use XCL_EMULATION_MODE=noop with Runtime.noop_devices and\n";
+  std::cout << "  Runtime.noop_load_xclbin_delay_ms to emulate slow loads\n";
+}
+
+static void
+throw_if_error(cl_int err, const char* msg)
+{
+  if (err != CL_SUCCESS)
+    throw std::runtime_error(std::string(msg) + " failed (" + std::to_string(err) + ")");
+}
+
+static double
+msec_since(clock_type::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static std::vector<xrt::device>
+open_devices(size_t count)
+{
+  std::vector<xrt::device> devices;
+  const size_t max_devices = 64;
+  for (size_t idx = 0; idx < (count ? count : max_devices); ++idx) {
+    try {
+      devices.emplace_back(static_cast<unsigned int>(idx));
+    }
+    catch (const std::exception&) {
+      if (count)
+        throw;
+      break;
+    }
+  }
+  if (devices.empty())
+    throw std::runtime_error("no devices found");
+  return devices;
+}
+
+static void
+run_native(const std::string& xclbin_fnm, size_t count)
+{
+  auto devices = open_devices(count);
+  xrt::xclbin xclbin{xclbin_fnm};
+
+  auto start = clock_type::now();
+  for (auto& device : devices)
+    device.load_xclbin(xclbin);
+  auto sequential = msec_since(start);
+
+  start = clock_type::now();
+  std::vector<std::future<xrt::uuid>> loads;
+  for (auto& device : devices)
+    loads.push_back(device.load_xclbin_async(xclbin));
+  for (auto& load : loads)
+    if (load.get() != xclbin.get_uuid())
+      throw std::runtime_error("unexpected xclbin uuid");
+  auto concurrent = msec_since(start);
+
+  std::cout << "devices: " << devices.size() << "\n";
+  std::cout << "  load_xclbin one by one: " << sequential << " ms\n";
+  std::cout << "  load_xclbin_async all: " << concurrent << " ms\n";
+}
+
+static void
+run_opencl(const std::string& xclbin_fnm)
+{
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_uint num_devices = 0;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 0, nullptr, &num_devices), "clGetDeviceIDs");
+  std::vector<cl_device_id> devices(num_devices);
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, num_devices, devices.data(), nullptr), "clGetDeviceIDs");
+
+  cl_int err = CL_SUCCESS;
+  auto context = clCreateContext(nullptr, num_devices, devices.data(), nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<unsigned char> xclbin((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  std::vector<const unsigned char*> binaries(num_devices, xclbin.data());
+  std::vector<size_t> sizes(num_devices, xclbin.size());
+  std::vector<cl_int> status(num_devices);
+
+  auto start = clock_type::now();
+  auto program = clCreateProgramWithBinary(context, num_devices, devices.data(), sizes.data(), binaries.data(), status.data(), &err);
+  auto elapsed = msec_since(start);
+  for (cl_uint idx = 0; idx < num_devices; ++idx)
+    throw_if_error(status[idx], ("binary status of device " + std::to_string(idx)).c_str());
+  throw_if_error(err, "clCreateProgramWithBinary");
+
+  std::cout << "devices: " << num_devices << "\n";
+  std::cout << "  clCreateProgramWithBinary: " << elapsed << " ms\n";
+
+  clReleaseProgram(program);
+  clReleaseContext(context);
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  std::string mode = "native";
+  size_t devices = 0;
+
+  std::vector<std::string> args(argv+1, argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      devices = std::stoul(arg);
+    else if (cur == "-m")
+      mode = arg;
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  if (mode == "native")
+    run_native(xclbin_fnm, devices);
+  else if (mode == "opencl")
+    run_opencl(xclbin_fnm);
+  else
+    throw std::runtime_error("bad mode '" + mode + "'");
+
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto ret = run(argc, argv);
+    if (!ret)
+      std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}